@@ -183,46 +183,27 @@ exit:
     return fcc_status;
 }
 
-/**This function retrives certificate's attribute and it's size according to its type.
+/**This function gets a stored certificate in its parsed form, from the KCM certificate cache.
 *
-* @param certificate_data[in]                  buffer of certificate.
-* @param size_of_certificate_data[in]          size of certificate data.
-* @attribute_type[in]                          type of attribute to retrieve.
-* @param size_of_certificate_data[out]         attribute data buffer.
-* @param size_of_certificate_data[out]         size of attribute data buffer.
+* @param certificate_name[in]              name of the certificate.
+* @param size_of_certificate_name[in]      size of the certificate name.
+* @param cert_info[out]                    the parsed certificate, valid until the KCM certificate cache changes (see kcm_cert_info_get()).
 *        fcc_status_e status.
 */
-static fcc_status_e fcc_get_certificate_attribute(palX509Handle_t x509_cert, cs_certificate_attribute_type_e attribute_type, uint8_t **attribute_data, size_t *attribute_size)
+static fcc_status_e fcc_get_certificate_info(const uint8_t *certificate_name, size_t size_of_certificate_name, const kcm_cert_info_s **cert_info)
 {
-
     kcm_status_e kcm_status = KCM_STATUS_SUCCESS;
-    fcc_status_e fcc_status = FCC_STATUS_SUCCESS;
-  
-
-
-    //Get attribute size
-    kcm_status = cs_attr_get_data_size_x509_cert(x509_cert,
-                                                 attribute_type, 
-                                                 attribute_size);
-    SA_PV_ERR_RECOVERABLE_RETURN_IF((kcm_status != KCM_STATUS_SUCCESS), fcc_status = FCC_STATUS_INVALID_CERT_ATTRIBUTE, "Failed to get size of attribute");
 
-    *attribute_data = fcc_malloc(*attribute_size);
-    SA_PV_ERR_RECOVERABLE_RETURN_IF((*attribute_data == NULL), fcc_status = FCC_STATUS_MEMORY_OUT, "Failed to allocate memory for attribute");
+    kcm_status = kcm_cert_info_get(certificate_name, size_of_certificate_name, cert_info);
+    SA_PV_ERR_RECOVERABLE_RETURN_IF((kcm_status == KCM_STATUS_ITEM_NOT_FOUND), FCC_STATUS_ITEM_NOT_EXIST, "KCM is not found");
+    SA_PV_ERR_RECOVERABLE_RETURN_IF((kcm_status == KCM_STATUS_ITEM_IS_EMPTY), FCC_STATUS_EMPTY_ITEM, "KCM item is empty");
+    SA_PV_ERR_RECOVERABLE_RETURN_IF((kcm_status == KCM_STATUS_OUT_OF_MEMORY), FCC_STATUS_MEMORY_OUT, "Failed to allocate parsed certificate");
+    SA_PV_ERR_RECOVERABLE_RETURN_IF((kcm_status >= KCM_CRYPTO_STATUS_UNSUPPORTED_HASH_MODE), FCC_STATUS_INVALID_CERTIFICATE, "Failed to get certificate descriptor");
+    SA_PV_ERR_RECOVERABLE_RETURN_IF((kcm_status != KCM_STATUS_SUCCESS), FCC_STATUS_KCM_STORAGE_ERROR, "Failed to get certificate data");
 
-    //Get data of "CN" attribute
-    kcm_status = cs_attr_get_data_x509_cert(x509_cert,
-                                            attribute_type,
-                                            *attribute_data,
-                                            *attribute_size,
-                                            attribute_size);
-    SA_PV_ERR_RECOVERABLE_GOTO_IF((kcm_status != KCM_STATUS_SUCCESS || *attribute_size == 0), fcc_status = FCC_STATUS_INVALID_CERT_ATTRIBUTE, exit, "Failed to get attribute data");
-
-    return fcc_status;
-exit:
-    fcc_free(*attribute_data);
-    *attribute_data = NULL;
-    return fcc_status;
+    return FCC_STATUS_SUCCESS;
 }
+
 /* The function verifies if current item exists and checks the result with is_should_be_present flag.
 *  In case of unsuitability of the flag and existence of the item, the function sets warning with relevant message.
 */
@@ -256,33 +237,25 @@ static fcc_status_e verify_existence_and_set_warning(const uint8_t *parameter_na
 }
 /**This function verifies certificate expiration according to
 *
-* @param certificate_data[in]                  buffer of certificate.
-* @param size_of_certificate_data[in]          size of certificate data.
+* @param cert_info[in]                         parsed certificate.
 * @param certificate_name[in]                  buffer of certificate name.
 * @param size_of_certificate_name[in]          size of certificate name buffer.
 *    @returns
 *        fcc_status_e status.
 */
-static fcc_status_e verify_certificate_expiration(palX509Handle_t x509_cert, const uint8_t *certificate_name, size_t size_of_certificate_name)
+static fcc_status_e verify_certificate_expiration(const kcm_cert_info_s *cert_info, const uint8_t *certificate_name, size_t size_of_certificate_name)
 {
     fcc_status_e fcc_status = FCC_STATUS_SUCCESS;
     fcc_status_e output_info_fcc_status = FCC_STATUS_SUCCESS;
-    size_t size_of_valid_from_attr = 0;
-    size_t size_of_valid_until_attr = 0;
-    uint64_t *valid_from_attr = NULL;
     uint64_t time = 0;
     uint64_t diff_time = 60; //seconds. This value used to reduce time adjustment 
-    uint64_t *valid_until_attr = NULL;
+    const uint64_t *valid_from_attr = &cert_info->valid_from;
+    const uint64_t *valid_until_attr = &cert_info->valid_to;
 
     SA_PV_LOG_TRACE_FUNC_ENTER_NO_ARGS();
 
-    //Get "valid_from" certificate attribute
-    fcc_status = fcc_get_certificate_attribute(x509_cert, CS_VALID_FROM_ATTRIBUTE_TYPE, (uint8_t**)&valid_from_attr, &size_of_valid_from_attr);
-    SA_PV_ERR_RECOVERABLE_GOTO_IF(fcc_status != FCC_STATUS_SUCCESS || size_of_valid_from_attr != sizeof(uint64_t), fcc_status = fcc_status, exit, "Failed to get size of valid_from attribute");
-
-    //Get "valid_until" certificate attribute
-    fcc_status = fcc_get_certificate_attribute(x509_cert, CS_VALID_TO_ATTRIBUTE_TYPE, (uint8_t**)&valid_until_attr, &size_of_valid_until_attr);
-    SA_PV_ERR_RECOVERABLE_GOTO_IF(fcc_status != FCC_STATUS_SUCCESS || size_of_valid_from_attr != sizeof(uint64_t), fcc_status = fcc_status, exit, "Failed to get size of valid_until attribute");
+    //Check "valid_from" and "valid_until" certificate attributes
+    SA_PV_ERR_RECOVERABLE_GOTO_IF((!cert_info->has_validity), fcc_status = FCC_STATUS_INVALID_CERT_ATTRIBUTE, exit, "Failed to get validity attributes");
 
 
     //Check device time
@@ -311,8 +284,6 @@ static fcc_status_e verify_certificate_expiration(palX509Handle_t x509_cert, con
 
     }
 exit:
-    fcc_free(valid_from_attr);
-    fcc_free(valid_until_attr);
     if (fcc_status != FCC_STATUS_SUCCESS) {
         output_info_fcc_status = fcc_store_error_info((const uint8_t*)certificate_name, size_of_certificate_name, fcc_status);
         SA_PV_ERR_RECOVERABLE_RETURN_IF((output_info_fcc_status != FCC_STATUS_SUCCESS), fcc_status = FCC_STATUS_OUTPUT_INFO_ERROR, "Failed to create output fcc_status error %d", fcc_status);
@@ -322,15 +293,14 @@ exit:
 }
 /**This function verifies lwm2m certificate ou attribute is equal to aid from server link.
 *
-* @param certificate_data[in]                  buffer of certificate.
-* @param size_of_certificate_data[in]          size of certificate data.
+* @param cert_info[in]                         parsed certificate.
 *        fcc_status_e status.
 */
-static fcc_status_e compare_ou_with_aid_server(palX509Handle_t x509_cert)
+static fcc_status_e compare_ou_with_aid_server(const kcm_cert_info_s *cert_info)
 {
     fcc_status_e fcc_status = FCC_STATUS_SUCCESS;
-    uint8_t *ou_attribute_data = NULL;
-    size_t ou_attribute_size = 0;
+    const uint8_t *ou_attribute_data = cert_info->ou;
+    size_t ou_attribute_size = cert_info->ou_size;
     uint8_t *parameter_name = (uint8_t*)g_fcc_lwm2m_server_uri_name;
     size_t size_of_parameter_name = strlen(g_fcc_lwm2m_server_uri_name);
     uint8_t *server_uri_buffer = NULL;
@@ -341,9 +311,8 @@ static fcc_status_e compare_ou_with_aid_server(palX509Handle_t x509_cert)
     int result = 0;
     int len_of_aid_sub_string = strlen("&aid=");
 
-    //Get OU certificate attribute
-    fcc_status = fcc_get_certificate_attribute(x509_cert, CS_OU_ATTRIBUTE_TYPE, &ou_attribute_data, &ou_attribute_size);
-    SA_PV_ERR_RECOVERABLE_RETURN_IF(fcc_status != FCC_STATUS_SUCCESS, fcc_status = fcc_status, "Failed to get size OU attribute");
+    //Check OU certificate attribute
+    SA_PV_ERR_RECOVERABLE_RETURN_IF((ou_attribute_data == NULL), fcc_status = FCC_STATUS_INVALID_CERT_ATTRIBUTE, "Failed to get size OU attribute");
 
     //Get aid data
     fcc_status = fcc_get_kcm_data(parameter_name, size_of_parameter_name, KCM_CONFIG_ITEM, &server_uri_buffer, &item_size);
@@ -369,30 +338,27 @@ static fcc_status_e compare_ou_with_aid_server(palX509Handle_t x509_cert)
     SA_PV_ERR_RECOVERABLE_GOTO_IF((result != 0), fcc_status = FCC_STATUS_INVALID_LWM2M_CN_ATTR, exit, "CN of LWM2M different from endpoint name");
 
 exit:
-    fcc_free(ou_attribute_data);
     fcc_free(server_uri_buffer);
     fcc_free(uri_string);
     return fcc_status;
 }
 /**This function verifies  certificate's cn attribute is equal to endpoint name.
 *
-* @param certificate_data[in]                  buffer of certificate.
-* @param size_of_certificate_data[in]          size of certificate data.
+* @param cert_info[in]                         parsed certificate.
 *        fcc_status_e status.
 */
-static fcc_status_e compare_cn_with_endpoint(palX509Handle_t x509_cert)
+static fcc_status_e compare_cn_with_endpoint(const kcm_cert_info_s *cert_info)
 {
     fcc_status_e fcc_status = FCC_STATUS_SUCCESS;
     //fcc_status_e output_info_fcc_status = FCC_STATUS_SUCCESS;
-    size_t size_of_cn_attr = 0;
-    uint8_t *cn_attribute_data = NULL;
+    size_t size_of_cn_attr = cert_info->cn_size;
+    const uint8_t *cn_attribute_data = cert_info->cn;
     size_t endpoint_name_size;
     uint8_t *endpoint_name_data = NULL;
     int result = 0;
 
-    //Get  CN certificate attribute
-    fcc_status = fcc_get_certificate_attribute(x509_cert, CS_CN_ATTRIBUTE_TYPE, &cn_attribute_data, &size_of_cn_attr);
-    SA_PV_ERR_RECOVERABLE_RETURN_IF(fcc_status != FCC_STATUS_SUCCESS, fcc_status = fcc_status, "Failed to get size CN attribute");
+    //Check CN certificate attribute
+    SA_PV_ERR_RECOVERABLE_RETURN_IF((cn_attribute_data == NULL), fcc_status = FCC_STATUS_INVALID_CERT_ATTRIBUTE, "Failed to get size CN attribute");
 
     //Get attribute returns size of string including  "\0"
     size_of_cn_attr = size_of_cn_attr - 1;
@@ -406,7 +372,6 @@ static fcc_status_e compare_cn_with_endpoint(palX509Handle_t x509_cert)
     SA_PV_ERR_RECOVERABLE_GOTO_IF((result != 0), fcc_status = FCC_STATUS_INVALID_LWM2M_CN_ATTR, exit, "CN of the certificate is different from endpoint name");
 
 exit:
-    fcc_free(cn_attribute_data);
     fcc_free(endpoint_name_data);
     return fcc_status;
 }
@@ -594,8 +559,6 @@ static fcc_status_e verify_device_certificate_and_private_key(bool use_bootstrap
     fcc_status_e fcc_status = FCC_STATUS_SUCCESS;
     fcc_status_e output_info_fcc_status = FCC_STATUS_SUCCESS;
     kcm_status_e kcm_status = KCM_STATUS_SUCCESS;
-    size_t size_of_device_cert = 0;
-    uint8_t *device_cert = NULL;
     bool is_self_signed = false;
     uint8_t *parameter_name = NULL;
     size_t size_of_parameter_name = 0;
@@ -603,7 +566,7 @@ static fcc_status_e verify_device_certificate_and_private_key(bool use_bootstrap
     size_t size_of_second_mode_parameter_name = 0;
     uint8_t *private_key_data = NULL;
     size_t size_of_private_key_data = 0;
-    palX509Handle_t x509_cert_handle = NULLPTR;
+    const kcm_cert_info_s *cert_info = NULL;
 
     SA_PV_LOG_TRACE_FUNC_ENTER_NO_ARGS();
 
@@ -643,33 +606,33 @@ static fcc_status_e verify_device_certificate_and_private_key(bool use_bootstrap
         size_of_second_mode_parameter_name = strlen(g_fcc_bootstrap_device_certificate_name);
     }
 
-    fcc_status = fcc_get_kcm_data(parameter_name, size_of_parameter_name, KCM_CERTIFICATE_ITEM, &device_cert, &size_of_device_cert);
+    //Check device certificate public key, this also makes sure the certificate is parsed and cached
+    fcc_status = fcc_get_certificate_info(parameter_name, size_of_parameter_name, &cert_info);
     SA_PV_ERR_RECOVERABLE_GOTO_IF((fcc_status != FCC_STATUS_SUCCESS), fcc_status = fcc_status, store_error_and_exit, "Failed to get device certificate");
 
-    //Create device certificate handle
-    kcm_status = cs_create_handle_from_der_x509_cert(device_cert, size_of_device_cert, &x509_cert_handle);
-    SA_PV_ERR_RECOVERABLE_GOTO_IF((kcm_status != KCM_STATUS_SUCCESS), fcc_status = FCC_STATUS_INVALID_CERTIFICATE, store_error_and_exit, "Failed to get device certificate descriptor");
-
-    //Check device certificate public key
-    kcm_status = cs_check_certifcate_public_key(x509_cert_handle, private_key_data, size_of_private_key_data);
+    kcm_status = kcm_cert_check_private_key(parameter_name, size_of_parameter_name, private_key_data, size_of_private_key_data);
     SA_PV_ERR_RECOVERABLE_GOTO_IF((kcm_status != KCM_STATUS_SUCCESS), fcc_status = FCC_STATUS_CERTIFICATE_PUBLIC_KEY_CORRELATION_ERROR, store_error_and_exit, "Failed to check device certificate public key");
 
     //Check if the certificate of second mode exists, if yes - set warning
     fcc_status = verify_existence_and_set_warning(second_mode_parameter_name, size_of_second_mode_parameter_name, KCM_CERTIFICATE_ITEM, false);
     SA_PV_ERR_RECOVERABLE_GOTO_IF((fcc_status != FCC_STATUS_SUCCESS), fcc_status = fcc_status, store_error_and_exit, "Failed to verify_existence_and_set_warning");
 
+    //Get the parsed certificate again, the certificate cache may have changed since. The checks below only read other items
+    fcc_status = fcc_get_certificate_info(parameter_name, size_of_parameter_name, &cert_info);
+    SA_PV_ERR_RECOVERABLE_GOTO_IF((fcc_status != FCC_STATUS_SUCCESS), fcc_status = fcc_status, store_error_and_exit, "Failed to get device certificate");
+
     //Compare device certificate's CN attribute with endpoint name
-    fcc_status = compare_cn_with_endpoint(x509_cert_handle);
+    fcc_status = compare_cn_with_endpoint(cert_info);
     SA_PV_ERR_RECOVERABLE_GOTO_IF((fcc_status != FCC_STATUS_SUCCESS), fcc_status = fcc_status, store_error_and_exit, "Failed to compare_cn_with_endpoint");
 
     //In case LWM2M certificate check it's OU attribute with aid of server link
     if (strcmp((const char*)parameter_name, g_fcc_lwm2m_device_certificate_name) == 0) {
-        fcc_status = compare_ou_with_aid_server(x509_cert_handle);
+        fcc_status = compare_ou_with_aid_server(cert_info);
         SA_PV_ERR_RECOVERABLE_GOTO_IF((fcc_status != FCC_STATUS_SUCCESS), fcc_status = fcc_status, store_error_and_exit, "Failed to compare_ou_with_aid_server");
     }
 
     //Check that device certificate not self-signed
-    kcm_status = cs_is_self_signed_x509_cert(x509_cert_handle, &is_self_signed);
+    kcm_status = cs_is_self_signed_x509_cert((palX509Handle_t)cert_info->x509_cert_handle, &is_self_signed);
     SA_PV_ERR_RECOVERABLE_GOTO_IF((kcm_status != KCM_STATUS_SUCCESS), fcc_status = FCC_STATUS_INVALID_CERTIFICATE, store_error_and_exit, "Failed to check if device certificate is self-signed");
     if (is_self_signed == true) {
         output_info_fcc_status = fcc_store_warning_info(parameter_name, size_of_parameter_name, g_fcc_self_signed_warning_str);
@@ -680,13 +643,11 @@ static fcc_status_e verify_device_certificate_and_private_key(bool use_bootstrap
                                       g_fcc_self_signed_warning_str);
     }
     //Check device certificate attributes
-    fcc_status = verify_certificate_expiration(x509_cert_handle, parameter_name, size_of_parameter_name);
+    fcc_status = verify_certificate_expiration(cert_info, parameter_name, size_of_parameter_name);
     SA_PV_ERR_RECOVERABLE_GOTO_IF((fcc_status != FCC_STATUS_SUCCESS), fcc_status = fcc_status, store_error_and_exit, "Failed to verify_certificate_validity");
 
 store_error_and_exit:
     fcc_free(private_key_data);
-    fcc_free(device_cert);
-    cs_close_handle_x509_cert(&x509_cert_handle);
     if (fcc_status != FCC_STATUS_SUCCESS) {
         output_info_fcc_status = fcc_store_error_info(parameter_name, size_of_parameter_name, fcc_status);
         SA_PV_ERR_RECOVERABLE_RETURN_IF((output_info_fcc_status != FCC_STATUS_SUCCESS),
@@ -703,19 +664,16 @@ store_error_and_exit:
 */
 static fcc_status_e verify_firmware_update_certificate(void)
 {
-    kcm_status_e kcm_status = KCM_STATUS_SUCCESS;
     fcc_status_e fcc_status = FCC_STATUS_SUCCESS;
     fcc_status_e fcc_output_status = FCC_STATUS_SUCCESS;
     fcc_status_e output_info_fcc_status = FCC_STATUS_SUCCESS;
     uint8_t *parameter_name = (uint8_t*)g_fcc_update_authentication_certificate_name;
     size_t size_of_parameter_name = strlen(g_fcc_update_authentication_certificate_name);
-    size_t certificate_data_size = 0;
-    uint8_t *certificate_data = NULL;
-    palX509Handle_t x509_cert_handle = NULLPTR;
+    const kcm_cert_info_s *cert_info = NULL;
 
     SA_PV_LOG_TRACE_FUNC_ENTER_NO_ARGS();
 
-    fcc_status = fcc_get_kcm_data(parameter_name, size_of_parameter_name, KCM_CERTIFICATE_ITEM, &certificate_data, &certificate_data_size);
+    fcc_status = fcc_get_certificate_info(parameter_name, size_of_parameter_name, &cert_info);
 
     if (fcc_status == FCC_STATUS_ITEM_NOT_EXIST || fcc_status == FCC_STATUS_EMPTY_ITEM) {
         fcc_output_status = fcc_store_warning_info((const uint8_t*)parameter_name, size_of_parameter_name, g_fcc_item_not_set_warning_str);
@@ -727,21 +685,14 @@ static fcc_status_e verify_firmware_update_certificate(void)
         fcc_status = FCC_STATUS_SUCCESS;
     } else {
         //If get kcm data returned error, exit with error
-        SA_PV_ERR_RECOVERABLE_GOTO_IF((fcc_status != FCC_STATUS_SUCCESS), fcc_status = fcc_status, exit, "Failed to get update certificate data");
-
-        //Create ca firmware integrity certificate handle
-        kcm_status = cs_create_handle_from_der_x509_cert(certificate_data, certificate_data_size, &x509_cert_handle);
-        SA_PV_ERR_RECOVERABLE_GOTO_IF((kcm_status != KCM_STATUS_SUCCESS), fcc_status = FCC_STATUS_INVALID_CERTIFICATE, exit, "Failed to get device certificate descriptor");
+        SA_PV_ERR_RECOVERABLE_GOTO_IF((fcc_status != FCC_STATUS_SUCCESS), fcc_status = fcc_status, exit, "Failed to get update certificate");
 
         //Check firmware update certificate expiration
-        fcc_status = verify_certificate_expiration(x509_cert_handle, parameter_name, size_of_parameter_name);
+        fcc_status = verify_certificate_expiration(cert_info, parameter_name, size_of_parameter_name);
         SA_PV_ERR_RECOVERABLE_GOTO_IF((fcc_status != FCC_STATUS_SUCCESS), fcc_status = fcc_status, exit, "Failed to verify_certificate_validity");
     }
 
 exit:
-
-    fcc_free(certificate_data);
-    cs_close_handle_x509_cert(&x509_cert_handle);
     if (fcc_status != FCC_STATUS_SUCCESS) {
         output_info_fcc_status = fcc_store_error_info(parameter_name, size_of_parameter_name, fcc_status);
         SA_PV_ERR_RECOVERABLE_RETURN_IF((output_info_fcc_status != FCC_STATUS_SUCCESS),
@@ -24,19 +24,18 @@
 
 
 /** Processes  certificate list.
-* The function extracts data parameters for each certificate and stores it.
+* The function extracts data parameters for each certificate and adds it to the store batch.
 *
 * @param certs_list_cb[in]   The cbor structure with certificate list.
+* @param batch[in/out]       The store batch.
 *
 * @return
 *     true for success, false otherwise.
 */
-fcc_status_e fcc_bundle_process_certificates(const cn_cbor *certs_list_cb)
+fcc_status_e fcc_bundle_process_certificates(const cn_cbor *certs_list_cb, fcc_bundle_store_batch_s *batch)
 {
     bool status = false;
     fcc_status_e fcc_status = FCC_STATUS_SUCCESS;
-    fcc_status_e output_info_fcc_status = FCC_STATUS_SUCCESS;
-    kcm_status_e kcm_result =  KCM_STATUS_SUCCESS;
     uint32_t cert_index = 0;
     cn_cbor *cert_cb;
     fcc_bundle_data_param_s certificate;
@@ -47,33 +46,21 @@ fcc_status_e fcc_bundle_process_certificates(const cn_cbor *certs_list_cb)
     //Initialize data struct
     memset(&certificate, 0, sizeof(fcc_bundle_data_param_s));
 
-    for (cert_index = 0; cert_index < (uint32_t)certs_list_cb->length; cert_index++) {
-
-        FCC_SET_START_TIMER(fcc_certificate_timer);
+    //Go over the certificates in order, without looking each one up by its index
+    for (cert_cb = certs_list_cb->first_child; cert_cb != NULL; cert_cb = cert_cb->next, cert_index++) {
 
         fcc_bundle_clean_and_free_data_param(&certificate);
 
-        //Get key CBOR struct at index key_index
-        cert_cb = cn_cbor_index(certs_list_cb, cert_index);
-        SA_PV_ERR_RECOVERABLE_RETURN_IF((cert_cb == NULL), fcc_status = FCC_STATUS_BUNDLE_ERROR, "Failed to get certificate at index (%" PRIu32 ") ", cert_index);
         SA_PV_ERR_RECOVERABLE_RETURN_IF((cert_cb->type != CN_CBOR_MAP), fcc_status = FCC_STATUS_BUNDLE_ERROR, "Wrong type of certificate CBOR struct at index (%" PRIu32 ") ", cert_index);
 
         status = fcc_bundle_get_data_param(cert_cb, &certificate);
         SA_PV_ERR_RECOVERABLE_RETURN_IF((status != true), fcc_status = FCC_STATUS_BUNDLE_ERROR, "Failed to get certificate data at index (%" PRIu32 ") ", cert_index);
 
-        kcm_result = kcm_item_store(certificate.name, certificate.name_len, KCM_CERTIFICATE_ITEM, true, certificate.data, certificate.data_size, certificate.acl);
-        FCC_END_TIMER((char*)certificate.name, certificate.name_len,fcc_certificate_timer);
-        SA_PV_ERR_RECOVERABLE_GOTO_IF((kcm_result != KCM_STATUS_SUCCESS), fcc_status = FCC_STATUS_KCM_ERROR, exit,"Failed to store certificate at index (%" PRIu32 ") ", cert_index);
-
+        fcc_status = fcc_bundle_batch_add(batch, &certificate, KCM_CERTIFICATE_ITEM);
+        SA_PV_ERR_RECOVERABLE_GOTO_IF((fcc_status != FCC_STATUS_SUCCESS), fcc_status = fcc_status, exit, "Failed to add certificate at index (%" PRIu32 ") ", cert_index);
     }
 
 exit:
-    if (kcm_result != KCM_STATUS_SUCCESS) {
-        output_info_fcc_status = fcc_bundle_store_error_info(certificate.name, certificate.name_len, kcm_result);
-        SA_PV_ERR_RECOVERABLE_RETURN_IF((output_info_fcc_status != FCC_STATUS_SUCCESS),
-                                        fcc_status = FCC_STATUS_OUTPUT_INFO_ERROR, 
-                                        "Failed to create output kcm_status error %d", kcm_result);
-    }
     fcc_bundle_clean_and_free_data_param(&certificate);
     SA_PV_LOG_TRACE_FUNC_EXIT_NO_ARGS();
     return fcc_status;
@@ -20,6 +20,8 @@
 #include "fcc_bundle_utils.h"
 #include "fcc_malloc.h"
 #include "general_utils.h"
+#include "fcc_output_info_handler.h"
+#include "fcc_time_profiling.h"
 
 #define  FCC_MAX_SIZE_OF_STRING 512
 
@@ -146,10 +148,38 @@ void fcc_bundle_clean_and_free_data_param(fcc_bundle_data_param_s *data_param)
     SA_PV_LOG_TRACE_FUNC_EXIT_NO_ARGS();
 
 }
+/** Finds the data parameter named by a cbor map key in the data parameter lookup table.
+*
+* @param data_param_key_cb[in]   The cbor map key
+*
+* @return
+*     index in fcc_bundle_data_param_lookup_table, or FCC_BUNDLE_DATA_PARAM_MAX_TYPE if not found.
+*/
+static int get_data_param_index(const cn_cbor *data_param_key_cb)
+{
+    int data_param_index;
+
+    if (data_param_key_cb->type != CN_CBOR_TEXT && data_param_key_cb->type != CN_CBOR_BYTES) {
+        return FCC_BUNDLE_DATA_PARAM_MAX_TYPE;
+    }
+
+    for (data_param_index = FCC_BUNDLE_DATA_PARAM_NAME_TYPE; data_param_index < FCC_BUNDLE_DATA_PARAM_MAX_TYPE; data_param_index++) {
+        if (is_memory_equal(fcc_bundle_data_param_lookup_table[data_param_index].data_param_name,
+                            strlen(fcc_bundle_data_param_lookup_table[data_param_index].data_param_name),
+                            data_param_key_cb->v.bytes,
+                            (size_t)data_param_key_cb->length)) {
+            break;
+        }
+    }
+    return data_param_index;
+}
+
 bool fcc_bundle_get_data_param(const cn_cbor *data_param_cb, fcc_bundle_data_param_s *data_param)
 {
     bool status = false;
     int data_param_index = 0;
+    bool data_param_found[FCC_BUNDLE_DATA_PARAM_MAX_TYPE];
+    cn_cbor *data_param_key_cb;
     cn_cbor *data_param_value_cb;
     fcc_bundle_data_param_type_e data_param_type;
 
@@ -157,14 +187,18 @@ bool fcc_bundle_get_data_param(const cn_cbor *data_param_cb, fcc_bundle_data_par
 
     //Prepare key struct
     fcc_bundle_clean_and_free_data_param(data_param);
+    memset(data_param_found, 0, sizeof(data_param_found));
 
-    //Go over all key's parameters and extract it to appropriate key struct member
-    for (data_param_index = FCC_BUNDLE_DATA_PARAM_NAME_TYPE; data_param_index < FCC_BUNDLE_DATA_PARAM_MAX_TYPE; data_param_index++) {
+    //Go once over the map and extract each known parameter to appropriate key struct member
+    for (data_param_key_cb = data_param_cb->first_child; data_param_key_cb != NULL && data_param_key_cb->next != NULL; data_param_key_cb = data_param_key_cb->next->next) {
+
+        data_param_index = get_data_param_index(data_param_key_cb);
 
-        //Get value of parameter
-        data_param_value_cb = cn_cbor_mapget_string(data_param_cb, fcc_bundle_data_param_lookup_table[data_param_index].data_param_name);
+        //As with cn_cbor_mapget_string(), only the first occurrence of a parameter is used
+        if (data_param_index < FCC_BUNDLE_DATA_PARAM_MAX_TYPE && !data_param_found[data_param_index]) {
+            data_param_found[data_param_index] = true;
+            data_param_value_cb = data_param_key_cb->next;
 
-        if (data_param_value_cb != NULL) {
             //Get type of parameter
             data_param_type = fcc_bundle_data_param_lookup_table[data_param_index].data_param_type;
 
@@ -220,3 +254,97 @@ error_exit:
     SA_PV_LOG_TRACE_FUNC_EXIT_NO_ARGS();
     return false;
 }
+
+fcc_status_e fcc_bundle_batch_add(fcc_bundle_store_batch_s *batch, fcc_bundle_data_param_s *data_param, kcm_item_type_e item_type)
+{
+    kcm_item_batch_entry_s *items;
+    kcm_item_batch_entry_s *item;
+    size_t items_capacity;
+
+    SA_PV_LOG_TRACE_FUNC_ENTER_NO_ARGS();
+    SA_PV_ERR_RECOVERABLE_RETURN_IF((batch == NULL), FCC_STATUS_INVALID_PARAMETER, "Invalid batch");
+    SA_PV_ERR_RECOVERABLE_RETURN_IF((data_param == NULL), FCC_STATUS_INVALID_PARAMETER, "Invalid data_param");
+
+    if (batch->items_count == batch->items_capacity) {
+        items_capacity = (batch->items_capacity == 0) ? 8 : batch->items_capacity * 2;
+        items = (kcm_item_batch_entry_s*)fcc_malloc(items_capacity * sizeof(kcm_item_batch_entry_s));
+        SA_PV_ERR_RECOVERABLE_RETURN_IF((items == NULL), FCC_STATUS_MEMORY_OUT, "Failed to allocate batch items");
+        if (batch->items_count > 0) {
+            memcpy(items, batch->items, batch->items_count * sizeof(kcm_item_batch_entry_s));
+        }
+        fcc_free(batch->items);
+        batch->items = items;
+        batch->items_capacity = items_capacity;
+    }
+
+    item = &batch->items[batch->items_count];
+    memset(item, 0, sizeof(kcm_item_batch_entry_s));
+    item->name = data_param->name;
+    item->name_len = data_param->name_len;
+    item->type = item_type;
+    item->data = data_param->data;
+    item->data_size = data_param->data_size;
+    item->security_desc = data_param->acl;
+    batch->items_count++;
+
+    //The batch owns the name from now on
+    data_param->name = NULL;
+
+    SA_PV_LOG_TRACE_FUNC_EXIT_NO_ARGS();
+    return FCC_STATUS_SUCCESS;
+}
+
+fcc_status_e fcc_bundle_batch_commit(fcc_bundle_store_batch_s *batch)
+{
+    fcc_status_e fcc_status = FCC_STATUS_SUCCESS;
+    fcc_status_e output_info_fcc_status = FCC_STATUS_SUCCESS;
+    kcm_status_e kcm_result = KCM_STATUS_SUCCESS;
+    kcm_item_batch_entry_s *items;
+    size_t items_count;
+    size_t failed_index;
+
+    SA_PV_LOG_TRACE_FUNC_ENTER_NO_ARGS();
+    SA_PV_ERR_RECOVERABLE_RETURN_IF((batch == NULL), FCC_STATUS_INVALID_PARAMETER, "Invalid batch");
+
+    items = batch->items + batch->items_committed;
+    items_count = batch->items_count - batch->items_committed;
+    if (items_count == 0) {
+        return FCC_STATUS_SUCCESS;
+    }
+
+    FCC_SET_START_TIMER(fcc_batch_timer);
+    kcm_result = kcm_items_store_batch(items, items_count, true, &failed_index);
+    FCC_END_TIMER("Total batch store", 0, fcc_batch_timer);
+    if (kcm_result != KCM_STATUS_SUCCESS) {
+        SA_PV_LOG_ERR("Failed to store item at index (%" PRIu32 ") of the batch", (uint32_t)failed_index);
+        fcc_status = FCC_STATUS_KCM_ERROR;
+        //The batch may fail before any item is handled
+        if (failed_index < items_count) {
+            output_info_fcc_status = fcc_bundle_store_error_info(items[failed_index].name, items[failed_index].name_len, kcm_result);
+            SA_PV_ERR_RECOVERABLE_RETURN_IF((output_info_fcc_status != FCC_STATUS_SUCCESS),
+                                            fcc_status = FCC_STATUS_OUTPUT_INFO_ERROR,
+                                            "Failed to create output kcm_status error %d", kcm_result);
+        }
+        return fcc_status;
+    }
+
+    batch->items_committed = batch->items_count;
+
+    SA_PV_LOG_TRACE_FUNC_EXIT_NO_ARGS();
+    return fcc_status;
+}
+
+void fcc_bundle_batch_free(fcc_bundle_store_batch_s *batch)
+{
+    size_t index;
+
+    SA_PV_LOG_TRACE_FUNC_ENTER_NO_ARGS();
+
+    for (index = 0; index < batch->items_count; index++) {
+        fcc_free((void*)batch->items[index].name);
+    }
+    fcc_free(batch->items);
+    memset(batch, 0, sizeof(fcc_bundle_store_batch_s));
+
+    SA_PV_LOG_TRACE_FUNC_EXIT_NO_ARGS();
+}
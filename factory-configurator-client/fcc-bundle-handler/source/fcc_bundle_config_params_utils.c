@@ -42,13 +42,11 @@ static fcc_status_e set_time_from_config_param(const fcc_bundle_data_param_s *cu
     return FCC_STATUS_SUCCESS;
 }
 
-fcc_status_e fcc_bundle_process_config_params(const cn_cbor *config_params_list_cb)
+fcc_status_e fcc_bundle_process_config_params(const cn_cbor *config_params_list_cb, fcc_bundle_store_batch_s *batch)
 {
 
     bool success = false;
     fcc_status_e fcc_status = FCC_STATUS_SUCCESS;
-    fcc_status_e output_info_fcc_status = FCC_STATUS_SUCCESS;
-    kcm_status_e kcm_result = KCM_STATUS_SUCCESS;
     uint32_t config_param_index = 0;
     cn_cbor *config_param_cb;
     fcc_bundle_data_param_s config_param;
@@ -60,15 +58,11 @@ fcc_status_e fcc_bundle_process_config_params(const cn_cbor *config_params_list_
     //Initialize data struct
     memset(&config_param, 0, sizeof(config_param));
 
-    for (config_param_index = 0; config_param_index < (uint32_t)config_params_list_cb->length; config_param_index++) {
-
-        FCC_SET_START_TIMER(fcc_config_param_timer);
+    //Go over the config params in order, without looking each one up by its index
+    for (config_param_cb = config_params_list_cb->first_child; config_param_cb != NULL; config_param_cb = config_param_cb->next, config_param_index++) {
 
         fcc_bundle_clean_and_free_data_param(&config_param);
 
-        //Get key CBOR struct at index key_index
-        config_param_cb = cn_cbor_index(config_params_list_cb, config_param_index);
-        SA_PV_ERR_RECOVERABLE_RETURN_IF((config_param_cb == NULL), fcc_status = FCC_STATUS_BUNDLE_ERROR, "Failed to get certificate at index (%" PRIu32 ") ", config_param_index);
         SA_PV_ERR_RECOVERABLE_RETURN_IF((config_param_cb->type != CN_CBOR_MAP), fcc_status = FCC_STATUS_BUNDLE_ERROR, "Wrong type of config param CBOR struct at index (%" PRIu32 ")", config_param_index);
 
         success = fcc_bundle_get_data_param(config_param_cb, &config_param);
@@ -76,22 +70,17 @@ fcc_status_e fcc_bundle_process_config_params(const cn_cbor *config_params_list_
 
         // Sets the time
         if (is_memory_equal(config_param.name, config_param.name_len, g_fcc_current_time_parameter_name, currentTimeLength)) {
+            FCC_SET_START_TIMER(fcc_config_param_timer);
             fcc_status = set_time_from_config_param(&config_param);
+            FCC_END_TIMER((char*)config_param.name, config_param.name_len, fcc_config_param_timer);
             SA_PV_ERR_RECOVERABLE_GOTO_IF((fcc_status != FCC_STATUS_SUCCESS), fcc_status = fcc_status, exit, "set_time_from_config_param failed");
         } else {
-            kcm_result = kcm_item_store(config_param.name, config_param.name_len, KCM_CONFIG_ITEM, true, config_param.data, config_param.data_size, config_param.acl);
-            SA_PV_ERR_RECOVERABLE_GOTO_IF((kcm_result != KCM_STATUS_SUCCESS), fcc_status = FCC_STATUS_KCM_ERROR, exit, "Failed to store configuration parameter at index (%" PRIu32 ") ", (uint32_t)config_param_index);
+            fcc_status = fcc_bundle_batch_add(batch, &config_param, KCM_CONFIG_ITEM);
+            SA_PV_ERR_RECOVERABLE_GOTO_IF((fcc_status != FCC_STATUS_SUCCESS), fcc_status = fcc_status, exit, "Failed to add configuration parameter at index (%" PRIu32 ") ", (uint32_t)config_param_index);
         }
-        FCC_END_TIMER((char*)config_param.name, config_param.name_len, fcc_config_param_timer);
     }
 
 exit:
-    if (kcm_result != KCM_STATUS_SUCCESS) {
-        output_info_fcc_status =  fcc_bundle_store_error_info(config_param.name, config_param.name_len, kcm_result);
-        SA_PV_ERR_RECOVERABLE_RETURN_IF((output_info_fcc_status != FCC_STATUS_SUCCESS),
-                                        fcc_status = FCC_STATUS_OUTPUT_INFO_ERROR,
-                                        "Failed to create output kcm_status error %d", kcm_result);
-    }
     fcc_bundle_clean_and_free_data_param(&config_param);
     SA_PV_LOG_TRACE_FUNC_EXIT_NO_ARGS();
 
@@ -204,18 +204,14 @@ exit:
 
 /** Checks bundle scheme version
 *
-* @param cbor_blob[in]   The pointer to main cbor blob.
+* @param scheme_version_cb[in]   The value of the scheme version group in the main cbor blob.
 * @return
 *     true for success, false otherwise.
 */
-static bool check_scheme_version(cn_cbor *cbor_blob)
+static bool check_scheme_version(const cn_cbor *scheme_version_cb)
 {
-    cn_cbor *scheme_version_cb = NULL;
     int result;
 
-    SA_PV_ERR_RECOVERABLE_RETURN_IF((cbor_blob == NULL), false, "Invalid cbor_blob");
-
-    scheme_version_cb = cn_cbor_mapget_string(cbor_blob, FCC_BUNDLE_SCHEME_GROUP_NAME);
     SA_PV_ERR_RECOVERABLE_RETURN_IF((scheme_version_cb == NULL), false, "Failed to find scheme version group");
 
     result = is_memory_equal(scheme_version_cb->v.bytes, scheme_version_cb->length, fcc_bundle_scheme_version, strlen(fcc_bundle_scheme_version));
@@ -224,6 +220,36 @@ static bool check_scheme_version(cn_cbor *cbor_blob)
     return true;
 }
 
+/** Indexes the groups of the main cbor map
+*
+* The function goes over the main map once and puts the value of each known group
+* in the entry of its lookup table record. If a group name appears more than once, the first one is used.
+*
+* @param main_list_cb[in]   The pointer to main cbor blob.
+* @param groups_cb[out]     The group values, by lookup table index. NULL for groups that are not in the blob.
+*/
+static void fcc_bundle_index_groups(const cn_cbor *main_list_cb, cn_cbor *groups_cb[FCC_MAX_CONFIG_PARAM_GROUP_TYPE])
+{
+    cn_cbor *key_cb;
+    size_t group_index;
+
+    memset(groups_cb, 0, sizeof(cn_cbor *) * FCC_MAX_CONFIG_PARAM_GROUP_TYPE);
+
+    for (key_cb = main_list_cb->first_child; key_cb != NULL && key_cb->next != NULL; key_cb = key_cb->next->next) {
+        if (key_cb->type != CN_CBOR_TEXT && key_cb->type != CN_CBOR_BYTES) {
+            continue;
+        }
+        for (group_index = 0; group_index < FCC_MAX_CONFIG_PARAM_GROUP_TYPE; group_index++) {
+            if (is_memory_equal(key_cb->v.bytes, key_cb->length, fcc_groups_lookup_table[group_index].group_name, strlen(fcc_groups_lookup_table[group_index].group_name))) {
+                if (groups_cb[group_index] == NULL) {
+                    groups_cb[group_index] = key_cb->next;
+                }
+                break;
+            }
+        }
+    }
+}
+
 /** Writes buffer to SOTP
 *
 * @param cbor_bytes[in]   The pointer to a cn_cbor object of type CN_CBOR_BYTES.
@@ -332,6 +358,8 @@ fcc_status_e fcc_bundle_handler(const uint8_t *encoded_blob, size_t encoded_blob
     fcc_status_e fcc_status = FCC_STATUS_SUCCESS;
     cn_cbor *main_list_cb = NULL;
     cn_cbor *group_value_cb = NULL;
+    cn_cbor *groups_cb[FCC_MAX_CONFIG_PARAM_GROUP_TYPE];
+    fcc_bundle_store_batch_s batch;
     cn_cbor_errback err;
     size_t group_index;
     fcc_bundle_param_group_type_e group_type;
@@ -366,6 +394,9 @@ fcc_status_e fcc_bundle_handler(const uint8_t *encoded_blob, size_t encoded_blob
     function will exit without fcc_verify_device_configured_4mbed_cloud where we perform additional fcc_clean_output_info_handler*/
     fcc_clean_output_info_handler();
 
+    // Keys, certificates and configuration parameters are collected and stored together
+    memset(&batch, 0, sizeof(batch));
+
     /* Decode CBOR message
     Check the size of the CBOR structure */
     main_list_cb = cn_cbor_decode(encoded_blob, encoded_blob_size CONTEXT_NULL, &err);
@@ -373,15 +404,17 @@ fcc_status_e fcc_bundle_handler(const uint8_t *encoded_blob, size_t encoded_blob
     SA_PV_ERR_RECOVERABLE_GOTO_IF((main_list_cb->type != CN_CBOR_MAP), fcc_status = FCC_STATUS_BUNDLE_ERROR, free_cbor_list_and_out, "Wrong CBOR structure type");
     SA_PV_ERR_RECOVERABLE_GOTO_IF((main_list_cb->length <= 0 || main_list_cb->length > FCC_MAX_CONFIG_PARAM_GROUP_TYPE *FCC_CBOR_MAP_LENGTH), fcc_status = FCC_STATUS_BUNDLE_ERROR, free_cbor_list_and_out, "Wrong CBOR structure size");
 
+    fcc_bundle_index_groups(main_list_cb, groups_cb);
+
     /* Check scheme version*/
-    status = check_scheme_version(main_list_cb);
+    status = check_scheme_version(groups_cb[0]); // The scheme version is the first record of the lookup table
     SA_PV_ERR_RECOVERABLE_GOTO_IF((status != true), fcc_status = FCC_STATUS_BUNDLE_INVALID_SCHEME, free_cbor_list_and_out, "check_scheme_version failed");
 
     //Go over parameter groups
     for (group_index = 0; group_index < FCC_MAX_CONFIG_PARAM_GROUP_TYPE; group_index++) {
         //Get content of current group (value of map, when key of map is name of group and value is list of params of current group)
         SA_PV_LOG_INFO(" fcc_groups_lookup_table[group_index].group_name is %s", fcc_groups_lookup_table[group_index].group_name);
-        group_value_cb = cn_cbor_mapget_string(main_list_cb, fcc_groups_lookup_table[group_index].group_name);
+        group_value_cb = groups_cb[group_index];
 
         if (group_value_cb != NULL) {
             //Get type of group
@@ -393,23 +426,25 @@ fcc_status_e fcc_bundle_handler(const uint8_t *encoded_blob, size_t encoded_blob
                     break;
                 case FCC_KEY_GROUP_TYPE:
                     FCC_SET_START_TIMER(fcc_gen_timer);
-                    fcc_status = fcc_bundle_process_keys(group_value_cb);
+                    fcc_status = fcc_bundle_process_keys(group_value_cb, &batch);
                     FCC_END_TIMER("Total keys process", 0 ,fcc_gen_timer);
                     SA_PV_ERR_RECOVERABLE_GOTO_IF((fcc_status != FCC_STATUS_SUCCESS), fcc_status = fcc_status, free_cbor_list_and_out, "fcc_bundle_process_keys failed");
                     break;
                 case FCC_CERTIFICATE_GROUP_TYPE:
                     FCC_SET_START_TIMER(fcc_gen_timer);
-                    fcc_status = fcc_bundle_process_certificates(group_value_cb);
+                    fcc_status = fcc_bundle_process_certificates(group_value_cb, &batch);
                     FCC_END_TIMER("Total certificates process", 0, fcc_gen_timer);
                     SA_PV_ERR_RECOVERABLE_GOTO_IF((fcc_status != FCC_STATUS_SUCCESS), fcc_status = fcc_status, free_cbor_list_and_out, "fcc_bundle_process_certificates failed");
                     break;
                 case FCC_CONFIG_PARAM_GROUP_TYPE:
                     FCC_SET_START_TIMER(fcc_gen_timer);
-                    fcc_status = fcc_bundle_process_config_params(group_value_cb);
+                    fcc_status = fcc_bundle_process_config_params(group_value_cb, &batch);
                     FCC_END_TIMER("Total config params process", 0, fcc_gen_timer);
                     SA_PV_ERR_RECOVERABLE_GOTO_IF((fcc_status != FCC_STATUS_SUCCESS), fcc_status = fcc_status, free_cbor_list_and_out, "fcc_bundle_process_config_params failed");
                     break;
                 case FCC_CERTIFICATE_CHAIN_GROUP_TYPE:
+                    fcc_status = fcc_bundle_batch_commit(&batch);
+                    SA_PV_ERR_RECOVERABLE_GOTO_IF((fcc_status != FCC_STATUS_SUCCESS), fcc_status = fcc_status, free_cbor_list_and_out, "fcc_bundle_batch_commit failed");
                     FCC_SET_START_TIMER(fcc_gen_timer);
                     fcc_status = fcc_bundle_process_certificate_chains(group_value_cb);
                     FCC_END_TIMER("Total certificate chains process", 0, fcc_gen_timer);
@@ -425,11 +460,15 @@ fcc_status_e fcc_bundle_handler(const uint8_t *encoded_blob, size_t encoded_blob
                     break;
                 case FCC_VERIFY_DEVICE_IS_READY_TYPE:
                     is_device_verify_group_exist = true;
+                    fcc_status = fcc_bundle_batch_commit(&batch);
+                    SA_PV_ERR_RECOVERABLE_GOTO_IF((fcc_status != FCC_STATUS_SUCCESS), fcc_status = fcc_status, free_cbor_list_and_out, "fcc_bundle_batch_commit failed");
                     fcc_status = process_fcc_verify(group_value_cb);
                     SA_PV_ERR_RECOVERABLE_GOTO_IF((fcc_status != FCC_STATUS_SUCCESS), fcc_status = fcc_status, free_cbor_list_and_out, "process_device_verify failed");
                     break;
                 case FCC_FACTORY_DISABLE_TYPE:
                     device_is_already_disabled = true;
+                    fcc_status = fcc_bundle_batch_commit(&batch);
+                    SA_PV_ERR_RECOVERABLE_GOTO_IF((fcc_status != FCC_STATUS_SUCCESS), fcc_status = fcc_status, free_cbor_list_and_out, "fcc_bundle_batch_commit failed");
                     fcc_status = process_fcc_disable(group_value_cb);
                     SA_PV_ERR_RECOVERABLE_GOTO_IF((fcc_status != FCC_STATUS_SUCCESS), fcc_status = fcc_status, free_cbor_list_and_out, "fcc_factory_disable failed");
                     break;
@@ -444,6 +483,10 @@ fcc_status_e fcc_bundle_handler(const uint8_t *encoded_blob, size_t encoded_blob
     SA_PV_ERR_RECOVERABLE_GOTO_IF((num_of_groups_in_message == 0), fcc_status = FCC_STATUS_INVALID_PARAMETER, free_cbor_list_and_out, "No groups in message");
     SA_PV_ERR_RECOVERABLE_GOTO_IF(((size_t)(main_list_cb->length/FCC_CBOR_MAP_LENGTH)!= num_of_groups_in_message), fcc_status = FCC_STATUS_BUNDLE_INVALID_GROUP, free_cbor_list_and_out, "One ore more names of groups are invalid");
 
+    // Store whatever was collected after the last group that required the items to be in storage
+    fcc_status = fcc_bundle_batch_commit(&batch);
+    SA_PV_ERR_RECOVERABLE_GOTO_IF((fcc_status != FCC_STATUS_SUCCESS), fcc_status = fcc_status, free_cbor_list_and_out, "fcc_bundle_batch_commit failed");
+
     if (!is_device_verify_group_exist && !device_is_already_disabled) {
         // device VERIFY group does NOT exist in the CBOR message and device is NOT disabled.
         // Perform device verification to keep backward compatibility.
@@ -454,6 +497,7 @@ fcc_status_e fcc_bundle_handler(const uint8_t *encoded_blob, size_t encoded_blob
     }
 
 free_cbor_list_and_out:
+    fcc_bundle_batch_free(&batch);
     cn_cbor_free(main_list_cb CONTEXT_NULL);
 
 exit:
@@ -87,20 +87,19 @@ bool fcc_bundle_get_key_type(const cn_cbor *key_type_cb, fcc_bundle_key_type_e *
 }
 
 /** Processes  keys list.
-* The function extracts data parameters for each key and stores its according to it type.
+* The function extracts data parameters for each key and adds it to the store batch according to it type.
 *
 * @param keys_list_cb[in]   The cbor structure with keys list.
+* @param batch[in/out]      The store batch.
 *
 * @return
 *     true for success, false otherwise.
 */
-fcc_status_e fcc_bundle_process_keys(const cn_cbor *keys_list_cb)
+fcc_status_e fcc_bundle_process_keys(const cn_cbor *keys_list_cb, fcc_bundle_store_batch_s *batch)
 {
 
     bool status = false;
     fcc_status_e fcc_status = FCC_STATUS_SUCCESS;
-    fcc_status_e output_info_fcc_status = FCC_STATUS_SUCCESS;
-    kcm_status_e kcm_result = KCM_STATUS_SUCCESS;
     uint32_t key_index = 0;
     cn_cbor *key_cb;
     fcc_bundle_data_param_s key;
@@ -111,15 +110,11 @@ fcc_status_e fcc_bundle_process_keys(const cn_cbor *keys_list_cb)
     //Initialize data struct
     memset(&key,0,sizeof(fcc_bundle_data_param_s));
 
-    for (key_index = 0; key_index < (uint32_t)keys_list_cb->length; key_index++) {
-
-        FCC_SET_START_TIMER(fcc_key_timer);
+    //Go over the keys in order, without looking each one up by its index
+    for (key_cb = keys_list_cb->first_child; key_cb != NULL; key_cb = key_cb->next, key_index++) {
 
         fcc_bundle_clean_and_free_data_param(&key);
 
-        //Get key CBOR struct at index key_index
-        key_cb = cn_cbor_index(keys_list_cb, key_index);
-        SA_PV_ERR_RECOVERABLE_RETURN_IF((key_cb == NULL), fcc_status = FCC_STATUS_BUNDLE_ERROR, "Failed to get key at index (%" PRIu32 ") ", key_index);
         SA_PV_ERR_RECOVERABLE_RETURN_IF((key_cb->type != CN_CBOR_MAP), fcc_status = FCC_STATUS_BUNDLE_ERROR, "Wrong type of key CBOR struct at index (%" PRIu32 ")", key_index);
 
         status = fcc_bundle_get_data_param(key_cb, &key);
@@ -128,34 +123,27 @@ fcc_status_e fcc_bundle_process_keys(const cn_cbor *keys_list_cb)
         switch (key.type) {
             case FCC_ECC_PRIVATE_KEY_TYPE:
             case FCC_RSA_PRIVATE_KEY_TYPE:
-                kcm_result = kcm_item_store(key.name, key.name_len, KCM_PRIVATE_KEY_ITEM, true, key.data, key.data_size, key.acl);
-                SA_PV_ERR_RECOVERABLE_GOTO_IF((kcm_result != KCM_STATUS_SUCCESS), fcc_status = FCC_STATUS_KCM_ERROR, exit, "Failed to store key private at index (%" PRIu32 ") ", key_index);
+                fcc_status = fcc_bundle_batch_add(batch, &key, KCM_PRIVATE_KEY_ITEM);
+                SA_PV_ERR_RECOVERABLE_GOTO_IF((fcc_status != FCC_STATUS_SUCCESS), fcc_status = fcc_status, exit, "Failed to add private key at index (%" PRIu32 ") ", key_index);
                 break;
 
             case FCC_ECC_PUBLIC_KEY_TYPE:
             case FCC_RSA_PUBLIC_KEY_TYPE:
-                kcm_result = kcm_item_store(key.name, key.name_len, KCM_PUBLIC_KEY_ITEM, true, key.data, key.data_size, key.acl);
-                SA_PV_ERR_RECOVERABLE_GOTO_IF((kcm_result != KCM_STATUS_SUCCESS), fcc_status = FCC_STATUS_KCM_ERROR, exit, "Failed to store key public at index (%" PRIu32 ") ", key_index);
+                fcc_status = fcc_bundle_batch_add(batch, &key, KCM_PUBLIC_KEY_ITEM);
+                SA_PV_ERR_RECOVERABLE_GOTO_IF((fcc_status != FCC_STATUS_SUCCESS), fcc_status = fcc_status, exit, "Failed to add public key at index (%" PRIu32 ") ", key_index);
                 break;
 
             case (FCC_SYM_KEY_TYPE):
-                kcm_result = kcm_item_store(key.name, key.name_len, KCM_SYMMETRIC_KEY_ITEM, true, key.data, key.data_size, key.acl);
-                SA_PV_ERR_RECOVERABLE_GOTO_IF((kcm_result != KCM_STATUS_SUCCESS), fcc_status = FCC_STATUS_KCM_ERROR, exit, "Failed to store symmetric key at index (%" PRIu32 ") ", key_index);
+                fcc_status = fcc_bundle_batch_add(batch, &key, KCM_SYMMETRIC_KEY_ITEM);
+                SA_PV_ERR_RECOVERABLE_GOTO_IF((fcc_status != FCC_STATUS_SUCCESS), fcc_status = fcc_status, exit, "Failed to add symmetric key at index (%" PRIu32 ") ", key_index);
                 break;
             default:
                 SA_PV_LOG_ERR("Invalid key type (%u)!", key.type);
                 goto exit;
         }
-        FCC_END_TIMER((char*)key.name, key.name_len, fcc_key_timer);
     }
 
 exit:
-    if (kcm_result != KCM_STATUS_SUCCESS) {
-        output_info_fcc_status = fcc_bundle_store_error_info(key.name, key.name_len, kcm_result);
-        SA_PV_ERR_RECOVERABLE_RETURN_IF((output_info_fcc_status != FCC_STATUS_SUCCESS),
-                                        fcc_status = FCC_STATUS_OUTPUT_INFO_ERROR,
-                                        "Failed to create output kcm_status error %d", kcm_result);
-    }
     fcc_bundle_clean_and_free_data_param(&key);
     SA_PV_LOG_TRACE_FUNC_EXIT_NO_ARGS();
     return fcc_status;
@@ -142,6 +142,16 @@ typedef struct fcc_bundle_data_param_ {
     cn_cbor                          *array_cn;
 } fcc_bundle_data_param_s;
 
+/**
+* KCM items collected from the bundle groups, stored together by fcc_bundle_batch_commit()
+*/
+typedef struct fcc_bundle_store_batch_ {
+    kcm_item_batch_entry_s           *items;
+    size_t                           items_count;
+    size_t                           items_capacity;
+    size_t                           items_committed;
+} fcc_bundle_store_batch_s;
+
 
 /** Frees all allocated memory of data parameter struct and sets initial values.
 *
@@ -161,24 +171,26 @@ void fcc_bundle_clean_and_free_data_param(fcc_bundle_data_param_s *data_param);
 bool get_data_buffer_from_cbor(const cn_cbor *data_cb, uint8_t **out_data_buffer, size_t *out_size);
 
 /** Processes  keys list.
-* The function extracts data parameters for each key and stores its according to it type.
+* The function extracts data parameters for each key and adds it to the store batch according to it type.
 *
 * @param keys_list_cb[in]   The cbor structure with keys list.
+* @param batch[in/out]      The store batch.
 *
 * @return
 *     fcc_status_e status.
 */
-fcc_status_e fcc_bundle_process_keys(const cn_cbor *keys_list_cb);
+fcc_status_e fcc_bundle_process_keys(const cn_cbor *keys_list_cb, fcc_bundle_store_batch_s *batch);
 
 /** Processes  certificate list.
-* The function extracts data parameters for each certificate and stores it.
+* The function extracts data parameters for each certificate and adds it to the store batch.
 *
 * @param certs_list_cb[in]   The cbor structure with certificate list.
+* @param batch[in/out]       The store batch.
 *
 * @return
 *      fcc_status_e status.
 */
-fcc_status_e fcc_bundle_process_certificates(const cn_cbor *certs_list_cb);
+fcc_status_e fcc_bundle_process_certificates(const cn_cbor *certs_list_cb, fcc_bundle_store_batch_s *batch);
 /** Processes  certificate chain list.
 * The function extracts data parameters for each certificate chain and stores it.
 *
@@ -190,19 +202,49 @@ fcc_status_e fcc_bundle_process_certificates(const cn_cbor *certs_list_cb);
 fcc_status_e fcc_bundle_process_certificate_chains(const cn_cbor *cert_chains_list_cb);
 
 /** Processes  configuration parameters list.
-* The function extracts data parameters for each config param and stores it.
+* The function extracts data parameters for each config param and adds it to the store batch.
+* The current time parameter is not stored, it sets the device time.
 *
 * @param config_params_list_cb[in]   The cbor structure with config param list.
+* @param batch[in/out]               The store batch.
+*
+* @return
+*      fcc_status_e status.
+*/
+fcc_status_e fcc_bundle_process_config_params(const cn_cbor *config_params_list_cb, fcc_bundle_store_batch_s *batch);
+
+/** Adds a data parameter to the store batch.
+* The batch takes over the name of the data parameter, the data and the ACL must stay valid until the batch is committed.
+*
+* @param batch[in/out]         The store batch.
+* @param data_param[in/out]    The data parameter structure.
+* @param item_type[in]         The KCM item type.
 *
 * @return
 *      fcc_status_e status.
 */
-fcc_status_e fcc_bundle_process_config_params(const cn_cbor *config_params_list_cb);
+fcc_status_e fcc_bundle_batch_add(fcc_bundle_store_batch_s *batch, fcc_bundle_data_param_s *data_param, kcm_item_type_e item_type);
+
+/** Stores the items added to the batch since the last commit with a single kcm_items_store_batch() call.
+* KCM keeps the certificates parsed during the store for the device verification.
+*
+* @param batch[in/out]   The store batch.
+*
+* @return
+*      fcc_status_e status.
+*/
+fcc_status_e fcc_bundle_batch_commit(fcc_bundle_store_batch_s *batch);
+
+/** Frees the store batch.
+*
+* @param batch[in/out]   The store batch.
+*/
+void fcc_bundle_batch_free(fcc_bundle_store_batch_s *batch);
 
 /** Gets data parameters.
 *
-* The function goes over all existing parameters (name,type,format,data,acl and etc) and
-* tries to find correlating parameter in cbor structure and saves it to data parameter structure.
+* The function goes once over the parameters of the cbor structure, finds each one in the data parameter
+* lookup table (name,type,format,data,acl and etc) and saves it to data parameter structure.
 *
 * @param data_param_cb[in]   The cbor structure with relevant data parameters.
 * @param data_param[out]     The data parameter structure
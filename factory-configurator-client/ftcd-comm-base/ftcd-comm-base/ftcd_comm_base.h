@@ -18,6 +18,8 @@
 #define __FTCD_COMM_BASE_H__
 
 #include <stdint.h>
+#include <stddef.h>
+#include "fcc_status.h"
 
 /**
 * @file ftcd_comm_base.h
@@ -140,6 +142,21 @@ public:
     */
     virtual bool read_message_signature(uint8_t *sig, size_t sig_size) = 0;
 
+protected:
+
+    /** Processes an inbound FT message and gets back the response.
+    * The default implementation passes the message to the FCC bundle handler.
+    *
+    * @param message The FT message.
+    * @param message_size The FT message size in bytes.
+    * @param response_out The response message, allocated with fcc_malloc().
+    * @param response_size_out The response message size in bytes.
+    *
+    * @returns
+    *     The status of the FCC bundle handler.
+    */
+    virtual fcc_status_e process_bundle(const uint8_t *message, size_t message_size, uint8_t **response_out, size_t *response_size_out);
+
 private:
 
     /** Creates and sends a Factory Message response (in this format - [TOKEN | STATUS | LENGTH | FT-MESSAGE | SIGNATURE]).
@@ -117,7 +117,7 @@ bool FtcdCommBase::process_message()
             }
 
             // process request and get back response
-            fcc_status = fcc_bundle_handler(message, message_size, &response_protocol_message, &response_protocol_message_size);
+            fcc_status = process_bundle(message, message_size, &response_protocol_message, &response_protocol_message_size);
             if ((fcc_status == FCC_STATUS_BUNDLE_RESPONSE_ERROR) || (response_protocol_message == NULL) || (response_protocol_message_size == 0)) {
                 status_code = FTCD_COMM_FAILED_TO_PROCESS_DATA;
                 mbed_tracef(TRACE_LEVEL_CMD, TRACE_GROUP,"Failed to process data\r");
@@ -155,6 +155,11 @@ bool FtcdCommBase::process_message()
     return true;
 }
 
+fcc_status_e FtcdCommBase::process_bundle(const uint8_t *message, size_t message_size, uint8_t **response_out, size_t *response_size_out)
+{
+    return fcc_bundle_handler(message, message_size, response_out, response_size_out);
+}
+
 bool FtcdCommBase::_create_and_send_response(const uint8_t *protocol_reponse, uint32_t protocol_response_size, ftcd_comm_status_e status_code)
 {
     bool success = true;
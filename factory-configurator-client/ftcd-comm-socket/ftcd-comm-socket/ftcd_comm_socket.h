@@ -23,6 +23,33 @@
 
 #define INFINITE_SOCKET_TIMEOUT -1
 
+/**
+* Maximal number of factory tool connections served at the same time by FtcdCommSocket::serve_sessions().
+* By default one connection is served, and the factory tool pipelines its messages on it.
+* All the sessions provision the one device running the FCC, into the same storage and one message at a time,
+* so more sessions do not provision more devices in parallel; that needs one device (or one process) per station.
+* Set it above 1 only for hosts where several tools talk to the same device at once, for example one that
+* provisions while another one verifies. Every session has its own thread, so when PAL_UNIQUE_THREAD_PRIORITY
+* is set at most 3 sessions are supported.
+*/
+#ifndef FTCD_SOCKET_MAX_SESSIONS
+#define FTCD_SOCKET_MAX_SESSIONS 1
+#endif
+
+/**
+* Stack size of a session thread.
+*/
+#ifndef FTCD_SOCKET_SESSION_THREAD_STACK_SIZE
+#define FTCD_SOCKET_SESSION_THREAD_STACK_SIZE (1024 * 16)
+#endif
+
+/**
+* Size of the receive buffer of a session.
+*/
+#ifndef FTCD_SOCKET_SESSION_RX_BUFFER_SIZE
+#define FTCD_SOCKET_SESSION_RX_BUFFER_SIZE 1460
+#endif
+
 /**
 * List of supported networks domains. Current supported domain is ipv4 only.
 */
@@ -43,6 +70,10 @@ struct palNetInterfaceInfo;
 * Class for Ethernet interface.
 */
 class EthernetInterface;
+/**
+* Class for a factory tool connection served by FtcdCommSocket::serve_sessions().
+*/
+class FtcdCommSocketSession;
 
 /** FtcdCommSocket implements the logic of listening for TCP connections and
 *  process incoming messages from the Factory Tool.
@@ -122,6 +153,18 @@ public:
     */
     virtual bool send(const uint8_t *data, uint32_t data_size);
 
+    /** Serves factory tool connections.
+    * Every accepted connection is a session, handled by its own thread. A session processes the
+    * messages of its connection one after the other until the connection is closed, so the factory
+    * tool may send its next messages without reconnecting or waiting for the previous response.
+    * Up to FTCD_SOCKET_MAX_SESSIONS sessions are served at the same time. The messages of all the
+    * sessions are passed to the FCC one at a time, since they all provision this device.
+    *
+    * @returns
+    *     true, if no connection arrived within the socket timeout and all sessions ended, false upon error.
+    */
+    bool serve_sessions(void);
+
 private:
 
     const void *_interface_handler;
@@ -133,6 +176,7 @@ private:
     ftcd_socket_domain_e _required_domain_type;
     uint32_t _interface_index;
     int32_t _rcv_timeout;
+    FtcdCommSocketSession *_sessions[FTCD_SOCKET_MAX_SESSIONS];
 
     /** Starts listening for incoming TCP socket connection
     *   A single connection allowed at a time
@@ -152,6 +196,13 @@ private:
     */
     ftcd_comm_status_e _read_from_socket( void *data_out, int data_out_size);
 
+    /** Deletes the sessions which have ended
+    *
+    * @returns
+    *    the index of a free session entry, or FTCD_SOCKET_MAX_SESSIONS if all are in use.
+    */
+    uint32_t _reap_sessions(void);
+
 };
 
 
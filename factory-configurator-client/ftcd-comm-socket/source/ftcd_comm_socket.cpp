@@ -26,12 +26,307 @@
 #include "ftcd_comm_socket.h"
 #include "fcc_malloc.h"
 
-#define NUM_OF_PENDING_CONNECTIONS 1
+#define NUM_OF_PENDING_CONNECTIONS FTCD_SOCKET_MAX_SESSIONS
 #define NUM_OF_TRIES_TO_GET_INTERFACE_INFO 5
 #define TRACE_GROUP "fcsk"
 #define RANDOM_PORT_MIN 1024
 #define RANDOM_PORT_MAX 65535
 
+#if PAL_UNIQUE_THREAD_PRIORITY && (FTCD_SOCKET_MAX_SESSIONS > 3)
+#error "FTCD_SOCKET_MAX_SESSIONS must not be bigger than 3 when PAL_UNIQUE_THREAD_PRIORITY is set"
+#endif
+
+/** Writes the given data to a connected socket
+*
+* @returns
+*     true upon success, false otherwise
+*/
+static bool send_to_socket(palSocket_t socket, const uint8_t *data, uint32_t data_size)
+{
+    bool success = true;
+    palStatus_t result = PAL_SUCCESS;
+    size_t sent_bytes = 0;
+    size_t remaind_bytes = (size_t)data_size;
+
+    do {
+        result = pal_send(socket, data, remaind_bytes, &sent_bytes);
+        if (result != PAL_SUCCESS) {
+            mbed_tracef(TRACE_LEVEL_CMD, TRACE_GROUP, "Failed pal_send\r");
+            success = false;
+            break;
+        }
+
+        if (sent_bytes == 0 || sent_bytes > remaind_bytes) {
+            mbed_tracef(TRACE_LEVEL_CMD, TRACE_GROUP, "Sending response message failed");
+            success = false;
+            break;
+        }
+        remaind_bytes = remaind_bytes - sent_bytes;
+        data += sent_bytes;
+
+    } while (remaind_bytes != 0);
+
+    return success;
+}
+
+/** FtcdCommSocketSession processes the messages of a single factory tool connection, in its own thread.
+*/
+class FtcdCommSocketSession : public FtcdCommBase
+{
+public:
+
+    /**
+    * The Session Constructor
+    * Takes ownership of the connected socket.
+    *
+    * @param socket The accepted connection.
+    * @param process_mutex Serializes the processing of messages of all the sessions.
+    * @param free_sessions Released when the session ends.
+    */
+    FtcdCommSocketSession(palSocket_t socket, palMutexID_t process_mutex, palSemaphoreID_t free_sessions);
+
+    /**
+    * The Session Destructor
+    * Closes the connection.
+    */
+    virtual ~FtcdCommSocketSession();
+
+    /** Starts the thread of the session
+    *
+    * @returns
+    *     true upon success, false otherwise
+    */
+    bool start(palThreadPriority_t priority);
+
+    /** Terminates the thread of an ended session
+    */
+    void stop(void);
+
+    /**
+    * @returns
+    *     true, if the connection has ended and the session may be deleted.
+    *     The session releases its count of the free sessions semaphore before, so a freed count
+    *     may be seen shortly before its session is finished.
+    */
+    bool is_finished(void) const;
+
+    virtual ftcd_comm_status_e is_token_detected(void);
+    virtual uint32_t read_message_size(void);
+    virtual bool read_message(uint8_t *message_out, size_t message_size);
+    virtual bool read_message_signature(uint8_t *sig, size_t sig_size);
+    virtual bool send(const uint8_t *data, uint32_t data_size);
+
+protected:
+
+    virtual fcc_status_e process_bundle(const uint8_t *message, size_t message_size, uint8_t **response_out, size_t *response_size_out);
+
+private:
+
+    palSocket_t _socket;
+    palMutexID_t _process_mutex;
+    palSemaphoreID_t _free_sessions;
+    palThreadID_t _thread;
+    volatile bool _finished;
+    size_t _rx_offset;
+    size_t _rx_length;
+    uint8_t _rx_buffer[FTCD_SOCKET_SESSION_RX_BUFFER_SIZE];
+
+    static void _thread_function(void const *argument);
+
+    /** Reads a requested amount of bytes from the connection.
+    * Small reads are served from the receive buffer, so that a message which arrived in one
+    * segment with the next ones is read with a single receive.
+    *
+    * @returns
+    *    FTCD_COMM_STATUS_SUCCESS, if all the bytes were read, error status otherwise.
+    */
+    ftcd_comm_status_e _read(void *data_out, size_t data_out_size);
+};
+
+FtcdCommSocketSession::FtcdCommSocketSession(palSocket_t socket, palMutexID_t process_mutex, palSemaphoreID_t free_sessions)
+{
+    _socket = socket;
+    _process_mutex = process_mutex;
+    _free_sessions = free_sessions;
+    _thread = NULLPTR;
+    _finished = false;
+    _rx_offset = 0;
+    _rx_length = 0;
+}
+
+FtcdCommSocketSession::~FtcdCommSocketSession()
+{
+    if (_socket != NULL) {
+        pal_close(&_socket);
+    }
+}
+
+bool FtcdCommSocketSession::start(palThreadPriority_t priority)
+{
+    palStatus_t result = pal_osThreadCreateWithAlloc(_thread_function, this, priority, FTCD_SOCKET_SESSION_THREAD_STACK_SIZE, NULL, &_thread);
+    if (result != PAL_SUCCESS) {
+        mbed_tracef(TRACE_LEVEL_CMD, TRACE_GROUP, "Failed to create session thread (status %" PRId32 ")", result);
+        _thread = NULLPTR;
+        return false;
+    }
+    return true;
+}
+
+void FtcdCommSocketSession::stop(void)
+{
+    if (_thread != NULLPTR) {
+        pal_osThreadTerminate(&_thread);
+        _thread = NULLPTR;
+    }
+}
+
+bool FtcdCommSocketSession::is_finished(void) const
+{
+    return _finished;
+}
+
+void FtcdCommSocketSession::_thread_function(void const *argument)
+{
+    FtcdCommSocketSession *session = (FtcdCommSocketSession *)argument;
+    palSemaphoreID_t free_sessions = session->_free_sessions;
+
+    // Keep processing messages as long as the factory tool sends them
+    while (session->process_message()) {
+    }
+    mbed_tracef(TRACE_LEVEL_CMD, TRACE_GROUP, "Factory tool session ended");
+
+    // Release the count before marking the session finished: once finished, the thread may be terminated
+    // and the session deleted at any time, and a count lost that way would never be given back
+    pal_osSemaphoreRelease(free_sessions);
+    session->_finished = true;
+}
+
+fcc_status_e FtcdCommSocketSession::process_bundle(const uint8_t *message, size_t message_size, uint8_t **response_out, size_t *response_size_out)
+{
+    fcc_status_e fcc_status;
+
+    if (pal_osMutexWait(_process_mutex, PAL_RTOS_WAIT_FOREVER) != PAL_SUCCESS) {
+        mbed_tracef(TRACE_LEVEL_CMD, TRACE_GROUP, "Failed to lock message processing");
+        return FCC_STATUS_ERROR;
+    }
+    fcc_status = FtcdCommBase::process_bundle(message, message_size, response_out, response_size_out);
+    pal_osMutexRelease(_process_mutex);
+
+    return fcc_status;
+}
+
+ftcd_comm_status_e FtcdCommSocketSession::_read(void *data_out, size_t data_out_size)
+{
+    uint8_t *out = (uint8_t *)data_out;
+    size_t bytes_received;
+    size_t copy_size;
+    palStatus_t status;
+
+    while (data_out_size > 0) {
+        if (_rx_offset < _rx_length) {
+            copy_size = _rx_length - _rx_offset;
+            if (copy_size > data_out_size) {
+                copy_size = data_out_size;
+            }
+            memcpy(out, _rx_buffer + _rx_offset, copy_size);
+            _rx_offset += copy_size;
+            out += copy_size;
+            data_out_size -= copy_size;
+            continue;
+        }
+
+        // Big reads go straight to the caller's buffer, small ones through the receive buffer
+        bytes_received = 0;
+        if (data_out_size >= sizeof(_rx_buffer)) {
+            status = pal_recv(_socket, out, data_out_size, &bytes_received);
+        } else {
+            _rx_offset = 0;
+            _rx_length = 0;
+            status = pal_recv(_socket, _rx_buffer, sizeof(_rx_buffer), &bytes_received);
+        }
+        if (status == PAL_ERR_SOCKET_WOULD_BLOCK) {
+            mbed_tracef(TRACE_LEVEL_CMD, TRACE_GROUP, "Receive socket timeout, (status = %" PRId32 ")", status);
+            return FTCD_COMM_NETWORK_TIMEOUT;
+        } else if (status != PAL_SUCCESS) {
+            mbed_tracef(TRACE_LEVEL_CMD, TRACE_GROUP, "Receive socket error, (status = %" PRId32 ")", status);
+            return FTCD_COMM_NETWORK_CONNECTION_ERROR;
+        }
+
+        if (data_out_size >= sizeof(_rx_buffer)) {
+            out += bytes_received;
+            data_out_size -= bytes_received;
+        } else {
+            _rx_length = bytes_received;
+        }
+    }
+    return FTCD_COMM_STATUS_SUCCESS;
+}
+
+ftcd_comm_status_e FtcdCommSocketSession::is_token_detected(void)
+{
+    char expected_token[] = FTCD_MSG_HEADER_TOKEN;
+    char c;
+    ftcd_comm_status_e result;
+    size_t idx = 0;
+
+    //read char by char to detect token
+    while (idx < FTCD_MSG_HEADER_TOKEN_SIZE_BYTES) {
+        result = _read(&c, 1);
+        if (result != FTCD_COMM_STATUS_SUCCESS) {
+            return result;
+        }
+
+        if (c == expected_token[idx]) {
+            idx++;
+        } else {
+            idx = 0;
+        }
+    }
+    return FTCD_COMM_STATUS_SUCCESS;
+}
+
+uint32_t FtcdCommSocketSession::read_message_size(void)
+{
+    uint32_t message_size = 0;
+
+    if (_read(&message_size, sizeof(message_size)) != FTCD_COMM_STATUS_SUCCESS) {
+        mbed_tracef(TRACE_LEVEL_CMD, TRACE_GROUP, "Failed reading message size\r");
+        return 0;
+    }
+    return message_size;
+}
+
+bool FtcdCommSocketSession::read_message(uint8_t *message_out, size_t message_size)
+{
+    if (message_out == NULL) {
+        mbed_tracef(TRACE_LEVEL_CMD, TRACE_GROUP, "Invalid message buffer\r");
+        return false;
+    }
+    if (_read(message_out, message_size) != FTCD_COMM_STATUS_SUCCESS) {
+        mbed_tracef(TRACE_LEVEL_CMD, TRACE_GROUP, "Failed reading message bytes\r");
+        return false;
+    }
+    return true;
+}
+
+bool FtcdCommSocketSession::read_message_signature(uint8_t *sig, size_t sig_size)
+{
+    if (sig == NULL) {
+        mbed_tracef(TRACE_LEVEL_CMD, TRACE_GROUP, "Invalid sig buffer\r");
+        return false;
+    }
+    if (_read(sig, sig_size) != FTCD_COMM_STATUS_SUCCESS) {
+        mbed_tracef(TRACE_LEVEL_CMD, TRACE_GROUP, "Failed reading message signature bytes\r");
+        return false;
+    }
+    return true;
+}
+
+bool FtcdCommSocketSession::send(const uint8_t *data, uint32_t data_size)
+{
+    return send_to_socket(_socket, data, data_size);
+}
+
 FtcdCommSocket::FtcdCommSocket(const void *interface_handler, ftcd_socket_domain_e domain, const uint16_t port_num, int32_t timeout)
 {
     _interface_handler = interface_handler;
@@ -54,6 +349,7 @@ FtcdCommSocket::FtcdCommSocket(const void *interface_handler, ftcd_socket_domain
     _net_interface_info = NULL;
     _server_socket = NULL;
     _client_socket = NULL;
+    memset(_sessions, 0, sizeof(_sessions));
 }
 
 FtcdCommSocket::~FtcdCommSocket()
@@ -255,29 +551,141 @@ bool FtcdCommSocket::read_message_signature(uint8_t *sig, size_t sig_size)
 
 
 bool FtcdCommSocket::send(const uint8_t *data, uint32_t data_size)
+{
+    return send_to_socket(_client_socket, data, data_size);
+}
+
+// Every session thread needs its own priority when PAL_UNIQUE_THREAD_PRIORITY is set
+static palThreadPriority_t session_priority(uint32_t index)
+{
+#if PAL_UNIQUE_THREAD_PRIORITY
+    static const palThreadPriority_t session_priorities[] = { PAL_osPriorityNormal, PAL_osPriorityAboveNormal, PAL_osPriorityHigh };
+    return session_priorities[index];
+#else
+    (void)index;
+    return PAL_osPriorityNormal;
+#endif
+}
+
+uint32_t FtcdCommSocket::_reap_sessions(void)
+{
+    uint32_t free_index = FTCD_SOCKET_MAX_SESSIONS;
+
+    for (uint32_t index = 0; index < FTCD_SOCKET_MAX_SESSIONS; index++) {
+        if (_sessions[index] != NULL && _sessions[index]->is_finished()) {
+            // The thread does not touch the session once finished, terminating it only frees its resources
+            _sessions[index]->stop();
+            delete _sessions[index];
+            _sessions[index] = NULL;
+        }
+        if (_sessions[index] == NULL && free_index == FTCD_SOCKET_MAX_SESSIONS) {
+            free_index = index;
+        }
+    }
+    return free_index;
+}
+
+bool FtcdCommSocket::serve_sessions(void)
 {
     bool success = true;
     palStatus_t result = PAL_SUCCESS;
-    size_t sent_bytes = 0;
-    size_t remaind_bytes = (size_t)data_size;
+    palMutexID_t process_mutex = NULLPTR;
+    palSemaphoreID_t free_sessions = NULLPTR;
+    palSocket_t session_socket;
+    palSocketLength_t addrlen;
+    palSocketAddress_t address;
+    uint32_t index;
+    int32_t count;
+
+    if (_server_socket == NULL) {
+        mbed_tracef(TRACE_LEVEL_CMD, TRACE_GROUP, "Server socket is not listening");
+        return false;
+    }
 
-    do {
-        result = pal_send(_client_socket, data, remaind_bytes, &sent_bytes);
+    result = pal_osMutexCreate(&process_mutex);
+    if (result != PAL_SUCCESS) {
+        mbed_tracef(TRACE_LEVEL_CMD, TRACE_GROUP, "Failed to create processing mutex (status %" PRId32 ")", result);
+        return false;
+    }
+
+    // Every session holds one count while it runs
+    result = pal_osSemaphoreCreate(FTCD_SOCKET_MAX_SESSIONS, &free_sessions);
+    if (result != PAL_SUCCESS) {
+        mbed_tracef(TRACE_LEVEL_CMD, TRACE_GROUP, "Failed to create sessions semaphore (status %" PRId32 ")", result);
+        pal_osMutexDelete(&process_mutex);
+        return false;
+    }
+
+    mbed_tracef(TRACE_LEVEL_CMD, TRACE_GROUP, "Serving up to %d factory tool sessions", FTCD_SOCKET_MAX_SESSIONS);
+
+    while (true) {
+        // Blocks while all sessions are in use
+        result = pal_osSemaphoreWait(free_sessions, PAL_RTOS_WAIT_FOREVER, &count);
         if (result != PAL_SUCCESS) {
-            mbed_tracef(TRACE_LEVEL_CMD, TRACE_GROUP, "Failed pal_send\r");
+            mbed_tracef(TRACE_LEVEL_CMD, TRACE_GROUP, "Failed waiting for a free session (status %" PRId32 ")", result);
             success = false;
             break;
         }
+        // The count may have been released by a session which is about to be marked finished
+        while ((index = _reap_sessions()) == FTCD_SOCKET_MAX_SESSIONS) {
+            pal_osDelay(1);
+        }
 
-        if (sent_bytes == 0 || sent_bytes > remaind_bytes) {
-            mbed_tracef(TRACE_LEVEL_CMD, TRACE_GROUP, "Sending response message failed");
-            success = false;
+        addrlen = 0;
+        memset(&address, 0, sizeof(address));
+        session_socket = NULL;
+        result = pal_accept(_server_socket, &address, &addrlen, &session_socket);
+        if (result != PAL_SUCCESS) {
+            pal_osSemaphoreRelease(free_sessions);
+            if (result == PAL_ERR_SOCKET_WOULD_BLOCK) {
+                mbed_tracef(TRACE_LEVEL_CMD, TRACE_GROUP, "No new factory tool connection\r");
+            } else {
+                mbed_tracef(TRACE_LEVEL_CMD, TRACE_GROUP, "pal_accept failed (status %" PRId32 ")", result);
+                success = false;
+            }
             break;
         }
-        remaind_bytes = remaind_bytes - sent_bytes;
-        data += sent_bytes;
 
-    } while (remaind_bytes != 0);
+        //set session socket timeout
+        if (_rcv_timeout >= 0) {
+            result = pal_setSocketOptions(session_socket, PAL_SO_RCVTIMEO, &_rcv_timeout, sizeof(_rcv_timeout));
+            if (result != PAL_SUCCESS) {
+                mbed_tracef(TRACE_LEVEL_CMD, TRACE_GROUP, "Cannot set session socket timeout (status %" PRId32 ")", result);
+                pal_close(&session_socket);
+                pal_osSemaphoreRelease(free_sessions);
+                continue;
+            }
+        }
+
+        _sessions[index] = new FtcdCommSocketSession(session_socket, process_mutex, free_sessions);
+        if (_sessions[index] == NULL) {
+            mbed_tracef(TRACE_LEVEL_CMD, TRACE_GROUP, "Failed to allocate session");
+            pal_close(&session_socket);
+            pal_osSemaphoreRelease(free_sessions);
+            continue;
+        }
+        if (!_sessions[index]->start(session_priority(index))) {
+            delete _sessions[index];
+            _sessions[index] = NULL;
+            pal_osSemaphoreRelease(free_sessions);
+            continue;
+        }
+        mbed_tracef(TRACE_LEVEL_CMD, TRACE_GROUP, "Factory tool session %" PRIu32 " started", index);
+    }
+
+    // Wait for the running sessions to end
+    for (index = 0; index < FTCD_SOCKET_MAX_SESSIONS; index++) {
+        pal_osSemaphoreWait(free_sessions, PAL_RTOS_WAIT_FOREVER, &count);
+    }
+    for (index = 0; index < FTCD_SOCKET_MAX_SESSIONS; index++) {
+        while (_sessions[index] != NULL && !_sessions[index]->is_finished()) {
+            pal_osDelay(1);
+        }
+    }
+    _reap_sessions();
+
+    pal_osSemaphoreDelete(&free_sessions);
+    pal_osMutexDelete(&process_mutex);
 
     return success;
 }
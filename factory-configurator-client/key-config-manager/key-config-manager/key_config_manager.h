@@ -69,6 +69,34 @@ kcm_status_e kcm_finalize(void);
 */
 kcm_status_e kcm_item_store(const uint8_t *kcm_item_name, size_t kcm_item_name_len, kcm_item_type_e kcm_item_type, bool kcm_item_is_factory, const uint8_t *kcm_item_data, size_t kcm_item_data_size, const kcm_security_desc_s security_desc);
 
+/**
+* KCM item stored by `kcm_items_store_batch()`.
+*/
+typedef struct kcm_item_batch_entry_ {
+    const uint8_t *name;                //!< KCM item name.
+    size_t name_len;                    //!< KCM item name length.
+    kcm_item_type_e type;               //!< KCM item type as defined in `::kcm_item_type_e`.
+    const uint8_t *data;                //!< KCM item data buffer.
+    size_t data_size;                   //!< KCM item data buffer size in bytes.
+    kcm_security_desc_s security_desc;  //!< Security descriptor.
+} kcm_item_batch_entry_s;
+
+/** Store several KCM items into a secure storage.
+*
+*    All the items are validated before any of them is written, on `KCM_BATCH_VALIDATION_THREADS` threads (2 by default).
+*    If an item fails, the items of the batch that were already written are deleted, so either all the items are stored or none.
+*    Certificates parsed during the validation are kept by the certificate cache, see `kcm_cert_info_get()`.
+*
+*    @param[in,out] items The KCM items.
+*    @param[in] items_count Number of KCM items.
+*    @param[in] kcm_item_is_factory True if the KCM items are factory items, otherwise false.
+*    @param[out] failed_index_out Index of the item that failed, or `items_count` if none did.
+*
+*    @returns
+*        KCM_STATUS_SUCCESS in case of success or one of the `::kcm_status_e` errors otherwise.
+*/
+kcm_status_e kcm_items_store_batch(kcm_item_batch_entry_s *items, size_t items_count, bool kcm_item_is_factory, size_t *failed_index_out);
+
 /* === Keys, Certificates and Configuration data retrieval === */
 
 /** Retrieve the KCM item data size from a secure storage.
@@ -135,6 +163,58 @@ kcm_status_e kcm_item_delete(const uint8_t *kcm_item_name, size_t kcm_item_name_
 */
 kcm_status_e kcm_factory_reset(void);
 
+/**  Drop all the KCM items kept in RAM by the item cache, and all the certificates kept by the certificate cache.
+*    Must be called when the storage is modified other than through the KCM APIs, for example after `storage_reset()`.
+*/
+void kcm_item_cache_invalidate(void);
+
+/* === Parsed certificates === */
+
+/**
+* Stored certificate, parsed once and kept by the certificate cache together with the attributes the device verification uses.
+*/
+typedef struct kcm_cert_info_ {
+    uintptr_t x509_cert_handle;         //!< The parsed certificate (a `palX509Handle_t`), owned by the cache.
+    const uint8_t *cn;                  //!< CN attribute, including its terminating '\0', or NULL if the certificate has none.
+    size_t cn_size;                     //!< CN attribute size in bytes.
+    const uint8_t *ou;                  //!< OU attribute, including its terminating '\0', or NULL if the certificate has none.
+    size_t ou_size;                     //!< OU attribute size in bytes.
+    bool has_validity;                  //!< True if `valid_from` and `valid_to` could be read from the certificate.
+    uint64_t valid_from;                //!< Start of the validity period, in seconds since the epoch.
+    uint64_t valid_to;                  //!< End of the validity period, in seconds since the epoch.
+} kcm_cert_info_s;
+
+/** Get a stored certificate in its parsed form.
+*
+*    The certificate is read and parsed on the first call only. It stays in the cache, which holds up to `KCM_CERT_CACHE_SIZE`
+*    certificates, until it is stored again with different data or deleted, or until `kcm_item_cache_invalidate()` is called.
+*
+*    @param[in] kcm_cert_name KCM certificate name.
+*    @param[in] kcm_cert_name_len KCM certificate name length.
+*    @param[out] kcm_cert_info_out The parsed certificate, which must not be released. It is valid until the certificate cache changes:
+*                                  until a certificate is stored or deleted, until `kcm_cert_info_get()` or `kcm_cert_check_private_key()`
+*                                  parses another certificate, or until `kcm_item_cache_invalidate()`, `kcm_factory_reset()` or `kcm_finalize()`
+*                                  is called. Reading other items does not change the certificate cache.
+*
+*    @returns
+*        KCM_STATUS_SUCCESS in case of success or one of the `::kcm_status_e` errors otherwise.
+*/
+kcm_status_e kcm_cert_info_get(const uint8_t *kcm_cert_name, size_t kcm_cert_name_len, const kcm_cert_info_s **kcm_cert_info_out);
+
+/** Check that a private key matches the public key of a stored certificate.
+*
+*    The result is kept with the parsed certificate, so checking the same key again does not repeat the key operations.
+*
+*    @param[in] kcm_cert_name KCM certificate name.
+*    @param[in] kcm_cert_name_len KCM certificate name length.
+*    @param[in] private_key_data DER private key.
+*    @param[in] private_key_data_size DER private key size in bytes.
+*
+*    @returns
+*        KCM_STATUS_SUCCESS if the keys match or one of the `::kcm_status_e` errors otherwise.
+*/
+kcm_status_e kcm_cert_check_private_key(const uint8_t *kcm_cert_name, size_t kcm_cert_name_len, const uint8_t *private_key_data, size_t private_key_data_size);
+
 
 
 #ifndef __DOXYGEN__
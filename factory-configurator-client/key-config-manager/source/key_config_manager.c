@@ -20,7 +20,10 @@
 #include "kcm_file_prefix_defs.h"
 #include "cs_der_certs.h"
 #include "cs_der_keys.h"
+#include "cs_hash.h"
+#include "cs_utils.h"
 #include "fcc_malloc.h"
+#include "pal.h"
 
 
 typedef enum {
@@ -31,8 +34,345 @@ typedef enum {
     KCM_CONFIG_DATA,
 } kcm_data_type;
 
+// Number of items kept in RAM by kcm_item_get_data() and kcm_item_get_data_size() (0 disables the cache).
+// Only certificates, public keys and configuration parameters are cached - private and symmetric keys are
+// always read from the storage so that no copy of them stays on the heap.
+#ifndef KCM_ITEM_CACHE_SIZE
+#define KCM_ITEM_CACHE_SIZE             0
+#endif
+
+// Items with more data than this are not cached.
+#ifndef KCM_ITEM_CACHE_MAX_DATA_SIZE
+#define KCM_ITEM_CACHE_MAX_DATA_SIZE    1024
+#endif
+
+// Number of threads validating the items of kcm_items_store_batch(), including the calling thread.
+// Helper threads that cannot be created (for example when their priority is already taken) are skipped.
+// Define it to 1 to validate on the calling thread only.
+#ifndef KCM_BATCH_VALIDATION_THREADS
+#define KCM_BATCH_VALIDATION_THREADS    2
+#endif
+
+// A helper thread parses certificates, so it gets the stack of an FTCD session thread
+#ifndef KCM_BATCH_VALIDATION_THREAD_STACK_SIZE
+#define KCM_BATCH_VALIDATION_THREAD_STACK_SIZE  (1024 * 16)
+#endif
+
+#if KCM_BATCH_VALIDATION_THREADS > 4
+#error "KCM_BATCH_VALIDATION_THREADS can not be greater than 4"
+#endif
+
+// Number of parsed certificates kept by kcm_cert_info_get(). The device verification uses up to three certificates.
+#ifndef KCM_CERT_CACHE_SIZE
+#define KCM_CERT_CACHE_SIZE             3
+#endif
+
+#if KCM_CERT_CACHE_SIZE < 1
+#error "KCM_CERT_CACHE_SIZE must be at least 1"
+#endif
+
 static bool kcm_initialized = false;
 
+#if KCM_ITEM_CACHE_SIZE > 0
+typedef struct kcm_cache_entry_ {
+    uint8_t *name; // Complete name, including the item type prefix
+    size_t name_size;
+    uint8_t *data;
+    size_t data_size;
+    uint32_t last_used;
+} kcm_cache_entry_s;
+
+static kcm_cache_entry_s kcm_item_cache[KCM_ITEM_CACHE_SIZE];
+static uint32_t kcm_item_cache_clock = 0;
+
+static bool kcm_item_cache_allowed(kcm_item_type_e kcm_item_type)
+{
+    return (kcm_item_type != KCM_PRIVATE_KEY_ITEM && kcm_item_type != KCM_SYMMETRIC_KEY_ITEM);
+}
+
+static kcm_cache_entry_s *kcm_item_cache_find(const uint8_t *kcm_complete_name, size_t kcm_complete_name_size)
+{
+    int i;
+
+    for (i = 0; i < KCM_ITEM_CACHE_SIZE; i++) {
+        if (kcm_item_cache[i].name != NULL && kcm_item_cache[i].name_size == kcm_complete_name_size &&
+                memcmp(kcm_item_cache[i].name, kcm_complete_name, kcm_complete_name_size) == 0) {
+            kcm_item_cache[i].last_used = ++kcm_item_cache_clock;
+            return &kcm_item_cache[i];
+        }
+    }
+    return NULL;
+}
+
+static void kcm_item_cache_release(kcm_cache_entry_s *entry)
+{
+    fcc_free(entry->name);
+    fcc_free(entry->data);
+    memset(entry, 0, sizeof(*entry));
+}
+
+static void kcm_item_cache_remove(const uint8_t *kcm_complete_name, size_t kcm_complete_name_size)
+{
+    kcm_cache_entry_s *entry = kcm_item_cache_find(kcm_complete_name, kcm_complete_name_size);
+
+    if (entry != NULL) {
+        kcm_item_cache_release(entry);
+    }
+}
+
+// Keep a copy of the item data, evicting the least recently used item if needed. Failing to cache is not an error.
+static void kcm_item_cache_insert(const uint8_t *kcm_complete_name, size_t kcm_complete_name_size, const uint8_t *data, size_t data_size)
+{
+    kcm_cache_entry_s *entry = &kcm_item_cache[0];
+    int i;
+
+    if (data_size > KCM_ITEM_CACHE_MAX_DATA_SIZE) {
+        return;
+    }
+
+    kcm_item_cache_remove(kcm_complete_name, kcm_complete_name_size);
+    for (i = 1; i < KCM_ITEM_CACHE_SIZE && entry->name != NULL; i++) {
+        if (kcm_item_cache[i].name == NULL || kcm_item_cache[i].last_used < entry->last_used) {
+            entry = &kcm_item_cache[i];
+        }
+    }
+    kcm_item_cache_release(entry);
+
+    entry->name = (uint8_t *)fcc_malloc(kcm_complete_name_size);
+    // Allocate at least one byte so that empty configuration items can be cached as well
+    entry->data = (uint8_t *)fcc_malloc(data_size ? data_size : 1);
+    if (entry->name == NULL || entry->data == NULL) {
+        kcm_item_cache_release(entry);
+        return;
+    }
+    memcpy(entry->name, kcm_complete_name, kcm_complete_name_size);
+    if (data_size > 0) {
+        memcpy(entry->data, data, data_size);
+    }
+    entry->name_size = kcm_complete_name_size;
+    entry->data_size = data_size;
+    entry->last_used = ++kcm_item_cache_clock;
+}
+
+static bool kcm_item_cache_get_size(kcm_item_type_e kcm_item_type, const uint8_t *kcm_complete_name, size_t kcm_complete_name_size, size_t *data_size_out)
+{
+    kcm_cache_entry_s *entry;
+
+    if (!kcm_item_cache_allowed(kcm_item_type)) {
+        return false;
+    }
+    entry = kcm_item_cache_find(kcm_complete_name, kcm_complete_name_size);
+    if (entry == NULL) {
+        return false;
+    }
+    *data_size_out = entry->data_size;
+    return true;
+}
+
+// Returns true if the item was found in the cache, in which case status_out holds the result of the read.
+static bool kcm_item_cache_get_data(kcm_item_type_e kcm_item_type, const uint8_t *kcm_complete_name, size_t kcm_complete_name_size,
+                                    uint8_t *data_out, size_t data_max_size, size_t *data_act_size_out, kcm_status_e *status_out)
+{
+    kcm_cache_entry_s *entry;
+
+    if (!kcm_item_cache_allowed(kcm_item_type)) {
+        return false;
+    }
+    entry = kcm_item_cache_find(kcm_complete_name, kcm_complete_name_size);
+    if (entry == NULL) {
+        return false;
+    }
+    if (entry->data_size > data_max_size) {
+        SA_PV_LOG_ERR("Buffer too small");
+        *status_out = KCM_STATUS_INSUFFICIENT_BUFFER;
+        return true;
+    }
+    if (entry->data_size > 0) {
+        memcpy(data_out, entry->data, entry->data_size);
+    }
+    *data_act_size_out = entry->data_size;
+    *status_out = KCM_STATUS_SUCCESS;
+    return true;
+}
+
+static void kcm_item_cache_store(kcm_item_type_e kcm_item_type, const uint8_t *kcm_complete_name, size_t kcm_complete_name_size, const uint8_t *data, size_t data_size)
+{
+    if (kcm_item_cache_allowed(kcm_item_type)) {
+        kcm_item_cache_insert(kcm_complete_name, kcm_complete_name_size, data, data_size);
+    }
+}
+#else
+#define kcm_item_cache_remove(kcm_complete_name, kcm_complete_name_size)
+#define kcm_item_cache_get_size(kcm_item_type, kcm_complete_name, kcm_complete_name_size, data_size_out) false
+#define kcm_item_cache_get_data(kcm_item_type, kcm_complete_name, kcm_complete_name_size, data_out, data_max_size, data_act_size_out, status_out) false
+#define kcm_item_cache_store(kcm_item_type, kcm_complete_name, kcm_complete_name_size, data, data_size)
+#endif
+
+typedef struct kcm_cert_cache_entry_ {
+    uint8_t *name; // Certificate name, without the item type prefix
+    size_t name_size;
+    uint8_t data_hash[CS_SHA256_SIZE];
+    kcm_cert_info_s info;
+    bool is_private_key_checked;
+    uint8_t private_key_hash[CS_SHA256_SIZE];
+    kcm_status_e private_key_status;
+    uint32_t last_used;
+} kcm_cert_cache_entry_s;
+
+static kcm_cert_cache_entry_s kcm_cert_cache[KCM_CERT_CACHE_SIZE];
+static uint32_t kcm_cert_cache_clock = 0;
+
+static kcm_cert_cache_entry_s *kcm_cert_cache_find(const uint8_t *kcm_cert_name, size_t kcm_cert_name_len)
+{
+    int i;
+
+    for (i = 0; i < KCM_CERT_CACHE_SIZE; i++) {
+        if (kcm_cert_cache[i].name != NULL && kcm_cert_cache[i].name_size == kcm_cert_name_len &&
+                memcmp(kcm_cert_cache[i].name, kcm_cert_name, kcm_cert_name_len) == 0) {
+            kcm_cert_cache[i].last_used = ++kcm_cert_cache_clock;
+            return &kcm_cert_cache[i];
+        }
+    }
+    return NULL;
+}
+
+static void kcm_cert_cache_release(kcm_cert_cache_entry_s *entry)
+{
+    palX509Handle_t x509_cert_handle = (palX509Handle_t)entry->info.x509_cert_handle;
+
+    if (x509_cert_handle != NULLPTR) {
+        cs_close_handle_x509_cert(&x509_cert_handle);
+    }
+    fcc_free(entry->name);
+    fcc_free((void *)entry->info.cn);
+    fcc_free((void *)entry->info.ou);
+    memset(entry, 0, sizeof(*entry));
+}
+
+/* Drops the certificate from the cache, unless data is not NULL and the cached certificate has the same data.
+*/
+static void kcm_cert_cache_remove(const uint8_t *kcm_cert_name, size_t kcm_cert_name_len, const uint8_t *data, size_t data_size)
+{
+    kcm_cert_cache_entry_s *entry = kcm_cert_cache_find(kcm_cert_name, kcm_cert_name_len);
+    uint8_t data_hash[CS_SHA256_SIZE];
+
+    if (entry == NULL) {
+        return;
+    }
+    if (data != NULL && cs_hash(CS_SHA256, data, data_size, data_hash, sizeof(data_hash)) == KCM_STATUS_SUCCESS &&
+            memcmp(entry->data_hash, data_hash, sizeof(data_hash)) == 0) {
+        return;
+    }
+    kcm_cert_cache_release(entry);
+}
+
+/* Reads a string attribute of the certificate. A missing attribute is not an error, it is left NULL.
+*/
+static kcm_status_e kcm_cert_attr_get(palX509Handle_t x509_cert_handle, cs_certificate_attribute_type_e attr_type, const uint8_t **attr_out, size_t *attr_size_out)
+{
+    kcm_status_e kcm_status;
+    uint8_t *attr;
+    size_t attr_size = 0;
+
+    kcm_status = cs_attr_get_data_size_x509_cert(x509_cert_handle, attr_type, &attr_size);
+    if (kcm_status != KCM_STATUS_SUCCESS || attr_size == 0) {
+        return KCM_STATUS_SUCCESS;
+    }
+
+    attr = (uint8_t *)fcc_malloc(attr_size);
+    SA_PV_ERR_RECOVERABLE_RETURN_IF((attr == NULL), KCM_STATUS_OUT_OF_MEMORY, "Failed allocating certificate attribute");
+
+    kcm_status = cs_attr_get_data_x509_cert(x509_cert_handle, attr_type, attr, attr_size, &attr_size);
+    if (kcm_status != KCM_STATUS_SUCCESS || attr_size == 0) {
+        fcc_free(attr);
+        return KCM_STATUS_SUCCESS;
+    }
+
+    *attr_out = attr;
+    *attr_size_out = attr_size;
+    return KCM_STATUS_SUCCESS;
+}
+
+/* Adds a parsed certificate to the cache, evicting the least recently used certificate if needed.
+*  The cache takes the ownership of x509_cert_handle, also when it fails.
+*/
+static kcm_status_e kcm_cert_cache_insert(const uint8_t *kcm_cert_name, size_t kcm_cert_name_len, const uint8_t *data, size_t data_size,
+                                          palX509Handle_t x509_cert_handle, kcm_cert_cache_entry_s **entry_out)
+{
+    kcm_status_e kcm_status = KCM_STATUS_SUCCESS;
+    kcm_cert_cache_entry_s *entry = NULL;
+    uint8_t data_hash[CS_SHA256_SIZE];
+    size_t size;
+    int i;
+
+    kcm_status = cs_hash(CS_SHA256, data, data_size, data_hash, sizeof(data_hash));
+    SA_PV_ERR_RECOVERABLE_GOTO_IF((kcm_status != KCM_STATUS_SUCCESS), (kcm_status = kcm_status), Exit, "Failed hashing certificate");
+
+    // A certificate that is already cached with the same data keeps its entry, including its private key check
+    entry = kcm_cert_cache_find(kcm_cert_name, kcm_cert_name_len);
+    if (entry != NULL) {
+        if (memcmp(entry->data_hash, data_hash, sizeof(data_hash)) == 0) {
+            cs_close_handle_x509_cert(&x509_cert_handle);
+            *entry_out = entry;
+            return KCM_STATUS_SUCCESS;
+        }
+    } else {
+        entry = &kcm_cert_cache[0];
+        for (i = 1; i < KCM_CERT_CACHE_SIZE && entry->name != NULL; i++) {
+            if (kcm_cert_cache[i].name == NULL || kcm_cert_cache[i].last_used < entry->last_used) {
+                entry = &kcm_cert_cache[i];
+            }
+        }
+    }
+    kcm_cert_cache_release(entry);
+
+    // From here on the entry owns the handle, releasing the entry closes it
+    entry->info.x509_cert_handle = (uintptr_t)x509_cert_handle;
+    x509_cert_handle = NULLPTR;
+
+    entry->name = (uint8_t *)fcc_malloc(kcm_cert_name_len);
+    SA_PV_ERR_RECOVERABLE_GOTO_IF((entry->name == NULL), (kcm_status = KCM_STATUS_OUT_OF_MEMORY), Exit, "Failed allocating certificate name");
+    memcpy(entry->name, kcm_cert_name, kcm_cert_name_len);
+    entry->name_size = kcm_cert_name_len;
+    memcpy(entry->data_hash, data_hash, sizeof(data_hash));
+
+    kcm_status = kcm_cert_attr_get((palX509Handle_t)entry->info.x509_cert_handle, CS_CN_ATTRIBUTE_TYPE, &entry->info.cn, &entry->info.cn_size);
+    SA_PV_ERR_RECOVERABLE_GOTO_IF((kcm_status != KCM_STATUS_SUCCESS), (kcm_status = kcm_status), Exit, "Failed getting CN attribute");
+
+    kcm_status = kcm_cert_attr_get((palX509Handle_t)entry->info.x509_cert_handle, CS_OU_ATTRIBUTE_TYPE, &entry->info.ou, &entry->info.ou_size);
+    SA_PV_ERR_RECOVERABLE_GOTO_IF((kcm_status != KCM_STATUS_SUCCESS), (kcm_status = kcm_status), Exit, "Failed getting OU attribute");
+
+    entry->info.has_validity =
+        (cs_attr_get_data_x509_cert((palX509Handle_t)entry->info.x509_cert_handle, CS_VALID_FROM_ATTRIBUTE_TYPE,
+                                    (uint8_t *)&entry->info.valid_from, sizeof(uint64_t), &size) == KCM_STATUS_SUCCESS && size == sizeof(uint64_t) &&
+         cs_attr_get_data_x509_cert((palX509Handle_t)entry->info.x509_cert_handle, CS_VALID_TO_ATTRIBUTE_TYPE,
+                                    (uint8_t *)&entry->info.valid_to, sizeof(uint64_t), &size) == KCM_STATUS_SUCCESS && size == sizeof(uint64_t));
+
+    entry->last_used = ++kcm_cert_cache_clock;
+    *entry_out = entry;
+
+Exit:
+    if (kcm_status != KCM_STATUS_SUCCESS) {
+        if (x509_cert_handle != NULLPTR) {
+            cs_close_handle_x509_cert(&x509_cert_handle);
+        }
+        if (entry != NULL) {
+            kcm_cert_cache_release(entry);
+        }
+    }
+    return kcm_status;
+}
+
+static void kcm_cert_cache_invalidate(void)
+{
+    int i;
+
+    for (i = 0; i < KCM_CERT_CACHE_SIZE; i++) {
+        kcm_cert_cache_release(&kcm_cert_cache[i]);
+    }
+    kcm_cert_cache_clock = 0;
+}
+
 static kcm_status_e kcm_add_prefix_to_name(const uint8_t *kcm_name, size_t kcm_name_len, const char *prefix, uint8_t **kcm_buffer_out, size_t *kcm_buffer_size_allocated_out)
 {
     size_t prefix_length;
@@ -111,6 +451,8 @@ kcm_status_e kcm_finalize(void)
 
     SA_PV_LOG_INFO_FUNC_ENTER_NO_ARGS();
 
+    kcm_item_cache_invalidate();
+
     if (kcm_initialized) {
         status = storage_finalize();
         SA_PV_ERR_RECOVERABLE_RETURN_IF((status != KCM_STATUS_SUCCESS), status, "Failed finalizing storage\n");
@@ -122,23 +464,18 @@ kcm_status_e kcm_finalize(void)
     return status;
 }
 
-kcm_status_e kcm_item_store(const uint8_t * kcm_item_name, size_t kcm_item_name_len, kcm_item_type_e kcm_item_type, bool kcm_item_is_factory, const uint8_t * kcm_item_data, size_t kcm_item_data_size, const kcm_security_desc_s security_desc)
+static bool kcm_item_is_encrypted(kcm_item_type_e kcm_item_type)
 {
-    kcm_status_e kcm_status = KCM_STATUS_SUCCESS;
-    kcm_ctx_s ctx;
-    uint8_t *kcm_complete_name = NULL; // Filename including prefix
-    size_t kcm_complete_name_size;
-    const char *prefix;
-    bool kcm_item_is_encrypted = true; //encrypt by default
-
-    SA_PV_LOG_INFO_FUNC_ENTER("item name =  %.*s len=%" PRIu32 ", data size=%" PRIu32 "", (int)kcm_item_name_len, (char*)kcm_item_name, (uint32_t)kcm_item_name_len, (uint32_t)kcm_item_data_size);
-
-    // Check if KCM initialized, if not initialize it
-    if (!kcm_initialized) {
-        kcm_status = kcm_init();
-        SA_PV_ERR_RECOVERABLE_RETURN_IF((kcm_status != KCM_STATUS_SUCCESS), kcm_status, "KCM initialization failed\n");
-    }
+    //do not encrypt public keys and certificates
+    return (kcm_item_type != KCM_PUBLIC_KEY_ITEM && kcm_item_type != KCM_CERTIFICATE_ITEM);
+}
 
+/* Checks the item parameters and validates its data according to the item type.
+*  If x509_cert_handle_out is not NULL, a certificate is kept parsed in it instead of being released.
+*/
+static kcm_status_e kcm_item_validate(const uint8_t * kcm_item_name, size_t kcm_item_name_len, kcm_item_type_e kcm_item_type, const uint8_t * kcm_item_data, size_t kcm_item_data_size, const kcm_security_desc_s security_desc, palX509Handle_t *x509_cert_handle_out)
+{
+    kcm_status_e kcm_status = KCM_STATUS_SUCCESS;
 
     // Validate function parameters
     SA_PV_ERR_RECOVERABLE_RETURN_IF((kcm_item_name == NULL), KCM_STATUS_INVALID_PARAMETER, "Invalid kcm_item_name");
@@ -157,15 +494,17 @@ kcm_status_e kcm_item_store(const uint8_t * kcm_item_name, size_t kcm_item_name_
         case KCM_PUBLIC_KEY_ITEM:
             kcm_status = cs_der_public_key_verify(kcm_item_data, kcm_item_data_size);
             SA_PV_ERR_RECOVERABLE_RETURN_IF((kcm_status != KCM_STATUS_SUCCESS), kcm_status, "Public key validation failed");
-            kcm_item_is_encrypted = false; //do not encrypt public key
             break;
         case KCM_SYMMETRIC_KEY_ITEM:
             //currently possible to write a symmetric key of size 0 since we do not check format
             break;
         case KCM_CERTIFICATE_ITEM:
-            kcm_status = cs_parse_der_x509_cert(kcm_item_data, kcm_item_data_size);
+            if (x509_cert_handle_out != NULL) {
+                kcm_status = cs_create_handle_from_der_x509_cert(kcm_item_data, kcm_item_data_size, x509_cert_handle_out);
+            } else {
+                kcm_status = cs_parse_der_x509_cert(kcm_item_data, kcm_item_data_size);
+            }
             SA_PV_ERR_RECOVERABLE_RETURN_IF((kcm_status != KCM_STATUS_SUCCESS), kcm_status, "Certificate validation failed");
-            kcm_item_is_encrypted = false; //do not encrypt certificates
             break;
         case KCM_CONFIG_ITEM:
             break;
@@ -173,22 +512,257 @@ kcm_status_e kcm_item_store(const uint8_t * kcm_item_name, size_t kcm_item_name_
             SA_PV_ERR_RECOVERABLE_RETURN_IF((true), KCM_STATUS_INVALID_PARAMETER, "Invalid kcm_item_type");
     }
 
+    return kcm_status;
+}
+
+/* Writes an already validated item to the storage.
+*/
+static kcm_status_e kcm_item_write(const uint8_t * kcm_item_name, size_t kcm_item_name_len, kcm_item_type_e kcm_item_type, bool kcm_item_is_factory, const uint8_t * kcm_item_data, size_t kcm_item_data_size)
+{
+    kcm_status_e kcm_status = KCM_STATUS_SUCCESS;
+    kcm_ctx_s ctx;
+    uint8_t *kcm_complete_name = NULL; // Filename including prefix
+    size_t kcm_complete_name_size;
+    const char *prefix;
+
     kcm_status = kcm_item_name_get_prefix(kcm_item_type, &prefix);
     SA_PV_ERR_RECOVERABLE_GOTO_IF((kcm_status != KCM_STATUS_SUCCESS), (kcm_status = kcm_status), Exit, "Failed during kcm_item_name_get_prefix");
 
     kcm_status = kcm_add_prefix_to_name(kcm_item_name, kcm_item_name_len, prefix, &kcm_complete_name, &kcm_complete_name_size);
     SA_PV_ERR_RECOVERABLE_GOTO_IF((kcm_status != KCM_STATUS_SUCCESS), (kcm_status = kcm_status), Exit, "Failed during kcm_add_prefix_to_name");
 
-    kcm_status = storage_file_write(&ctx, kcm_complete_name, kcm_complete_name_size, kcm_item_data, kcm_item_data_size, kcm_item_is_factory, kcm_item_is_encrypted);
+    kcm_item_cache_remove(kcm_complete_name, kcm_complete_name_size);
+    if (kcm_item_type == KCM_CERTIFICATE_ITEM) {
+        kcm_cert_cache_remove(kcm_item_name, kcm_item_name_len, kcm_item_data, kcm_item_data_size);
+    }
+
+    kcm_status = storage_file_write(&ctx, kcm_complete_name, kcm_complete_name_size, kcm_item_data, kcm_item_data_size, kcm_item_is_factory, kcm_item_is_encrypted(kcm_item_type));
     SA_PV_ERR_RECOVERABLE_GOTO_IF((kcm_status != KCM_STATUS_SUCCESS), (kcm_status = kcm_status), Exit, "Failed writing file to storage");
 
 Exit:
     fcc_free(kcm_complete_name);
+    return kcm_status;
+}
+
+kcm_status_e kcm_item_store(const uint8_t * kcm_item_name, size_t kcm_item_name_len, kcm_item_type_e kcm_item_type, bool kcm_item_is_factory, const uint8_t * kcm_item_data, size_t kcm_item_data_size, const kcm_security_desc_s security_desc)
+{
+    kcm_status_e kcm_status = KCM_STATUS_SUCCESS;
+
+    SA_PV_LOG_INFO_FUNC_ENTER("item name =  %.*s len=%" PRIu32 ", data size=%" PRIu32 "", (int)kcm_item_name_len, (char*)kcm_item_name, (uint32_t)kcm_item_name_len, (uint32_t)kcm_item_data_size);
+
+    // Check if KCM initialized, if not initialize it
+    if (!kcm_initialized) {
+        kcm_status = kcm_init();
+        SA_PV_ERR_RECOVERABLE_RETURN_IF((kcm_status != KCM_STATUS_SUCCESS), kcm_status, "KCM initialization failed\n");
+    }
+
+    kcm_status = kcm_item_validate(kcm_item_name, kcm_item_name_len, kcm_item_type, kcm_item_data, kcm_item_data_size, security_desc, NULL);
+    SA_PV_ERR_RECOVERABLE_RETURN_IF((kcm_status != KCM_STATUS_SUCCESS), kcm_status, "Item validation failed");
+
+    kcm_status = kcm_item_write(kcm_item_name, kcm_item_name_len, kcm_item_type, kcm_item_is_factory, kcm_item_data, kcm_item_data_size);
+
     SA_PV_LOG_INFO_FUNC_EXIT_NO_ARGS();
 
     return kcm_status;
 }
 
+typedef struct kcm_batch_validation_ {
+    kcm_item_batch_entry_s *items;
+    kcm_status_e *results;
+    palX509Handle_t *x509_cert_handles; // Certificates parsed by the validation, handed to the certificate cache once written
+    size_t items_count;
+    size_t next_index;
+    bool failed;
+#if KCM_BATCH_VALIDATION_THREADS > 1
+    palMutexID_t mutex;
+    palSemaphoreID_t done;
+#endif
+} kcm_batch_validation_s;
+
+/* Validates items of the batch until none is left or one has failed. Items are taken in order, so when an item
+*  fails all the items before it have been taken and the first failure is always found.
+*/
+static void kcm_batch_validate_items(kcm_batch_validation_s *validation)
+{
+    kcm_item_batch_entry_s *item;
+    size_t index;
+
+    for (;;) {
+#if KCM_BATCH_VALIDATION_THREADS > 1
+        pal_osMutexWait(validation->mutex, PAL_RTOS_WAIT_FOREVER);
+#endif
+        index = validation->next_index;
+        if (index < validation->items_count && !validation->failed) {
+            validation->next_index++;
+        } else {
+            index = validation->items_count;
+        }
+#if KCM_BATCH_VALIDATION_THREADS > 1
+        pal_osMutexRelease(validation->mutex);
+#endif
+        if (index == validation->items_count) {
+            return;
+        }
+
+        item = &validation->items[index];
+        validation->results[index] = kcm_item_validate(item->name, item->name_len, item->type, item->data, item->data_size, item->security_desc,
+                                                       &validation->x509_cert_handles[index]);
+        if (validation->results[index] != KCM_STATUS_SUCCESS) {
+#if KCM_BATCH_VALIDATION_THREADS > 1
+            pal_osMutexWait(validation->mutex, PAL_RTOS_WAIT_FOREVER);
+#endif
+            validation->failed = true;
+#if KCM_BATCH_VALIDATION_THREADS > 1
+            pal_osMutexRelease(validation->mutex);
+#endif
+        }
+    }
+}
+
+#if KCM_BATCH_VALIDATION_THREADS > 1
+static void kcm_batch_validation_thread(void const *argument)
+{
+    kcm_batch_validation_s *validation = (kcm_batch_validation_s *)argument;
+
+    kcm_batch_validate_items(validation);
+    pal_osSemaphoreRelease(validation->done);
+}
+
+// Every thread needs its own priority when PAL_UNIQUE_THREAD_PRIORITY is set
+static const palThreadPriority_t kcm_batch_validation_priorities[KCM_BATCH_VALIDATION_THREADS - 1] = {
+    PAL_osPriorityBelowNormal,
+#if KCM_BATCH_VALIDATION_THREADS > 2
+    PAL_osPriorityLow,
+#endif
+#if KCM_BATCH_VALIDATION_THREADS > 3
+    PAL_osPriorityIdle,
+#endif
+};
+#endif
+
+static void kcm_batch_validate(kcm_batch_validation_s *validation)
+{
+#if KCM_BATCH_VALIDATION_THREADS > 1
+    palThreadID_t threads[KCM_BATCH_VALIDATION_THREADS - 1];
+    size_t threads_count = 0;
+    size_t i;
+    int32_t count;
+
+    validation->mutex = NULLPTR;
+    validation->done = NULLPTR;
+    if (validation->items_count > 1 &&
+        pal_osMutexCreate(&validation->mutex) == PAL_SUCCESS &&
+        pal_osSemaphoreCreate(0, &validation->done) == PAL_SUCCESS) {
+        for (i = 0; i < KCM_BATCH_VALIDATION_THREADS - 1 && i + 1 < validation->items_count; i++) {
+            if (pal_osThreadCreateWithAlloc(kcm_batch_validation_thread, validation, kcm_batch_validation_priorities[i],
+                                            KCM_BATCH_VALIDATION_THREAD_STACK_SIZE, NULL, &threads[threads_count]) == PAL_SUCCESS) {
+                threads_count++;
+            }
+        }
+    }
+    // When the mutex could not be created no helper thread was started, and locking it just fails
+    kcm_batch_validate_items(validation);
+
+    for (i = 0; i < threads_count; i++) {
+        pal_osSemaphoreWait(validation->done, PAL_RTOS_WAIT_FOREVER, &count);
+    }
+    for (i = 0; i < threads_count; i++) {
+        pal_osThreadTerminate(&threads[i]);
+    }
+    if (validation->done != NULLPTR) {
+        pal_osSemaphoreDelete(&validation->done);
+    }
+    if (validation->mutex != NULLPTR) {
+        pal_osMutexDelete(&validation->mutex);
+    }
+#else
+    kcm_batch_validate_items(validation);
+#endif
+}
+
+kcm_status_e kcm_items_store_batch(kcm_item_batch_entry_s *items, size_t items_count, bool kcm_item_is_factory, size_t *failed_index_out)
+{
+    kcm_status_e kcm_status = KCM_STATUS_SUCCESS;
+    kcm_batch_validation_s validation;
+    kcm_cert_cache_entry_s *cert_entry;
+    size_t index;
+    size_t written;
+
+    SA_PV_LOG_INFO_FUNC_ENTER("items count=%" PRIu32 "", (uint32_t)items_count);
+
+    // Check if KCM initialized, if not initialize it
+    if (!kcm_initialized) {
+        kcm_status = kcm_init();
+        SA_PV_ERR_RECOVERABLE_RETURN_IF((kcm_status != KCM_STATUS_SUCCESS), kcm_status, "KCM initialization failed\n");
+    }
+
+    // Validate function parameters
+    SA_PV_ERR_RECOVERABLE_RETURN_IF((items == NULL && items_count > 0), KCM_STATUS_INVALID_PARAMETER, "Invalid items");
+    SA_PV_ERR_RECOVERABLE_RETURN_IF((failed_index_out == NULL), KCM_STATUS_INVALID_PARAMETER, "Invalid failed_index_out");
+    *failed_index_out = items_count;
+
+    if (items_count == 0) {
+        return KCM_STATUS_SUCCESS;
+    }
+
+    memset(&validation, 0, sizeof(validation));
+    validation.items = items;
+    validation.items_count = items_count;
+    validation.results = (kcm_status_e *)fcc_malloc(items_count * sizeof(kcm_status_e));
+    validation.x509_cert_handles = (palX509Handle_t *)fcc_malloc(items_count * sizeof(palX509Handle_t));
+    SA_PV_ERR_RECOVERABLE_GOTO_IF((validation.results == NULL || validation.x509_cert_handles == NULL), (kcm_status = KCM_STATUS_OUT_OF_MEMORY), Exit, "Failed allocating validation results");
+
+    for (index = 0; index < items_count; index++) {
+        validation.x509_cert_handles[index] = NULLPTR;
+        validation.results[index] = KCM_STATUS_SUCCESS;
+    }
+
+    // Validate all the items before anything is written
+    kcm_batch_validate(&validation);
+
+    for (index = 0; index < items_count; index++) {
+        if (validation.results[index] != KCM_STATUS_SUCCESS) {
+            kcm_status = validation.results[index];
+            SA_PV_ERR_RECOVERABLE_GOTO_IF((true), *failed_index_out = index, Exit, "Validation of item %" PRIu32 " failed", (uint32_t)index);
+        }
+    }
+
+    for (written = 0; written < items_count; written++) {
+        kcm_status = kcm_item_write(items[written].name, items[written].name_len, items[written].type, kcm_item_is_factory, items[written].data, items[written].data_size);
+        if (kcm_status != KCM_STATUS_SUCCESS) {
+            SA_PV_LOG_ERR("Failed writing item %" PRIu32 " (%d), rolling back the batch", (uint32_t)written, kcm_status);
+            *failed_index_out = written;
+            // Items of the batch were created by it (storing an existing item fails), so removing them restores the storage
+            for (index = 0; index < written; index++) {
+                (void)kcm_item_delete(items[index].name, items[index].name_len, items[index].type);
+            }
+            goto Exit;
+        }
+    }
+
+    // Keep the certificates parsed by the validation, failing to cache them is not an error
+    for (index = 0; index < items_count; index++) {
+        if (validation.x509_cert_handles[index] != NULLPTR) {
+            (void)kcm_cert_cache_insert(items[index].name, items[index].name_len, items[index].data, items[index].data_size,
+                                        validation.x509_cert_handles[index], &cert_entry);
+            validation.x509_cert_handles[index] = NULLPTR;
+        }
+    }
+
+Exit:
+    if (validation.x509_cert_handles != NULL) {
+        for (index = 0; index < items_count; index++) {
+            if (validation.x509_cert_handles[index] != NULLPTR) {
+                cs_close_handle_x509_cert(&validation.x509_cert_handles[index]);
+            }
+        }
+    }
+    fcc_free(validation.x509_cert_handles);
+    fcc_free(validation.results);
+    SA_PV_LOG_INFO_FUNC_EXIT_NO_ARGS();
+    return kcm_status;
+}
+
 
 kcm_status_e kcm_item_get_data_size(const uint8_t *kcm_item_name, size_t kcm_item_name_len, kcm_item_type_e kcm_item_type, size_t *kcm_item_data_size_out)
 {
@@ -219,8 +793,10 @@ kcm_status_e kcm_item_get_data_size(const uint8_t *kcm_item_name, size_t kcm_ite
     status = kcm_add_prefix_to_name(kcm_item_name, kcm_item_name_len, prefix, &kcm_complete_name, &kcm_complete_name_size);
     SA_PV_ERR_RECOVERABLE_GOTO_IF((status != KCM_STATUS_SUCCESS), (status = status), Exit, "Failed during kcm_add_prefix_to_name");
 
-    status = storage_file_size_get(&ctx, kcm_complete_name, kcm_complete_name_size, &kcm_data_size);
-    SA_PV_ERR_RECOVERABLE_GOTO_IF((status != KCM_STATUS_SUCCESS), (status = status), Exit, "Failed in getting file size");
+    if (!kcm_item_cache_get_size(kcm_item_type, kcm_complete_name, kcm_complete_name_size, &kcm_data_size)) {
+        status = storage_file_size_get(&ctx, kcm_complete_name, kcm_complete_name_size, &kcm_data_size);
+        SA_PV_ERR_RECOVERABLE_GOTO_IF((status != KCM_STATUS_SUCCESS), (status = status), Exit, "Failed in getting file size");
+    }
 
     *kcm_item_data_size_out = kcm_data_size;
     SA_PV_LOG_INFO_FUNC_EXIT("kcm data size = %" PRIu32 "", (uint32_t)*kcm_item_data_size_out);
@@ -261,8 +837,14 @@ kcm_status_e kcm_item_get_data(const uint8_t * kcm_item_name, size_t kcm_item_na
     status = kcm_add_prefix_to_name(kcm_item_name, kcm_item_name_len, prefix, &kcm_complete_name, &kcm_complete_name_size);
     SA_PV_ERR_RECOVERABLE_GOTO_IF((status != KCM_STATUS_SUCCESS), (status = status), Exit, "Failed during kcm_add_prefix_to_name");
 
-    status = storage_file_read(&ctx, kcm_complete_name, kcm_complete_name_size, kcm_item_data_out, kcm_item_data_max_size, kcm_item_data_act_size_out);
-    SA_PV_ERR_RECOVERABLE_GOTO_IF((status != KCM_STATUS_SUCCESS), (status = status), Exit, "Failed reading file from storage (%d)", status);
+    if (kcm_item_cache_get_data(kcm_item_type, kcm_complete_name, kcm_complete_name_size, kcm_item_data_out, kcm_item_data_max_size, kcm_item_data_act_size_out, &status)) {
+        SA_PV_ERR_RECOVERABLE_GOTO_IF((status != KCM_STATUS_SUCCESS), (status = status), Exit, "Failed reading cached item (%d)", status);
+    } else {
+        status = storage_file_read(&ctx, kcm_complete_name, kcm_complete_name_size, kcm_item_data_out, kcm_item_data_max_size, kcm_item_data_act_size_out);
+        SA_PV_ERR_RECOVERABLE_GOTO_IF((status != KCM_STATUS_SUCCESS), (status = status), Exit, "Failed reading file from storage (%d)", status);
+
+        kcm_item_cache_store(kcm_item_type, kcm_complete_name, kcm_complete_name_size, kcm_item_data_out, *kcm_item_data_act_size_out);
+    }
 
     SA_PV_LOG_INFO_FUNC_EXIT("kcm data size = %" PRIu32 "", (uint32_t)*kcm_item_data_act_size_out);
 Exit:
@@ -299,6 +881,11 @@ kcm_status_e kcm_item_delete(const uint8_t * kcm_item_name, size_t kcm_item_name
     status = kcm_add_prefix_to_name(kcm_item_name, kcm_item_name_len, prefix, &kcm_complete_name, &kcm_complete_name_size);
     SA_PV_ERR_RECOVERABLE_GOTO_IF((status != KCM_STATUS_SUCCESS), (status = status), Exit, "Failed during kcm_add_prefix_to_name");
 
+    kcm_item_cache_remove(kcm_complete_name, kcm_complete_name_size);
+    if (kcm_item_type == KCM_CERTIFICATE_ITEM) {
+        kcm_cert_cache_remove(kcm_item_name, kcm_item_name_len, NULL, 0);
+    }
+
     status = storage_file_delete(&ctx, kcm_complete_name, kcm_complete_name_size);
     SA_PV_ERR_RECOVERABLE_GOTO_IF((status != KCM_STATUS_SUCCESS), (status = status), Exit, "Failed deleting kcm data");
 
@@ -321,6 +908,8 @@ kcm_status_e kcm_factory_reset(void)
         SA_PV_ERR_RECOVERABLE_RETURN_IF((status != KCM_STATUS_SUCCESS), status, "KCM initialization failed\n");
     }
 
+    kcm_item_cache_invalidate();
+
     status = storage_factory_reset();
     SA_PV_ERR_RECOVERABLE_GOTO_IF((status != KCM_STATUS_SUCCESS), (status = status), Exit, "Failed perform factory reset");
 
@@ -329,3 +918,106 @@ Exit:
     return status;
 }
 
+void kcm_item_cache_invalidate(void)
+{
+#if KCM_ITEM_CACHE_SIZE > 0
+    int i;
+
+    for (i = 0; i < KCM_ITEM_CACHE_SIZE; i++) {
+        kcm_item_cache_release(&kcm_item_cache[i]);
+    }
+    kcm_item_cache_clock = 0;
+#endif
+    kcm_cert_cache_invalidate();
+}
+
+/* Gets the cache entry of a certificate, reading and parsing the certificate if it is not cached yet.
+*/
+static kcm_status_e kcm_cert_cache_get(const uint8_t *kcm_cert_name, size_t kcm_cert_name_len, kcm_cert_cache_entry_s **entry_out)
+{
+    kcm_status_e kcm_status = KCM_STATUS_SUCCESS;
+    palX509Handle_t x509_cert_handle = NULLPTR;
+    uint8_t *cert_data = NULL;
+    size_t cert_data_size = 0;
+
+    // Check if KCM initialized, if not initialize it
+    if (!kcm_initialized) {
+        kcm_status = kcm_init();
+        SA_PV_ERR_RECOVERABLE_RETURN_IF((kcm_status != KCM_STATUS_SUCCESS), kcm_status, "KCM initialization failed\n");
+    }
+
+    // Validate function parameters
+    SA_PV_ERR_RECOVERABLE_RETURN_IF((kcm_cert_name == NULL), KCM_STATUS_INVALID_PARAMETER, "Invalid kcm_cert_name");
+    SA_PV_ERR_RECOVERABLE_RETURN_IF((kcm_cert_name_len == 0), KCM_STATUS_INVALID_PARAMETER, "Invalid kcm_cert_name_len");
+
+    *entry_out = kcm_cert_cache_find(kcm_cert_name, kcm_cert_name_len);
+    if (*entry_out != NULL) {
+        return KCM_STATUS_SUCCESS;
+    }
+
+    kcm_status = kcm_item_get_data_size(kcm_cert_name, kcm_cert_name_len, KCM_CERTIFICATE_ITEM, &cert_data_size);
+    SA_PV_ERR_RECOVERABLE_RETURN_IF((kcm_status != KCM_STATUS_SUCCESS), kcm_status, "Failed getting certificate size");
+    SA_PV_ERR_RECOVERABLE_RETURN_IF((cert_data_size == 0), KCM_STATUS_ITEM_IS_EMPTY, "Certificate is empty");
+
+    cert_data = (uint8_t *)fcc_malloc(cert_data_size);
+    SA_PV_ERR_RECOVERABLE_RETURN_IF((cert_data == NULL), KCM_STATUS_OUT_OF_MEMORY, "Failed allocating certificate data");
+
+    kcm_status = kcm_item_get_data(kcm_cert_name, kcm_cert_name_len, KCM_CERTIFICATE_ITEM, cert_data, cert_data_size, &cert_data_size);
+    SA_PV_ERR_RECOVERABLE_GOTO_IF((kcm_status != KCM_STATUS_SUCCESS), (kcm_status = kcm_status), Exit, "Failed getting certificate data");
+
+    kcm_status = cs_create_handle_from_der_x509_cert(cert_data, cert_data_size, &x509_cert_handle);
+    SA_PV_ERR_RECOVERABLE_GOTO_IF((kcm_status != KCM_STATUS_SUCCESS), (kcm_status = kcm_status), Exit, "Failed parsing certificate");
+
+    kcm_status = kcm_cert_cache_insert(kcm_cert_name, kcm_cert_name_len, cert_data, cert_data_size, x509_cert_handle, entry_out);
+    SA_PV_ERR_RECOVERABLE_GOTO_IF((kcm_status != KCM_STATUS_SUCCESS), (kcm_status = kcm_status), Exit, "Failed caching certificate");
+
+Exit:
+    fcc_free(cert_data);
+    return kcm_status;
+}
+
+kcm_status_e kcm_cert_info_get(const uint8_t *kcm_cert_name, size_t kcm_cert_name_len, const kcm_cert_info_s **kcm_cert_info_out)
+{
+    kcm_status_e kcm_status = KCM_STATUS_SUCCESS;
+    kcm_cert_cache_entry_s *entry = NULL;
+
+    SA_PV_LOG_INFO_FUNC_ENTER("cert name = %.*s len = %" PRIu32 "", (int)kcm_cert_name_len, (char*)kcm_cert_name, (uint32_t)kcm_cert_name_len);
+
+    SA_PV_ERR_RECOVERABLE_RETURN_IF((kcm_cert_info_out == NULL), KCM_STATUS_INVALID_PARAMETER, "Invalid kcm_cert_info_out");
+
+    kcm_status = kcm_cert_cache_get(kcm_cert_name, kcm_cert_name_len, &entry);
+    SA_PV_ERR_RECOVERABLE_RETURN_IF((kcm_status != KCM_STATUS_SUCCESS), kcm_status, "Failed getting parsed certificate");
+
+    *kcm_cert_info_out = &entry->info;
+
+    SA_PV_LOG_INFO_FUNC_EXIT_NO_ARGS();
+    return kcm_status;
+}
+
+kcm_status_e kcm_cert_check_private_key(const uint8_t *kcm_cert_name, size_t kcm_cert_name_len, const uint8_t *private_key_data, size_t private_key_data_size)
+{
+    kcm_status_e kcm_status = KCM_STATUS_SUCCESS;
+    kcm_cert_cache_entry_s *entry = NULL;
+    uint8_t private_key_hash[CS_SHA256_SIZE];
+
+    SA_PV_LOG_INFO_FUNC_ENTER("cert name = %.*s len = %" PRIu32 "", (int)kcm_cert_name_len, (char*)kcm_cert_name, (uint32_t)kcm_cert_name_len);
+
+    SA_PV_ERR_RECOVERABLE_RETURN_IF((private_key_data == NULL || private_key_data_size == 0), KCM_STATUS_INVALID_PARAMETER, "Invalid private_key_data");
+
+    kcm_status = kcm_cert_cache_get(kcm_cert_name, kcm_cert_name_len, &entry);
+    SA_PV_ERR_RECOVERABLE_RETURN_IF((kcm_status != KCM_STATUS_SUCCESS), kcm_status, "Failed getting parsed certificate");
+
+    // Only a digest of the key is kept, to recognize the key the cached result belongs to
+    kcm_status = cs_hash(CS_SHA256, private_key_data, private_key_data_size, private_key_hash, sizeof(private_key_hash));
+    SA_PV_ERR_RECOVERABLE_RETURN_IF((kcm_status != KCM_STATUS_SUCCESS), kcm_status, "Failed hashing private key");
+
+    if (!entry->is_private_key_checked || memcmp(entry->private_key_hash, private_key_hash, sizeof(private_key_hash)) != 0) {
+        entry->private_key_status = cs_check_certifcate_public_key((palX509Handle_t)entry->info.x509_cert_handle, private_key_data, private_key_data_size);
+        memcpy(entry->private_key_hash, private_key_hash, sizeof(private_key_hash));
+        entry->is_private_key_checked = true;
+    }
+    kcm_status = entry->private_key_status;
+
+    SA_PV_LOG_INFO_FUNC_EXIT_NO_ARGS();
+    return kcm_status;
+}
@@ -16,11 +16,16 @@
 
 
 
+// Per-file ESFS backend. It is replaced by the log-structured backend in esfs_log.c when ESFS_LOG_STORE is defined.
+
+#ifndef ESFS_LOG_STORE
+
 // ----------------------------------------------------------- Includes -----------------------------------------------------------
 
 
 #include "esfs.h"
 #include "esfs_file_name.h"
+#include "esfs_performance.h"
 
 #include "mbed-trace/mbed_trace.h"
 
@@ -73,8 +78,30 @@
 
 #define MAX_FULL_PATH_SIZE (PAL_MAX_FOLDER_DEPTH_CHAR + 1 + PAL_MAX(sizeof(ESFS_BACKUP_DIRECTORY), sizeof(ESFS_WORKING_DIRECTORY)) + PAL_MAX(sizeof(FACTORY_RESET_DIR) + sizeof(FACTORY_RESET_FILE), ESFS_QUALIFIED_FILE_NAME_LENGTH))
 
+// Number of working files whose CMAC verification is remembered between esfs_open() calls (0 disables it).
+// - An entry is keyed by the file status from pal_fsFstat(): device, file number, size, modification and change time.
+//   Any write to the file changes its change time, which cannot be set back by a user, so an unchanged status means
+//   the verified content. A file whose status matches is accepted on open without reading it.
+// - File systems without pal_fsFstat() support (PAL_ERR_NOT_SUPPORTED) always verify the whole file.
+// - The cache is in RAM only, so the first open of every file after boot is still verified.
+#ifndef ESFS_VERIFIED_CACHE_SIZE
+#define ESFS_VERIFIED_CACHE_SIZE        (8)
+#endif
+
 static bool esfs_initialize = false;
 
+#if ESFS_VERIFIED_CACHE_SIZE > 0
+typedef struct esfs_verified_entry
+{
+    char short_file_name[ESFS_QUALIFIED_FILE_NAME_LENGTH];
+    pal_fsFileStat_t stat;
+    uint32_t last_used;     // 0 marks a free entry
+} esfs_verified_entry_t;
+
+static esfs_verified_entry_t esfs_verified_cache[ESFS_VERIFIED_CACHE_SIZE];
+static uint32_t esfs_verified_cache_clock = 0;
+#endif
+
 
 
 // -------------------------------------------------- Functions Implementation ----------------------------------------------------
@@ -84,6 +111,73 @@ static bool esfs_initialize = false;
 //                              Helper Functions
 //      ---------------------------------------------------------------
 
+#if ESFS_VERIFIED_CACHE_SIZE > 0
+// Return the cache entry of the given short file name, or NULL if it is not cached.
+static esfs_verified_entry_t *esfs_verified_cache_find(const char *short_file_name)
+{
+    for (int i = 0; i < ESFS_VERIFIED_CACHE_SIZE; i++)
+    {
+        if (esfs_verified_cache[i].last_used != 0 &&
+            strncmp(esfs_verified_cache[i].short_file_name, short_file_name, ESFS_QUALIFIED_FILE_NAME_LENGTH) == 0)
+        {
+            return &esfs_verified_cache[i];
+        }
+    }
+    return NULL;
+}
+
+// Return true if the file was verified and has not changed since.
+static bool esfs_verified_cache_check(const char *short_file_name, const pal_fsFileStat_t *stat)
+{
+    esfs_verified_entry_t *entry = esfs_verified_cache_find(short_file_name);
+    if (entry && memcmp(&entry->stat, stat, sizeof(pal_fsFileStat_t)) == 0)
+    {
+        entry->last_used = ++esfs_verified_cache_clock;
+        return true;
+    }
+    return false;
+}
+
+// Remember a verified file, replacing its previous entry or else the least recently used one.
+static void esfs_verified_cache_insert(const char *short_file_name, const pal_fsFileStat_t *stat)
+{
+    esfs_verified_entry_t *entry = esfs_verified_cache_find(short_file_name);
+    if (!entry)
+    {
+        entry = &esfs_verified_cache[0];
+        for (int i = 1; i < ESFS_VERIFIED_CACHE_SIZE; i++)
+        {
+            if (esfs_verified_cache[i].last_used < entry->last_used)
+            {
+                entry = &esfs_verified_cache[i];
+            }
+        }
+        strncpy(entry->short_file_name, short_file_name, ESFS_QUALIFIED_FILE_NAME_LENGTH - 1);
+        entry->short_file_name[ESFS_QUALIFIED_FILE_NAME_LENGTH - 1] = '\0';
+    }
+    entry->stat = *stat;
+    entry->last_used = ++esfs_verified_cache_clock;
+}
+
+static void esfs_verified_cache_remove(const char *short_file_name)
+{
+    esfs_verified_entry_t *entry = esfs_verified_cache_find(short_file_name);
+    if (entry)
+    {
+        entry->last_used = 0;
+    }
+}
+
+static void esfs_verified_cache_clear(void)
+{
+    memset(esfs_verified_cache, 0, sizeof(esfs_verified_cache));
+    esfs_verified_cache_clock = 0;
+}
+#else
+#define esfs_verified_cache_remove(short_file_name)
+#define esfs_verified_cache_clear()
+#endif
+
 
 esfs_result_e esfs_init(void)
 {
@@ -192,6 +286,7 @@ errorExit:
 esfs_result_e esfs_finalize(void)
 {
     esfs_initialize = false;
+    esfs_verified_cache_clear();
     tr_info("esfs_finalize - enter");
     return ESFS_SUCCESS;
 }
@@ -690,6 +785,7 @@ esfs_result_e esfs_reset(void)
     palStatus_t pal_result = PAL_SUCCESS;
     char dir_path[MAX_FULL_PATH_SIZE] = { 0 };
     tr_info("esfs_reset - enter");
+    esfs_verified_cache_clear();
     pal_result = pal_fsGetMountPoint(PAL_FS_PARTITION_PRIMARY, PAL_MAX_FOLDER_DEPTH_CHAR + 1, dir_path);
     if (pal_result != PAL_SUCCESS)
     {
@@ -786,6 +882,8 @@ esfs_result_e esfs_factory_reset(void) {
     char working_dir_path[MAX_FULL_PATH_SIZE] = { 0 };
     char full_path_backup_dir[MAX_FULL_PATH_SIZE] = { 0 };
     tr_info("esfs_factory_reset - enter");
+    add_performance_mark("esfs_factory_reset", ESFS_PERFORMANCE_START);
+    esfs_verified_cache_clear();
     pal_result = pal_fsGetMountPoint(PAL_FS_PARTITION_SECONDARY, PAL_MAX_FOLDER_DEPTH_CHAR + 1, full_path_backup_dir);
     if (pal_result != PAL_SUCCESS)
     {
@@ -876,18 +974,6 @@ esfs_result_e esfs_factory_reset(void) {
             goto errorExit;
         }
     }
-    else
-    {
-        // delete the files in working dir
-        pal_result = pal_fsRmFiles(working_dir_path);
-        // the use case is that esfs folder may not exist
-        if ((pal_result != PAL_SUCCESS) && (pal_result != PAL_ERR_FS_NO_FILE) && (pal_result != PAL_ERR_FS_NO_PATH))
-        {
-            tr_err("esfs_factory_reset() - pal_fsRmFiles(ESFS_WORKING_DIRECTORY) failed with pal_status = 0x%x", (unsigned int)pal_result);
-            result = ESFS_ERROR;
-            goto errorExit;
-        }
-    }
 
 
 
@@ -900,11 +986,13 @@ esfs_result_e esfs_factory_reset(void) {
     }
     strncat(full_path_backup_dir, "/" ESFS_BACKUP_DIRECTORY, sizeof(ESFS_BACKUP_DIRECTORY));
 
-    pal_result = pal_fsCpFolder(full_path_backup_dir, working_dir_path);
+    // The backup replaces the files of the working folder, in one step where the platform can swap folders,
+    // so an interrupted reset leaves either the old or the factory files until it is run again
+    pal_result = pal_fsReplaceFolder(full_path_backup_dir, working_dir_path);
 
     if ((pal_result != PAL_SUCCESS) && (pal_result != PAL_ERR_FS_NO_FILE))
     {
-        tr_err("esfs_factory_reset() - pal_fsCpFolder() from backup to working failed with pal_status = 0x%x", (unsigned int)pal_result);
+        tr_err("esfs_factory_reset() - pal_fsReplaceFolder() from backup to working failed with pal_status = 0x%x", (unsigned int)pal_result);
         result = ESFS_ERROR;
         goto errorExit;
     }
@@ -919,9 +1007,11 @@ esfs_result_e esfs_factory_reset(void) {
         goto errorExit;
      }
 
+    add_performance_mark("esfs_factory_reset", ESFS_PERFORMANCE_END);
     return ESFS_SUCCESS;
 
 errorExit:
+    add_performance_mark("esfs_factory_reset", ESFS_PERFORMANCE_END);
     return result;
 }
 // Internal function to check the files validity.
@@ -1035,10 +1125,23 @@ static esfs_result_e esfs_check_cmac(esfs_file_t *file_handle)
 
     palCMACHandle_t signature_ctx;
     uint16_t cmac_created = 0;
+#if ESFS_VERIFIED_CACHE_SIZE > 0
+    pal_fsFileStat_t stat;
+    bool stat_valid = false;
+#endif
 
     // Verify that the at least 2*ESFS_CMAC_SIZE_IN_BYTES bytes
     PAL_ASSERT_STATIC(sizeof(buffer) >= (2*ESFS_CMAC_SIZE_IN_BYTES));
 
+#if ESFS_VERIFIED_CACHE_SIZE > 0
+    // A file that did not change since it was verified is accepted as is, the position is left untouched
+    stat_valid = (pal_fsFstat(&file_handle->file, &stat) == PAL_SUCCESS);
+    if (stat_valid && esfs_verified_cache_check(file_handle->short_file_name, &stat))
+    {
+        return ESFS_SUCCESS;
+    }
+#endif
+
     // Get current position
     res = pal_fsFtell(&file_handle->file, &initial_pos);
     if(res != PAL_SUCCESS)
@@ -1150,6 +1253,13 @@ static esfs_result_e esfs_check_cmac(esfs_file_t *file_handle)
     }
     else
     {
+#if ESFS_VERIFIED_CACHE_SIZE > 0
+        // The status was taken before reading, a change made while verifying gives another status
+        if (stat_valid)
+        {
+            esfs_verified_cache_insert(file_handle->short_file_name, &stat);
+        }
+#endif
         return ESFS_SUCCESS;
     }
 errorExit:
@@ -1653,6 +1763,7 @@ esfs_result_e esfs_create(const uint8_t *name, size_t name_length, const esfs_tl
         goto errorExit;
     }
     strncat(file_full_path, file_handle->short_file_name, ESFS_QUALIFIED_FILE_NAME_LENGTH - 1);
+    esfs_verified_cache_remove(file_handle->short_file_name);
 
     // Check if the file exists in esfs working directory
     res = pal_fsFopen(file_full_path, PAL_FS_FLAG_READWRITEEXCLUSIVE, &file_handle->file);
@@ -1840,6 +1951,7 @@ esfs_result_e esfs_open(const uint8_t *name, size_t name_length, uint16_t *esfs_
     int32_t file_size;
 
     tr_info("esfs_open - enter");
+    add_performance_mark("esfs_open", ESFS_PERFORMANCE_START);
     // Check parameters
     if(!file_handle || !name || name_length == 0 || name_length > ESFS_MAX_NAME_LENGTH)
     {
@@ -1896,7 +2008,9 @@ esfs_result_e esfs_open(const uint8_t *name, size_t name_length, uint16_t *esfs_
     }
 
     // Check the signature if required
+    add_performance_mark("esfs_check_cmac", ESFS_PERFORMANCE_START);
     result = esfs_check_cmac(file_handle);
+    add_performance_mark("esfs_check_cmac", ESFS_PERFORMANCE_END);
     if(result != ESFS_SUCCESS)
     {
         tr_err("esfs_open() - esfs_check_cmac() (signature) failed with status = 0x%x", result);
@@ -2031,9 +2145,11 @@ esfs_result_e esfs_open(const uint8_t *name, size_t name_length, uint16_t *esfs_
     file_handle->file_flag = ESFS_READ;
     file_handle->blob_name_length = name_length;
 
+    add_performance_mark("esfs_open", ESFS_PERFORMANCE_END);
     return ESFS_SUCCESS;
 
 errorExit:
+    add_performance_mark("esfs_open", ESFS_PERFORMANCE_END);
     if(file_opened)
     {
         pal_fsFclose(&file_handle->file);
@@ -2292,6 +2408,7 @@ esfs_result_e esfs_close(esfs_file_t *file_handle)
     esfs_result_e result = ESFS_ERROR;
 
     tr_info("esfs_close - enter");
+    add_performance_mark("esfs_close", ESFS_PERFORMANCE_START);
     if(esfs_validate(file_handle) != ESFS_SUCCESS)
     {
         tr_err("esfs_close() failed with bad parameters");
@@ -2395,8 +2512,10 @@ esfs_result_e esfs_close(esfs_file_t *file_handle)
         }
     }
 
+    add_performance_mark("esfs_close", ESFS_PERFORMANCE_END);
     return ESFS_SUCCESS;
 errorExit:
+    add_performance_mark("esfs_close", ESFS_PERFORMANCE_END);
     return result;
 }
 
@@ -2422,6 +2541,7 @@ esfs_result_e esfs_delete(const uint8_t *name, size_t name_length)
         goto errorExit;
     }
     tr_info("esfs_delete %s", short_file_name);
+    esfs_verified_cache_remove(short_file_name);
 
     pal_result = pal_fsGetMountPoint(PAL_FS_PARTITION_PRIMARY, PAL_MAX_FOLDER_DEPTH_CHAR + 1, working_dir_path);
     if (pal_result != PAL_SUCCESS)
@@ -2580,3 +2700,5 @@ esfs_result_e esfs_read_meta_data(esfs_file_t *file_handle, uint32_t index, esfs
 errorExit:
     return result;
 }
+
+#endif // ESFS_LOG_STORE
@@ -0,0 +1,1889 @@
+/*
+ * Copyright (c) 2017 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Log-structured ESFS backend, selected by defining ESFS_LOG_STORE. It implements the API of esfs.h on top of
+// a single container instead of one file per item:
+//
+// - The working store is an append-only log of records. Each record holds the blob name, the meta data and the
+//   data of one file (or marks a file as deleted) and ends with a CMAC that is chained to the CMAC of the
+//   previous record. A record only becomes part of the store once its CMAC is written, so a torn write at the
+//   end of the log is dropped when the log is scanned at esfs_init(). A record that does not verify ends the log, so
+//   a corrupted record only loses itself and the records after it.
+// - An in-memory index maps the name of every live file to its record, so esfs_open() reads a single record.
+// - The log lives in one of two slot files. Compaction and factory reset write a new log into the other slot
+//   and commit it by writing its header, which carries a higher generation number, last. The valid slot with
+//   the highest generation is the working store, so both operations are atomic with respect to power loss.
+// - Files created with ESFS_FACTORY_VAL are also appended to a factory snapshot log in the backup directory,
+//   which esfs_factory_reset() swaps in as the new working log. The factory log has two slot files of its own, so
+//   it is compacted the same way when files are created again with ESFS_FACTORY_VAL.
+
+#ifdef ESFS_LOG_STORE
+
+// ----------------------------------------------------------- Includes -----------------------------------------------------------
+
+
+#include "esfs.h"
+#include "esfs_performance.h"
+
+#include "mbed-trace/mbed_trace.h"
+
+#include "pal_rtos.h"
+#include "pal_types.h"
+#include "pal_Crypto.h"
+
+#include <string.h>  // For memcmp, memcpy and strncat
+#include <stddef.h>  // For offsetof
+#include <inttypes.h>  // For PRIu32
+
+
+
+// --------------------------------------------------------- Definitions ----------------------------------------------------------
+
+
+#define TRACE_GROUP                     "esfs"  // Maximum 4 characters
+
+#define ESFS_WORKING_DIRECTORY          "WORKING"
+#define ESFS_BACKUP_DIRECTORY           "BACKUP"
+#define ESFS_LOG_SLOT_0_FILE            "esfs0.log"
+#define ESFS_LOG_SLOT_1_FILE            "esfs1.log"
+#define ESFS_LOG_FACTORY_SLOT_0_FILE    "esfsfr0.log"
+#define ESFS_LOG_FACTORY_SLOT_1_FILE    "esfsfr1.log"
+
+// Maximum number of files in the store. Each one takes an index entry of 16 bytes of RAM, in the index of the
+// working log and in the index of the factory log.
+#ifndef ESFS_LOG_MAX_FILES
+#define ESFS_LOG_MAX_FILES              (64)
+#endif
+
+// A log is compacted when it is larger than ESFS_LOG_COMPACTION_MIN_SIZE bytes and less than
+// ESFS_LOG_COMPACTION_LIVE_PERCENT percent of it belongs to live files.
+#ifndef ESFS_LOG_COMPACTION_MIN_SIZE
+#define ESFS_LOG_COMPACTION_MIN_SIZE    (16 * 1024)
+#endif
+
+#ifndef ESFS_LOG_COMPACTION_LIVE_PERCENT
+#define ESFS_LOG_COMPACTION_LIVE_PERCENT (50)
+#endif
+
+// We choose a size that does not take up too much stack, but minimizes the number of reads.
+#define ESFS_READ_CHUNK_SIZE_IN_BYTES   (64)
+
+#define ESFS_MAX_NAME_LENGTH            (1024)
+
+#define ESFS_BITS_IN_BYTE               (8)
+#define ESFS_AES_BLOCK_SIZE_BYTES       (16)
+#define ESFS_AES_IV_SIZE_BYTES          (16)
+#define ESFS_AES_COUNTER_INDEX_IN_IV    ESFS_AES_NONCE_SIZE_BYTES
+#define ESFS_AES_KEY_SIZE_BYTES         (16)
+#define ESFS_AES_KEY_SIZE_BITS          (ESFS_AES_KEY_SIZE_BYTES * ESFS_BITS_IN_BYTE)
+
+#define ESFS_CMAC_SIZE_IN_BYTES         (16)
+
+// This should be incremented when the log format changes
+#define ESFS_LOG_FORMAT_VERSION         (1)
+
+#define ESFS_LOG_MAGIC                  (0x474c5345)    // "ESLG"
+#define ESFS_LOG_RECORD_MAGIC           (0x43455245)    // "EREC"
+
+#define ESFS_LOG_RECORD_PUT             (1)
+#define ESFS_LOG_RECORD_DELETE          (2)
+
+#define ESFS_LOG_PATH_SIZE (PAL_MAX_FOLDER_DEPTH_CHAR + 1 + PAL_MAX(sizeof(ESFS_BACKUP_DIRECTORY), sizeof(ESFS_WORKING_DIRECTORY)) + sizeof(ESFS_LOG_FACTORY_SLOT_0_FILE))
+
+// Header at the start of a log file. The CMAC covers the fields before it and seeds the CMAC chain of the records.
+typedef struct esfs_log_header
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t reserved;
+    uint32_t generation;
+    uint8_t cmac[ESFS_CMAC_SIZE_IN_BYTES];
+} esfs_log_header_t;
+
+// A record is this header followed by the name, the meta data TLV table, the meta data values, the data and a CMAC
+// over the previous CMAC of the chain, the bytes following this header up to the CMAC, and finally this header.
+// The meta data values and the data are encrypted as a single AES-CTR stream if ESFS_ENCRYPTED is set.
+typedef struct esfs_log_record
+{
+    uint32_t magic;
+    uint16_t type;
+    uint16_t esfs_mode;
+    uint16_t name_length;
+    uint16_t meta_data_qty;
+    uint32_t meta_data_size;    // Size of the meta data values
+    uint32_t data_size;
+    uint8_t nonce[ESFS_AES_NONCE_SIZE_BYTES];
+} esfs_log_record_t;
+
+typedef struct esfs_log_index_entry
+{
+    uint32_t name_hash;
+    uint32_t offset;            // Offset of the record in the working log
+    uint32_t size;              // Size of the record, including its CMAC
+    uint16_t name_length;
+} esfs_log_index_entry_t;
+
+typedef struct esfs_log_index
+{
+    esfs_log_index_entry_t entries[ESFS_LOG_MAX_FILES];
+    uint16_t count;
+    uint32_t live_bytes;        // Size of the records of the live files
+} esfs_log_index_t;
+
+typedef struct esfs_log
+{
+    palFileDescriptor_t file;
+    bool is_open;
+    bool is_factory;            // The factory snapshot log, else the working log
+    uint8_t slot;
+    uint32_t generation;
+    uint32_t size;              // Physical size of the file
+    uint32_t tail;              // Offset after the last committed record
+    uint8_t chain[ESFS_CMAC_SIZE_IN_BYTES];    // CMAC of the last committed record
+} esfs_log_t;
+
+static bool esfs_initialize = false;
+
+static esfs_log_t esfs_working_log;
+static esfs_log_index_t esfs_working_index;
+// Only used while a record is appended to the factory log
+static esfs_log_index_t esfs_factory_index;
+static uint16_t esfs_log_open_handles = 0;
+static bool esfs_log_writer_active = false;
+
+
+
+// -------------------------------------------------- Functions Implementation ----------------------------------------------------
+
+
+//      ---------------------------------------------------------------
+//                              Helper Functions
+//      ---------------------------------------------------------------
+
+
+// Validate that a file handle has been initialized by create or open.
+static esfs_result_e esfs_validate(esfs_file_t *file_handle)
+{
+    if(file_handle && file_handle->blob_name_length > 0)
+    {
+        return ESFS_SUCCESS;
+    }
+    else
+    {
+        return ESFS_ERROR;
+    }
+}
+
+static esfs_result_e esfs_log_path(pal_fsStorageID_t partition, const char *dir_and_file, char *path)
+{
+    palStatus_t pal_result = pal_fsGetMountPoint(partition, PAL_MAX_FOLDER_DEPTH_CHAR + 1, path);
+    if (pal_result != PAL_SUCCESS)
+    {
+        tr_err("esfs_log_path() - pal_fsGetMountPoint() failed with pal_status = 0x%x", (unsigned int)pal_result);
+        return ESFS_ERROR;
+    }
+    strncat(path, dir_and_file, ESFS_LOG_PATH_SIZE - strlen(path) - 1);
+    return ESFS_SUCCESS;
+}
+
+static esfs_result_e esfs_log_slot_path(bool is_factory, uint8_t slot, char *path)
+{
+    if (is_factory)
+    {
+        return esfs_log_path(PAL_FS_PARTITION_SECONDARY,
+                             slot ? "/" ESFS_BACKUP_DIRECTORY "/" ESFS_LOG_FACTORY_SLOT_1_FILE : "/" ESFS_BACKUP_DIRECTORY "/" ESFS_LOG_FACTORY_SLOT_0_FILE,
+                             path);
+    }
+    return esfs_log_path(PAL_FS_PARTITION_PRIMARY,
+                         slot ? "/" ESFS_WORKING_DIRECTORY "/" ESFS_LOG_SLOT_1_FILE : "/" ESFS_WORKING_DIRECTORY "/" ESFS_LOG_SLOT_0_FILE,
+                         path);
+}
+
+static esfs_result_e esfs_log_read(esfs_log_t *log, uint32_t offset, void *buffer, size_t length)
+{
+    size_t num_bytes = 0;
+    palStatus_t res = pal_fsFseek(&log->file, (int32_t)offset, PAL_FS_OFFSET_SEEKSET);
+    if (res == PAL_SUCCESS)
+    {
+        res = pal_fsFread(&log->file, buffer, length, &num_bytes);
+    }
+    if (res != PAL_SUCCESS || num_bytes != length)
+    {
+        tr_err("esfs_log_read() failed with pal result = 0x%x and num_bytes bytes = %zu", (unsigned int)res, num_bytes);
+        return ESFS_ERROR;
+    }
+    return ESFS_SUCCESS;
+}
+
+static esfs_result_e esfs_log_write(esfs_log_t *log, uint32_t offset, const void *buffer, size_t length)
+{
+    size_t num_bytes = 0;
+    palStatus_t res = pal_fsFseek(&log->file, (int32_t)offset, PAL_FS_OFFSET_SEEKSET);
+    if (res == PAL_SUCCESS)
+    {
+        res = pal_fsFwrite(&log->file, buffer, length, &num_bytes);
+    }
+    if (res != PAL_SUCCESS || num_bytes != length)
+    {
+        tr_err("esfs_log_write() failed with pal result = 0x%x and num_bytes bytes = %zu", (unsigned int)res, num_bytes);
+        return ESFS_ERROR;
+    }
+    if (offset + length > log->size)
+    {
+        log->size = offset + length;
+    }
+    return ESFS_SUCCESS;
+}
+
+static esfs_result_e esfs_log_open_file(esfs_log_t *log, const char *path, pal_fsFileMode_t mode)
+{
+    int32_t size;
+    palStatus_t res = pal_fsFopen(path, mode, &log->file);
+    if (res != PAL_SUCCESS)
+    {
+        return (res == PAL_ERR_FS_NO_FILE) ? ESFS_NOT_EXISTS : ESFS_ERROR;
+    }
+    log->is_open = true;
+
+    res = pal_fsFseek(&log->file, 0, PAL_FS_OFFSET_SEEKEND);
+    if (res == PAL_SUCCESS)
+    {
+        res = pal_fsFtell(&log->file, &size);
+    }
+    if (res != PAL_SUCCESS)
+    {
+        tr_err("esfs_log_open_file() - failed to get the size of %s with pal_status = 0x%x", path, (unsigned int)res);
+        return ESFS_ERROR;
+    }
+    log->size = (uint32_t)size;
+    return ESFS_SUCCESS;
+}
+
+static void esfs_log_close_file(esfs_log_t *log)
+{
+    if (log->is_open)
+    {
+        (void)pal_fsFclose(&log->file);
+        log->is_open = false;
+    }
+}
+
+// Push the bytes written so far to the storage media.
+static esfs_result_e esfs_log_sync(esfs_log_t *log)
+{
+    palStatus_t res = pal_fsFflush(&log->file);
+    if (res != PAL_SUCCESS)
+    {
+        tr_err("esfs_log_sync() - pal_fsFflush() failed with pal_status = 0x%x", (unsigned int)res);
+        return ESFS_ERROR;
+    }
+    return ESFS_SUCCESS;
+}
+
+// Check whether the bytes of the log from offset up to end are all zero.
+static esfs_result_e esfs_log_is_zero(esfs_log_t *log, uint32_t offset, uint32_t end, bool *is_zero)
+{
+    uint8_t buffer[ESFS_READ_CHUNK_SIZE_IN_BYTES];
+
+    *is_zero = true;
+    while (offset < end)
+    {
+        size_t chunk = PAL_MIN(sizeof(buffer), end - offset);
+        if (esfs_log_read(log, offset, buffer, chunk) != ESFS_SUCCESS)
+        {
+            return ESFS_ERROR;
+        }
+        for (size_t i = 0; i < chunk; i++)
+        {
+            if (buffer[i] != 0)
+            {
+                *is_zero = false;
+                return ESFS_SUCCESS;
+            }
+        }
+        offset += chunk;
+    }
+    return ESFS_SUCCESS;
+}
+
+// Zero the bytes left after the tail by a record that was never committed, so that the only thing that can follow
+// the last committed record is the record being written. This lets esfs_log_scan() tell a torn final record from a
+// corrupted one, and drops the records that follow a corrupted one.
+static esfs_result_e esfs_log_clear_tail(esfs_log_t *log)
+{
+    uint8_t buffer[ESFS_READ_CHUNK_SIZE_IN_BYTES];
+    uint32_t end = log->size;
+
+    if (log->tail >= end)
+    {
+        return ESFS_SUCCESS;
+    }
+    memset(buffer, 0, sizeof(buffer));
+    for (uint32_t offset = log->tail; offset < end; offset += sizeof(buffer))
+    {
+        if (esfs_log_write(log, offset, buffer, PAL_MIN(sizeof(buffer), end - offset)) != ESFS_SUCCESS)
+        {
+            return ESFS_ERROR;
+        }
+    }
+    return esfs_log_sync(log);
+}
+
+static esfs_result_e esfs_log_cmac_start(palCMACHandle_t *cmac_ctx)
+{
+    uint8_t key[ESFS_CMAC_SIZE_IN_BYTES];
+    palStatus_t res = pal_osGetDeviceKey128Bit(palOsStorageSignatureKey, key, ESFS_CMAC_SIZE_IN_BYTES);
+    if (res == PAL_SUCCESS)
+    {
+        res = pal_CMACStart(cmac_ctx, key, 128, PAL_CIPHER_ID_AES);
+    }
+    if (res != PAL_SUCCESS)
+    {
+        tr_err("esfs_log_cmac_start() failed with pal_status = 0x%x", (unsigned int)res);
+        return ESFS_ERROR;
+    }
+    return ESFS_SUCCESS;
+}
+
+static esfs_result_e esfs_log_cmac_finish(palCMACHandle_t *cmac_ctx, uint8_t *cmac)
+{
+    size_t len = 0;
+    palStatus_t res = pal_CMACFinish(cmac_ctx, cmac, &len);
+    if (res != PAL_SUCCESS || len != ESFS_CMAC_SIZE_IN_BYTES)
+    {
+        tr_err("esfs_log_cmac_finish() - pal_CMACFinish() failed with pal_status = 0x%x", (unsigned int)res);
+        return ESFS_ERROR;
+    }
+    return ESFS_SUCCESS;
+}
+
+static esfs_result_e esfs_log_header_init(esfs_log_header_t *header, uint32_t generation)
+{
+    palCMACHandle_t cmac_ctx;
+    esfs_result_e result;
+
+    memset(header, 0, sizeof(*header));
+    header->magic = ESFS_LOG_MAGIC;
+    header->version = ESFS_LOG_FORMAT_VERSION;
+    header->generation = generation;
+
+    result = esfs_log_cmac_start(&cmac_ctx);
+    if (result != ESFS_SUCCESS)
+    {
+        return result;
+    }
+    if (pal_CMACUpdate(cmac_ctx, (const unsigned char *)header, offsetof(esfs_log_header_t, cmac)) != PAL_SUCCESS)
+    {
+        (void)esfs_log_cmac_finish(&cmac_ctx, header->cmac);
+        return ESFS_ERROR;
+    }
+    return esfs_log_cmac_finish(&cmac_ctx, header->cmac);
+}
+
+// Read and check the header of an open log. On success the log is positioned before its first record.
+static esfs_result_e esfs_log_header_load(esfs_log_t *log)
+{
+    esfs_log_header_t header;
+    esfs_log_header_t expected;
+
+    if (log->size < sizeof(header) || esfs_log_read(log, 0, &header, sizeof(header)) != ESFS_SUCCESS)
+    {
+        return ESFS_ERROR;
+    }
+    if (header.magic != ESFS_LOG_MAGIC)
+    {
+        return ESFS_ERROR;
+    }
+    if (header.version != ESFS_LOG_FORMAT_VERSION)
+    {
+        return ESFS_INVALID_FILE_VERSION;
+    }
+    if (esfs_log_header_init(&expected, header.generation) != ESFS_SUCCESS)
+    {
+        return ESFS_ERROR;
+    }
+    if (memcmp(expected.cmac, header.cmac, ESFS_CMAC_SIZE_IN_BYTES) != 0)
+    {
+        return ESFS_CMAC_DOES_NOT_MATCH;
+    }
+    log->generation = header.generation;
+    log->tail = sizeof(header);
+    memcpy(log->chain, header.cmac, ESFS_CMAC_SIZE_IN_BYTES);
+    return ESFS_SUCCESS;
+}
+
+// Encrypt / decrypt with AES-CTR at the given position of the encrypted stream of a record.
+// The IV is laid out as in the per-file backend: the nonce followed by the big endian block counter.
+static esfs_result_e esfs_log_crypt(palAesHandle_t aes_ctx, const uint8_t *nonce, uint32_t position, const uint8_t *buf_in, uint8_t *buf_out, size_t len_bytes)
+{
+    uint8_t block_in[ESFS_AES_BLOCK_SIZE_BYTES];
+    uint8_t block_out[ESFS_AES_BLOCK_SIZE_BYTES];
+    uint8_t iv[ESFS_AES_IV_SIZE_BYTES];
+
+    while (len_bytes > 0)
+    {
+        uint32_t counter = position / ESFS_AES_BLOCK_SIZE_BYTES;
+        size_t offset = position % ESFS_AES_BLOCK_SIZE_BYTES;
+        size_t chunk = PAL_MIN(ESFS_AES_BLOCK_SIZE_BYTES - offset, len_bytes);
+        int i;
+
+        memcpy(iv, nonce, ESFS_AES_NONCE_SIZE_BYTES);
+        memset(iv + ESFS_AES_COUNTER_INDEX_IN_IV, 0, ESFS_AES_IV_SIZE_BYTES - ESFS_AES_COUNTER_INDEX_IN_IV);
+        for (i = ESFS_AES_IV_SIZE_BYTES - 1; i >= ESFS_AES_COUNTER_INDEX_IN_IV; i--)
+        {
+            iv[i] = (uint8_t)counter;
+            counter >>= 8;
+        }
+
+        memset(block_in, 0, sizeof(block_in));
+        memcpy(block_in + offset, buf_in, chunk);
+        if (pal_aesCTRWithZeroOffset(aes_ctx, block_in, block_out, ESFS_AES_BLOCK_SIZE_BYTES, iv) != PAL_SUCCESS)
+        {
+            tr_err("esfs_log_crypt() - pal_aesCTRWithZeroOffset() failed");
+            return ESFS_ERROR;
+        }
+        memcpy(buf_out, block_out + offset, chunk);
+
+        buf_in += chunk;
+        buf_out += chunk;
+        position += chunk;
+        len_bytes -= chunk;
+    }
+    return ESFS_SUCCESS;
+}
+
+static esfs_result_e esfs_log_aes_init(esfs_file_t *file_handle)
+{
+    uint8_t aes_key[ESFS_AES_KEY_SIZE_BYTES] = {0};
+    palStatus_t res = pal_initAes(&file_handle->aes_ctx);
+    if (res != PAL_SUCCESS)
+    {
+        tr_err("esfs_log_aes_init() - pal_initAes() failed with pal status 0x%x", (unsigned int)res);
+        return ESFS_ERROR;
+    }
+    // Note: On each call, PAL should return the same 128 bits key
+    res = pal_osGetDeviceKey128Bit(palOsStorageEncryptionKey, aes_key, ESFS_AES_KEY_SIZE_BYTES);
+    if (res == PAL_SUCCESS)
+    {
+        res = pal_setAesKey(file_handle->aes_ctx, aes_key, ESFS_AES_KEY_SIZE_BITS, PAL_KEY_TARGET_ENCRYPTION);
+    }
+    if (res != PAL_SUCCESS)
+    {
+        tr_err("esfs_log_aes_init() - failed to set the AES key with pal status 0x%x", (unsigned int)res);
+        pal_freeAes(&file_handle->aes_ctx);
+        return ESFS_ERROR;
+    }
+    return ESFS_SUCCESS;
+}
+
+static uint32_t esfs_log_record_body_size(const esfs_log_record_t *record)
+{
+    return record->name_length + record->meta_data_qty * sizeof(esfs_tlvItem_t) + record->meta_data_size + record->data_size;
+}
+
+// Offset of the first encrypted byte (the meta data values) of the record of an open file.
+static uint32_t esfs_log_encrypted_offset(const esfs_file_t *file_handle)
+{
+    return file_handle->record_offset + sizeof(esfs_log_record_t) + file_handle->blob_name_length +
+           file_handle->tlv_properties.number_of_items * sizeof(esfs_tlvItem_t);
+}
+
+static uint32_t esfs_log_meta_data_size(const esfs_file_t *file_handle)
+{
+    uint32_t size = 0;
+    for (int i = 0; i < file_handle->tlv_properties.number_of_items; i++)
+    {
+        size += file_handle->tlv_properties.tlv_items[i].length_in_bytes;
+    }
+    return size;
+}
+
+// Verify the record at the given offset of src against the CMAC chain value that precedes it.
+// If dst is not NULL, the record is also appended to dst and chained to its last record.
+// On success record holds the record header, record_size its total size and cmac its CMAC in src.
+// ESFS_NOT_EXISTS is returned if there is no complete record at offset, ESFS_CMAC_DOES_NOT_MATCH if the record is
+// complete but its CMAC is wrong (record_size is set in that case), ESFS_INTERNAL_ERROR if the record is valid but
+// could not be appended to dst, and ESFS_ERROR if src could not be read.
+static esfs_result_e esfs_log_process_record(esfs_log_t *src, uint32_t offset, const uint8_t *chain,
+                                             esfs_log_record_t *record, uint32_t *record_size, uint8_t *cmac,
+                                             esfs_log_t *dst)
+{
+    uint8_t buffer[ESFS_READ_CHUNK_SIZE_IN_BYTES];
+    uint8_t stored_cmac[ESFS_CMAC_SIZE_IN_BYTES];
+    palCMACHandle_t src_ctx;
+    palCMACHandle_t dst_ctx;
+    bool src_ctx_created = false;
+    bool dst_ctx_created = false;
+    esfs_result_e result = ESFS_ERROR;
+    uint32_t body_size;
+    uint32_t pos;
+    size_t len;
+
+    if (offset + sizeof(*record) + ESFS_CMAC_SIZE_IN_BYTES > src->size)
+    {
+        return ESFS_NOT_EXISTS;
+    }
+    if (esfs_log_read(src, offset, record, sizeof(*record)) != ESFS_SUCCESS)
+    {
+        return ESFS_ERROR;
+    }
+    if (record->magic != ESFS_LOG_RECORD_MAGIC ||
+        (record->type != ESFS_LOG_RECORD_PUT && record->type != ESFS_LOG_RECORD_DELETE) ||
+        record->name_length == 0 || record->name_length > ESFS_MAX_NAME_LENGTH ||
+        record->meta_data_qty > ESFS_MAX_TYPE_LENGTH_VALUES)
+    {
+        return ESFS_NOT_EXISTS;
+    }
+    body_size = esfs_log_record_body_size(record);
+    if (body_size > src->size - offset - sizeof(*record) - ESFS_CMAC_SIZE_IN_BYTES)
+    {
+        return ESFS_NOT_EXISTS;
+    }
+    *record_size = sizeof(*record) + body_size + ESFS_CMAC_SIZE_IN_BYTES;
+
+    if (esfs_log_cmac_start(&src_ctx) != ESFS_SUCCESS)
+    {
+        goto errorExit;
+    }
+    src_ctx_created = true;
+    if (pal_CMACUpdate(src_ctx, chain, ESFS_CMAC_SIZE_IN_BYTES) != PAL_SUCCESS)
+    {
+        goto errorExit;
+    }
+    if (dst)
+    {
+        if (esfs_log_cmac_start(&dst_ctx) != ESFS_SUCCESS)
+        {
+            goto errorExit;
+        }
+        dst_ctx_created = true;
+        if (pal_CMACUpdate(dst_ctx, dst->chain, ESFS_CMAC_SIZE_IN_BYTES) != PAL_SUCCESS)
+        {
+            goto errorExit;
+        }
+    }
+
+    for (pos = 0; pos < body_size; pos += sizeof(buffer))
+    {
+        size_t chunk = PAL_MIN(sizeof(buffer), body_size - pos);
+        if (esfs_log_read(src, offset + sizeof(*record) + pos, buffer, chunk) != ESFS_SUCCESS ||
+            pal_CMACUpdate(src_ctx, buffer, chunk) != PAL_SUCCESS)
+        {
+            goto errorExit;
+        }
+        if (dst && (esfs_log_write(dst, dst->tail + sizeof(*record) + pos, buffer, chunk) != ESFS_SUCCESS ||
+                    pal_CMACUpdate(dst_ctx, buffer, chunk) != PAL_SUCCESS))
+        {
+            result = ESFS_INTERNAL_ERROR;
+            goto errorExit;
+        }
+    }
+
+    if (pal_CMACUpdate(src_ctx, (const unsigned char *)record, sizeof(*record)) != PAL_SUCCESS)
+    {
+        goto errorExit;
+    }
+    src_ctx_created = false;
+    if (esfs_log_cmac_finish(&src_ctx, cmac) != ESFS_SUCCESS ||
+        esfs_log_read(src, offset + sizeof(*record) + body_size, stored_cmac, ESFS_CMAC_SIZE_IN_BYTES) != ESFS_SUCCESS)
+    {
+        goto errorExit;
+    }
+    if (memcmp(cmac, stored_cmac, ESFS_CMAC_SIZE_IN_BYTES) != 0)
+    {
+        result = ESFS_CMAC_DOES_NOT_MATCH;
+        goto errorExit;
+    }
+
+    if (dst)
+    {
+        uint8_t dst_cmac[ESFS_CMAC_SIZE_IN_BYTES];
+
+        result = ESFS_INTERNAL_ERROR;
+        if (pal_CMACUpdate(dst_ctx, (const unsigned char *)record, sizeof(*record)) != PAL_SUCCESS)
+        {
+            goto errorExit;
+        }
+        dst_ctx_created = false;
+        if (esfs_log_cmac_finish(&dst_ctx, dst_cmac) != ESFS_SUCCESS ||
+            esfs_log_write(dst, dst->tail, record, sizeof(*record)) != ESFS_SUCCESS ||
+            esfs_log_write(dst, dst->tail + sizeof(*record) + body_size, dst_cmac, ESFS_CMAC_SIZE_IN_BYTES) != ESFS_SUCCESS)
+        {
+            goto errorExit;
+        }
+        dst->tail += *record_size;
+        memcpy(dst->chain, dst_cmac, ESFS_CMAC_SIZE_IN_BYTES);
+    }
+
+    return ESFS_SUCCESS;
+
+errorExit:
+    if (src_ctx_created)
+    {
+        (void)pal_CMACFinish(&src_ctx, buffer, &len);
+    }
+    if (dst_ctx_created)
+    {
+        (void)pal_CMACFinish(&dst_ctx, buffer, &len);
+    }
+    return result;
+}
+
+static uint32_t esfs_log_name_hash(const uint8_t *name, size_t name_length)
+{
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < name_length; i++)
+    {
+        hash = (hash ^ name[i]) * 16777619u;
+    }
+    return hash;
+}
+
+// Compare the name of the record of log at record_offset with a name given either in memory (name) or, when name is
+// NULL, as the name of the record of log at name_offset. Both names are name_length bytes long.
+static esfs_result_e esfs_log_name_equals(esfs_log_t *log, uint32_t record_offset, const uint8_t *name, uint32_t name_offset, size_t name_length, bool *equal)
+{
+    uint8_t buffer[ESFS_READ_CHUNK_SIZE_IN_BYTES / 2];
+    uint8_t other[ESFS_READ_CHUNK_SIZE_IN_BYTES / 2];
+
+    *equal = false;
+    for (size_t pos = 0; pos < name_length; pos += sizeof(buffer))
+    {
+        size_t chunk = PAL_MIN(sizeof(buffer), name_length - pos);
+        if (esfs_log_read(log, record_offset + sizeof(esfs_log_record_t) + pos, buffer, chunk) != ESFS_SUCCESS)
+        {
+            return ESFS_ERROR;
+        }
+        if (!name && esfs_log_read(log, name_offset + sizeof(esfs_log_record_t) + pos, other, chunk) != ESFS_SUCCESS)
+        {
+            return ESFS_ERROR;
+        }
+        if (memcmp(buffer, name ? name + pos : other, chunk) != 0)
+        {
+            return ESFS_SUCCESS;
+        }
+    }
+    *equal = true;
+    return ESFS_SUCCESS;
+}
+
+// Find the entry of the index of log for a name, in memory or in the record of log at name_offset. position is -1 if
+// there is none.
+static esfs_result_e esfs_log_index_find(esfs_log_index_t *index, esfs_log_t *log, uint32_t name_hash, const uint8_t *name, uint32_t name_offset, size_t name_length, int *position)
+{
+    bool equal;
+
+    *position = -1;
+    for (int i = 0; i < index->count; i++)
+    {
+        if (index->entries[i].name_hash == name_hash && index->entries[i].name_length == name_length)
+        {
+            if (esfs_log_name_equals(log, index->entries[i].offset, name, name_offset, name_length, &equal) != ESFS_SUCCESS)
+            {
+                return ESFS_ERROR;
+            }
+            if (equal)
+            {
+                *position = i;
+                break;
+            }
+        }
+    }
+    return ESFS_SUCCESS;
+}
+
+static void esfs_log_index_remove(esfs_log_index_t *index, int position)
+{
+    index->live_bytes -= index->entries[position].size;
+    index->entries[position] = index->entries[--index->count];
+}
+
+// Apply a committed record of log to its index.
+static esfs_result_e esfs_log_index_apply(esfs_log_index_t *index, esfs_log_t *log, const esfs_log_record_t *record, uint32_t name_hash, uint32_t offset, uint32_t size)
+{
+    int position;
+
+    if (esfs_log_index_find(index, log, name_hash, NULL, offset, record->name_length, &position) != ESFS_SUCCESS)
+    {
+        return ESFS_ERROR;
+    }
+    if (position >= 0)
+    {
+        esfs_log_index_remove(index, position);
+    }
+    if (record->type == ESFS_LOG_RECORD_PUT)
+    {
+        if (index->count >= ESFS_LOG_MAX_FILES)
+        {
+            tr_err("esfs_log_index_apply() - more than ESFS_LOG_MAX_FILES files in the log");
+            return ESFS_ERROR;
+        }
+        index->entries[index->count].name_hash = name_hash;
+        index->entries[index->count].offset = offset;
+        index->entries[index->count].size = size;
+        index->entries[index->count].name_length = record->name_length;
+        index->count++;
+        index->live_bytes += size;
+    }
+    return ESFS_SUCCESS;
+}
+
+static esfs_result_e esfs_log_record_name_hash(esfs_log_t *log, uint32_t offset, uint16_t name_length, uint32_t *name_hash)
+{
+    uint8_t buffer[ESFS_READ_CHUNK_SIZE_IN_BYTES];
+    uint32_t hash = 2166136261u;
+
+    for (size_t pos = 0; pos < name_length; pos += sizeof(buffer))
+    {
+        size_t chunk = PAL_MIN(sizeof(buffer), (size_t)name_length - pos);
+        if (esfs_log_read(log, offset + sizeof(esfs_log_record_t) + pos, buffer, chunk) != ESFS_SUCCESS)
+        {
+            return ESFS_ERROR;
+        }
+        for (size_t i = 0; i < chunk; i++)
+        {
+            hash = (hash ^ buffer[i]) * 16777619u;
+        }
+    }
+    *name_hash = hash;
+    return ESFS_SUCCESS;
+}
+
+// Walk the records of a log whose header is loaded and set its tail after the last valid one.
+// Anything after it is overwritten by the next record. Usually it is a record that was not committed: either an
+// incomplete record, whose header is only written when it is committed, or a complete record whose CMAC does not
+// match because the write was torn. Since esfs_log_clear_tail() runs before each record is written, a torn record
+// can only be followed by zeros. A record with a wrong CMAC followed by anything else is corrupted; the log is
+// truncated before it, since the CMAC chain of the records after it cannot be trusted.
+// If dst is not NULL, the valid records are appended to it, and if index is not NULL they are applied to it.
+static esfs_result_e esfs_log_scan(esfs_log_t *log, esfs_log_t *dst, esfs_log_index_t *index)
+{
+    esfs_log_record_t record;
+    uint32_t record_size;
+    uint32_t name_hash;
+    uint8_t cmac[ESFS_CMAC_SIZE_IN_BYTES];
+    bool is_zero;
+    esfs_result_e result;
+
+    for (;;)
+    {
+        result = esfs_log_process_record(log, log->tail, log->chain, &record, &record_size, cmac, dst);
+        if (result == ESFS_INTERNAL_ERROR || result == ESFS_ERROR)
+        {
+            return ESFS_ERROR;
+        }
+        if (result == ESFS_CMAC_DOES_NOT_MATCH)
+        {
+            if (esfs_log_is_zero(log, log->tail + record_size, log->size, &is_zero) != ESFS_SUCCESS)
+            {
+                return ESFS_ERROR;
+            }
+            if (!is_zero)
+            {
+                tr_err("esfs_log_scan() - the record at offset %" PRIu32 " is corrupted, the log is truncated before it", log->tail);
+            }
+        }
+        if (result != ESFS_SUCCESS)
+        {
+            if (log->tail < log->size)
+            {
+                tr_info("esfs_log_scan() - log ends with %" PRIu32 " uncommitted bytes", log->size - log->tail);
+            }
+            break;
+        }
+        if (index)
+        {
+            if (esfs_log_record_name_hash(log, log->tail, record.name_length, &name_hash) != ESFS_SUCCESS ||
+                esfs_log_index_apply(index, log, &record, name_hash, log->tail, record_size) != ESFS_SUCCESS)
+            {
+                return ESFS_ERROR;
+            }
+        }
+        log->tail += record_size;
+        memcpy(log->chain, cmac, ESFS_CMAC_SIZE_IN_BYTES);
+    }
+    return ESFS_SUCCESS;
+}
+
+static void esfs_log_index_clear(esfs_log_index_t *index)
+{
+    index->count = 0;
+    index->live_bytes = 0;
+}
+
+// Check the header of an open log. A log whose header is missing or all zero was never committed: it is a log that
+// was being created, or the target of a swap that did not complete, and holds nothing that can be lost.
+static esfs_result_e esfs_log_header_check(esfs_log_t *log, bool *is_blank)
+{
+    *is_blank = false;
+    if (log->size < sizeof(esfs_log_header_t))
+    {
+        *is_blank = true;
+        return ESFS_NOT_EXISTS;
+    }
+    if (esfs_log_is_zero(log, 0, sizeof(esfs_log_header_t), is_blank) != ESFS_SUCCESS)
+    {
+        return ESFS_ERROR;
+    }
+    return *is_blank ? ESFS_NOT_EXISTS : esfs_log_header_load(log);
+}
+
+// Open the valid slot of a log with the highest generation, with its header loaded and its tail before the first
+// record. If no slot holds a committed log, an empty log is created in slot 0 if create is set, or else
+// ESFS_NOT_EXISTS is returned. A slot that was committed but does not validate fails the open instead of being
+// replaced.
+static esfs_result_e esfs_log_load(esfs_log_t *log, bool is_factory, bool create)
+{
+    char path[ESFS_LOG_PATH_SIZE];
+    esfs_log_t slots[2];
+    int chosen = -1;
+    esfs_result_e invalid_result = ESFS_SUCCESS;
+    bool is_blank;
+    esfs_result_e result;
+
+    memset(slots, 0, sizeof(slots));
+    for (uint8_t slot = 0; slot < 2; slot++)
+    {
+        memset(path, 0, sizeof(path));
+        slots[slot].is_factory = is_factory;
+        slots[slot].slot = slot;
+        if (esfs_log_slot_path(is_factory, slot, path) != ESFS_SUCCESS)
+        {
+            return ESFS_ERROR;
+        }
+        result = esfs_log_open_file(&slots[slot], path, PAL_FS_FLAG_READONLY);
+        if (result == ESFS_SUCCESS)
+        {
+            result = esfs_log_header_check(&slots[slot], &is_blank);
+            if (result == ESFS_SUCCESS)
+            {
+                if (chosen < 0 || slots[slot].generation > slots[chosen].generation)
+                {
+                    chosen = slot;
+                }
+            }
+            else if (!is_blank)
+            {
+                tr_err("esfs_log_load() - %s is not valid (esfs result = 0x%x)", path, result);
+                invalid_result = result;
+            }
+        }
+        else if (result != ESFS_NOT_EXISTS)
+        {
+            tr_err("esfs_log_load() - failed to open %s", path);
+            invalid_result = ESFS_ERROR;
+        }
+        esfs_log_close_file(&slots[slot]);
+    }
+
+    memset(path, 0, sizeof(path));
+    if (chosen < 0 && invalid_result != ESFS_SUCCESS)
+    {
+        return invalid_result;
+    }
+    if (chosen < 0)
+    {
+        esfs_log_header_t header;
+
+        if (!create)
+        {
+            return ESFS_NOT_EXISTS;
+        }
+        // First boot, or the first log was never committed
+        memset(log, 0, sizeof(*log));
+        log->is_factory = is_factory;
+        if (esfs_log_slot_path(is_factory, 0, path) != ESFS_SUCCESS ||
+            esfs_log_open_file(log, path, PAL_FS_FLAG_READWRITETRUNC) != ESFS_SUCCESS ||
+            esfs_log_header_init(&header, 1) != ESFS_SUCCESS ||
+            esfs_log_write(log, 0, &header, sizeof(header)) != ESFS_SUCCESS ||
+            esfs_log_sync(log) != ESFS_SUCCESS)
+        {
+            tr_err("esfs_log_load() - failed to create the log");
+            esfs_log_close_file(log);
+            return ESFS_ERROR;
+        }
+        log->generation = 1;
+        log->tail = sizeof(header);
+        memcpy(log->chain, header.cmac, ESFS_CMAC_SIZE_IN_BYTES);
+        return ESFS_SUCCESS;
+    }
+
+    *log = slots[chosen];
+    if (esfs_log_slot_path(is_factory, log->slot, path) != ESFS_SUCCESS ||
+        esfs_log_open_file(log, path, PAL_FS_FLAG_READWRITE) != ESFS_SUCCESS)
+    {
+        tr_err("esfs_log_load() - failed to open %s for writing", path);
+        esfs_log_close_file(log);
+        return ESFS_ERROR;
+    }
+    return ESFS_SUCCESS;
+}
+
+// Write a new log into the inactive slot of log and switch to it. The new log holds the live records of log, as
+// listed by index, if src is NULL, or else the valid records of src. The switch is committed by writing the header
+// of the new log last, since esfs_log_load() picks the valid slot with the highest generation. On success index
+// describes the new log.
+static esfs_result_e esfs_log_swap(esfs_log_t *log, esfs_log_index_t *index, esfs_log_t *src)
+{
+    char path[ESFS_LOG_PATH_SIZE] = { 0 };
+    esfs_log_header_t header;
+    esfs_log_t target;
+    esfs_log_record_t record;
+    uint32_t record_size;
+    uint8_t cmac[ESFS_CMAC_SIZE_IN_BYTES];
+    uint8_t chain[ESFS_CMAC_SIZE_IN_BYTES];
+    esfs_result_e result = ESFS_ERROR;
+
+    memset(&target, 0, sizeof(target));
+    target.is_factory = log->is_factory;
+    target.slot = log->slot ? 0 : 1;
+    if (esfs_log_slot_path(target.is_factory, target.slot, path) != ESFS_SUCCESS ||
+        esfs_log_header_init(&header, log->generation + 1) != ESFS_SUCCESS ||
+        esfs_log_open_file(&target, path, PAL_FS_FLAG_READWRITETRUNC) != ESFS_SUCCESS)
+    {
+        tr_err("esfs_log_swap() - failed to create %s", path);
+        goto errorExit;
+    }
+
+    // The header is left blank until the new log is complete
+    memset(cmac, 0, sizeof(cmac));
+    for (uint32_t pos = 0; pos < sizeof(header); pos += sizeof(cmac))
+    {
+        if (esfs_log_write(&target, pos, cmac, PAL_MIN(sizeof(cmac), sizeof(header) - pos)) != ESFS_SUCCESS)
+        {
+            goto errorExit;
+        }
+    }
+    target.generation = header.generation;
+    target.tail = sizeof(header);
+    memcpy(target.chain, header.cmac, ESFS_CMAC_SIZE_IN_BYTES);
+
+    if (src)
+    {
+        if (esfs_log_scan(src, &target, NULL) != ESFS_SUCCESS)
+        {
+            tr_err("esfs_log_swap() - failed to copy the records");
+            goto errorExit;
+        }
+    }
+    else
+    {
+        for (int i = 0; i < index->count; i++)
+        {
+            if (esfs_log_read(log, index->entries[i].offset - ESFS_CMAC_SIZE_IN_BYTES, chain, sizeof(chain)) != ESFS_SUCCESS ||
+                esfs_log_process_record(log, index->entries[i].offset, chain, &record, &record_size, cmac, &target) != ESFS_SUCCESS)
+            {
+                tr_err("esfs_log_swap() - failed to copy a live record");
+                goto errorExit;
+            }
+        }
+    }
+
+    // Flush the records before the header that commits them
+    if (esfs_log_sync(&target) != ESFS_SUCCESS ||
+        esfs_log_write(&target, 0, &header, sizeof(header)) != ESFS_SUCCESS ||
+        esfs_log_sync(&target) != ESFS_SUCCESS)
+    {
+        tr_err("esfs_log_swap() - failed to commit %s", path);
+        goto errorExit;
+    }
+
+    esfs_log_close_file(log);
+    *log = target;
+    log->tail = sizeof(header);
+    memcpy(log->chain, header.cmac, ESFS_CMAC_SIZE_IN_BYTES);
+    esfs_log_index_clear(index);
+    return esfs_log_scan(log, NULL, index);
+
+errorExit:
+    esfs_log_close_file(&target);
+    return result;
+}
+
+// Compact log if it is large and mostly made of records that were replaced or deleted. A failed compaction leaves
+// the current log in use, and is retried on the next change.
+static void esfs_log_compact_if_needed(esfs_log_t *log, esfs_log_index_t *index)
+{
+    if (log->tail > ESFS_LOG_COMPACTION_MIN_SIZE &&
+        (uint64_t)index->live_bytes * 100 < (uint64_t)log->tail * ESFS_LOG_COMPACTION_LIVE_PERCENT)
+    {
+        add_performance_mark("esfs_log_compact", ESFS_PERFORMANCE_START);
+        if (esfs_log_swap(log, index, NULL) != ESFS_SUCCESS)
+        {
+            tr_err("esfs_log_compact_if_needed() - compaction failed");
+        }
+        add_performance_mark("esfs_log_compact", ESFS_PERFORMANCE_END);
+    }
+}
+
+static void esfs_log_working_compact_if_needed(void)
+{
+    // Open files refer to the offsets of their records
+    if (esfs_log_open_handles == 0)
+    {
+        esfs_log_compact_if_needed(&esfs_working_log, &esfs_working_index);
+    }
+}
+
+// Append a committed record of the working log to the factory snapshot, creating it if needed.
+static esfs_result_e esfs_log_factory_append(uint32_t offset)
+{
+    esfs_log_t factory_log;
+    esfs_log_record_t record;
+    uint32_t record_offset;
+    uint32_t record_size;
+    uint32_t name_hash;
+    uint8_t chain[ESFS_CMAC_SIZE_IN_BYTES];
+    uint8_t cmac[ESFS_CMAC_SIZE_IN_BYTES];
+    esfs_result_e result;
+
+    result = esfs_log_load(&factory_log, true, true);
+    if (result != ESFS_SUCCESS)
+    {
+        tr_err("esfs_log_factory_append() - the factory log is not valid (esfs result = 0x%x)", result);
+        return result;
+    }
+    esfs_log_index_clear(&esfs_factory_index);
+    result = esfs_log_scan(&factory_log, NULL, &esfs_factory_index);
+    if (result == ESFS_SUCCESS)
+    {
+        result = esfs_log_clear_tail(&factory_log);
+    }
+    if (result == ESFS_SUCCESS)
+    {
+        result = esfs_log_read(&esfs_working_log, offset - ESFS_CMAC_SIZE_IN_BYTES, chain, sizeof(chain));
+    }
+    record_offset = factory_log.tail;
+    if (result == ESFS_SUCCESS)
+    {
+        result = esfs_log_process_record(&esfs_working_log, offset, chain, &record, &record_size, cmac, &factory_log);
+    }
+    if (result == ESFS_SUCCESS)
+    {
+        result = esfs_log_sync(&factory_log);
+    }
+    if (result == ESFS_SUCCESS)
+    {
+        result = esfs_log_record_name_hash(&factory_log, record_offset, record.name_length, &name_hash);
+    }
+    if (result == ESFS_SUCCESS)
+    {
+        result = esfs_log_index_apply(&esfs_factory_index, &factory_log, &record, name_hash, record_offset, record_size);
+    }
+    if (result == ESFS_SUCCESS)
+    {
+        esfs_log_compact_if_needed(&factory_log, &esfs_factory_index);
+    }
+    if (pal_fsFclose(&factory_log.file) != PAL_SUCCESS)
+    {
+        result = ESFS_ERROR;
+    }
+    return result;
+}
+
+
+
+//      ---------------------------------------------------------------
+//                              API Functions
+//      ---------------------------------------------------------------
+
+
+esfs_result_e esfs_init(void)
+{
+    char dir_path[ESFS_LOG_PATH_SIZE] = { 0 };
+    palStatus_t pal_result;
+    esfs_result_e result;
+
+    tr_info("esfs_init - enter");
+    if (esfs_initialize)
+    {
+        return ESFS_SUCCESS;
+    }
+
+    if (esfs_log_path(PAL_FS_PARTITION_PRIMARY, "/" ESFS_WORKING_DIRECTORY, dir_path) != ESFS_SUCCESS)
+    {
+        return ESFS_ERROR;
+    }
+    //Looping on first file system operation to work around IOTMORF-914 - sd-driver initialization
+    for (int i = 0; i < 100; i++)
+    {
+        pal_result = pal_fsMkDir(dir_path);
+        if ((pal_result == PAL_SUCCESS) || (pal_result == PAL_ERR_FS_NAME_ALREADY_EXIST))
+        {
+            break;
+        }
+        tr_err("esfs_init() %d", i);
+        pal_osDelay(50);
+    }
+    if ((pal_result != PAL_SUCCESS) && (pal_result != PAL_ERR_FS_NAME_ALREADY_EXIST))
+    {
+        tr_err("esfs_init() - pal_fsMkDir() for working directory failed with pal_status = 0x%x", (unsigned int)pal_result);
+        return ESFS_ERROR;
+    }
+
+    memset(dir_path, 0, sizeof(dir_path));
+    if (esfs_log_path(PAL_FS_PARTITION_SECONDARY, "/" ESFS_BACKUP_DIRECTORY, dir_path) != ESFS_SUCCESS)
+    {
+        return ESFS_ERROR;
+    }
+    pal_result = pal_fsMkDir(dir_path);
+    if ((pal_result != PAL_SUCCESS) && (pal_result != PAL_ERR_FS_NAME_ALREADY_EXIST))
+    {
+        tr_err("esfs_init() - pal_fsMkDir() for backup directory failed with pal_status = 0x%x", (unsigned int)pal_result);
+        return ESFS_ERROR;
+    }
+
+    add_performance_mark("esfs_log_load", ESFS_PERFORMANCE_START);
+    result = esfs_log_load(&esfs_working_log, false, true);
+    if (result == ESFS_SUCCESS)
+    {
+        esfs_log_index_clear(&esfs_working_index);
+        result = esfs_log_scan(&esfs_working_log, NULL, &esfs_working_index);
+        if (result != ESFS_SUCCESS)
+        {
+            esfs_log_close_file(&esfs_working_log);
+        }
+    }
+    add_performance_mark("esfs_log_load", ESFS_PERFORMANCE_END);
+    if (result != ESFS_SUCCESS)
+    {
+        tr_err("esfs_init() - loading the working log failed with esfs result = 0x%x", result);
+        return result;
+    }
+
+    esfs_log_open_handles = 0;
+    esfs_log_writer_active = false;
+    esfs_initialize = true;
+    return ESFS_SUCCESS;
+}
+
+esfs_result_e esfs_finalize(void)
+{
+    tr_info("esfs_finalize - enter");
+    esfs_log_close_file(&esfs_working_log);
+    esfs_log_index_clear(&esfs_working_index);
+    esfs_initialize = false;
+    return ESFS_SUCCESS;
+}
+
+esfs_result_e esfs_reset(void)
+{
+    char path[ESFS_LOG_PATH_SIZE] = { 0 };
+    esfs_log_t empty_log;
+    palStatus_t pal_result;
+    esfs_result_e result;
+
+    tr_info("esfs_reset - enter");
+    result = esfs_init();
+    if (result != ESFS_SUCCESS)
+    {
+        tr_err("esfs_reset() - esfs_init() failed");
+        return result;
+    }
+    if (esfs_log_open_handles != 0)
+    {
+        tr_err("esfs_reset() failed - files are open");
+        return ESFS_ERROR;
+    }
+
+    // Switch to an empty working log, then drop the factory snapshot
+    memset(&empty_log, 0, sizeof(empty_log));
+    result = esfs_log_swap(&esfs_working_log, &esfs_working_index, &empty_log);
+    if (result != ESFS_SUCCESS)
+    {
+        tr_err("esfs_reset() - esfs_log_swap() failed with esfs result = 0x%x", result);
+        return result;
+    }
+    for (uint8_t slot = 0; slot < 2; slot++)
+    {
+        memset(path, 0, sizeof(path));
+        if (esfs_log_slot_path(true, slot, path) != ESFS_SUCCESS)
+        {
+            return ESFS_ERROR;
+        }
+        pal_result = pal_fsUnlink(path);
+        if ((pal_result != PAL_SUCCESS) && (pal_result != PAL_ERR_FS_NO_FILE))
+        {
+            tr_err("esfs_reset() - pal_fsUnlink() for the factory log failed with pal_status = 0x%x", (unsigned int)pal_result);
+            return ESFS_ERROR;
+        }
+    }
+    return ESFS_SUCCESS;
+}
+
+esfs_result_e esfs_factory_reset(void)
+{
+    esfs_log_t factory_log;
+    esfs_result_e result;
+
+    tr_info("esfs_factory_reset - enter");
+    if (!esfs_initialize || esfs_log_open_handles != 0)
+    {
+        tr_err("esfs_factory_reset() failed - not initialized or files are open");
+        return ESFS_ERROR;
+    }
+
+    add_performance_mark("esfs_factory_reset", ESFS_PERFORMANCE_START);
+    result = esfs_log_load(&factory_log, true, false);
+    if (result == ESFS_NOT_EXISTS)
+    {
+        // No factory files were ever created, so the factory state is empty
+        memset(&factory_log, 0, sizeof(factory_log));
+        result = ESFS_SUCCESS;
+    }
+    if (result == ESFS_SUCCESS)
+    {
+        result = esfs_log_swap(&esfs_working_log, &esfs_working_index, &factory_log);
+        esfs_log_close_file(&factory_log);
+    }
+    add_performance_mark("esfs_factory_reset", ESFS_PERFORMANCE_END);
+
+    if (result != ESFS_SUCCESS)
+    {
+        tr_err("esfs_factory_reset() failed with esfs result = 0x%x", result);
+        return ESFS_ERROR;
+    }
+    return ESFS_SUCCESS;
+}
+
+esfs_result_e esfs_create(const uint8_t *name, size_t name_length, const esfs_tlv_item_t *meta_data, size_t meta_data_qty, uint16_t esfs_mode, esfs_file_t *file_handle)
+{
+    esfs_log_record_t record;
+    uint8_t buffer[ESFS_READ_CHUNK_SIZE_IN_BYTES];
+    uint32_t name_hash;
+    uint32_t offset;
+    uint32_t meta_data_pos;
+    uint32_t encrypted_offset;
+    bool is_aes_ctx_created = false;
+    bool is_cmac_created = false;
+    int position;
+    size_t i;
+    esfs_result_e result = ESFS_ERROR;
+
+    // Verify that the structure is always packed to six bytes, since we read and write it as a whole.
+    PAL_ASSERT_STATIC(sizeof(esfs_tlvItem_t) == 6);
+    PAL_ASSERT_STATIC(sizeof(esfs_log_record_t) == 28);
+
+    tr_info("esfs_create - enter");
+    if (!file_handle || !name || name_length == 0 || name_length > ESFS_MAX_NAME_LENGTH || meta_data_qty > ESFS_MAX_TYPE_LENGTH_VALUES)
+    {
+        tr_err("esfs_create() failed with bad parameters");
+        return ESFS_INVALID_PARAMETER;
+    }
+    memset(&record, 0, sizeof(record));
+    for (i = 0; i < meta_data_qty; i++)
+    {
+        if ((!meta_data[i].value) || (meta_data[i].length_in_bytes == 0))
+        {
+            tr_err("esfs_create() failed with bad parameters for metadata");
+            return ESFS_INVALID_PARAMETER;
+        }
+        record.meta_data_size += meta_data[i].length_in_bytes;
+    }
+    // The position of the meta data values inside the record must fit esfs_tlvItem_t
+    meta_data_pos = sizeof(record) + name_length + meta_data_qty * sizeof(esfs_tlvItem_t);
+    if (meta_data_pos + record.meta_data_size > UINT16_MAX)
+    {
+        tr_err("esfs_create() failed - meta data too large");
+        return ESFS_INVALID_PARAMETER;
+    }
+    if (!esfs_initialize)
+    {
+        tr_err("esfs_create() failed - esfs is not initialized");
+        return ESFS_ERROR;
+    }
+    if (esfs_log_writer_active)
+    {
+        tr_err("esfs_create() failed - another file is being written");
+        return ESFS_FILE_OPEN_FOR_WRITE;
+    }
+
+    name_hash = esfs_log_name_hash(name, name_length);
+    if (esfs_log_index_find(&esfs_working_index, &esfs_working_log, name_hash, name, 0, name_length, &position) != ESFS_SUCCESS)
+    {
+        return ESFS_ERROR;
+    }
+    if (position >= 0)
+    {
+        tr_err("esfs_create() - file exists");
+        return ESFS_EXISTS;
+    }
+    if (esfs_working_index.count >= ESFS_LOG_MAX_FILES)
+    {
+        tr_err("esfs_create() failed - ESFS_LOG_MAX_FILES files exist");
+        return ESFS_ERROR;
+    }
+    if (esfs_log_clear_tail(&esfs_working_log) != ESFS_SUCCESS)
+    {
+        return ESFS_ERROR;
+    }
+
+    memset(file_handle, 0, sizeof(*file_handle));
+    if ((esfs_mode & ESFS_ENCRYPTED) != 0)
+    {
+        if (esfs_log_aes_init(file_handle) != ESFS_SUCCESS)
+        {
+            goto errorExit;
+        }
+        is_aes_ctx_created = true;
+        if (pal_osRandomBuffer(file_handle->nonce, ESFS_AES_NONCE_SIZE_BYTES) != PAL_SUCCESS)
+        {
+            tr_err("esfs_create() - pal_osRandomBuffer() failed");
+            goto errorExit;
+        }
+    }
+
+    record.magic = ESFS_LOG_RECORD_MAGIC;
+    record.type = ESFS_LOG_RECORD_PUT;
+    record.esfs_mode = esfs_mode;
+    record.name_length = name_length;
+    record.meta_data_qty = meta_data_qty;
+    memcpy(record.nonce, file_handle->nonce, ESFS_AES_NONCE_SIZE_BYTES);
+
+    file_handle->record_offset = esfs_working_log.tail;
+    file_handle->esfs_mode = esfs_mode;
+    file_handle->tlv_properties.number_of_items = meta_data_qty;
+    for (i = 0; i < meta_data_qty; i++)
+    {
+        file_handle->tlv_properties.tlv_items[i].type = meta_data[i].type;
+        file_handle->tlv_properties.tlv_items[i].length_in_bytes = meta_data[i].length_in_bytes;
+        file_handle->tlv_properties.tlv_items[i].position = meta_data_pos;
+        meta_data_pos += meta_data[i].length_in_bytes;
+    }
+
+    // The record header is written on esfs_close, once the data size is known
+    if (esfs_log_cmac_start(&file_handle->signature_ctx) != ESFS_SUCCESS)
+    {
+        goto errorExit;
+    }
+    is_cmac_created = true;
+    offset = file_handle->record_offset + sizeof(record);
+    if (pal_CMACUpdate(file_handle->signature_ctx, esfs_working_log.chain, ESFS_CMAC_SIZE_IN_BYTES) != PAL_SUCCESS ||
+        pal_CMACUpdate(file_handle->signature_ctx, name, name_length) != PAL_SUCCESS ||
+        esfs_log_write(&esfs_working_log, offset, name, name_length) != ESFS_SUCCESS)
+    {
+        goto errorExit;
+    }
+    offset += name_length;
+    if (meta_data_qty > 0 &&
+        (pal_CMACUpdate(file_handle->signature_ctx, (const unsigned char *)file_handle->tlv_properties.tlv_items, meta_data_qty * sizeof(esfs_tlvItem_t)) != PAL_SUCCESS ||
+         esfs_log_write(&esfs_working_log, offset, file_handle->tlv_properties.tlv_items, meta_data_qty * sizeof(esfs_tlvItem_t)) != ESFS_SUCCESS))
+    {
+        goto errorExit;
+    }
+    offset += meta_data_qty * sizeof(esfs_tlvItem_t);
+    encrypted_offset = offset;
+
+    for (i = 0; i < meta_data_qty; i++)
+    {
+        const uint8_t *value = meta_data[i].value;
+        for (size_t pos = 0; pos < meta_data[i].length_in_bytes; pos += sizeof(buffer))
+        {
+            size_t chunk = PAL_MIN(sizeof(buffer), (size_t)meta_data[i].length_in_bytes - pos);
+            if ((esfs_mode & ESFS_ENCRYPTED) != 0)
+            {
+                if (esfs_log_crypt(file_handle->aes_ctx, file_handle->nonce, offset - encrypted_offset, value + pos, buffer, chunk) != ESFS_SUCCESS)
+                {
+                    goto errorExit;
+                }
+            }
+            else
+            {
+                memcpy(buffer, value + pos, chunk);
+            }
+            if (pal_CMACUpdate(file_handle->signature_ctx, buffer, chunk) != PAL_SUCCESS ||
+                esfs_log_write(&esfs_working_log, offset, buffer, chunk) != ESFS_SUCCESS)
+            {
+                goto errorExit;
+            }
+            offset += chunk;
+        }
+    }
+
+    // Set last, since esfs_validate() checks it
+    file_handle->blob_name_length = name_length;
+    file_handle->file_flag = ESFS_WRITE;
+    file_handle->data_size = 0;
+    esfs_log_writer_active = true;
+    esfs_log_open_handles++;
+    return ESFS_SUCCESS;
+
+errorExit:
+    tr_err("esfs_create() failed");
+    if (is_cmac_created)
+    {
+        (void)pal_CMACFinish(&file_handle->signature_ctx, buffer, &i);
+    }
+    if (is_aes_ctx_created)
+    {
+        pal_freeAes(&file_handle->aes_ctx);
+    }
+    file_handle->blob_name_length = 0;
+    return result;
+}
+
+esfs_result_e esfs_open(const uint8_t *name, size_t name_length, uint16_t *esfs_mode, esfs_file_t *file_handle)
+{
+    esfs_log_record_t record;
+    uint32_t record_size;
+    uint8_t chain[ESFS_CMAC_SIZE_IN_BYTES];
+    uint8_t cmac[ESFS_CMAC_SIZE_IN_BYTES];
+    int position;
+    esfs_result_e result = ESFS_ERROR;
+
+    tr_info("esfs_open - enter");
+    if (!name || name_length == 0 || name_length > ESFS_MAX_NAME_LENGTH || !file_handle || !esfs_mode)
+    {
+        tr_err("esfs_open() failed with bad parameters");
+        return ESFS_INVALID_PARAMETER;
+    }
+    if (!esfs_initialize)
+    {
+        tr_err("esfs_open() failed - esfs is not initialized");
+        return ESFS_ERROR;
+    }
+
+    add_performance_mark("esfs_open", ESFS_PERFORMANCE_START);
+    if (esfs_log_index_find(&esfs_working_index, &esfs_working_log, esfs_log_name_hash(name, name_length), name, 0, name_length, &position) != ESFS_SUCCESS)
+    {
+        goto errorExit;
+    }
+    if (position < 0)
+    {
+        result = ESFS_NOT_EXISTS;
+        goto errorExit;
+    }
+
+    memset(file_handle, 0, sizeof(*file_handle));
+    file_handle->record_offset = esfs_working_index.entries[position].offset;
+
+    // Verify the record against the CMAC that precedes it, which is the header CMAC for the first record
+    if (esfs_log_read(&esfs_working_log, file_handle->record_offset - ESFS_CMAC_SIZE_IN_BYTES, chain, sizeof(chain)) != ESFS_SUCCESS)
+    {
+        goto errorExit;
+    }
+    result = esfs_log_process_record(&esfs_working_log, file_handle->record_offset, chain, &record, &record_size, cmac, NULL);
+    if (result != ESFS_SUCCESS)
+    {
+        tr_err("esfs_open() - record verification failed with esfs result = 0x%x", result);
+        if (result != ESFS_CMAC_DOES_NOT_MATCH)
+        {
+            result = ESFS_ERROR;
+        }
+        goto errorExit;
+    }
+    result = ESFS_ERROR;
+
+    file_handle->tlv_properties.number_of_items = record.meta_data_qty;
+    if (record.meta_data_qty > 0 &&
+        esfs_log_read(&esfs_working_log, file_handle->record_offset + sizeof(record) + record.name_length,
+                      file_handle->tlv_properties.tlv_items, record.meta_data_qty * sizeof(esfs_tlvItem_t)) != ESFS_SUCCESS)
+    {
+        goto errorExit;
+    }
+
+    file_handle->esfs_mode = record.esfs_mode;
+    memcpy(file_handle->nonce, record.nonce, ESFS_AES_NONCE_SIZE_BYTES);
+    if ((record.esfs_mode & ESFS_ENCRYPTED) != 0 && esfs_log_aes_init(file_handle) != ESFS_SUCCESS)
+    {
+        goto errorExit;
+    }
+
+    file_handle->data_size = record.data_size;
+    file_handle->current_read_pos = 0;
+    file_handle->file_flag = ESFS_READ;
+    file_handle->blob_name_length = record.name_length;
+    *esfs_mode = record.esfs_mode;
+    esfs_log_open_handles++;
+    add_performance_mark("esfs_open", ESFS_PERFORMANCE_END);
+    return ESFS_SUCCESS;
+
+errorExit:
+    add_performance_mark("esfs_open", ESFS_PERFORMANCE_END);
+    if (file_handle)
+    {
+        file_handle->blob_name_length = 0;
+    }
+    return result;
+}
+
+esfs_result_e esfs_write(esfs_file_t *file_handle, const void *buffer, size_t bytes_to_write)
+{
+    uint8_t chunk_buffer[ESFS_READ_CHUNK_SIZE_IN_BYTES];
+    const uint8_t *data = buffer;
+    uint32_t data_offset;
+    uint32_t meta_data_size;
+
+    tr_info("esfs_write - enter");
+    if ((esfs_validate(file_handle) != ESFS_SUCCESS) || (!buffer) || (bytes_to_write == 0))
+    {
+        tr_err("esfs_write() failed with bad parameters");
+        return ESFS_INVALID_PARAMETER;
+    }
+    if (file_handle->file_flag == ESFS_READ)
+    {
+        tr_err("esfs_write() write failed - file is opened for read only");
+        return ESFS_FILE_OPEN_FOR_READ;
+    }
+
+    meta_data_size = esfs_log_meta_data_size(file_handle);
+    data_offset = esfs_log_encrypted_offset(file_handle) + meta_data_size;
+    for (size_t pos = 0; pos < bytes_to_write; pos += sizeof(chunk_buffer))
+    {
+        size_t chunk = PAL_MIN(sizeof(chunk_buffer), bytes_to_write - pos);
+        if ((file_handle->esfs_mode & ESFS_ENCRYPTED) != 0)
+        {
+            if (esfs_log_crypt(file_handle->aes_ctx, file_handle->nonce, meta_data_size + file_handle->data_size,
+                               data + pos, chunk_buffer, chunk) != ESFS_SUCCESS)
+            {
+                goto errorExit;
+            }
+        }
+        else
+        {
+            memcpy(chunk_buffer, data + pos, chunk);
+        }
+        if (pal_CMACUpdate(file_handle->signature_ctx, chunk_buffer, chunk) != PAL_SUCCESS ||
+            esfs_log_write(&esfs_working_log, data_offset + file_handle->data_size, chunk_buffer, chunk) != ESFS_SUCCESS)
+        {
+            goto errorExit;
+        }
+        file_handle->data_size += chunk;
+    }
+    return ESFS_SUCCESS;
+
+errorExit:
+    tr_err("esfs_write() failed");
+    // Since the write failed, the record cannot be committed
+    file_handle->file_invalid = 1;
+    return ESFS_ERROR;
+}
+
+esfs_result_e esfs_read(esfs_file_t *file_handle, void *buffer, size_t bytes_to_read, size_t *read_bytes)
+{
+    uint32_t meta_data_size;
+    uint32_t data_offset;
+
+    tr_info("esfs_read - enter");
+    if (esfs_validate(file_handle) != ESFS_SUCCESS || read_bytes == NULL || !buffer)
+    {
+        return ESFS_INVALID_PARAMETER;
+    }
+    if (file_handle->file_flag != ESFS_READ)
+    {
+        return ESFS_FILE_OPEN_FOR_WRITE;
+    }
+
+    // Limit how many bytes we can actually read depending on the size of the data section.
+    bytes_to_read = PAL_MIN(file_handle->data_size - file_handle->current_read_pos, bytes_to_read);
+    meta_data_size = esfs_log_meta_data_size(file_handle);
+    data_offset = esfs_log_encrypted_offset(file_handle) + meta_data_size;
+
+    if (bytes_to_read > 0)
+    {
+        if (esfs_log_read(&esfs_working_log, data_offset + file_handle->current_read_pos, buffer, bytes_to_read) != ESFS_SUCCESS)
+        {
+            return ESFS_ERROR;
+        }
+        if ((file_handle->esfs_mode & ESFS_ENCRYPTED) != 0 &&
+            esfs_log_crypt(file_handle->aes_ctx, file_handle->nonce, meta_data_size + file_handle->current_read_pos,
+                           buffer, buffer, bytes_to_read) != ESFS_SUCCESS)
+        {
+            return ESFS_ERROR;
+        }
+    }
+
+    *read_bytes = bytes_to_read;
+    file_handle->current_read_pos += bytes_to_read;
+    return ESFS_SUCCESS;
+}
+
+esfs_result_e esfs_seek(esfs_file_t *file_handle, int32_t offset, esfs_seek_origin_e whence, uint32_t *position)
+{
+    int32_t new_pos;
+
+    tr_info("esfs_seek - enter");
+    if (esfs_validate(file_handle) != ESFS_SUCCESS)
+    {
+        tr_err("esfs_seek() failed with bad parameters");
+        return ESFS_INVALID_PARAMETER;
+    }
+    if (file_handle->file_flag != ESFS_READ)
+    {
+        tr_err("esfs_seek() seek failed - file is opened for write only");
+        return ESFS_FILE_OPEN_FOR_WRITE;
+    }
+
+    if (whence == ESFS_SEEK_SET)
+    {
+        new_pos = offset;
+    }
+    else if (whence == ESFS_SEEK_END)
+    {
+        if (offset > 0)
+        {
+            tr_err("esfs_seek() failed with bad parameters in offset calculation : ESFS_SEEK_END");
+            return ESFS_INVALID_PARAMETER;
+        }
+        new_pos = (int32_t)file_handle->data_size + offset;
+    }
+    else if (whence == ESFS_SEEK_CUR)
+    {
+        new_pos = (int32_t)file_handle->current_read_pos + offset;
+    }
+    else
+    {
+        tr_err("esfs_seek() failed with bad parameters - wrong whence");
+        return ESFS_INVALID_PARAMETER;
+    }
+    if (new_pos < 0 || new_pos > (int32_t)file_handle->data_size)
+    {
+        tr_err("esfs_seek() failed with bad parameters in offset calculation");
+        return ESFS_INVALID_PARAMETER;
+    }
+
+    file_handle->current_read_pos = new_pos;
+    if (position)
+    {
+        *position = (uint32_t)new_pos;
+    }
+    return ESFS_SUCCESS;
+}
+
+esfs_result_e esfs_file_size(esfs_file_t *file_handle, size_t *size_in_bytes)
+{
+    tr_info("esfs_file_size - enter");
+    if ((esfs_validate(file_handle) != ESFS_SUCCESS) || (!size_in_bytes))
+    {
+        tr_err("esfs_file_size() failed with bad parameters");
+        return ESFS_INVALID_PARAMETER;
+    }
+    // For a file being written this is the size of the data written so far
+    *size_in_bytes = file_handle->data_size;
+    return ESFS_SUCCESS;
+}
+
+esfs_result_e esfs_close(esfs_file_t *file_handle)
+{
+    esfs_log_record_t record;
+    uint8_t cmac[ESFS_CMAC_SIZE_IN_BYTES];
+    uint32_t record_size;
+    uint32_t name_hash;
+    uint16_t name_length;
+    esfs_result_e result = ESFS_ERROR;
+
+    tr_info("esfs_close - enter");
+    if (esfs_validate(file_handle) != ESFS_SUCCESS)
+    {
+        tr_err("esfs_close() failed with bad parameters");
+        return ESFS_INVALID_PARAMETER;
+    }
+
+    if ((file_handle->esfs_mode & ESFS_ENCRYPTED) != 0)
+    {
+        pal_freeAes(&file_handle->aes_ctx);
+    }
+    name_length = file_handle->blob_name_length;
+    file_handle->blob_name_length = 0;
+    esfs_log_open_handles--;
+
+    if (file_handle->file_flag != ESFS_WRITE)
+    {
+        esfs_log_working_compact_if_needed();
+        return ESFS_SUCCESS;
+    }
+
+    add_performance_mark("esfs_close", ESFS_PERFORMANCE_START);
+    esfs_log_writer_active = false;
+
+    memset(&record, 0, sizeof(record));
+    record.magic = ESFS_LOG_RECORD_MAGIC;
+    record.type = ESFS_LOG_RECORD_PUT;
+    record.esfs_mode = file_handle->esfs_mode;
+    record.meta_data_qty = file_handle->tlv_properties.number_of_items;
+    record.meta_data_size = esfs_log_meta_data_size(file_handle);
+    record.data_size = file_handle->data_size;
+    memcpy(record.nonce, file_handle->nonce, ESFS_AES_NONCE_SIZE_BYTES);
+    record.name_length = name_length;
+
+    if (pal_CMACUpdate(file_handle->signature_ctx, (const unsigned char *)&record, sizeof(record)) != PAL_SUCCESS)
+    {
+        file_handle->file_invalid = 1;
+    }
+    if (esfs_log_cmac_finish(&file_handle->signature_ctx, cmac) != ESFS_SUCCESS || file_handle->file_invalid)
+    {
+        // Nothing is committed. The partial record past the tail is overwritten by the next one.
+        tr_err("esfs_close() - the file is invalid and was not stored");
+        goto errorExit;
+    }
+
+    record_size = sizeof(record) + esfs_log_record_body_size(&record) + ESFS_CMAC_SIZE_IN_BYTES;
+    if (esfs_log_write(&esfs_working_log, file_handle->record_offset, &record, sizeof(record)) != ESFS_SUCCESS ||
+        esfs_log_write(&esfs_working_log, file_handle->record_offset + record_size - ESFS_CMAC_SIZE_IN_BYTES, cmac, ESFS_CMAC_SIZE_IN_BYTES) != ESFS_SUCCESS ||
+        esfs_log_sync(&esfs_working_log) != ESFS_SUCCESS)
+    {
+        tr_err("esfs_close() - failed to write the record");
+        goto errorExit;
+    }
+
+    esfs_working_log.tail = file_handle->record_offset + record_size;
+    memcpy(esfs_working_log.chain, cmac, ESFS_CMAC_SIZE_IN_BYTES);
+    if (esfs_log_record_name_hash(&esfs_working_log, file_handle->record_offset, record.name_length, &name_hash) != ESFS_SUCCESS ||
+        esfs_log_index_apply(&esfs_working_index, &esfs_working_log, &record, name_hash, file_handle->record_offset, record_size) != ESFS_SUCCESS)
+    {
+        goto errorExit;
+    }
+
+    // The file is stored once its record is committed to the working log. Failing to add it to the factory
+    // snapshot only means that a factory reset will not restore it.
+    if ((record.esfs_mode & ESFS_FACTORY_VAL) && esfs_log_factory_append(file_handle->record_offset) != ESFS_SUCCESS)
+    {
+        tr_err("esfs_close() - esfs_log_factory_append() failed, the file is missing from the factory snapshot");
+    }
+
+    add_performance_mark("esfs_close", ESFS_PERFORMANCE_END);
+    esfs_log_working_compact_if_needed();
+    return ESFS_SUCCESS;
+
+errorExit:
+    add_performance_mark("esfs_close", ESFS_PERFORMANCE_END);
+    return result;
+}
+
+esfs_result_e esfs_delete(const uint8_t *name, size_t name_length)
+{
+    esfs_log_record_t record;
+    palCMACHandle_t cmac_ctx;
+    uint8_t cmac[ESFS_CMAC_SIZE_IN_BYTES];
+    uint32_t offset;
+    uint32_t name_hash;
+    int position;
+
+    tr_info("esfs_delete - enter");
+    if (!name || name_length == 0 || name_length > ESFS_MAX_NAME_LENGTH)
+    {
+        tr_err("esfs_delete() failed with bad parameters");
+        return ESFS_INVALID_PARAMETER;
+    }
+    if (!esfs_initialize || esfs_log_writer_active)
+    {
+        tr_err("esfs_delete() failed - not initialized or a file is being written");
+        return ESFS_ERROR;
+    }
+
+    name_hash = esfs_log_name_hash(name, name_length);
+    if (esfs_log_index_find(&esfs_working_index, &esfs_working_log, name_hash, name, 0, name_length, &position) != ESFS_SUCCESS)
+    {
+        return ESFS_ERROR;
+    }
+    if (position < 0)
+    {
+        return ESFS_NOT_EXISTS;
+    }
+
+    memset(&record, 0, sizeof(record));
+    record.magic = ESFS_LOG_RECORD_MAGIC;
+    record.type = ESFS_LOG_RECORD_DELETE;
+    record.name_length = name_length;
+
+    if (esfs_log_cmac_start(&cmac_ctx) != ESFS_SUCCESS)
+    {
+        return ESFS_ERROR;
+    }
+    if (pal_CMACUpdate(cmac_ctx, esfs_working_log.chain, ESFS_CMAC_SIZE_IN_BYTES) != PAL_SUCCESS ||
+        pal_CMACUpdate(cmac_ctx, name, name_length) != PAL_SUCCESS ||
+        pal_CMACUpdate(cmac_ctx, (const unsigned char *)&record, sizeof(record)) != PAL_SUCCESS)
+    {
+        (void)esfs_log_cmac_finish(&cmac_ctx, cmac);
+        return ESFS_ERROR;
+    }
+    if (esfs_log_cmac_finish(&cmac_ctx, cmac) != ESFS_SUCCESS)
+    {
+        return ESFS_ERROR;
+    }
+
+    offset = esfs_working_log.tail;
+    if (esfs_log_clear_tail(&esfs_working_log) != ESFS_SUCCESS ||
+        esfs_log_write(&esfs_working_log, offset, &record, sizeof(record)) != ESFS_SUCCESS ||
+        esfs_log_write(&esfs_working_log, offset + sizeof(record), name, name_length) != ESFS_SUCCESS ||
+        esfs_log_write(&esfs_working_log, offset + sizeof(record) + name_length, cmac, ESFS_CMAC_SIZE_IN_BYTES) != ESFS_SUCCESS ||
+        esfs_log_sync(&esfs_working_log) != ESFS_SUCCESS)
+    {
+        tr_err("esfs_delete() - failed to write the record");
+        return ESFS_ERROR;
+    }
+
+    esfs_working_log.tail = offset + sizeof(record) + name_length + ESFS_CMAC_SIZE_IN_BYTES;
+    memcpy(esfs_working_log.chain, cmac, ESFS_CMAC_SIZE_IN_BYTES);
+    esfs_log_index_remove(&esfs_working_index, position);
+
+    esfs_log_working_compact_if_needed();
+    return ESFS_SUCCESS;
+}
+
+esfs_result_e esfs_get_meta_data_properties(esfs_file_t *file_handle, esfs_tlv_properties_t **meta_data_properties)
+{
+    tr_info("esfs_get_meta_data_properties - enter");
+    if ((esfs_validate(file_handle) != ESFS_SUCCESS) || (!meta_data_properties))
+    {
+        tr_err("esfs_get_meta_data_properties() failed with bad parameters");
+        return ESFS_INVALID_PARAMETER;
+    }
+    if (file_handle->file_flag != ESFS_READ)
+    {
+        tr_err("esfs_get_meta_data_properties() failed - file is opened for write only");
+        return ESFS_FILE_OPEN_FOR_WRITE;
+    }
+    *meta_data_properties = &file_handle->tlv_properties;
+    return ESFS_SUCCESS;
+}
+
+esfs_result_e esfs_read_meta_data(esfs_file_t *file_handle, uint32_t index, esfs_tlv_item_t *meta_data)
+{
+    esfs_tlvItem_t *item;
+    uint32_t offset;
+
+    tr_info("esfs_read_meta_data - enter");
+    if (esfs_validate(file_handle) != ESFS_SUCCESS || index >= ESFS_MAX_TYPE_LENGTH_VALUES || !meta_data || (file_handle->tlv_properties.tlv_items[index].length_in_bytes == 0))
+    {
+        tr_err("esfs_read_meta_data() failed with bad parameters");
+        return ESFS_INVALID_PARAMETER;
+    }
+    if (file_handle->file_flag != ESFS_READ)
+    {
+        tr_err("esfs_read_meta_data() failed - file is opened for write only");
+        return ESFS_FILE_OPEN_FOR_WRITE;
+    }
+
+    item = &file_handle->tlv_properties.tlv_items[index];
+    offset = file_handle->record_offset + item->position;
+    if (esfs_log_read(&esfs_working_log, offset, meta_data->value, item->length_in_bytes) != ESFS_SUCCESS)
+    {
+        return ESFS_ERROR;
+    }
+    if ((file_handle->esfs_mode & ESFS_ENCRYPTED) != 0 &&
+        esfs_log_crypt(file_handle->aes_ctx, file_handle->nonce, offset - esfs_log_encrypted_offset(file_handle),
+                       meta_data->value, meta_data->value, item->length_in_bytes) != ESFS_SUCCESS)
+    {
+        return ESFS_ERROR;
+    }
+    meta_data->type = item->type;
+    meta_data->length_in_bytes = item->length_in_bytes;
+    return ESFS_SUCCESS;
+}
+
+#endif // ESFS_LOG_STORE
@@ -36,6 +36,9 @@
 // ESFS_FILE_NAME_LENGTH + dot + extension (for example:  123456789.txt)
 #define ESFS_QUALIFIED_FILE_NAME_LENGTH       (ESFS_FILE_NAME_LENGTH + 4)
 
+// Define ESFS_LOG_STORE to keep all the files in a single log-structured container (esfs_log.c) instead of
+// one file per blob (esfs.c). The on-disk layouts of the two backends are not compatible.
+
 
 typedef enum {
     ESFS_SUCCESS = 0,
@@ -106,6 +109,9 @@ typedef struct {
     // These are valid for files that are opened not created.
     long current_read_pos;   // byte position from the start of the data.
     size_t data_size;   // size in bytes of the data only
+#ifdef ESFS_LOG_STORE
+    uint32_t record_offset; // offset of the file's record in the log
+#endif
 }esfs_file_t;
 
 // ESFS whence enum values are in sync with those of pal
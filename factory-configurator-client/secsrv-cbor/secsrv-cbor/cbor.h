@@ -111,6 +111,33 @@
 
 #endif // USE_CBOR_CONTEXT
 
+#ifdef USE_CBOR_CONTEXT
+#define CN_CALLOC_SIZE(size, ctx) (((ctx) && (ctx)->calloc_func) ? \
+    (ctx)->calloc_func(1, (size), (ctx)->context) : \
+    calloc(1, (size)))
+#define CN_CALLOC_SIZE_CONTEXT(size) CN_CALLOC_SIZE(size, context)
+#else
+#ifndef CN_CALLOC_SIZE
+#define CN_CALLOC_SIZE(size) calloc(1, (size))
+#endif
+#define CN_CALLOC_SIZE_CONTEXT(size) CN_CALLOC_SIZE(size)
+#endif // USE_CBOR_CONTEXT
+
+#ifndef CBOR_NO_MAP_INDEX
+/* Decoded maps with fewer pairs are searched linearly */
+#ifndef CBOR_MAP_INDEX_MIN_PAIRS
+#define CBOR_MAP_INDEX_MIN_PAIRS 8
+#endif
+
+/**
+ * Number of slots in the lookup index of a map.
+ *
+ * @param[in]  pairs  The number of key/value pairs in the map
+ * @return            A power of two of at least twice the pairs
+ */
+size_t cn_cbor_map_index_slots(size_t pairs);
+#endif // CBOR_NO_MAP_INDEX
+
 #ifndef UNUSED_PARAM
 #define UNUSED_PARAM(p) ((void)&(p))
 #endif
@@ -71,6 +71,13 @@ typedef enum cn_cbor_flags {
   CN_CBOR_FL_COUNT = 1,
   /** An indefinite number of children */
   CN_CBOR_FL_INDEF = 2,
+  /** The root of a tree decoded by cn_cbor_decode(), whose nodes are all in
+     one allocation */
+  CN_CBOR_FL_ARENA = 4,
+  /** A decoded map which has a lookup index, in v.index */
+  CN_CBOR_FL_INDEX = 8,
+  /** The lookup index of the map has been built */
+  CN_CBOR_FL_INDEXED = 0x10,
   /** Not used yet; the structure must free the v.str pointer when the
      structure is freed */
   CN_CBOR_FL_OWNER = 0x80,            /* of str */
@@ -99,6 +106,8 @@ typedef struct cn_cbor {
     double dbl;
     /** for use during parsing */
     unsigned long count;
+    /** CN_CBOR_MAP with CN_CBOR_FL_INDEX, the slots of its lookup index */
+    struct cn_cbor** index;
   } v;                          /* TBD: optimize immediate */
   /** Number of children.
     * @note: for maps, this is 2x the number of entries */
@@ -220,6 +229,13 @@ typedef struct cn_cbor_context {
 /**
  * Decode an array of CBOR bytes into structures.
  *
+ * All the structures of the result are taken from a single allocation, sized by
+ * a first pass over the bytes. Byte and text strings point into `buf`, which
+ * must outlive the result. Maps of at least CBOR_MAP_INDEX_MIN_PAIRS pairs also
+ * get room for a lookup index, which is built by the first cn_cbor_mapget_string()
+ * or cn_cbor_mapget_int() on them (unless CBOR_NO_MAP_INDEX is defined).
+ * Nodes of the result must not be moved into another tree.
+ *
  * @param[in]  buf          The array of bytes to parse
  * @param[in]  len          The number of bytes in the array
  * @param[in]  CBOR_CONTEXT Allocation context (only if USE_CBOR_CONTEXT is defined)
@@ -230,6 +246,10 @@ cn_cbor* cn_cbor_decode(const uint8_t *buf, size_t len CBOR_CONTEXT, cn_cbor_err
 
 /**
  * Get a value from a CBOR map that has the given string as a key.
+ * If the key appears more than once, the first value is returned.
+ *
+ * @note: the lookup index of a decoded map is built on the first lookup, so
+ * concurrent lookups in the same tree must be serialized by the caller.
  *
  * @param[in]  cb           The CBOR map
  * @param[in]  key          The string to look up in the map
@@ -239,6 +259,7 @@ cn_cbor* cn_cbor_mapget_string(const cn_cbor* cb, const char* key);
 
 /**
  * Get a value from a CBOR map that has the given integer as a key.
+ * If the key appears more than once, the first value is returned.
  *
  * @param[in]  cb           The CBOR map
  * @param[in]  key          The int to look up in the map
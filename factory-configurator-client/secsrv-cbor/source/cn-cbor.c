@@ -9,6 +9,7 @@ extern "C" {
 #endif
 
 #include <stdlib.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <string.h>
 #include <assert.h>
@@ -22,9 +23,30 @@ extern "C" {
 
 #define CN_CBOR_FAIL(code) do { pb->err = code;  goto fail; } while(0)
 
+/* A decoded tree.  Its nodes, root first, and the lookup indexes of its maps
+   are all in this single allocation. */
+typedef struct cn_cbor_arena {
+  size_t nodes_count;
+  size_t nodes_used;
+  size_t index_slots;
+  size_t index_used;
+  cn_cbor** index;              /* follows the nodes */
+  cn_cbor nodes[];
+} cn_cbor_arena;
+
+#define ARENA_OF_ROOT(cb) ((cn_cbor_arena *)((unsigned char *)(cb) - offsetof(cn_cbor_arena, nodes)))
+
+static bool is_arena_node(const cn_cbor_arena *arena, const cn_cbor *cb) {
+  return ((uintptr_t)cb - (uintptr_t)arena->nodes) < arena->nodes_count * sizeof(cn_cbor);
+}
+
 void cn_cbor_free(cn_cbor* cb CBOR_CONTEXT) {
   cn_cbor* p = cb;
+  cn_cbor_arena* arena = NULL;
   assert(!p || !p->parent);
+  if (p && (p->flags & CN_CBOR_FL_ARENA)) {
+    arena = ARENA_OF_ROOT(p);
+  }
   while (p) {
     cn_cbor* p1;
     while ((p1 = p->first_child)) { /* go down */
@@ -34,9 +56,15 @@ void cn_cbor_free(cn_cbor* cb CBOR_CONTEXT) {
       if ((p1 = p->parent))
         p1->first_child = 0;
     }
-    CN_CBOR_FREE_CONTEXT(p);
+    /* only nodes added to a decoded tree after decoding are freed one by one */
+    if (!arena || !is_arena_node(arena, p)) {
+      CN_CBOR_FREE_CONTEXT(p);
+    }
     p = p1;
   }
+  if (arena) {
+    CN_CBOR_FREE_CONTEXT(arena);
+  }
 }
 
 #ifndef CBOR_NO_FLOAT
@@ -96,15 +124,82 @@ struct parse_buf {
   unsigned char *buf;
   unsigned char *ebuf;
   cn_cbor_error err;
+  cn_cbor_arena *arena;
 };
 
+/* First pass: count the nodes that decode_item() creates and the index slots
+   of the maps that get an index.  The heads are walked flat, only string
+   contents are skipped.  Errors are left for decode_item() to report. */
+static void count_items(unsigned char *pos, unsigned char *ebuf, size_t *nodes, size_t *index_slots) {
+  int ib;
+  unsigned int mt;
+  int ai;
+  uint64_t val;
+
+  while (pos < ebuf) {
+    ib = ntoh8p(pos);
+    pos++;
+    if (ib == IB_BREAK)
+      continue;
+    (*nodes)++;
+    mt = ib >> 5;
+    ai = ib & 0x1f;
+    val = ai;
+    switch (ai) {
+    case AI_1: if ((size_t)(ebuf - pos) < 1) return; val = ntoh8p(pos);  pos += 1; break;
+    case AI_2: if ((size_t)(ebuf - pos) < 2) return; val = ntoh16p(pos); pos += 2; break;
+    case AI_4: if ((size_t)(ebuf - pos) < 4) return; val = ntoh32p(pos); pos += 4; break;
+    case AI_8: if ((size_t)(ebuf - pos) < 8) return; val = ntoh64p(pos); pos += 8; break;
+    case AI_INDEF: continue;
+    }
+    if (mt == MT_BYTES || mt == MT_TEXT) {
+      if (val > (uint64_t)(ebuf - pos))
+        return;
+      pos += val;
+    }
+#ifndef CBOR_NO_MAP_INDEX
+    /* a map that claims more pairs than there are bytes left fails to decode anyway */
+    else if (mt == MT_MAP && val >= CBOR_MAP_INDEX_MIN_PAIRS && val <= (uint64_t)(ebuf - pos) / 2) {
+      *index_slots += cn_cbor_map_index_slots(val);
+    }
+#endif /* CBOR_NO_MAP_INDEX */
+  }
+#ifdef CBOR_NO_MAP_INDEX
+  UNUSED_PARAM(index_slots);
+#endif /* CBOR_NO_MAP_INDEX */
+}
+
+static cn_cbor *arena_node(cn_cbor_arena *arena) {
+  if (arena->nodes_used == arena->nodes_count)
+    return NULL;
+  return &arena->nodes[arena->nodes_used++];
+}
+
+#ifndef CBOR_NO_MAP_INDEX
+/* Give a fully decoded map the room for its lookup index, which is built on
+   the first lookup. */
+static void arena_map_index(cn_cbor_arena *arena, cn_cbor *map) {
+  size_t pairs = map->length / 2;
+  size_t slots;
+
+  if (pairs < CBOR_MAP_INDEX_MIN_PAIRS)
+    return;
+  slots = cn_cbor_map_index_slots(pairs);
+  if (slots > arena->index_slots - arena->index_used)
+    return;
+  map->v.index = arena->index + arena->index_used;
+  map->flags |= CN_CBOR_FL_INDEX;
+  arena->index_used += slots;
+}
+#endif /* CBOR_NO_MAP_INDEX */
+
 #define TAKE(pos, ebuf, n, stmt)                \
   if (n > (size_t)(ebuf - pos))                 \
     CN_CBOR_FAIL(CN_CBOR_ERR_OUT_OF_DATA);      \
   stmt;                                         \
   pos += n;
 
-static cn_cbor *decode_item (struct parse_buf *pb CBOR_CONTEXT, cn_cbor* top_parent) {
+static cn_cbor *decode_item (struct parse_buf *pb, cn_cbor* top_parent) {
   unsigned char *pos = pb->buf;
   unsigned char *ebuf = pb->ebuf;
   cn_cbor* parent = top_parent;
@@ -144,7 +239,7 @@ again:
   ai = ib & 0x1f;
   val = ai;
 
-  cb = CN_CALLOC_CONTEXT();
+  cb = arena_node(pb->arena);
   if (!cb)
     CN_CBOR_FAIL(CN_CBOR_ERR_OUT_OF_MEMORY);
 
@@ -267,6 +362,10 @@ fill:                           /* emulate loops */
   }
   /* so we are done filling parent. */
 complete:                       /* emulate return from call */
+#ifndef CBOR_NO_MAP_INDEX
+  if (parent->type == CN_CBOR_MAP && (parent->flags & CN_CBOR_FL_COUNT))
+    arena_map_index(pb->arena, parent);
+#endif /* CBOR_NO_MAP_INDEX */
   if (parent == top_parent) {
     if (pos != ebuf)            /* XXX do this outside */
       CN_CBOR_FAIL(CN_CBOR_ERR_NOT_ALL_DATA_CONSUMED);
@@ -287,20 +386,32 @@ fail:
 cn_cbor* cn_cbor_decode(const unsigned char* buf, size_t len CBOR_CONTEXT, cn_cbor_errback *errp) {
   cn_cbor catcher = {CN_CBOR_INVALID, 0, {0}, 0, NULL, NULL, NULL, NULL};
   struct parse_buf pb;
-  cn_cbor* ret;
+  cn_cbor* ret = NULL;
+  size_t nodes = 0;
+  size_t index_slots = 0;
 
   pb.buf  = (unsigned char *)buf;
   pb.ebuf = (unsigned char *)buf+len;
   pb.err  = CN_CBOR_NO_ERROR;
-  ret = decode_item(&pb CBOR_CONTEXT_PARAM, &catcher);
+
+  /* every head takes at least one byte, so the counts are bounded by len */
+  count_items(pb.buf, pb.ebuf, &nodes, &index_slots);
+  pb.arena = CN_CALLOC_SIZE_CONTEXT(offsetof(cn_cbor_arena, nodes) + nodes * sizeof(cn_cbor) + index_slots * sizeof(cn_cbor*));
+  if (pb.arena) {
+    pb.arena->nodes_count = nodes;
+    pb.arena->index_slots = index_slots;
+    pb.arena->index = (cn_cbor**)&pb.arena->nodes[nodes];
+    ret = decode_item(&pb, &catcher);
+  } else {
+    pb.err = CN_CBOR_ERR_OUT_OF_MEMORY;
+  }
   if (ret != NULL) {
     /* mark as top node */
     ret->parent = NULL;
+    ret->flags |= CN_CBOR_FL_ARENA;
   } else {
-
-    if (catcher.first_child) {
-      catcher.first_child->parent = 0;
-      cn_cbor_free(catcher.first_child CBOR_CONTEXT_PARAM);
+    if (pb.arena) {
+      CN_CBOR_FREE_CONTEXT(pb.arena);
     }
 //fail:
     if (errp) {
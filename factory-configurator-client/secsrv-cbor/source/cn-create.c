@@ -75,6 +75,9 @@ cn_cbor* cn_cbor_int_create(int64_t value
 
 static bool _append_kv(cn_cbor *cb_map, cn_cbor *key, cn_cbor *val)
 {
+  //The lookup index of a decoded map does not cover the new pair, drop it.
+  cb_map->flags &= ~(CN_CBOR_FL_INDEX | CN_CBOR_FL_INDEXED);
+
   //Connect key and value and insert them into the map.
   key->parent = cb_map;
   key->next = val;
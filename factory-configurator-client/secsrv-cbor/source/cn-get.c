@@ -3,10 +3,130 @@
 #include <assert.h>
 
 #include "cn-cbor.h"
+#include "cbor.h"
+
+#ifndef CBOR_NO_MAP_INDEX
+
+size_t cn_cbor_map_index_slots(size_t pairs) {
+  size_t slots = 1;
+  while (slots < pairs * 2) {
+    slots <<= 1;
+  }
+  return slots;
+}
+
+/* FNV-1a */
+static uint32_t hash_bytes(const uint8_t* data, size_t len) {
+  uint32_t hash = 2166136261U;
+  size_t i;
+  for (i = 0; i < len; i++) {
+    hash ^= data[i];
+    hash *= 16777619U;
+  }
+  return hash;
+}
+
+static uint32_t hash_int(uint64_t value) {
+  value ^= value >> 33;
+  value *= 0xff51afd7ed558ccdULL;
+  value ^= value >> 33;
+  return (uint32_t)value;
+}
+
+static bool is_string_key(const cn_cbor* cp) {
+  return cp->type == CN_CBOR_TEXT || cp->type == CN_CBOR_BYTES;
+}
+
+static bool is_int_key(const cn_cbor* cp) {
+  return cp->type == CN_CBOR_UINT || cp->type == CN_CBOR_INT;
+}
+
+/* Integer keys are compared by their 64 bit pattern, as cn_cbor_mapget_int() does */
+static uint64_t int_key(const cn_cbor* cp) {
+  return cp->type == CN_CBOR_UINT ? cp->v.uint : (uint64_t)cp->v.sint;
+}
+
+static bool is_same_key(const cn_cbor* cp1, const cn_cbor* cp2) {
+  if (is_string_key(cp1)) {
+    return is_string_key(cp2) && cp1->length == cp2->length &&
+           memcmp(cp1->v.str, cp2->v.str, cp1->length) == 0;
+  }
+  return is_int_key(cp2) && int_key(cp1) == int_key(cp2);
+}
+
+/* Keys are inserted in map order and only the first of equal keys is kept,
+   so that a lookup returns the same value as the linear walk. */
+static void build_map_index(cn_cbor* cb) {
+  size_t mask = cn_cbor_map_index_slots(cb->length / 2) - 1;
+  size_t i;
+  cn_cbor* cp;
+  uint32_t hash;
+
+  for (cp = cb->first_child; cp && cp->next; cp = cp->next->next) {
+    if (is_string_key(cp)) {
+      hash = hash_bytes(cp->v.bytes, cp->length);
+    } else if (is_int_key(cp)) {
+      hash = hash_int(int_key(cp));
+    } else {
+      continue;
+    }
+    for (i = hash & mask; cb->v.index[i]; i = (i + 1) & mask) {
+      if (is_same_key(cb->v.index[i], cp)) {
+        break;
+      }
+    }
+    if (!cb->v.index[i]) {
+      cb->v.index[i] = cp;
+    }
+  }
+  cb->flags |= CN_CBOR_FL_INDEXED;
+}
+
+/* The index is a cache of the map, so it is built through the const pointer */
+static cn_cbor** map_index(const cn_cbor* cb) {
+  if (!(cb->flags & CN_CBOR_FL_INDEXED)) {
+    build_map_index((cn_cbor*)cb);
+  }
+  return cb->v.index;
+}
+
+static cn_cbor* map_index_get_string(const cn_cbor* cb, const char* key, size_t keylen) {
+  cn_cbor** index = map_index(cb);
+  size_t mask = cn_cbor_map_index_slots(cb->length / 2) - 1;
+  size_t i;
+
+  for (i = hash_bytes((const uint8_t*)key, keylen) & mask; index[i]; i = (i + 1) & mask) {
+    if (is_string_key(index[i]) && (size_t)index[i]->length == keylen &&
+        memcmp(index[i]->v.str, key, keylen) == 0) {
+      return index[i]->next;
+    }
+  }
+  return NULL;
+}
+
+static cn_cbor* map_index_get_int(const cn_cbor* cb, uint64_t key) {
+  cn_cbor** index = map_index(cb);
+  size_t mask = cn_cbor_map_index_slots(cb->length / 2) - 1;
+  size_t i;
+
+  for (i = hash_int(key) & mask; index[i]; i = (i + 1) & mask) {
+    if (is_int_key(index[i]) && int_key(index[i]) == key) {
+      return index[i]->next;
+    }
+  }
+  return NULL;
+}
+
+#endif /* CBOR_NO_MAP_INDEX */
 
 cn_cbor* cn_cbor_mapget_int(const cn_cbor* cb, int key) {
   cn_cbor* cp;
   assert(cb);
+#ifndef CBOR_NO_MAP_INDEX
+  if (cb->flags & CN_CBOR_FL_INDEX) {
+    return map_index_get_int(cb, (uint64_t)(int64_t)key);
+  }
+#endif /* CBOR_NO_MAP_INDEX */
   for (cp = cb->first_child; cp && cp->next; cp = cp->next->next) {
     switch(cp->type) {
     case CN_CBOR_UINT:
@@ -32,6 +152,11 @@ cn_cbor* cn_cbor_mapget_string(const cn_cbor* cb, const char* key) {
   assert(cb);
   assert(key);
   keylen = strlen(key);
+#ifndef CBOR_NO_MAP_INDEX
+  if (cb->flags & CN_CBOR_FL_INDEX) {
+    return map_index_get_string(cb, key, keylen);
+  }
+#endif /* CBOR_NO_MAP_INDEX */
   for (cp = cb->first_child; cp && cp->next; cp = cp->next->next) {
     switch(cp->type) {
     case CN_CBOR_TEXT: // fall-through
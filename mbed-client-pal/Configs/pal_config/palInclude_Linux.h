@@ -67,6 +67,16 @@
     #define PAL_FS_RM_INSTEAD_OF_FORMAT 0
 #endif
 
+/*\brief  copy files with a reflink, copy_file_range() or sendfile() instead of through a user space buffer*/
+#ifndef PAL_FS_KERNEL_COPY
+    #define PAL_FS_KERNEL_COPY 1
+#endif
+
+/*\brief  pal_fsCpFolder() and pal_fsReplaceFolder() copy to a staging folder and swap it with the destination folder in one rename*/
+#ifndef PAL_FS_CP_FOLDER_ATOMIC_SWAP
+    #define PAL_FS_CP_FOLDER_ATOMIC_SWAP 1
+#endif
+
 #ifndef PAL_FS_FORMAT_COMMAND
     #define PAL_FS_FORMAT_COMMAND "mkfs -F -t %s %s"
 #endif
@@ -76,6 +86,73 @@
     #define PARTITION_FORMAT_ADDITIONAL_PARAMS NULL
 #endif
 
+/*\brief  emulate the internal flash with a memory mapped file, with NOR semantics (erase to 0xFF, writes only clear bits).
+           off by default, the internal flash is then not supported on Linux*/
+#ifndef PAL_INTERNAL_FLASH_EMULATOR
+    #define PAL_INTERNAL_FLASH_EMULATOR 0
+#endif
+
+#if PAL_INTERNAL_FLASH_EMULATOR
+
+/*\brief  file backing the emulated flash, under the primary mount point. it is re-formatted if the geometry below changes*/
+#ifndef PAL_INTERNAL_FLASH_EMULATOR_FILE
+    #define PAL_INTERNAL_FLASH_EMULATOR_FILE "pal_internal_flash.bin"
+#endif
+
+/*\brief  size of an emulated sector, the unit of erase*/
+#ifndef PAL_INTERNAL_FLASH_EMULATOR_SECTOR_SIZE
+    #define PAL_INTERNAL_FLASH_EMULATOR_SECTOR_SIZE (4*1024)
+#endif
+
+/*\brief  number of emulated sectors*/
+#ifndef PAL_INTERNAL_FLASH_EMULATOR_SECTOR_COUNT
+    #define PAL_INTERNAL_FLASH_EMULATOR_SECTOR_COUNT 16
+#endif
+
+/*\brief  emulated page size, the minimum writing unit*/
+#ifndef PAL_INTERNAL_FLASH_EMULATOR_PAGE_SIZE
+    #define PAL_INTERNAL_FLASH_EMULATOR_PAGE_SIZE 8
+#endif
+
+/*\brief  time in microseconds added to the erase of each sector*/
+#ifndef PAL_INTERNAL_FLASH_EMULATOR_ERASE_LATENCY_US
+    #define PAL_INTERNAL_FLASH_EMULATOR_ERASE_LATENCY_US 0
+#endif
+
+/*\brief  time in microseconds added to the programming of each page*/
+#ifndef PAL_INTERNAL_FLASH_EMULATOR_PROGRAM_LATENCY_US
+    #define PAL_INTERNAL_FLASH_EMULATOR_PROGRAM_LATENCY_US 0
+#endif
+
+/*\brief  number of erases after which a sector fails to erase, 0 for no limit*/
+#ifndef PAL_INTERNAL_FLASH_EMULATOR_ENDURANCE
+    #define PAL_INTERNAL_FLASH_EMULATOR_ENDURANCE 0
+#endif
+
+/*\brief  fail a write that would have to set a bit that is cleared, instead of keeping the bit cleared like the hardware*/
+#ifndef PAL_INTERNAL_FLASH_EMULATOR_STRICT_WRITE
+    #define PAL_INTERNAL_FLASH_EMULATOR_STRICT_WRITE 0
+#endif
+
+/*\brief  the two SOTP sections take the first four emulated sectors*/
+#ifndef PAL_INTERNAL_FLASH_SECTION_1_ADDRESS
+    #define PAL_INTERNAL_FLASH_SECTION_1_ADDRESS    0
+#endif
+
+#ifndef PAL_INTERNAL_FLASH_SECTION_2_ADDRESS
+    #define PAL_INTERNAL_FLASH_SECTION_2_ADDRESS    (2 * PAL_INTERNAL_FLASH_EMULATOR_SECTOR_SIZE)
+#endif
+
+#ifndef PAL_INTERNAL_FLASH_SECTION_1_SIZE
+    #define PAL_INTERNAL_FLASH_SECTION_1_SIZE       (2 * PAL_INTERNAL_FLASH_EMULATOR_SECTOR_SIZE)
+#endif
+
+#ifndef PAL_INTERNAL_FLASH_SECTION_2_SIZE
+    #define PAL_INTERNAL_FLASH_SECTION_2_SIZE       (2 * PAL_INTERNAL_FLASH_EMULATOR_SECTOR_SIZE)
+#endif
+
+#endif //PAL_INTERNAL_FLASH_EMULATOR
+
  /*\brief  Starting Address for section 1 Minimum requirement size is 1KB and section must be consecutive sectors*/
 #ifndef PAL_INTERNAL_FLASH_SECTION_1_ADDRESS
     #define PAL_INTERNAL_FLASH_SECTION_1_ADDRESS    0
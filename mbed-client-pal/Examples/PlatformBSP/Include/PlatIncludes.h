@@ -16,6 +16,8 @@
 #ifndef K64_BSPINCLUDES_H_
 #define K64_BSPINCLUDES_H_
 
+#include <stdint.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -61,6 +63,34 @@ void fileSystemMountDrive(void);
 #ifdef PAL_MEMORY_STATISTICS
 void printMemoryStats(void);
 #define PRINT_MEMORY_STATS	printMemoryStats();
+
+/*! Heap usage counted by the memory profiler (Utils/memoryProfiler/Other). */
+typedef struct palMemoryStats{
+	int32_t totalSize;    //!< Bytes currently allocated.
+	int32_t waterMark;    //!< Peak of totalSize since the last reset.
+	int32_t allocations;  //!< Number of allocations since the last reset.
+}palMemoryStats_t;
+
+/*! \brief Read the counters of the memory profiler.
+*
+* Dividing the difference of two readings by the number of operations done in
+* between gives the allocations per operation of a workload.
+*
+* @param[out] stats The counters.
+*
+* \return void
+*
+*/
+void getMemoryStats(palMemoryStats_t* stats);
+
+/*! \brief Restart the water marks from the current usage and zero the allocation count.
+*
+* @param None
+*
+* \return void
+*
+*/
+void resetMemoryStats(void);
 #else //PAL_MEMORY_STATISTICS
 #define PRINT_MEMORY_STATS
 #endif
@@ -366,6 +366,19 @@ palStatus_t pal_CtrDRBGGenerate(palCtrDrbgCtxHandle_t ctx, unsigned char* out, s
     return status;
 }
 
+palStatus_t pal_CtrDRBGReseed(palCtrDrbgCtxHandle_t ctx)
+{
+    palStatus_t status = PAL_SUCCESS;
+
+    if (NULLPTR == ctx)
+    {
+        return PAL_ERR_INVALID_ARGUMENT;
+    }
+
+    status = pal_plat_CtrDRBGReseed(ctx);
+    return status;
+}
+
 palStatus_t pal_CtrDRBGFree(palCtrDrbgCtxHandle_t* ctx)
 {
     palStatus_t status = PAL_SUCCESS;
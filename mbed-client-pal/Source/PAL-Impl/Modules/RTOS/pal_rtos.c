@@ -28,8 +28,19 @@ uint32_t g_palThreadPriorities[PAL_NUMBER_OF_THREADS_PRIORITIES] = {0};
 palMutexID_t g_palThreadInitMutex = NULLPTR;
 
 //! static variables for Random functionality.
-//! CTR-DRBG context to be used for generating random numbers from given seed
-static palCtrDrbgCtxHandle_t s_ctrDRBGCtx = NULLPTR;
+//! CTR-DRBG instances to be used for generating random numbers, each seeded from
+//! the platform entropy source and reseeded every PAL_RANDOM_DRBG_RESEED_INTERVAL calls.
+typedef struct palRandomDRBG
+{
+    palCtrDrbgCtxHandle_t ctx;
+    palMutexID_t mutex;
+    uint32_t requests; //!< Number of calls served since the last (re)seed.
+} palRandomDRBG_t;
+
+static palRandomDRBG_t s_randomDRBG[PAL_RANDOM_DRBG_INSTANCES];
+
+static palStatus_t pal_osRandomInit(void);
+static palStatus_t pal_osRandomDestroy(void);
 
 
 static uint64_t g_palDeviceBootTimeInSec = 0;
@@ -52,12 +63,18 @@ palStatus_t pal_RTOSInitialize(void* opaqueContext)
     {
         return PAL_SUCCESS;
     }
+#if PAL_UNIQUE_THREAD_PRIORITY
     memset(g_palThreadPriorities, 0, sizeof(g_palThreadPriorities));
+#endif //PAL_UNIQUE_THREAD_PRIORITY
     status = pal_osMutexCreate(&g_palThreadInitMutex);
     if(PAL_SUCCESS == status)
     {
         status = pal_plat_RTOSInitialize(opaqueContext);
         if(PAL_SUCCESS == status)
+        {
+            status = pal_osRandomInit();
+        }
+        if(PAL_SUCCESS == status)
         {
         	palRTOSInitialized = true;
         }
@@ -81,9 +98,9 @@ palStatus_t pal_RTOSDestroy(void)
 		palRTOSInitialized = false;
 
 	    status = pal_osMutexDelete(&g_palThreadInitMutex);
-		if ((NULLPTR != s_ctrDRBGCtx) && (PAL_SUCCESS == status))
+		if (PAL_SUCCESS == status)
 		{
-			status = pal_CtrDRBGFree(&s_ctrDRBGCtx);
+			status = pal_osRandomDestroy();
 		}
 	    if (PAL_SUCCESS == status)
 		{
@@ -457,33 +474,106 @@ palStatus_t pal_osRandom32bit(uint32_t *random)
     return status;
 }
 
+static palStatus_t pal_osRandomInit(void)
+{
+    palStatus_t status = PAL_SUCCESS;
+
+    for (int i = 0; (i < PAL_RANDOM_DRBG_INSTANCES) && (PAL_SUCCESS == status); ++i)
+    {
+        s_randomDRBG[i].ctx = NULLPTR;
+        s_randomDRBG[i].requests = 0;
+        status = pal_osMutexCreate(&s_randomDRBG[i].mutex);
+    }
+    return status;
+}
+
+static palStatus_t pal_osRandomDestroy(void)
+{
+    palStatus_t status = PAL_SUCCESS;
+
+    for (int i = 0; i < PAL_RANDOM_DRBG_INSTANCES; ++i)
+    {
+        if (NULLPTR != s_randomDRBG[i].ctx)
+        {
+            status = pal_CtrDRBGFree(&s_randomDRBG[i].ctx);
+        }
+        if (NULLPTR != s_randomDRBG[i].mutex)
+        {
+            pal_osMutexDelete(&s_randomDRBG[i].mutex);
+        }
+    }
+    return status;
+}
+
+//! Maps the calling thread to its DRBG instance.
+static palRandomDRBG_t* pal_osRandomInstance(void)
+{
+#if PAL_RANDOM_DRBG_INSTANCES > 1
+    uintptr_t id = (uintptr_t)pal_osThreadGetId();
+    // Thread IDs are handles or pointers on some platforms, fold their aligned low bits in
+    id ^= (id >> 4) ^ (id >> 12);
+    return &s_randomDRBG[id % PAL_RANDOM_DRBG_INSTANCES];
+#else
+    return &s_randomDRBG[0];
+#endif
+}
+
 palStatus_t pal_osRandomBuffer(uint8_t *randomBuf, size_t bufSizeBytes)
 {
     palStatus_t status = PAL_SUCCESS;
+    palRandomDRBG_t* drbg = NULL;
 
     if (NULL == randomBuf)
     {
         return PAL_ERR_INVALID_ARGUMENT;
     }
 
-    if (NULLPTR == s_ctrDRBGCtx)
+    drbg = pal_osRandomInstance();
+    // The mutexes only exist after pal_init(), before that there is a single thread
+    if (NULLPTR != drbg->mutex)
+    {
+        status = pal_osMutexWait(drbg->mutex, PAL_RTOS_WAIT_FOREVER);
+        if (PAL_SUCCESS != status)
+        {
+            return status;
+        }
+    }
+
+    if (NULLPTR == drbg->ctx)
     {
         uint8_t seed[PAL_INITIAL_RANDOM_SIZE] = {0}; //in order to get 128-bits initial seed
         status = pal_plat_osRandomBuffer(seed, sizeof(seed));
-        if (PAL_SUCCESS != status)
+        if (PAL_SUCCESS == status)
         {
-            goto finish;
+            status = pal_CtrDRBGInit(&drbg->ctx, (void*)seed, sizeof(seed));
+            if ((PAL_SUCCESS != status) && (NULLPTR != drbg->ctx))
+            {
+                pal_CtrDRBGFree(&drbg->ctx);
+            }
         }
-        status = pal_CtrDRBGInit(&s_ctrDRBGCtx, (void*)seed, sizeof(seed));
-        if (PAL_SUCCESS != status)
+        memset(seed, 0, sizeof(seed));
+        drbg->requests = 0;
+    }
+    else if (drbg->requests >= PAL_RANDOM_DRBG_RESEED_INTERVAL)
+    {
+        // Bounds how much output depends on a single seed, should the state ever leak
+        status = pal_CtrDRBGReseed(drbg->ctx);
+        if (PAL_SUCCESS == status)
         {
-            goto finish;
+            drbg->requests = 0;
         }
     }
 
-    status = pal_CtrDRBGGenerate(s_ctrDRBGCtx, (unsigned char*)randomBuf, bufSizeBytes);
+    if (PAL_SUCCESS == status)
+    {
+        status = pal_CtrDRBGGenerate(drbg->ctx, (unsigned char*)randomBuf, bufSizeBytes);
+        drbg->requests++;
+    }
 
-finish:
+    if (NULLPTR != drbg->mutex)
+    {
+        pal_osMutexRelease(drbg->mutex);
+    }
     return status;
 }
 
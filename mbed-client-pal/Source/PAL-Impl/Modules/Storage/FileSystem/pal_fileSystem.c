@@ -128,6 +128,44 @@ palStatus_t pal_fsFclose(palFileDescriptor_t *fd)
 }
 
 
+palStatus_t pal_fsFflush(palFileDescriptor_t *fd)
+{
+    palStatus_t ret = PAL_SUCCESS;
+    if (fd == NULL)
+    {
+        return PAL_ERR_FS_INVALID_ARGUMENT;
+    }
+    if (*fd == 0)
+    {
+        ret = PAL_ERR_FS_BAD_FD;
+    }
+    else
+    {
+        ret = pal_plat_fsFflush(fd);
+    }
+    return ret;
+}
+
+
+palStatus_t pal_fsFstat(palFileDescriptor_t *fd, pal_fsFileStat_t *stat)
+{
+    palStatus_t ret = PAL_SUCCESS;
+    if ((fd == NULL) || (stat == NULL))
+    {
+        return PAL_ERR_FS_INVALID_ARGUMENT;
+    }
+    if (*fd == 0)
+    {
+        ret = PAL_ERR_FS_BAD_FD;
+    }
+    else
+    {
+        ret = pal_plat_fsFstat(fd, stat);
+    }
+    return ret;
+}
+
+
 palStatus_t pal_fsFread(palFileDescriptor_t *fd, void * buffer, size_t numOfBytes, size_t *numberOfBytesRead)
 {
     palStatus_t ret = PAL_SUCCESS;
@@ -264,6 +302,25 @@ palStatus_t pal_fsCpFolder(const char *pathNameSrc,  char *pathNameDest)
 }
 
 
+palStatus_t pal_fsReplaceFolder(const char *pathNameSrc,  char *pathNameDest)
+{
+    palStatus_t ret = PAL_SUCCESS;
+    if ((pathNameSrc == NULL) || ((pathNameDest == NULL)))
+    {
+        ret = PAL_ERR_FS_INVALID_FILE_NAME;
+    }
+    else if ((pal_plat_fsSizeCheck(pathNameSrc) >= PAL_MAX_FOLDER_DEPTH_CHAR) || (pal_plat_fsSizeCheck(pathNameDest) >= PAL_MAX_FOLDER_DEPTH_CHAR))
+    {
+        ret = PAL_ERR_FS_FILENAME_LENGTH;
+    }
+    else
+    {
+        ret = pal_plat_fsReplaceFolder(pathNameSrc, pathNameDest);
+    }
+    return ret;
+}
+
+
 
 palStatus_t pal_fsSetMountPoint(pal_fsStorageID_t dataID, const char *path)
 {
@@ -110,7 +110,7 @@ palStatus_t pal_internalFlashWrite(const size_t size, const uint32_t address, co
 	    if (ret == PAL_SUCCESS)
 	    {
 	        alignmentLeft = size % pageSize; //Keep the leftover to be copied separately
-	        if (size > pageSize)
+	        if (size >= pageSize)
 	        {
 	            ret = pal_plat_internalFlashWrite(size - alignmentLeft, address, buffer);
 	        }
@@ -422,6 +422,14 @@ palStatus_t pal_CtrDRBGInit(palCtrDrbgCtxHandle_t* ctx, const void* seed, size_t
 */
 palStatus_t pal_CtrDRBGGenerate(palCtrDrbgCtxHandle_t ctx, unsigned char* out, size_t len);
 
+/*! CTR_DRBG reseed from the platform entropy source.
+*
+* @param[in] ctx:	The CTR_DRBG context.
+*
+\return PAL_SUCCESS on success. A negative value indicating a specific error code in case of failure.
+*/
+palStatus_t pal_CtrDRBGReseed(palCtrDrbgCtxHandle_t ctx);
+
 /*! CTR_DRBG destroy
 *
 * @param[in] ctx:   The CTR_DRBG context to destroy.
@@ -105,6 +105,16 @@
     #define PAL_INITIAL_RANDOM_SIZE 48
 #endif
 
+//! The number of CTR-DRBG instances behind `pal_osRandomBuffer`. A thread always uses the instance its thread ID maps to, so threads mostly do not wait for each other.
+#ifndef PAL_RANDOM_DRBG_INSTANCES
+    #define PAL_RANDOM_DRBG_INSTANCES 4
+#endif
+
+//! The number of `pal_osRandomBuffer` calls served by a CTR-DRBG instance before it is reseeded from the platform entropy source.
+#ifndef PAL_RANDOM_DRBG_RESEED_INTERVAL
+    #define PAL_RANDOM_DRBG_RESEED_INTERVAL 1024
+#endif
+
 #ifndef PAL_RTOS_WAIT_FOREVER
     #define PAL_RTOS_WAIT_FOREVER UINT_MAX
 #endif
@@ -112,9 +122,16 @@
 /*
  * TLS configuration
  */
-//! The the maximum number of TLS contexts supported.
+//! The the maximum number of simultaneous TLS contexts supported.
+//! Contexts are allocated on demand in slabs of `PAL_TLS_CTX_SLAB_SIZE`, so only a pointer per slab is reserved for the maximum.
 #ifndef PAL_MAX_NUM_OF_TLS_CTX
-    #define PAL_MAX_NUM_OF_TLS_CTX 1
+    #define PAL_MAX_NUM_OF_TLS_CTX 32
+#endif
+
+//! The number of TLS contexts allocated together when the TLS context table grows.
+//! The first slab is kept once allocated, so the usual single connection never allocates its context again.
+#ifndef PAL_TLS_CTX_SLAB_SIZE
+    #define PAL_TLS_CTX_SLAB_SIZE 1
 #endif
 
 //! The maximum number of supported cipher suites.
@@ -122,6 +139,11 @@
     #define PAL_MAX_ALLOWED_CIPHER_SUITES 1
 #endif
 
+//! The number of seeded TLS configurations kept after `pal_tlsConfigurationFree` for reuse by the next `pal_initTLSConfiguration`.
+#ifndef PAL_TLS_CONF_POOL_SIZE
+    #define PAL_TLS_CONF_POOL_SIZE 2
+#endif
+
 //! This value is in milliseconds. 1000 = 1 second.
 #ifndef PAL_DTLS_PEER_MIN_TIMEOUT
     #define PAL_DTLS_PEER_MIN_TIMEOUT 1000
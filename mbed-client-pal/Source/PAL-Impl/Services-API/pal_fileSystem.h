@@ -100,6 +100,15 @@
 
 typedef uintptr_t palFileDescriptor_t; //!< Pointer to a generic File Descriptor object
 
+/** \brief Status of an open file, see \c pal_fsFstat(). */
+typedef struct pal_fsFileStat {
+	uint64_t size;				//!< File size in bytes.
+	uint64_t deviceID;			//!< The device holding the file.
+	uint64_t fileID;			//!< The file number within the device, a file keeps it as long as it exists.
+	uint64_t modificationTime;	//!< Last change of the file content, in nanoseconds.
+	uint64_t changeTime;		//!< Last change of the file content or attributes, in nanoseconds. It cannot be set by a user.
+} pal_fsFileStat_t;
+
 /**
  @} */
 /**
@@ -259,6 +268,34 @@ palStatus_t pal_fsFopen(const char *pathName, pal_fsFileMode_t mode,
 palStatus_t pal_fsFclose(palFileDescriptor_t *fd);
 
 
+/*! \brief This function writes any buffered data of the file to the storage media.
+ *
+* @param[in] fd A pointer to the open file object structure.
+ *
+* \return PAL_SUCCESS upon successful operation. \n
+*         PAL_FILE_SYSTEM_ERROR - see error code \c palError_t.
+ *
+* \note When the function has completed successfully, the data written so far survives a power loss.
+ *
+ */
+palStatus_t pal_fsFflush(palFileDescriptor_t *fd);
+
+
+/*! \brief This function gets the status of an open file.
+ *
+* @param[in] fd A pointer to the open file object structure.
+* @param[out] stat The status of the file.
+ *
+* \return PAL_SUCCESS upon successful operation. \n
+*         PAL_ERR_NOT_SUPPORTED if the file system does not keep the file number and change times. \n
+*         PAL_FILE_SYSTEM_ERROR - see error code \c palError_t.
+ *
+* \note Any write to the file changes its status, so an unchanged status means unchanged content.
+ *
+ */
+palStatus_t pal_fsFstat(palFileDescriptor_t *fd, pal_fsFileStat_t *stat);
+
+
 /*! \brief This function reads an array of bytes from the stream and stores it in the block of memory
 *			specified by buffer. The position indicator of the stream is advanced by the total amount of bytes read.
  *
@@ -380,6 +417,20 @@ palStatus_t pal_fsRmFiles(const char *pathName);
  */
 palStatus_t pal_fsCpFolder(const char *pathNameSrc, char *pathNameDest);
 
+/*! \brief This function replaces the files of the destination folder with \b all files of the source folder (FLAT copy only).
+ *
+* @param[in]  pathNameSrc A pointer to a null-terminated string that specifies the source folder.
+* @param[in]  pathNameDest A pointer to a null-terminated string that specifies the destination folder (MUST exist).
+ *
+ * \return PAL_SUCCESS upon successful operation.\n
+*         PAL_FILE_SYSTEM_ERROR - see error code description \c palError_t.
+ *
+* \note Both folders \b must \b not \b be \b open. If the folders do not exist, the function fails.
+* \note Unlike \c pal_fsCpFolder(), the files of the destination that are not in the source are removed.
+* On Linux the destination is replaced in one step, so an interruption leaves either the old or the new files.
+ */
+palStatus_t pal_fsReplaceFolder(const char *pathNameSrc, char *pathNameDest);
+
 /*! \brief This function sets the mount directory for the given storage ID (primary or secondary), 
  *
 * @param[in]  Path A pointer to a null-terminated string that specifies the root folder.
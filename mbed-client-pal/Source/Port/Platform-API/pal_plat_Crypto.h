@@ -325,6 +325,14 @@ palStatus_t pal_plat_CtrDRBGSeed(palCtrDrbgCtxHandle_t ctx, const void* seed, si
 */
 palStatus_t pal_plat_CtrDRBGGenerate(palCtrDrbgCtxHandle_t ctx, unsigned char* out, size_t len);
 
+/*!	CTR_DRBG reseed with fresh data from the platform entropy source.
+*
+* @param[in] ctx:	The CTR_DRBG context.
+*
+\return PAL_SUCCESS on success. A negative value indicating a specific error code in case of failure.
+*/
+palStatus_t pal_plat_CtrDRBGReseed(palCtrDrbgCtxHandle_t ctx);
+
 /*!	AES cipher CMAC.
 *
 * @param[in] ctx:               The CMAC context to initialize.
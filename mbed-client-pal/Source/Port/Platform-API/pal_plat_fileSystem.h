@@ -100,6 +100,30 @@ palStatus_t pal_plat_fsFclose(palFileDescriptor_t *fd);
 
 
 
+/*! \brief This function writes any buffered data of the file, including the data cached by the operating system, to the storage media.
+*
+* @param[in] fd A pointer to the open file object structure.
+*
+* \return PAL_SUCCESS upon a successful operation. \n
+*         PAL_FILE_SYSTEM_ERROR - see the error code \c palError_t.
+*/
+palStatus_t pal_plat_fsFflush(palFileDescriptor_t *fd);
+
+
+
+/*! \brief This function gets the status of an open file.
+*
+* @param[in] fd A pointer to the open file object structure.
+* @param[out] stat The status of the file.
+*
+* \return PAL_SUCCESS upon a successful operation. \n
+*         PAL_ERR_NOT_SUPPORTED if the file system does not keep the file number and change times. \n
+*         PAL_FILE_SYSTEM_ERROR - see the error code \c palError_t.
+*/
+palStatus_t pal_plat_fsFstat(palFileDescriptor_t *fd, pal_fsFileStat_t *stat);
+
+
+
 /*! \brief	This function reads an array of bytes from the stream and stores them in the block of memory
 *			specified by the buffer. The position indicator of the stream is advanced by the total amount of bytes read.
 *
@@ -222,6 +246,22 @@ palStatus_t pal_plat_fsRmFiles(const char *pathName);
 palStatus_t pal_plat_fsCpFolder(const char *pathNameSrc,  char *pathNameDest);
 
 
+/*! \brief This function replaces the files of a destination folder with \b all files of a source folder (FLAT copy only).
+*
+* @param[in]  pathNameSrc A pointer to a null-terminated string that specifies the source folder.
+* @param[in]  pathNameDest A pointer to a null-terminated string that specifies the destination folder (MUST exist).
+*
+* \return PAL_SUCCESS upon a successful operation.\n
+*         PAL_FILE_SYSTEM_ERROR - see the error code description \c palError_t.
+*
+* \note Both folders \b must \b not \b be \b open. If a folder does not exist the function fails.
+* \note The files of the destination that are not in the source are removed, the directories found in it are kept.
+* \note A platform that can swap folders in one step should do so, so that an interrupted call leaves either
+*       the old or the new files.
+*/
+palStatus_t pal_plat_fsReplaceFolder(const char *pathNameSrc,  char *pathNameDest);
+
+
 /*! \brief This function gets the default value for  root directory (primary)
 *
 * @param[in]  dataID - id of the data to ge the root folder for.
@@ -105,6 +105,41 @@ size_t pal_plat_internalFlashGetSectorSize(uint32_t address);
 */
 palStatus_t pal_plat_internalFlashGetAreaInfo(bool section, palSotpAreaData_t *data);
 
+#if PAL_INTERNAL_FLASH_EMULATOR
+///////////////////////////////////////////////////////////////
+////-------------------Flash emulator------------------------//
+///////////////////////////////////////////////////////////////
+/*! \brief Wear counters of an emulated flash sector */
+typedef struct palFlashEmulatorSectorStats
+{
+    uint32_t eraseCount;        /*\brief  number of erases of the sector since the counters were reset*/
+    uint32_t bytesProgrammed;   /*\brief  number of bytes written to the sector since the counters were reset*/
+} palFlashEmulatorSectorStats_t;
+
+/*! \brief This function returns the number of sectors of the emulated flash
+*/
+size_t pal_plat_internalFlashEmulatorGetSectorCount(void);
+
+/*! \brief This function returns the wear counters of an emulated sector
+*
+* @param[in]	sector - the index of the sector, starting at the sector of address 0
+* @param[out]	stats - the counters of the sector
+*
+* \return PAL_SUCCESS upon successful operation. \n
+*         PAL_ERR_INTERNAL_FLASH_ERROR - see error code \c palError_t.
+*
+* \note The counters are kept in the file backing the flash, so they survive a restart.
+*/
+palStatus_t pal_plat_internalFlashEmulatorGetStats(uint32_t sector, palFlashEmulatorSectorStats_t *stats);
+
+/*! \brief This function resets the wear counters of all the emulated sectors
+*
+* \return PAL_SUCCESS upon successful operation. \n
+*         PAL_ERR_INTERNAL_FLASH_ERROR - see error code \c palError_t.
+*/
+palStatus_t pal_plat_internalFlashEmulatorResetStats(void);
+#endif //PAL_INTERNAL_FLASH_EMULATOR
+
 
 #ifdef __cplusplus
 }
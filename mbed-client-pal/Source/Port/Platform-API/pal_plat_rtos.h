@@ -48,11 +48,13 @@ extern "C" {
 
 //! An array of PAL thread priorities. The size of the array is defined in the Service API (`pal_configuration.h`) by PAL_MAX_NUMBER_OF_THREADS.
 extern uint32_t g_palThreadPriorities[PAL_NUMBER_OF_THREADS_PRIORITIES];
-extern palMutexID_t g_palThreadInitMutex ;
 
 #define PRIORITY_INDEX_OFFSET 3
 #endif //PAL_UNIQUE_THREAD_PRIORITY
 
+//! Serializes thread creation and termination, with or without unique thread priorities.
+extern palMutexID_t g_palThreadInitMutex ;
+
 #define PAL_SHA256_DEVICE_KEY_SIZE_IN_BYTES 32
 #define PAL_DEVICE_KEY_SIZE_IN_BYTES 16
 #define PAL_DEVICE_KEY_SIZE_IN_BITS (PAL_DEVICE_KEY_SIZE_IN_BYTES * 8)
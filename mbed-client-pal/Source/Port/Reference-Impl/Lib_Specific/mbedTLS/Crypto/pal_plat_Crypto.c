@@ -993,6 +993,30 @@ palStatus_t pal_plat_CtrDRBGGenerate(palCtrDrbgCtxHandle_t ctx, unsigned char* o
     return status;
 }
 
+palStatus_t pal_plat_CtrDRBGReseed(palCtrDrbgCtxHandle_t ctx)
+{
+    palStatus_t status = PAL_SUCCESS;
+    int32_t platStatus = CRYPTO_PLAT_SUCCESS;
+    palCtrDrbgCtx_t* palCtrDrbgCtx = (palCtrDrbgCtx_t*)ctx;
+
+    platStatus = mbedtls_ctr_drbg_reseed(&palCtrDrbgCtx->ctrDrbgCtx, NULL, 0);
+    if (CRYPTO_PLAT_SUCCESS != platStatus)
+    {
+        switch(platStatus)
+        {
+            case MBEDTLS_ERR_CTR_DRBG_ENTROPY_SOURCE_FAILED:
+                status = PAL_ERR_CTR_DRBG_ENTROPY_SOURCE_FAILED;
+                break;
+            default:
+                {
+                    PAL_LOG(ERR, "Crypto ctrdrbg reseed status %" PRId32 "", platStatus);
+                    status = PAL_ERR_GENERIC_FAILURE;
+                }
+        }
+    }
+    return status;
+}
+
 palStatus_t pal_plat_cipherCMAC(const unsigned char *key, size_t keyLenInBits, const unsigned char *input, size_t inputLenInBytes, unsigned char *output)
 {
     palStatus_t status = PAL_SUCCESS;
@@ -102,6 +102,8 @@ typedef struct palTLS{
 	palTLSConf_t* palConfCtx;
 	bool tlsInit;
 	uint32_t tlsIndex;
+	uint16_t generation; // must match the generation encoded in the handle
+	uint32_t nextFree; // next entry of the free list while the entry is not in use
 	char* psk; //NULL terminated
 	char* identity; //NULL terminated
 	bool wantReadOrWrite;
@@ -115,14 +117,42 @@ PAL_PRIVATE void palDebug(void *ctx, int debugLevel, const char *fileName, int l
 int pal_plat_entropySourceTLS( void *data, unsigned char *output, size_t len, size_t *olen );
 PAL_PRIVATE int palTimingGetDelay( void *data );
 PAL_PRIVATE void palTimingSetDelay( void *data, uint32_t intMs, uint32_t finMs );
-//! This is the array to hold the TLS context
-PAL_PRIVATE palTLS_t *g_palTLSContext = NULL;
+PAL_PRIVATE palTLSConf_t* pal_plat_tlsConfCheckOut(void);
+PAL_PRIVATE void pal_plat_tlsConfCheckIn(palTLSConf_t* localConfigCtx);
+//! A TLS handle holds the table index + 1 in its low bits and the generation of the entry above them,
+//! so a handle of a freed context is rejected even after its entry was reused.
+#define PAL_TLS_HANDLE_INDEX_BITS 16
+#define PAL_TLS_HANDLE_INDEX_MASK ((1UL << PAL_TLS_HANDLE_INDEX_BITS) - 1)
+#define PAL_TLS_CTX_SLABS ((PAL_MAX_NUM_OF_TLS_CTX + PAL_TLS_CTX_SLAB_SIZE - 1) / PAL_TLS_CTX_SLAB_SIZE)
+#define PAL_TLS_CTX_NONE UINT32_MAX
+
+#if (PAL_MAX_NUM_OF_TLS_CTX >= PAL_TLS_HANDLE_INDEX_MASK) || (PAL_TLS_CTX_SLAB_SIZE < 1)
+    #error "PAL_MAX_NUM_OF_TLS_CTX must be below 65535 and PAL_TLS_CTX_SLAB_SIZE at least 1"
+#endif
+
+//! This is the table to hold the TLS contexts. Slabs are allocated when the free list is empty and never
+//! move, so entry pointers stay valid; all but the first are released once the last context is freed.
+PAL_PRIVATE palTLS_t* g_palTLSSlabs[PAL_TLS_CTX_SLABS];
+PAL_PRIVATE uint32_t g_palTLSSlabCount = 0;
+PAL_PRIVATE uint32_t g_palTLSCount = 0;
+PAL_PRIVATE uint32_t g_palTLSFreeList = PAL_TLS_CTX_NONE;
+PAL_PRIVATE uint16_t g_palTLSGeneration = 0;
+PAL_PRIVATE palMutexID_t g_palTLSMutex = NULLPTR;
+
+//! Configurations released by pal_plat_tlsConfigurationFree(), kept with their CTR-DRBG
+//! seeded so the next configuration skips the entropy gathering. The mutex also
+//! serializes the seeding, as g_entropy is shared.
+PAL_PRIVATE palTLSConf_t* g_tlsConfPool[PAL_TLS_CONF_POOL_SIZE];
+PAL_PRIVATE palMutexID_t g_tlsConfPoolMutex = NULLPTR;
 
 palStatus_t pal_plat_initTLSLibrary(void)
 {
 	palStatus_t status = PAL_SUCCESS;
 
-	g_palTLSContext = NULL;
+	memset(g_palTLSSlabs, 0, sizeof(g_palTLSSlabs));
+	g_palTLSSlabCount = 0;
+	g_palTLSCount = 0;
+	g_palTLSFreeList = PAL_TLS_CTX_NONE;
 
 	g_entropy = (mbedtls_entropy_context*)malloc(sizeof(mbedtls_entropy_context));
 	if (NULL == g_entropy)
@@ -133,6 +163,12 @@ palStatus_t pal_plat_initTLSLibrary(void)
 	{
 		mbedtls_entropy_init(g_entropy);
 		g_entropyInitiated = false;
+		memset(g_tlsConfPool, 0, sizeof(g_tlsConfPool));
+		status = pal_osMutexCreate(&g_tlsConfPoolMutex);
+		if (PAL_SUCCESS == status)
+		{
+			status = pal_osMutexCreate(&g_palTLSMutex);
+		}
 	}
 
 	return status;
@@ -141,15 +177,36 @@ palStatus_t pal_plat_initTLSLibrary(void)
 
 palStatus_t pal_plat_cleanupTLS(void)
 {
+	for (int i = 0; i < PAL_TLS_CONF_POOL_SIZE; ++i)
+	{
+		if (NULL != g_tlsConfPool[i])
+		{
+			mbedtls_ctr_drbg_free(&g_tlsConfPool[i]->ctrDrbg);
+			free(g_tlsConfPool[i]->confCtx);
+			free(g_tlsConfPool[i]);
+			g_tlsConfPool[i] = NULL;
+		}
+	}
+	if (NULLPTR != g_tlsConfPoolMutex)
+	{
+		pal_osMutexDelete(&g_tlsConfPoolMutex);
+	}
 	mbedtls_entropy_free(g_entropy);
 	g_entropyInitiated = false;
 	free(g_entropy);
 	g_entropy = NULL;
-	if (g_palTLSContext)
+	if (NULLPTR != g_palTLSMutex)
+	{
+		pal_osMutexDelete(&g_palTLSMutex);
+	}
+	for (uint32_t i = 0; i < g_palTLSSlabCount; ++i)
 	{
-		free((void*)g_palTLSContext);
-		g_palTLSContext = NULL;
+		free(g_palTLSSlabs[i]);
+		g_palTLSSlabs[i] = NULL;
 	}
+	g_palTLSSlabCount = 0;
+	g_palTLSCount = 0;
+	g_palTLSFreeList = PAL_TLS_CTX_NONE;
 	return PAL_SUCCESS;
 }
 
@@ -182,23 +239,32 @@ palStatus_t pal_plat_addEntropySource(palEntropySource_f entropyCallback)
 }
 
 
-palStatus_t pal_plat_initTLSConf(palTLSConfHandle_t* palConfCtx, palTLSTransportMode_t transportVersion, palDTLSSide_t methodType)
+//! Takes a seeded configuration from the pool, or creates and seeds a new one.
+PAL_PRIVATE palTLSConf_t* pal_plat_tlsConfCheckOut(void)
 {
 	palStatus_t status = PAL_SUCCESS;
 	palTLSConf_t* localConfigCtx = NULL;
 	int32_t platStatus = SSL_LIB_SUCCESS;
-	int32_t endpoint = 0;
-	int32_t transport = 0;
 
-	if (NULLPTR == palConfCtx)
+	status = pal_osMutexWait(g_tlsConfPoolMutex, PAL_RTOS_WAIT_FOREVER);
+	if (PAL_SUCCESS != status)
 	{
-		return PAL_ERR_INVALID_ARGUMENT;
+		return NULL;
+	}
+
+	for (int i = 0; i < PAL_TLS_CONF_POOL_SIZE; ++i)
+	{
+		if (NULL != g_tlsConfPool[i])
+		{
+			localConfigCtx = g_tlsConfPool[i];
+			g_tlsConfPool[i] = NULL;
+			goto finish;
+		}
 	}
 
 	localConfigCtx = (palTLSConf_t*)malloc(sizeof(palTLSConf_t));
 	if (NULL == localConfigCtx)
 	{
-		status = PAL_ERR_NO_MEMORY;
 		goto finish;
 	}
 
@@ -208,6 +274,86 @@ palStatus_t pal_plat_initTLSConf(palTLSConfHandle_t* palConfCtx, palTLSTransport
 		status = PAL_ERR_NO_MEMORY;
 		goto finish;
 	}
+
+	mbedtls_ctr_drbg_init(&localConfigCtx->ctrDrbg);
+	status = pal_plat_addEntropySource(pal_plat_entropySourceTLS);
+	if (PAL_SUCCESS != status)
+	{
+		goto finish;
+	}
+
+	platStatus = mbedtls_ctr_drbg_seed(&localConfigCtx->ctrDrbg, mbedtls_entropy_func, g_entropy, NULL, 0); //Custom data can be defined in 
+																						  //pal_TLS.h header and to be defined by 
+																						  //Service code. But we need to check if other platform support this 
+																						  //input!
+	if (SSL_LIB_SUCCESS != platStatus)
+	{
+		status = PAL_ERR_TLS_CONFIG_INIT;
+	}
+
+finish:
+	if (PAL_SUCCESS != status && NULL != localConfigCtx)
+	{
+		if (NULL != localConfigCtx->confCtx)
+		{
+			mbedtls_ctr_drbg_free(&localConfigCtx->ctrDrbg);
+			free(localConfigCtx->confCtx);
+		}
+		free(localConfigCtx);
+		localConfigCtx = NULL;
+	}
+	pal_osMutexRelease(g_tlsConfPoolMutex);
+	return localConfigCtx;
+}
+
+//! Returns a configuration, whose mbedTLS configuration is already freed, to the pool, or frees it when the pool is full.
+PAL_PRIVATE void pal_plat_tlsConfCheckIn(palTLSConf_t* localConfigCtx)
+{
+	if (PAL_SUCCESS == pal_osMutexWait(g_tlsConfPoolMutex, PAL_RTOS_WAIT_FOREVER))
+	{
+		for (int i = 0; i < PAL_TLS_CONF_POOL_SIZE; ++i)
+		{
+			if (NULL == g_tlsConfPool[i])
+			{
+				g_tlsConfPool[i] = localConfigCtx;
+				localConfigCtx = NULL;
+				break;
+			}
+		}
+		pal_osMutexRelease(g_tlsConfPoolMutex);
+	}
+
+	if (NULL != localConfigCtx)
+	{
+		mbedtls_ctr_drbg_free(&localConfigCtx->ctrDrbg);
+		free(localConfigCtx->confCtx);
+		memset(localConfigCtx, 0, sizeof(palTLSConf_t));
+		free(localConfigCtx);
+	}
+}
+
+
+palStatus_t pal_plat_initTLSConf(palTLSConfHandle_t* palConfCtx, palTLSTransportMode_t transportVersion, palDTLSSide_t methodType)
+{
+	palStatus_t status = PAL_SUCCESS;
+	palTLSConf_t* localConfigCtx = NULL;
+	int32_t platStatus = SSL_LIB_SUCCESS;
+	int32_t endpoint = 0;
+	int32_t transport = 0;
+
+	if (NULLPTR == palConfCtx)
+	{
+		return PAL_ERR_INVALID_ARGUMENT;
+	}
+
+	localConfigCtx = pal_plat_tlsConfCheckOut();
+	if (NULL == localConfigCtx)
+	{
+		status = PAL_ERR_TLS_CONFIG_INIT;
+		goto finish;
+	}
+
+	localConfigCtx->palIOCtx = NULLPTR;
 	localConfigCtx->tlsIndex = 0;
 	localConfigCtx->hasKeys = false;
 	localConfigCtx->hasChain = false;
@@ -239,34 +385,14 @@ palStatus_t pal_plat_initTLSConf(palTLSConfHandle_t* palConfCtx, palTLSTransport
 		goto finish;
 	}								
 
-	mbedtls_ctr_drbg_init(&localConfigCtx->ctrDrbg);
-	status = pal_plat_addEntropySource(pal_plat_entropySourceTLS);
-	if (PAL_SUCCESS != status)
-	{
-		goto finish;
-	}								
-
-	platStatus = mbedtls_ctr_drbg_seed(&localConfigCtx->ctrDrbg, mbedtls_entropy_func, g_entropy, NULL, 0); //Custom data can be defined in 
-																						  //pal_TLS.h header and to be defined by 
-																						  //Service code. But we need to check if other platform support this 
-																						  //input!
-	if (SSL_LIB_SUCCESS != platStatus)
-	{
-		status = PAL_ERR_TLS_CONFIG_INIT;
-		goto finish;
-	}
-	
 	mbedtls_ssl_conf_rng(localConfigCtx->confCtx, mbedtls_ctr_drbg_random, &localConfigCtx->ctrDrbg);
 	*palConfCtx = (uintptr_t)localConfigCtx;
 	
 finish:	
 	if (PAL_SUCCESS != status && NULL != localConfigCtx)
 	{
-		if (NULL != localConfigCtx->confCtx)
-		{
-			free(localConfigCtx->confCtx);			
-		}
-		free(localConfigCtx);
+		mbedtls_ssl_config_free(localConfigCtx->confCtx);
+		pal_plat_tlsConfCheckIn(localConfigCtx);
 		*palConfCtx = NULLPTR;
 	}
 	return status;
@@ -297,64 +423,145 @@ palStatus_t pal_plat_tlsConfigurationFree(palTLSConfHandle_t* palTLSConf)
 	}
 
 	mbedtls_ssl_config_free(localConfigCtx->confCtx);
-	mbedtls_ctr_drbg_free(&localConfigCtx->ctrDrbg);
-
-	free(localConfigCtx->confCtx);
+	pal_plat_tlsConfCheckIn(localConfigCtx);
 
-	memset(localConfigCtx, 0, sizeof(palTLSConf_t));
-	free(localConfigCtx);
 	*palTLSConf = NULLPTR;
 	return status;
 }
 
 
-palStatus_t pal_plat_initTLS(palTLSConfHandle_t palTLSConf, palTLSHandle_t* palTLSHandle)
+PAL_PRIVATE palTLS_t* pal_plat_tlsCtxAt(uint32_t index)
 {
-	palStatus_t status = PAL_SUCCESS;
-	uint32_t firstAvailableCtxIndex = PAL_MAX_NUM_OF_TLS_CTX;
-	palTLSConf_t* localConfigCtx = (palTLSConf_t*)palTLSConf;
-	
+	return &g_palTLSSlabs[index / PAL_TLS_CTX_SLAB_SIZE][index % PAL_TLS_CTX_SLAB_SIZE];
+}
 
-	if (NULLPTR == palTLSConf || NULLPTR == palTLSHandle)
+//! Returns the TLS context of the handle, or NULL if the handle is not of a live context.
+PAL_PRIVATE palTLS_t* pal_plat_tlsCtxFromHandle(palTLSHandle_t palTLSHandle)
+{
+	uint32_t index = (uint32_t)(palTLSHandle & PAL_TLS_HANDLE_INDEX_MASK);
+	palTLS_t* localTLSCtx = NULL;
+
+	if ((0 == index) || (index > g_palTLSSlabCount * PAL_TLS_CTX_SLAB_SIZE))
 	{
-		return PAL_ERR_INVALID_ARGUMENT;
+		return NULL;
 	}
-	
-	if (NULL == g_palTLSContext) //We allocate the entire array only for the first time
+	localTLSCtx = pal_plat_tlsCtxAt(index - 1);
+	if ((false == localTLSCtx->tlsInit) || (localTLSCtx->generation != (uint16_t)(palTLSHandle >> PAL_TLS_HANDLE_INDEX_BITS)))
+	{
+		return NULL;
+	}
+	return localTLSCtx;
+}
+
+//! Takes an entry off the free list, growing the table by a slab if needed. Must be called with g_palTLSMutex held.
+PAL_PRIVATE palStatus_t pal_plat_tlsCtxAlloc(uint32_t* index)
+{
+	if (g_palTLSCount >= PAL_MAX_NUM_OF_TLS_CTX)
 	{
-		g_palTLSContext = (palTLS_t*)malloc(PAL_MAX_NUM_OF_TLS_CTX * sizeof(palTLS_t));
-		if (NULL == g_palTLSContext)
+		return PAL_ERR_TLS_RESOURCE;
+	}
+
+	if (PAL_TLS_CTX_NONE == g_palTLSFreeList)
+	{
+		uint32_t first = g_palTLSSlabCount * PAL_TLS_CTX_SLAB_SIZE;
+		palTLS_t* slab = NULL;
+
+		if (g_palTLSSlabCount >= PAL_TLS_CTX_SLABS)
 		{
-			status = PAL_ERR_TLS_RESOURCE;
-			goto finish;
+			return PAL_ERR_TLS_RESOURCE;
+		}
+		slab = (palTLS_t*)malloc(PAL_TLS_CTX_SLAB_SIZE * sizeof(palTLS_t));
+		if (NULL == slab)
+		{
+			return PAL_ERR_TLS_RESOURCE;
+		}
+		memset(slab, 0, PAL_TLS_CTX_SLAB_SIZE * sizeof(palTLS_t));
+		for (uint32_t i = 0; i < PAL_TLS_CTX_SLAB_SIZE; ++i)
+		{
+			slab[i].nextFree = first + i + 1;
 		}
-		memset((void*)g_palTLSContext, 0 ,PAL_MAX_NUM_OF_TLS_CTX * sizeof(palTLS_t));
+		slab[PAL_TLS_CTX_SLAB_SIZE - 1].nextFree = PAL_TLS_CTX_NONE;
+		g_palTLSSlabs[g_palTLSSlabCount] = slab;
+		g_palTLSSlabCount++;
+		g_palTLSFreeList = first;
 	}
 
-	for (uint32_t i=0 ; i < PAL_MAX_NUM_OF_TLS_CTX ; ++i)
+	*index = g_palTLSFreeList;
+	g_palTLSFreeList = pal_plat_tlsCtxAt(*index)->nextFree;
+	g_palTLSCount++;
+	return PAL_SUCCESS;
+}
+
+//! Puts an entry back on the free list. Must be called with g_palTLSMutex held.
+PAL_PRIVATE void pal_plat_tlsCtxRelease(uint32_t index)
+{
+	pal_plat_tlsCtxAt(index)->nextFree = g_palTLSFreeList;
+	g_palTLSFreeList = index;
+	g_palTLSCount--;
+
+	if ((0 == g_palTLSCount) && (g_palTLSSlabCount > 1)) // no more contexts, keep only the first slab for the next one
 	{
-		if (false == g_palTLSContext[i].tlsInit)
+		for (uint32_t i = 1; i < g_palTLSSlabCount; ++i)
 		{
-			firstAvailableCtxIndex = i;
-			break;
+			free(g_palTLSSlabs[i]);
+			g_palTLSSlabs[i] = NULL;
+		}
+		g_palTLSSlabCount = 1;
+		for (uint32_t i = 0; i < PAL_TLS_CTX_SLAB_SIZE; ++i)
+		{
+			g_palTLSSlabs[0][i].nextFree = i + 1;
 		}
+		g_palTLSSlabs[0][PAL_TLS_CTX_SLAB_SIZE - 1].nextFree = PAL_TLS_CTX_NONE;
+		g_palTLSFreeList = 0;
+	}
+}
+
+
+palStatus_t pal_plat_initTLS(palTLSConfHandle_t palTLSConf, palTLSHandle_t* palTLSHandle)
+{
+	palStatus_t status = PAL_SUCCESS;
+	uint32_t index = PAL_TLS_CTX_NONE;
+	palTLS_t* localTLSCtx = NULL;
+	palTLSConf_t* localConfigCtx = (palTLSConf_t*)palTLSConf;
+
+
+	if (NULLPTR == palTLSConf || NULLPTR == palTLSHandle)
+	{
+		return PAL_ERR_INVALID_ARGUMENT;
+	}
+
+	status = pal_osMutexWait(g_palTLSMutex, PAL_RTOS_WAIT_FOREVER);
+	if (PAL_SUCCESS != status)
+	{
+		return status;
 	}
 
-	if (firstAvailableCtxIndex >= PAL_MAX_NUM_OF_TLS_CTX)
+	status = pal_plat_tlsCtxAlloc(&index);
+	if (PAL_SUCCESS != status)
 	{
-        status = PAL_ERR_TLS_RESOURCE;
 		goto finish;
 	}
-	memset(&g_palTLSContext[firstAvailableCtxIndex], 0 , sizeof(palTLS_t));
-	mbedtls_ssl_init(&g_palTLSContext[firstAvailableCtxIndex].tlsCtx);
-	localConfigCtx->tlsIndex = firstAvailableCtxIndex;
-	g_palTLSContext[firstAvailableCtxIndex].palConfCtx = localConfigCtx;
-	g_palTLSContext[firstAvailableCtxIndex].tlsIndex = firstAvailableCtxIndex;
-	g_palTLSContext[firstAvailableCtxIndex].tlsInit = true;
-	mbedtls_ssl_set_timer_cb(&g_palTLSContext[firstAvailableCtxIndex].tlsCtx, &localConfigCtx->timerCtx, palTimingSetDelay, palTimingGetDelay);
-	*palTLSHandle = (palTLSHandle_t)&g_palTLSContext[firstAvailableCtxIndex];
+
+	g_palTLSGeneration++;
+	if (0 == g_palTLSGeneration)
+	{
+		g_palTLSGeneration = 1;
+	}
+
+	localTLSCtx = pal_plat_tlsCtxAt(index);
+	memset(localTLSCtx, 0 , sizeof(palTLS_t));
+	mbedtls_ssl_init(&localTLSCtx->tlsCtx);
+	localConfigCtx->tlsIndex = index;
+	localTLSCtx->palConfCtx = localConfigCtx;
+	localTLSCtx->tlsIndex = index;
+	localTLSCtx->generation = g_palTLSGeneration;
+	localTLSCtx->nextFree = PAL_TLS_CTX_NONE;
+	localTLSCtx->tlsInit = true;
+	mbedtls_ssl_set_timer_cb(&localTLSCtx->tlsCtx, &localConfigCtx->timerCtx, palTimingSetDelay, palTimingGetDelay);
+	*palTLSHandle = ((palTLSHandle_t)localTLSCtx->generation << PAL_TLS_HANDLE_INDEX_BITS) | (palTLSHandle_t)(index + 1);
 
 finish:
+	pal_osMutexRelease(g_palTLSMutex);
 	return status;
 }
 
@@ -363,42 +570,34 @@ palStatus_t pal_plat_freeTLS(palTLSHandle_t* palTLSHandle)
 {
 	palStatus_t status = PAL_SUCCESS;
 	palTLS_t* localTLSCtx = NULL;
-	bool foundActiveTLSCtx = false;
-	
+	uint32_t index = 0;
+
 	if (NULLPTR == palTLSHandle || NULLPTR == *palTLSHandle)
 	{
 		return PAL_ERR_INVALID_ARGUMENT;
 	}
 
-	localTLSCtx = (palTLS_t*)*palTLSHandle;
-	if (false == localTLSCtx->tlsInit)
+	status = pal_osMutexWait(g_palTLSMutex, PAL_RTOS_WAIT_FOREVER);
+	if (PAL_SUCCESS != status)
+	{
+		return status;
+	}
+
+	localTLSCtx = pal_plat_tlsCtxFromHandle(*palTLSHandle);
+	if (NULL == localTLSCtx)
 	{
 		status = PAL_ERR_TLS_CONTEXT_NOT_INITIALIZED;
 		goto finish;
 	}
 
-	g_palTLSContext[localTLSCtx->tlsIndex].tlsInit = false;
-
+	index = localTLSCtx->tlsIndex;
 	mbedtls_ssl_free(&localTLSCtx->tlsCtx);
 	memset(localTLSCtx, 0, sizeof(palTLS_t));
 	*palTLSHandle = NULLPTR;
+	pal_plat_tlsCtxRelease(index);
 
-	for (uint32_t i=0 ; i < PAL_MAX_NUM_OF_TLS_CTX ; ++i) //lets see if we need to release the global array
-	{
-		if (true == g_palTLSContext[i].tlsInit)
-		{
-			foundActiveTLSCtx = true;
-			break;
-		}
-	}	
-
-	if (false == foundActiveTLSCtx) // no more contexts, no need to hold the entire ctx array
-	{
-		free((void*)g_palTLSContext);
-		g_palTLSContext = NULL;
-	}
-	
 finish:
+	pal_osMutexRelease(g_palTLSMutex);
 	return status;
 }
 
@@ -480,13 +679,19 @@ finish:
 palStatus_t pal_plat_sslGetVerifyResult(palTLSHandle_t palTLSHandle)
 {
 	palStatus_t status = PAL_SUCCESS;
-	palTLS_t* localTLSCtx = (palTLS_t*)palTLSHandle;
+	palTLS_t* localTLSCtx = NULL;
 	int32_t platStatus = SSL_LIB_SUCCESS;
 
 	if (NULLPTR == palTLSHandle)
 	{
 		return PAL_ERR_INVALID_ARGUMENT;
 	}
+
+	localTLSCtx = pal_plat_tlsCtxFromHandle(palTLSHandle);
+	if (NULL == localTLSCtx)
+	{
+		return PAL_ERR_TLS_CONTEXT_NOT_INITIALIZED;
+	}
 	
 	platStatus = mbedtls_ssl_get_verify_result(&localTLSCtx->tlsCtx);
 	if (SSL_LIB_SUCCESS != platStatus)
@@ -504,13 +709,19 @@ palStatus_t pal_plat_sslRead(palTLSHandle_t palTLSHandle, void *buffer, uint32_t
 {
 	palStatus_t status = PAL_SUCCESS;
 	int32_t platStatus = SSL_LIB_SUCCESS;
-	palTLS_t* localTLSCtx = (palTLS_t*)palTLSHandle;
+	palTLS_t* localTLSCtx = NULL;
 
 	if (NULLPTR == palTLSHandle || NULL == buffer || NULL == actualLen)
 	{
 		return PAL_ERR_INVALID_ARGUMENT;
 	}
 
+	localTLSCtx = pal_plat_tlsCtxFromHandle(palTLSHandle);
+	if (NULL == localTLSCtx)
+	{
+		return PAL_ERR_TLS_CONTEXT_NOT_INITIALIZED;
+	}
+
 	platStatus = mbedtls_ssl_read(&localTLSCtx->tlsCtx, (unsigned char*)buffer, len);
 	if (platStatus > SSL_LIB_SUCCESS)
 	{
@@ -530,13 +741,19 @@ palStatus_t pal_plat_sslWrite(palTLSHandle_t palTLSHandle, const void *buffer, u
 {
 	palStatus_t status = PAL_SUCCESS;
 	int32_t platStatus = SSL_LIB_SUCCESS;
-	palTLS_t* localTLSCtx = (palTLS_t*)palTLSHandle;
+	palTLS_t* localTLSCtx = NULL;
 
 	if (NULLPTR == palTLSHandle || NULL == buffer || NULL == bytesWritten)
 	{
 		return PAL_ERR_INVALID_ARGUMENT;
 	}
 
+	localTLSCtx = pal_plat_tlsCtxFromHandle(palTLSHandle);
+	if (NULL == localTLSCtx)
+	{
+		return PAL_ERR_TLS_CONTEXT_NOT_INITIALIZED;
+	}
+
 	platStatus = mbedtls_ssl_write(&localTLSCtx->tlsCtx, (unsigned char*)buffer, len);
 	if (platStatus > SSL_LIB_SUCCESS)
 	{
@@ -584,7 +801,7 @@ palStatus_t pal_plat_setHandShakeTimeOut(palTLSConfHandle_t palTLSConf, uint32_t
 palStatus_t pal_plat_sslSetup(palTLSHandle_t palTLSHandle, palTLSConfHandle_t palTLSConf)
 {
 	palStatus_t status = PAL_SUCCESS;
-	palTLS_t* localTLSCtx = (palTLS_t*)palTLSHandle;
+	palTLS_t* localTLSCtx = NULL;
 	palTLSConf_t* localConfigCtx = (palTLSConf_t*)palTLSConf;
 	int32_t platStatus = SSL_LIB_SUCCESS;
 
@@ -593,6 +810,12 @@ palStatus_t pal_plat_sslSetup(palTLSHandle_t palTLSHandle, palTLSConfHandle_t pa
 		return PAL_ERR_INVALID_ARGUMENT;
 	}
 
+	localTLSCtx = pal_plat_tlsCtxFromHandle(palTLSHandle);
+	if (NULL == localTLSCtx)
+	{
+		return PAL_ERR_TLS_CONTEXT_NOT_INITIALIZED;
+	}
+
 	if (!localTLSCtx->wantReadOrWrite)
 	{
 		platStatus = mbedtls_ssl_setup(&localTLSCtx->tlsCtx, localConfigCtx->confCtx);
@@ -619,13 +842,19 @@ finish:
 palStatus_t pal_plat_handShake(palTLSHandle_t palTLSHandle)
 {
 	palStatus_t status = PAL_SUCCESS;
-	palTLS_t* localTLSCtx = (palTLS_t*)palTLSHandle;
+	palTLS_t* localTLSCtx = NULL;
 	int32_t platStatus = SSL_LIB_SUCCESS;
 
 	if (NULLPTR == palTLSHandle)
 	{
 		return PAL_ERR_INVALID_ARGUMENT;
 	}
+
+	localTLSCtx = pal_plat_tlsCtxFromHandle(palTLSHandle);
+	if (NULL == localTLSCtx)
+	{
+		return PAL_ERR_TLS_CONTEXT_NOT_INITIALIZED;
+	}
 	
 	platStatus = mbedtls_ssl_handshake(&localTLSCtx->tlsCtx);
 	switch(platStatus)
@@ -793,13 +1022,18 @@ palStatus_t pal_plat_sslSetIOCallBacks(palTLSConfHandle_t palTLSConf, palTLSSock
 		return status;
 	}
 
+	if (localConfigCtx->tlsIndex >= g_palTLSSlabCount * PAL_TLS_CTX_SLAB_SIZE)
+	{
+		return PAL_ERR_TLS_CONTEXT_NOT_INITIALIZED;
+	}
+
 	if (isNonBlocking)
 	{
-		mbedtls_ssl_set_bio(&g_palTLSContext[localConfigCtx->tlsIndex].tlsCtx, palIOCtx, palBIOSend, palBIORecv, NULL);
+		mbedtls_ssl_set_bio(&pal_plat_tlsCtxAt(localConfigCtx->tlsIndex)->tlsCtx, palIOCtx, palBIOSend, palBIORecv, NULL);
 	}
 	else
 	{
-		mbedtls_ssl_set_bio(&g_palTLSContext[localConfigCtx->tlsIndex].tlsCtx, palIOCtx, palBIOSend, NULL, palBIORecv_timeout);
+		mbedtls_ssl_set_bio(&pal_plat_tlsCtxAt(localConfigCtx->tlsIndex)->tlsCtx, palIOCtx, palBIOSend, NULL, palBIORecv_timeout);
 	}
 
 	return PAL_SUCCESS;
@@ -818,13 +1052,19 @@ palStatus_t pal_plat_sslDebugging(uint8_t turnOn)
 		func = palDebug;
 	}
 
-	for (int i=0 ; i < PAL_MAX_NUM_OF_TLS_CTX ; ++i )
+	status = pal_osMutexWait(g_palTLSMutex, PAL_RTOS_WAIT_FOREVER);
+	if (PAL_SUCCESS != status)
+	{
+		return status;
+	}
+	for (uint32_t i=0 ; i < g_palTLSSlabCount * PAL_TLS_CTX_SLAB_SIZE ; ++i )
 	{
-		if ((g_palTLSContext != NULL) && (g_palTLSContext[i].tlsInit))
+		if (pal_plat_tlsCtxAt(i)->tlsInit)
 		{
-			status = pal_plat_SetLoggingCb((palTLSConfHandle_t)g_palTLSContext[i].palConfCtx, func, NULL);
+			status = pal_plat_SetLoggingCb((palTLSConfHandle_t)pal_plat_tlsCtxAt(i)->palConfCtx, func, NULL);
 		}
 	}
+	pal_osMutexRelease(g_palTLSMutex);
 
 	return status;
 }
@@ -167,6 +167,35 @@ palStatus_t pal_plat_fsFclose(palFileDescriptor_t *fd)
 }
 
 
+palStatus_t pal_plat_fsFflush(palFileDescriptor_t *fd)
+{
+    FRESULT status = FR_OK;
+    palStatus_t ret = PAL_SUCCESS;
+
+    if (CHK_FD_VALIDITY(*fd))
+    {//Bad File Descriptor
+        ret = PAL_ERR_FS_BAD_FD;
+        return ret;
+    }
+
+    status = f_sync((FIL *)*fd);
+    if (FR_OK != status)
+    {
+        ret = pal_plat_errorTranslation(status);
+    }
+    return ret;
+}
+
+
+palStatus_t pal_plat_fsFstat(palFileDescriptor_t *fd, pal_fsFileStat_t *stat)
+{
+    // FatFs has no file number and keeps times in 2 seconds units
+    (void)fd;
+    (void)stat;
+    return PAL_ERR_NOT_SUPPORTED;
+}
+
+
 palStatus_t pal_plat_fsFread(palFileDescriptor_t *fd, void * buffer, size_t numOfBytes, size_t *numberOfBytesRead)
 {
     palStatus_t ret = PAL_SUCCESS;
@@ -488,6 +517,18 @@ palStatus_t pal_plat_fsCpFolder(const char *pathNameSrc,  char *pathNameDest)
 }
 
 
+palStatus_t pal_plat_fsReplaceFolder(const char *pathNameSrc,  char *pathNameDest)
+{
+    // Without an atomic swap the destination is emptied first, so an interrupted call leaves it partly copied
+    palStatus_t ret = pal_plat_fsRmFiles(pathNameDest);
+    if ((ret == PAL_SUCCESS) || (ret == PAL_ERR_FS_NO_FILE))
+    {
+        ret = pal_plat_fsCpFolder(pathNameSrc, pathNameDest);
+    }
+    return ret;
+}
+
+
 PAL_PRIVATE palStatus_t pal_plat_fsCpFile(const char *pathNameSrc,  char *pathNameDest, char * fileName)
 {
     palStatus_t ret = PAL_SUCCESS;
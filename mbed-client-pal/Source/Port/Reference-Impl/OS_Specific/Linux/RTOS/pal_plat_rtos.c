@@ -277,13 +277,19 @@ void* threadFunctionWrapper(void* arg)
 
     if ((NULL != threadWrapper) && (NULL != threadWrapper->realThreadFunc))
     {
+        // The wrapper lives in the thread's entry, which is cleaned and may be given to a new thread as soon as
+        // this thread is terminated, so the thread keeps its own copy of what it needs once its function returns.
+        palTimerFuncPtr realThreadFunc = threadWrapper->realThreadFunc;
+        void* realThreadArgs = threadWrapper->realThreadArgs;
+        uint32_t palThreadID = g_palThreads[threadWrapper->threadIndex].palThreadID;
+
         if(g_palThreads[threadWrapper->threadIndex].threadID == NULLPTR)
         {
             g_palThreads[threadWrapper->threadIndex].threadID =  pthread_self();
         }
 
-        threadWrapper->realThreadFunc(threadWrapper->realThreadArgs);
-        threadCleanUp(g_palThreads[threadWrapper->threadIndex].palThreadID);
+        realThreadFunc(realThreadArgs);
+        threadCleanUp(palThreadID);
 
     }
     return NULL;
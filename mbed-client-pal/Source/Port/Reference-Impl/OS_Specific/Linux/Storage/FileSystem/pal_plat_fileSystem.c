@@ -7,6 +7,11 @@
 #include <string.h>
 #include <dirent.h>
 #include <stdlib.h>
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <sys/sendfile.h>
+#include <sys/syscall.h>
+#include <linux/fs.h>
 
 //PAL Includes
 #include "pal.h"
@@ -15,6 +20,11 @@
 
 
 #define PAL_FS_COPY_BUFFER_SIZE 256                                                            //!< Size of the chunk to copy files
+#define PAL_FS_SWAP_FOLDER_SUFFIX ".palswap"                                                   //!< Suffix of the staging folder of pal_plat_fsCpFolder
+
+#ifndef RENAME_EXCHANGE
+#define RENAME_EXCHANGE (1 << 1)                                                               //!< renameat2() flag, missing in older headers
+#endif
 
 PAL_PRIVATE const char* g_platOpenModeConvert[] = {"0", "r", "r+", "w+x", "w+"};                    //!< platform convert table for \b fopen() modes
 PAL_PRIVATE const int g_platSeekWhenceConvert[] = {0, SEEK_SET, SEEK_CUR, SEEK_END};                //!< platform convert table for \b fseek() relative position modes
@@ -68,6 +78,52 @@ PAL_PRIVATE palStatus_t pal_plat_addFileNameToPath(const char *pathName, const c
 */
 PAL_PRIVATE palStatus_t pal_plat_fsCpFile(const char *pathNameSrc,  char *pathNameDest, char * fileName);
 
+/*! \brief This function copy the regular files of the source folder to the destination folder, one by one
+*
+* @param[in]  pathNameSrc - Pointer to a null-terminated string that specifies the source dir.
+* @param[in]  pathNameDest - Pointer to a null-terminated string that specifies the destination dir
+*
+* \return PAL_SUCCESS upon successful operation.\n
+*         PAL_FILE_SYSTEM_ERROR - see error code description \c palError_t
+*/
+PAL_PRIVATE palStatus_t pal_plat_fsCpFolderInPlace(const char *pathNameSrc,  const char *pathNameDest);
+
+#if PAL_FS_KERNEL_COPY
+/*! \brief This function copy a file without passing the data through user space
+*
+* The data is shared with a reflink (FICLONE) where the file system supports it, and copied with
+* copy_file_range() or sendfile() otherwise.
+*
+* @param[in]  pathSrc - Pointer to a null-terminated string that specifies the source file.
+* @param[in]  pathDest - Pointer to a null-terminated string that specifies the destination file.
+*
+* \return PAL_SUCCESS upon successful operation.\n
+*         PAL_ERR_NOT_SUPPORTED - none of the methods is supported for these files and nothing was written.\n
+*         PAL_FILE_SYSTEM_ERROR - see error code description \c palError_t
+*
+* \note If the Destination file exist then it shall be truncated
+*/
+PAL_PRIVATE palStatus_t pal_plat_fsKernelCpFile(const char *pathSrc, const char *pathDest);
+#endif
+
+#if PAL_FS_CP_FOLDER_ATOMIC_SWAP
+/*! \brief This function copy the files of the source folder to the destination folder as a single atomic step
+*
+* The current files of the destination, unless they are replaced, and the files of the source are copied to a staging
+* folder next to the destination, which is then exchanged with the destination folder by renameat2(RENAME_EXCHANGE).
+* After a power failure the destination holds either all of the old or all of the new files.
+*
+* @param[in]  pathNameSrc - Pointer to a null-terminated string that specifies the source dir.
+* @param[in]  pathNameDest - Pointer to a null-terminated string that specifies the destination dir
+* @param[in]  keepDestFiles - true to keep the files of the destination that are not in the source, false to remove them
+*
+* \return PAL_SUCCESS upon successful operation.\n
+*         PAL_ERR_NOT_SUPPORTED - the swap can not be used for these folders and the destination was not changed.\n
+*         PAL_FILE_SYSTEM_ERROR - see error code description \c palError_t
+*/
+PAL_PRIVATE palStatus_t pal_plat_fsCpFolderSwap(const char *pathNameSrc,  const char *pathNameDest, bool keepDestFiles);
+#endif
+
 palStatus_t pal_plat_fsMkdir(const char *pathName)
 {
     palStatus_t ret = PAL_SUCCESS;
@@ -126,6 +182,40 @@ palStatus_t pal_plat_fsFclose(palFileDescriptor_t *fd)
 }
 
 
+palStatus_t pal_plat_fsFflush(palFileDescriptor_t *fd)
+{
+    palStatus_t ret = PAL_SUCCESS;
+    // fflush() only hands the stdio buffer to the kernel, fsync() pushes it to the device
+    if (fflush((FILE *)*fd) || fsync(fileno((FILE *)*fd)))
+    {
+        ret = pal_plat_errorTranslation(errno);
+    }
+    return ret;
+}
+
+
+palStatus_t pal_plat_fsFstat(palFileDescriptor_t *fd, pal_fsFileStat_t *stat)
+{
+    palStatus_t ret = PAL_SUCCESS;
+    struct stat fileStat;
+
+    // Written data may still be in the stdio buffer, it must reach the file for its times to change
+    if (fflush((FILE *)*fd) || fstat(fileno((FILE *)*fd), &fileStat))
+    {
+        ret = pal_plat_errorTranslation(errno);
+    }
+    else
+    {
+        stat->size = (uint64_t)fileStat.st_size;
+        stat->deviceID = (uint64_t)fileStat.st_dev;
+        stat->fileID = (uint64_t)fileStat.st_ino;
+        stat->modificationTime = ((uint64_t)fileStat.st_mtim.tv_sec * 1000000000) + (uint64_t)fileStat.st_mtim.tv_nsec;
+        stat->changeTime = ((uint64_t)fileStat.st_ctim.tv_sec * 1000000000) + (uint64_t)fileStat.st_ctim.tv_nsec;
+    }
+    return ret;
+}
+
+
 palStatus_t pal_plat_fsFread(palFileDescriptor_t *fd, void * buffer, size_t numOfBytes, size_t *numberOfBytesRead)
 {
     palStatus_t ret = PAL_SUCCESS;
@@ -260,6 +350,38 @@ palStatus_t pal_plat_fsRmFiles(const char *pathName)
 
 
 palStatus_t pal_plat_fsCpFolder(const char *pathNameSrc,  char *pathNameDest)
+{
+#if PAL_FS_CP_FOLDER_ATOMIC_SWAP
+    palStatus_t ret = pal_plat_fsCpFolderSwap(pathNameSrc, pathNameDest, true);
+    if (ret != PAL_ERR_NOT_SUPPORTED)
+    {
+        return ret;
+    }
+#endif
+    return pal_plat_fsCpFolderInPlace(pathNameSrc, pathNameDest);
+}
+
+
+palStatus_t pal_plat_fsReplaceFolder(const char *pathNameSrc,  char *pathNameDest)
+{
+    palStatus_t ret = PAL_SUCCESS;
+#if PAL_FS_CP_FOLDER_ATOMIC_SWAP
+    ret = pal_plat_fsCpFolderSwap(pathNameSrc, pathNameDest, false);
+    if (ret != PAL_ERR_NOT_SUPPORTED)
+    {
+        return ret;
+    }
+#endif
+    ret = pal_plat_fsRmFiles(pathNameDest);
+    if ((ret == PAL_SUCCESS) || (ret == PAL_ERR_FS_NO_FILE))
+    {
+        ret = pal_plat_fsCpFolderInPlace(pathNameSrc, pathNameDest);
+    }
+    return ret;
+}
+
+
+PAL_PRIVATE palStatus_t pal_plat_fsCpFolderInPlace(const char *pathNameSrc,  const char *pathNameDest)
 {
     DIR *src_dh = NULL; //Directory for the source Directory handler
     palStatus_t ret = PAL_SUCCESS;
@@ -287,7 +409,7 @@ palStatus_t pal_plat_fsCpFolder(const char *pathNameSrc,  char *pathNameDest)
                     continue;
                 }
                 //copy the file to the destination
-                ret = pal_plat_fsCpFile(pathNameSrc, pathNameDest, currentEntry->d_name);
+                ret = pal_plat_fsCpFile(pathNameSrc, (char *)pathNameDest, currentEntry->d_name);
                 if (ret != PAL_SUCCESS)
                 {
                     break;
@@ -317,6 +439,19 @@ PAL_PRIVATE palStatus_t pal_plat_fsCpFile(const char *pathNameSrc,  char *pathNa
     char * buffer = NULL;
     size_t bytesCount = 0;
 
+#if PAL_FS_KERNEL_COPY
+    char dest_name[PAL_MAX_FILE_AND_FOLDER_LENGTH] = {0};
+
+    pal_plat_addFileNameToPath(pathNameSrc, fileName, buffer_name, sizeof(buffer_name));
+    pal_plat_addFileNameToPath(pathNameDest, fileName, dest_name, sizeof(dest_name));
+    ret = pal_plat_fsKernelCpFile(buffer_name, dest_name);
+    if (ret != PAL_ERR_NOT_SUPPORTED)
+    {
+        return ret;
+    }
+    ret = PAL_SUCCESS;
+#endif
+
     //Add file name to path
     pal_plat_addFileNameToPath(pathNameSrc, fileName, buffer_name, sizeof(buffer_name));
     src_fd = (palFileDescriptor_t)fopen(buffer_name, g_platOpenModeConvert[PAL_FS_FLAG_READONLY]);
@@ -382,6 +517,245 @@ PAL_PRIVATE palStatus_t pal_plat_fsCpFile(const char *pathNameSrc,  char *pathNa
     return ret;
 }
 
+#if PAL_FS_KERNEL_COPY
+PAL_PRIVATE palStatus_t pal_plat_fsKernelCpFile(const char *pathSrc, const char *pathDest)
+{
+    palStatus_t ret = PAL_SUCCESS;
+    struct stat srcStat;
+    off_t offset = 0;
+    ssize_t copied = 0;
+    int srcFd = -1;
+    int dstFd = -1;
+
+    srcFd = open(pathSrc, O_RDONLY);
+    if ((srcFd < 0) || fstat(srcFd, &srcStat))
+    {
+        ret = pal_plat_errorTranslation(errno);
+        goto finish;
+    }
+    dstFd = open(pathDest, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+    if (dstFd < 0)
+    {
+        ret = pal_plat_errorTranslation(errno);
+        goto finish;
+    }
+
+#ifdef FICLONE
+    // On copy on write file systems the destination shares the extents of the source
+    if (ioctl(dstFd, FICLONE, srcFd) == 0)
+    {
+        goto finish;
+    }
+#endif
+
+#ifdef SYS_copy_file_range
+    {
+        loff_t inOffset = 0;
+        loff_t outOffset = 0;
+        while (inOffset < srcStat.st_size)
+        {
+            copied = syscall(SYS_copy_file_range, srcFd, &inOffset, dstFd, &outOffset, (size_t)(srcStat.st_size - inOffset), 0);
+            if (copied <= 0)
+            {
+                break;
+            }
+        }
+        offset = (off_t)inOffset;
+    }
+    if ((offset > 0) || (srcStat.st_size == 0))
+    {
+        // Once data was copied a failure can no longer be retried another way
+        if (copied < 0)
+        {
+            ret = pal_plat_errorTranslation(errno);
+        }
+        else if (offset < srcStat.st_size)
+        {
+            ret = PAL_ERR_FS_ERROR; // The file was truncated while copying
+        }
+        goto finish;
+    }
+#endif
+
+    // copy_file_range() is not available for this pair of files, e.g. across file systems on older kernels
+    while (offset < srcStat.st_size)
+    {
+        copied = sendfile(dstFd, srcFd, &offset, (size_t)(srcStat.st_size - offset));
+        if (copied <= 0)
+        {
+            break;
+        }
+    }
+    if (offset == 0)
+    {
+        ret = PAL_ERR_NOT_SUPPORTED;
+    }
+    else if (copied < 0)
+    {
+        ret = pal_plat_errorTranslation(errno);
+    }
+    else if (offset < srcStat.st_size)
+    {
+        ret = PAL_ERR_FS_ERROR;
+    }
+
+finish:
+    if (srcFd >= 0)
+    {
+        close(srcFd);
+    }
+    if ((dstFd >= 0) && close(dstFd) && (ret == PAL_SUCCESS))
+    {
+        ret = pal_plat_errorTranslation(errno);
+    }
+    return ret;
+}
+#endif //PAL_FS_KERNEL_COPY
+
+
+#if PAL_FS_CP_FOLDER_ATOMIC_SWAP
+/*! \brief This function flush a file or a folder to the storage */
+PAL_PRIVATE palStatus_t pal_plat_fsSyncPath(const char *pathName)
+{
+    palStatus_t ret = PAL_SUCCESS;
+    int fd = open(pathName, O_RDONLY);
+    if ((fd < 0) || fsync(fd))
+    {
+        ret = pal_plat_errorTranslation(errno);
+    }
+    if (fd >= 0)
+    {
+        close(fd);
+    }
+    return ret;
+}
+
+
+/*! \brief This function remove a folder with the files in it, ignoring a missing folder */
+PAL_PRIVATE void pal_plat_fsRemoveFolder(const char *pathName)
+{
+    if (pal_plat_fsRmFiles(pathName) == PAL_SUCCESS)
+    {
+        rmdir(pathName);
+    }
+}
+
+
+PAL_PRIVATE palStatus_t pal_plat_fsCpFolderSwap(const char *pathNameSrc,  const char *pathNameDest, bool keepDestFiles)
+{
+    palStatus_t ret = PAL_SUCCESS;
+    char stagePath[PAL_MAX_FILE_AND_FOLDER_LENGTH] = {0};
+    char parentPath[PAL_MAX_FILE_AND_FOLDER_LENGTH] = {0};
+    char filePath[PAL_MAX_FILE_AND_FOLDER_LENGTH] = {0};
+    char * separator = NULL;
+    struct stat pathStat;
+    struct dirent * currentEntry = NULL;
+    DIR *dh = NULL;
+    size_t length = 0;
+    int platStatus = -1;
+
+    // Both folders must exist, otherwise the in place copy reports the error
+    if (stat(pathNameSrc, &pathStat) || !S_ISDIR(pathStat.st_mode) ||
+        stat(pathNameDest, &pathStat) || !S_ISDIR(pathStat.st_mode))
+    {
+        return PAL_ERR_NOT_SUPPORTED;
+    }
+
+    strncpy(stagePath, pathNameDest, sizeof(stagePath) - 1);
+    length = strlen(stagePath);
+    while ((length > 1) && (stagePath[length - 1] == '/'))
+    {
+        stagePath[--length] = '\0';
+    }
+    if (length + sizeof(PAL_FS_SWAP_FOLDER_SUFFIX) > sizeof(stagePath))
+    {
+        return PAL_ERR_NOT_SUPPORTED;
+    }
+    strncpy(parentPath, stagePath, sizeof(parentPath) - 1);
+    separator = strrchr(parentPath, '/');
+    if (separator == NULL)
+    {
+        strncpy(parentPath, ".", sizeof(parentPath) - 1);
+    }
+    else
+    {
+        separator[(separator == parentPath) ? 1 : 0] = '\0';
+    }
+    strncat(stagePath, PAL_FS_SWAP_FOLDER_SUFFIX, sizeof(stagePath) - length - 1);
+
+    // Sub folders of the destination are left in place by pal_fsCpFolder(), which a swap can not do
+    dh = opendir(pathNameDest);
+    if (dh == NULL)
+    {
+        return PAL_ERR_NOT_SUPPORTED;
+    }
+    while (pal_plat_findNextFile(dh, &currentEntry) && currentEntry && (currentEntry->d_type != DT_DIR))
+    {
+    }
+    closedir(dh);
+    if (currentEntry)
+    {
+        return PAL_ERR_NOT_SUPPORTED;
+    }
+
+    // A staging folder left by an interrupted copy is stale
+    pal_plat_fsRemoveFolder(stagePath);
+    ret = pal_plat_fsMkdir(stagePath);
+    if ((ret == PAL_SUCCESS) && keepDestFiles)
+    {
+        ret = pal_plat_fsCpFolderInPlace(pathNameDest, stagePath);
+    }
+    if (ret == PAL_SUCCESS)
+    {
+        ret = pal_plat_fsCpFolderInPlace(pathNameSrc, stagePath);
+    }
+    if (ret == PAL_SUCCESS)
+    {
+        // The new files must be on the storage before the swap makes them visible
+        dh = opendir(stagePath);
+        if (dh == NULL)
+        {
+            ret = pal_plat_errorTranslation(errno);
+        }
+        while ((ret == PAL_SUCCESS) && pal_plat_findNextFile(dh, &currentEntry) && currentEntry)
+        {
+            pal_plat_addFileNameToPath(stagePath, currentEntry->d_name, filePath, sizeof(filePath));
+            ret = pal_plat_fsSyncPath(filePath);
+        }
+        if (dh)
+        {
+            closedir(dh);
+        }
+    }
+    if (ret == PAL_SUCCESS)
+    {
+        ret = pal_plat_fsSyncPath(stagePath);
+    }
+    if (ret != PAL_SUCCESS)
+    {
+        pal_plat_fsRemoveFolder(stagePath);
+        return ret;
+    }
+
+    errno = ENOSYS;
+#ifdef SYS_renameat2
+    platStatus = syscall(SYS_renameat2, AT_FDCWD, stagePath, AT_FDCWD, pathNameDest, RENAME_EXCHANGE);
+#endif
+    if (platStatus)
+    {
+        // The kernel or the file system does not support the exchange
+        ret = ((errno == EINVAL) || (errno == ENOSYS)) ? PAL_ERR_NOT_SUPPORTED : pal_plat_errorTranslation(errno);
+        pal_plat_fsRemoveFolder(stagePath);
+        return ret;
+    }
+
+    // The staging folder now holds the old files
+    ret = pal_plat_fsSyncPath(parentPath);
+    pal_plat_fsRemoveFolder(stagePath);
+    return ret;
+}
+#endif //PAL_FS_CP_FOLDER_ATOMIC_SWAP
+
 
 const char* pal_plat_fsGetDefaultRootFolder(pal_fsStorageID_t dataID)
 {
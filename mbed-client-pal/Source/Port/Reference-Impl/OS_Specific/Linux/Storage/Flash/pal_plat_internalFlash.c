@@ -17,10 +17,302 @@
 #include "pal.h"
 #include "pal_plat_internalFlash.h"
 
+#if PAL_INTERNAL_FLASH_EMULATOR
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// The emulated flash is a file holding the flash content, followed by the wear counters of each sector and a
+// trailer describing the geometry. The file is mapped into memory, so reads and writes are plain memory accesses.
+#define PAL_FLASH_EMULATOR_MAGIC        0x48534C46 //"FLSH"
+#define PAL_FLASH_EMULATOR_SIZE         ((size_t)PAL_INTERNAL_FLASH_EMULATOR_SECTOR_SIZE * PAL_INTERNAL_FLASH_EMULATOR_SECTOR_COUNT)
+
+typedef struct palFlashEmulatorTrailer
+{
+    uint32_t magic;
+    uint32_t sectorSize;
+    uint32_t sectorCount;
+    uint32_t pageSize;
+} palFlashEmulatorTrailer_t;
+
+#define PAL_FLASH_EMULATOR_FILE_SIZE    (PAL_FLASH_EMULATOR_SIZE + \
+                                         sizeof(palFlashEmulatorSectorStats_t) * PAL_INTERNAL_FLASH_EMULATOR_SECTOR_COUNT + \
+                                         sizeof(palFlashEmulatorTrailer_t))
+#endif //PAL_INTERNAL_FLASH_EMULATOR
+
 
 ////////////////////////////PRIVATE///////////////////////////////////
+#if PAL_INTERNAL_FLASH_EMULATOR
+PAL_PRIVATE int g_flashFd = -1;
+PAL_PRIVATE uint8_t *g_flashMemory = NULL;
+PAL_PRIVATE palFlashEmulatorSectorStats_t *g_flashStats = NULL;
+
+PAL_PRIVATE void pal_plat_flashEmulatorDelay(uint32_t microseconds)
+{
+    if (microseconds > 0)
+    {
+        usleep(microseconds);
+    }
+}
+#endif //PAL_INTERNAL_FLASH_EMULATOR
 ////////////////////////////END PRIVATE////////////////////////////////
 
+#if PAL_INTERNAL_FLASH_EMULATOR
+
+palStatus_t pal_plat_internalFlashInit(void)
+{
+    palStatus_t ret = PAL_SUCCESS;
+    palFlashEmulatorTrailer_t *trailer = NULL;
+    struct stat fileStat;
+    char filePath[PAL_MAX_FILE_AND_FOLDER_LENGTH] = {0};
+    char mountPoint[PAL_MAX_FOLDER_DEPTH_CHAR + 1] = {0};
+
+    if (g_flashMemory != NULL)
+    {
+        return PAL_SUCCESS;
+    }
+
+    // The file holds the SOTP sections, so it is kept with the rest of the device storage and only the owner can access it
+    ret = pal_fsGetMountPoint(PAL_FS_PARTITION_PRIMARY, sizeof(mountPoint), mountPoint);
+    if ((ret != PAL_SUCCESS) ||
+        (snprintf(filePath, sizeof(filePath), "%s/%s", mountPoint, PAL_INTERNAL_FLASH_EMULATOR_FILE) >= (int)sizeof(filePath)))
+    {
+        return PAL_ERR_INTERNAL_FLASH_INIT_ERROR;
+    }
+
+    // The mount point may not have been used yet
+    if (mkdir(mountPoint, 0700) && (errno != EEXIST))
+    {
+        return PAL_ERR_INTERNAL_FLASH_INIT_ERROR;
+    }
+
+    g_flashFd = open(filePath, O_RDWR | O_CREAT, 0600);
+    if ((g_flashFd < 0) || fstat(g_flashFd, &fileStat))
+    {
+        ret = PAL_ERR_INTERNAL_FLASH_INIT_ERROR;
+        goto finish;
+    }
+    if (((size_t)fileStat.st_size != PAL_FLASH_EMULATOR_FILE_SIZE) && ftruncate(g_flashFd, PAL_FLASH_EMULATOR_FILE_SIZE))
+    {
+        ret = PAL_ERR_INTERNAL_FLASH_INIT_ERROR;
+        goto finish;
+    }
+
+    g_flashMemory = (uint8_t *)mmap(NULL, PAL_FLASH_EMULATOR_FILE_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, g_flashFd, 0);
+    if (g_flashMemory == MAP_FAILED)
+    {
+        g_flashMemory = NULL;
+        ret = PAL_ERR_INTERNAL_FLASH_INIT_ERROR;
+        goto finish;
+    }
+    g_flashStats = (palFlashEmulatorSectorStats_t *)(g_flashMemory + PAL_FLASH_EMULATOR_SIZE);
+    trailer = (palFlashEmulatorTrailer_t *)(g_flashStats + PAL_INTERNAL_FLASH_EMULATOR_SECTOR_COUNT);
+
+    // A new file, or one created with another geometry, starts as a fully erased flash
+    if ((trailer->magic != PAL_FLASH_EMULATOR_MAGIC) ||
+        (trailer->sectorSize != PAL_INTERNAL_FLASH_EMULATOR_SECTOR_SIZE) ||
+        (trailer->sectorCount != PAL_INTERNAL_FLASH_EMULATOR_SECTOR_COUNT) ||
+        (trailer->pageSize != PAL_INTERNAL_FLASH_EMULATOR_PAGE_SIZE))
+    {
+        memset(g_flashMemory, 0xFF, PAL_FLASH_EMULATOR_SIZE);
+        memset(g_flashStats, 0, sizeof(palFlashEmulatorSectorStats_t) * PAL_INTERNAL_FLASH_EMULATOR_SECTOR_COUNT);
+        trailer->sectorSize = PAL_INTERNAL_FLASH_EMULATOR_SECTOR_SIZE;
+        trailer->sectorCount = PAL_INTERNAL_FLASH_EMULATOR_SECTOR_COUNT;
+        trailer->pageSize = PAL_INTERNAL_FLASH_EMULATOR_PAGE_SIZE;
+        trailer->magic = PAL_FLASH_EMULATOR_MAGIC;
+    }
+
+finish:
+    if ((ret != PAL_SUCCESS) && (g_flashFd >= 0))
+    {
+        close(g_flashFd);
+        g_flashFd = -1;
+    }
+    return ret;
+}
+
+
+palStatus_t pal_plat_internalFlashDeInit(void)
+{
+    palStatus_t ret = PAL_SUCCESS;
+    if (g_flashMemory != NULL)
+    {
+        if (msync(g_flashMemory, PAL_FLASH_EMULATOR_FILE_SIZE, MS_SYNC) || munmap(g_flashMemory, PAL_FLASH_EMULATOR_FILE_SIZE))
+        {
+            ret = PAL_ERR_INTERNAL_FLASH_GENERIC_FAILURE;
+        }
+        g_flashMemory = NULL;
+        g_flashStats = NULL;
+    }
+    if (g_flashFd >= 0)
+    {
+        close(g_flashFd);
+        g_flashFd = -1;
+    }
+    return ret;
+}
+
+
+palStatus_t pal_plat_internalFlashWrite(const size_t size, const uint32_t address, const uint32_t * buffer)
+{
+    const uint8_t *source = (const uint8_t *)buffer;
+    uint8_t *destination = NULL;
+    size_t i = 0;
+    size_t chunk = 0;
+
+    if (g_flashMemory == NULL)
+    {
+        return PAL_ERR_INTERNAL_FLASH_NOT_INIT_ERROR;
+    }
+    if ((address % PAL_INTERNAL_FLASH_EMULATOR_PAGE_SIZE) != 0)
+    {
+        return PAL_ERR_INTERNAL_FLASH_ADDRESS_NOT_ALIGNED;
+    }
+    if ((size % PAL_INTERNAL_FLASH_EMULATOR_PAGE_SIZE) != 0)
+    {
+        return PAL_ERR_INTERNAL_FLASH_BUFFER_SIZE_NOT_ALIGNED;
+    }
+    if ((address >= PAL_FLASH_EMULATOR_SIZE) || (size > PAL_FLASH_EMULATOR_SIZE - address))
+    {
+        return PAL_ERR_INTERNAL_FLASH_WRONG_SIZE;
+    }
+
+    destination = g_flashMemory + address;
+#if PAL_INTERNAL_FLASH_EMULATOR_STRICT_WRITE
+    for (i = 0; i < size; i++)
+    {
+        if ((destination[i] & source[i]) != source[i])
+        {
+            return PAL_ERR_INTERNAL_FLASH_WRITE_ERROR; // Programming can not set a bit back to 1
+        }
+    }
+#endif
+    // Like NOR flash, programming can only clear bits
+    for (i = 0; i < size; i++)
+    {
+        destination[i] &= source[i];
+    }
+
+    // Credit each sector with the bytes programmed in it
+    for (i = 0; i < size; i += chunk)
+    {
+        chunk = PAL_INTERNAL_FLASH_EMULATOR_SECTOR_SIZE - ((address + i) % PAL_INTERNAL_FLASH_EMULATOR_SECTOR_SIZE);
+        if (chunk > size - i)
+        {
+            chunk = size - i;
+        }
+        g_flashStats[(address + i) / PAL_INTERNAL_FLASH_EMULATOR_SECTOR_SIZE].bytesProgrammed += chunk;
+    }
+    pal_plat_flashEmulatorDelay((uint32_t)(size / PAL_INTERNAL_FLASH_EMULATOR_PAGE_SIZE) * PAL_INTERNAL_FLASH_EMULATOR_PROGRAM_LATENCY_US);
+    return PAL_SUCCESS;
+}
+
+
+palStatus_t pal_plat_internalFlashRead(const size_t size, const uint32_t address, uint32_t * buffer)
+{
+    if (g_flashMemory == NULL)
+    {
+        return PAL_ERR_INTERNAL_FLASH_NOT_INIT_ERROR;
+    }
+    if ((address >= PAL_FLASH_EMULATOR_SIZE) || (size > PAL_FLASH_EMULATOR_SIZE - address))
+    {
+        return PAL_ERR_INTERNAL_FLASH_WRONG_SIZE;
+    }
+    memcpy(buffer, g_flashMemory + address, size);
+    return PAL_SUCCESS;
+}
+
+
+palStatus_t pal_plat_internalFlashErase(uint32_t address, size_t size)
+{
+    uint32_t sector = 0;
+
+    if (g_flashMemory == NULL)
+    {
+        return PAL_ERR_INTERNAL_FLASH_NOT_INIT_ERROR;
+    }
+    if ((address % PAL_INTERNAL_FLASH_EMULATOR_SECTOR_SIZE) || (size % PAL_INTERNAL_FLASH_EMULATOR_SECTOR_SIZE))
+    {
+        return PAL_ERR_INTERNAL_FLASH_SECTOR_NOT_ALIGNED;
+    }
+    if ((address >= PAL_FLASH_EMULATOR_SIZE) || (size > PAL_FLASH_EMULATOR_SIZE - address))
+    {
+        return PAL_ERR_INTERNAL_FLASH_WRONG_SIZE;
+    }
+
+    for (sector = address / PAL_INTERNAL_FLASH_EMULATOR_SECTOR_SIZE; size > 0; sector++, size -= PAL_INTERNAL_FLASH_EMULATOR_SECTOR_SIZE)
+    {
+#if PAL_INTERNAL_FLASH_EMULATOR_ENDURANCE
+        if (g_flashStats[sector].eraseCount >= PAL_INTERNAL_FLASH_EMULATOR_ENDURANCE)
+        {
+            return PAL_ERR_INTERNAL_FLASH_ERASE_ERROR; // The sector is worn out
+        }
+#endif
+        memset(g_flashMemory + (size_t)sector * PAL_INTERNAL_FLASH_EMULATOR_SECTOR_SIZE, 0xFF, PAL_INTERNAL_FLASH_EMULATOR_SECTOR_SIZE);
+        g_flashStats[sector].eraseCount++;
+        pal_plat_flashEmulatorDelay(PAL_INTERNAL_FLASH_EMULATOR_ERASE_LATENCY_US);
+    }
+    return PAL_SUCCESS;
+}
+
+
+size_t pal_plat_internalFlashGetPageSize(void)
+{
+    return PAL_INTERNAL_FLASH_EMULATOR_PAGE_SIZE;
+}
+
+
+size_t pal_plat_internalFlashGetSectorSize(uint32_t address)
+{
+    if (address >= PAL_FLASH_EMULATOR_SIZE)
+    {
+        return 0;
+    }
+    return PAL_INTERNAL_FLASH_EMULATOR_SECTOR_SIZE;
+}
+
+
+size_t pal_plat_internalFlashEmulatorGetSectorCount(void)
+{
+    return PAL_INTERNAL_FLASH_EMULATOR_SECTOR_COUNT;
+}
+
+
+palStatus_t pal_plat_internalFlashEmulatorGetStats(uint32_t sector, palFlashEmulatorSectorStats_t *stats)
+{
+    if (stats == NULL)
+    {
+        return PAL_ERR_INTERNAL_FLASH_NULL_PTR_RECEIVED;
+    }
+    if (g_flashStats == NULL)
+    {
+        return PAL_ERR_INTERNAL_FLASH_NOT_INIT_ERROR;
+    }
+    if (sector >= PAL_INTERNAL_FLASH_EMULATOR_SECTOR_COUNT)
+    {
+        return PAL_ERR_INTERNAL_FLASH_WRONG_SIZE;
+    }
+    *stats = g_flashStats[sector];
+    return PAL_SUCCESS;
+}
+
+
+palStatus_t pal_plat_internalFlashEmulatorResetStats(void)
+{
+    if (g_flashStats == NULL)
+    {
+        return PAL_ERR_INTERNAL_FLASH_NOT_INIT_ERROR;
+    }
+    memset(g_flashStats, 0, sizeof(palFlashEmulatorSectorStats_t) * PAL_INTERNAL_FLASH_EMULATOR_SECTOR_COUNT);
+    return PAL_SUCCESS;
+}
+
+#else //PAL_INTERNAL_FLASH_EMULATOR
+
 palStatus_t pal_plat_internalFlashInit(void)
 {
 	return PAL_SUCCESS;
@@ -61,3 +353,5 @@ size_t pal_plat_internalFlashGetSectorSize(uint32_t address)
 {
 	return 0;
 }
+
+#endif //PAL_INTERNAL_FLASH_EMULATOR
@@ -176,6 +176,27 @@ palStatus_t pal_plat_fsFclose(palFileDescriptor_t *fd)
 }
 
 
+palStatus_t pal_plat_fsFflush(palFileDescriptor_t *fd)
+{
+    palStatus_t ret = PAL_SUCCESS;
+    // fsync() makes the file system commit the file, fflush() only empties the stdio buffer
+    if (fflush((FILE *)*fd) || fsync(fileno((FILE *)*fd)))
+    {
+        ret = pal_plat_errorTranslation(errno);
+    }
+    return ret;
+}
+
+
+palStatus_t pal_plat_fsFstat(palFileDescriptor_t *fd, pal_fsFileStat_t *stat)
+{
+    // The FAT file system has no file number and keeps times in 2 seconds units at best
+    (void)fd;
+    (void)stat;
+    return PAL_ERR_NOT_SUPPORTED;
+}
+
+
 palStatus_t pal_plat_fsFread(palFileDescriptor_t *fd, void * buffer, size_t numOfBytes, size_t *numberOfBytesRead)
 {
     palStatus_t ret = PAL_SUCCESS;
@@ -353,6 +374,18 @@ palStatus_t pal_plat_fsCpFolder(const char *pathNameSrc,  char *pathNameDest)
 }
 
 
+palStatus_t pal_plat_fsReplaceFolder(const char *pathNameSrc,  char *pathNameDest)
+{
+    // Without an atomic swap the destination is emptied first, so an interrupted call leaves it partly copied
+    palStatus_t ret = pal_plat_fsRmFiles(pathNameDest);
+    if ((ret == PAL_SUCCESS) || (ret == PAL_ERR_FS_NO_FILE))
+    {
+        ret = pal_plat_fsCpFolder(pathNameSrc, pathNameDest);
+    }
+    return ret;
+}
+
+
 PAL_PRIVATE palStatus_t pal_plat_fsCpFile(const char *pathNameSrc,  char *pathNameDest, char * fileName)
 {
     palStatus_t ret = PAL_SUCCESS;
@@ -0,0 +1,376 @@
+/*
+ * Copyright (c) 2016 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Benchmark and model check of the callback registry of mbed-client, M2MCallbackStorage.
+ *
+ * The benchmark creates BENCHMARK_RESOURCES resources, each with a value
+ * updated, an execute and a notification sent callback, and measures:
+ *  - "setup" the registration of the callbacks of every resource,
+ *  - "dispatch" BENCHMARK_DISPATCH_ROUNDS rounds of the value updated and
+ *    execute callbacks of every resource, the lookups made when a PUT or a
+ *    POST reaches a resource,
+ *  - "teardown" the delete of the object tree, which removes the callbacks of
+ *    every resource.
+ * For every step the benchmark prints the time of the step and the average
+ * time per resource.
+ *
+ * The model check runs BENCHMARK_MODEL_OPERATIONS random adds, removes and
+ * lookups on the callbacks of BENCHMARK_MODEL_RESOURCES resources, and checks
+ * every result against a flat list of the associations in the order they
+ * were added: the first callback added for an object and a type is the one
+ * returned and removed. The operations alternate between phases that mostly
+ * add and phases that mostly remove, so the storage grows and shrinks.
+ */
+
+#include "pal.h"
+#include "pal_test_main.h"
+#include "mbed-client/m2mobject.h"
+#include "mbed-client/m2mobjectinstance.h"
+#include "mbed-client/m2mresource.h"
+#include "include/m2mcallbackstorage.h"
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+
+// The figures are the output of the benchmark, so they do not depend on DEBUG like PAL_PRINTF
+#define BENCHMARK_PRINTF(ARGS...) printf(ARGS)
+
+#ifndef BENCHMARK_RESOURCES
+#define BENCHMARK_RESOURCES 50000
+#endif
+#define BENCHMARK_RESOURCES_PER_INSTANCE 100
+#define BENCHMARK_DISPATCH_ROUNDS 4
+#define BENCHMARK_NAME_SIZE 8
+
+#define BENCHMARK_MODEL_RESOURCES 61
+#define BENCHMARK_MODEL_CALLBACKS 4 // callbacks per object and type, so that a pair can hold more than one
+#define BENCHMARK_MODEL_SIZE (BENCHMARK_MODEL_RESOURCES * M2MCallbackAssociation::M2MCallbackTypeCount * BENCHMARK_MODEL_CALLBACKS)
+#define BENCHMARK_MODEL_OPERATIONS 1000000
+#define BENCHMARK_MODEL_PHASE 20000
+#define BENCHMARK_MODEL_SEED 0x2545F491
+
+typedef struct benchmarkAssociation
+{
+	const M2MBase* object;
+	void* callback;
+	M2MCallbackAssociation::M2MCallbackType type;
+	void* clientArgs;
+} benchmarkAssociation_t;
+
+PAL_PRIVATE uint32_t g_valueUpdated;
+PAL_PRIVATE uint32_t g_executed;
+PAL_PRIVATE uint32_t g_random;
+PAL_PRIVATE benchmarkAssociation_t g_model[BENCHMARK_MODEL_SIZE];
+PAL_PRIVATE uint32_t g_modelCount;
+
+
+PAL_PRIVATE uint64_t benchmarkTicksToMicroSec(uint64_t ticks)
+{
+	return (ticks * 1000000) / pal_osKernelSysTickFrequency();
+}
+
+PAL_PRIVATE void benchmarkReport(const char* step, uint64_t start, uint32_t count)
+{
+	uint64_t elapsedUs = benchmarkTicksToMicroSec(pal_osKernelSysTick() - start);
+
+	BENCHMARK_PRINTF("%-8s %lu resources in %lu us, %lu ns per resource\r\n", step, (unsigned long)count,
+	            (unsigned long)elapsedUs, (unsigned long)((elapsedUs * 1000) / count));
+}
+
+PAL_PRIVATE void benchmarkValueUpdated(const char*)
+{
+	++g_valueUpdated;
+}
+
+PAL_PRIVATE void benchmarkExecute(void*)
+{
+	++g_executed;
+}
+
+PAL_PRIVATE void benchmarkNotificationSent(void)
+{
+}
+
+// Object with BENCHMARK_RESOURCES_PER_INSTANCE resources in each of its instances
+class BenchmarkObject : public M2MObject {
+public:
+	BenchmarkObject() : M2MObject("32769", stringdup("32769")) {}
+
+	bool createResources(M2MResource** resources, uint32_t count)
+	{
+		char name[BENCHMARK_NAME_SIZE];
+		M2MObjectInstance* instance = NULL;
+		uint32_t i = 0;
+
+		for (i = 0; i < count; ++i)
+		{
+			if (0 == (i % BENCHMARK_RESOURCES_PER_INSTANCE))
+			{
+				instance = create_object_instance((uint16_t)(i / BENCHMARK_RESOURCES_PER_INSTANCE));
+				if (NULL == instance)
+				{
+					return false;
+				}
+			}
+			snprintf(name, sizeof(name), "%lu", (unsigned long)(i % BENCHMARK_RESOURCES_PER_INSTANCE));
+			resources[i] = instance->create_dynamic_resource(name, "Benchmark", M2MResourceInstance::INTEGER, false);
+			if (NULL == resources[i])
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+};
+
+PAL_PRIVATE palStatus_t benchmarkDispatch(void)
+{
+	BenchmarkObject* object = new BenchmarkObject();
+	M2MResource** resources = (M2MResource**)calloc(BENCHMARK_RESOURCES, sizeof(M2MResource*));
+	const String name("Benchmark");
+	uint64_t start = 0;
+	uint32_t round = 0;
+	uint32_t i = 0;
+
+	if ((NULL == resources) || !object->createResources(resources, BENCHMARK_RESOURCES))
+	{
+		free(resources);
+		delete object;
+		return PAL_ERR_NO_MEMORY;
+	}
+
+	start = pal_osKernelSysTick();
+	for (i = 0; i < BENCHMARK_RESOURCES; ++i)
+	{
+		if (!resources[i]->set_value_updated_function(benchmarkValueUpdated) ||
+		    !resources[i]->set_execute_function(benchmarkExecute) ||
+		    !resources[i]->set_notification_sent_callback(benchmarkNotificationSent))
+		{
+			free(resources);
+			delete object;
+			return PAL_ERR_NO_MEMORY;
+		}
+	}
+	benchmarkReport("setup", start, BENCHMARK_RESOURCES);
+
+	g_valueUpdated = 0;
+	g_executed = 0;
+	start = pal_osKernelSysTick();
+	for (round = 0; round < BENCHMARK_DISPATCH_ROUNDS; ++round)
+	{
+		for (i = 0; i < BENCHMARK_RESOURCES; ++i)
+		{
+			resources[i]->execute_value_updated(name);
+			resources[i]->execute(NULL);
+		}
+	}
+	benchmarkReport("dispatch", start, BENCHMARK_RESOURCES * BENCHMARK_DISPATCH_ROUNDS);
+
+	start = pal_osKernelSysTick();
+	delete object;
+	benchmarkReport("teardown", start, BENCHMARK_RESOURCES);
+	free(resources);
+
+	if ((g_valueUpdated != (BENCHMARK_RESOURCES * BENCHMARK_DISPATCH_ROUNDS)) ||
+	    (g_executed != (BENCHMARK_RESOURCES * BENCHMARK_DISPATCH_ROUNDS)))
+	{
+		return PAL_ERR_GENERIC_FAILURE;
+	}
+	return PAL_SUCCESS;
+}
+
+// xorshift32, the model check is the same on every run
+PAL_PRIVATE uint32_t benchmarkRandom(uint32_t range)
+{
+	g_random ^= g_random << 13;
+	g_random ^= g_random >> 17;
+	g_random ^= g_random << 5;
+	return g_random % range;
+}
+
+// Index of the first association of the pair in the model, or -1 if there is none
+PAL_PRIVATE int32_t benchmarkModelFind(const M2MBase* object, M2MCallbackAssociation::M2MCallbackType type, void* callback)
+{
+	uint32_t i = 0;
+
+	for (i = 0; i < g_modelCount; ++i)
+	{
+		if ((g_model[i].object == object) && (g_model[i].type == type) && ((NULL == callback) || (g_model[i].callback == callback)))
+		{
+			return (int32_t)i;
+		}
+	}
+	return -1;
+}
+
+PAL_PRIVATE void benchmarkModelRemoveAt(uint32_t index)
+{
+	memmove(&g_model[index], &g_model[index + 1], (g_modelCount - index - 1) * sizeof(g_model[0]));
+	--g_modelCount;
+}
+
+// Compares the lookups of a pair with the model
+PAL_PRIVATE bool benchmarkModelCheck(const M2MBase* object, M2MCallbackAssociation::M2MCallbackType type)
+{
+	const int32_t index = benchmarkModelFind(object, type, NULL);
+	void* callback = M2MCallbackStorage::get_callback(*object, type);
+	M2MCallbackAssociation* association = M2MCallbackStorage::get_association_item(*object, type);
+
+	if (index < 0)
+	{
+		return (NULL == callback) && (NULL == association) && !M2MCallbackStorage::does_callback_exist(*object, type);
+	}
+	return (g_model[index].callback == callback) && (NULL != association) &&
+	       (association->_object == object) && (association->_callback == callback) &&
+	       (association->_type == type) && (association->_client_args == g_model[index].clientArgs) &&
+	       M2MCallbackStorage::does_callback_exist(*object, type);
+}
+
+PAL_PRIVATE palStatus_t benchmarkModel(void)
+{
+	BenchmarkObject* object = new BenchmarkObject();
+	M2MResource* resources[BENCHMARK_MODEL_RESOURCES];
+	palStatus_t status = PAL_SUCCESS;
+	uint32_t operations = 0;
+	uint32_t maxCount = 0;
+	uint32_t i = 0;
+	int type = 0;
+
+	if (!object->createResources(resources, BENCHMARK_MODEL_RESOURCES))
+	{
+		delete object;
+		return PAL_ERR_NO_MEMORY;
+	}
+	g_random = BENCHMARK_MODEL_SEED;
+	g_modelCount = 0;
+
+	for (operations = 0; (operations < BENCHMARK_MODEL_OPERATIONS) && (PAL_SUCCESS == status); ++operations)
+	{
+		const M2MBase* resource = resources[benchmarkRandom(BENCHMARK_MODEL_RESOURCES)];
+		const M2MCallbackAssociation::M2MCallbackType callbackType =
+		        (M2MCallbackAssociation::M2MCallbackType)benchmarkRandom(M2MCallbackAssociation::M2MCallbackTypeCount);
+		void* callback = (void*)(uintptr_t)(0x1000 + benchmarkRandom(BENCHMARK_MODEL_CALLBACKS));
+		void* clientArgs = (void*)(uintptr_t)benchmarkRandom(0x10000);
+		// Even phases add three times out of four, odd phases remove three times out of four
+		const bool addPhase = (0 == ((operations / BENCHMARK_MODEL_PHASE) & 1));
+		const uint32_t operation = benchmarkRandom(8);
+
+		if ((operation < 4) && ((operation < 3) == addPhase))
+		{
+			const bool added = M2MCallbackStorage::add_callback(*resource, callback, callbackType, clientArgs);
+			const bool expected = (benchmarkModelFind(resource, callbackType, callback) < 0);
+
+			if (added != expected)
+			{
+				status = PAL_ERR_GENERIC_FAILURE;
+			}
+			else if (added)
+			{
+				g_model[g_modelCount].object = resource;
+				g_model[g_modelCount].callback = callback;
+				g_model[g_modelCount].type = callbackType;
+				g_model[g_modelCount].clientArgs = clientArgs;
+				++g_modelCount;
+			}
+		}
+		else if (operation < 4)
+		{
+			const int32_t index = benchmarkModelFind(resource, callbackType, NULL);
+			void* removed = M2MCallbackStorage::remove_callback(*resource, callbackType);
+
+			if (removed != ((index < 0) ? NULL : g_model[index].callback))
+			{
+				status = PAL_ERR_GENERIC_FAILURE;
+			}
+			else if (index >= 0)
+			{
+				benchmarkModelRemoveAt((uint32_t)index);
+			}
+		}
+		if ((PAL_SUCCESS == status) && !benchmarkModelCheck(resource, callbackType))
+		{
+			status = PAL_ERR_GENERIC_FAILURE;
+		}
+		if (g_modelCount > maxCount)
+		{
+			maxCount = g_modelCount;
+		}
+	}
+
+	// Remove what is left, pair by pair, in the order of the model
+	while ((PAL_SUCCESS == status) && (g_modelCount > 0))
+	{
+		const M2MBase* resource = g_model[0].object;
+		const M2MCallbackAssociation::M2MCallbackType callbackType = g_model[0].type;
+
+		if (M2MCallbackStorage::remove_callback(*resource, callbackType) != g_model[0].callback)
+		{
+			status = PAL_ERR_GENERIC_FAILURE;
+		}
+		benchmarkModelRemoveAt(0);
+		if ((PAL_SUCCESS == status) && !benchmarkModelCheck(resource, callbackType))
+		{
+			status = PAL_ERR_GENERIC_FAILURE;
+		}
+	}
+	for (i = 0; (i < BENCHMARK_MODEL_RESOURCES) && (PAL_SUCCESS == status); ++i)
+	{
+		for (type = 0; type < M2MCallbackAssociation::M2MCallbackTypeCount; ++type)
+		{
+			if (M2MCallbackStorage::does_callback_exist(*resources[i], (M2MCallbackAssociation::M2MCallbackType)type))
+			{
+				status = PAL_ERR_GENERIC_FAILURE;
+			}
+		}
+	}
+	BENCHMARK_PRINTF("model    %lu operations, %lu callbacks at most, %s\r\n", (unsigned long)operations,
+	            (unsigned long)maxCount, (PAL_SUCCESS == status) ? "passed" : "failed");
+
+	// Only the callbacks of the model are left on failure, they are not deleted with the resources
+	if (PAL_SUCCESS == status)
+	{
+		delete object;
+	}
+	return status;
+}
+
+
+void palTestMain(pal_args_t* args)
+{
+	palStatus_t status = PAL_SUCCESS;
+	(void)args;
+
+	status = pal_init();
+
+	BENCHMARK_PRINTF("*****PAL_CALLBACK_STORAGE_BENCHMARK_START*****\r\n");
+	if (PAL_SUCCESS == status)
+	{
+		status = benchmarkDispatch();
+	}
+	if (PAL_SUCCESS == status)
+	{
+		status = benchmarkModel();
+	}
+	if (PAL_SUCCESS != status)
+	{
+		BENCHMARK_PRINTF("benchmark failed with status 0x%lx\r\n", (unsigned long)(uint32_t)status);
+	}
+	BENCHMARK_PRINTF("*****PAL_CALLBACK_STORAGE_BENCHMARK_END*****\r\n");
+
+	M2MCallbackStorage::delete_instance();
+	pal_destroy();
+}
@@ -0,0 +1,215 @@
+/*
+ * Copyright (c) 2016 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Decode and lookup benchmark of the CBOR decoder of the factory bundles (secsrv-cbor).
+ *
+ * For every size of g_bundleEntries the benchmark encodes a bundle map of
+ * that many parameters. Each parameter is a map of a name, a format and
+ * BENCHMARK_DATA_SIZE bytes of data, under a text key of its own. The
+ * benchmark then measures, over BENCHMARK_ROUNDS_ENTRIES entries in total:
+ *  - "decode" cn_cbor_decode() and cn_cbor_free() of the bundle,
+ *  - "lookup" the decode of the bundle, the cn_cbor_mapget_string() of every
+ *    parameter and of its data, and the free of the bundle.
+ * For every size the benchmark prints the time per bundle and per entry, so
+ * the cost of a lookup shows whether it depends on the size of the map. The
+ * data of every parameter is checked after the timing.
+ *
+ * The same source is built with CBOR_NO_MAP_INDEX, where a lookup walks the map.
+ */
+
+#include "pal.h"
+#include "pal_test_main.h"
+#include "cn-cbor.h"
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+
+// The figures are the output of the benchmark, so they do not depend on DEBUG like PAL_PRINTF
+#define BENCHMARK_PRINTF(ARGS...) printf(ARGS)
+
+#define BENCHMARK_DATA_SIZE 32
+#define BENCHMARK_NAME_SIZE 16
+#define BENCHMARK_ROUNDS_ENTRIES 200000
+#define BENCHMARK_MAX_ENTRIES 1000
+
+#ifdef CBOR_NO_MAP_INDEX
+#define BENCHMARK_LOOKUP "walk"
+#else
+#define BENCHMARK_LOOKUP "index"
+#endif
+
+PAL_PRIVATE const uint32_t g_bundleEntries[] = { 10, 30, 100, 300, 1000 };
+
+PAL_PRIVATE char g_names[BENCHMARK_MAX_ENTRIES][BENCHMARK_NAME_SIZE];
+PAL_PRIVATE uint8_t g_data[BENCHMARK_MAX_ENTRIES][BENCHMARK_DATA_SIZE];
+
+
+PAL_PRIVATE uint64_t benchmarkTicksToMicroSec(uint64_t ticks)
+{
+	return (ticks * 1000000) / pal_osKernelSysTickFrequency();
+}
+
+// Encodes a bundle of the first entries of g_names and g_data, the caller frees the result
+PAL_PRIVATE uint8_t* benchmarkEncode(uint32_t entries, int* size)
+{
+	cn_cbor_errback err;
+	cn_cbor* bundle = cn_cbor_map_create(&err);
+	uint8_t* encoded = NULL;
+	bool success = (NULL != bundle);
+	uint32_t i = 0;
+
+	for (i = 0; (i < entries) && success; ++i)
+	{
+		cn_cbor* parameter = cn_cbor_map_create(&err);
+
+		success = (NULL != parameter) &&
+		          cn_cbor_mapput_string(bundle, g_names[i], parameter, &err) &&
+		          cn_cbor_mapput_string(parameter, "Name", cn_cbor_string_create(g_names[i], &err), &err) &&
+		          cn_cbor_mapput_string(parameter, "Format", cn_cbor_string_create("der", &err), &err) &&
+		          cn_cbor_mapput_string(parameter, "Data", cn_cbor_data_create(g_data[i], BENCHMARK_DATA_SIZE, &err), &err);
+	}
+	if (success)
+	{
+		*size = cn_cbor_get_encoded_size(bundle, &err);
+		encoded = (*size > 0) ? (uint8_t*)malloc((size_t)*size) : NULL;
+		if ((NULL != encoded) && (cn_cbor_encoder_write(bundle, encoded, *size, &err) != *size))
+		{
+			free(encoded);
+			encoded = NULL;
+		}
+	}
+	cn_cbor_free(bundle);
+	return encoded;
+}
+
+// Looks up every parameter of a decoded bundle and its data, returns the number of parameters found
+PAL_PRIVATE uint32_t benchmarkLookup(const cn_cbor* bundle, uint32_t entries, bool check)
+{
+	uint32_t found = 0;
+	uint32_t i = 0;
+
+	for (i = 0; (i < entries) && (NULL != bundle); ++i)
+	{
+		const cn_cbor* parameter = cn_cbor_mapget_string(bundle, g_names[i]);
+		const cn_cbor* data = parameter ? cn_cbor_mapget_string(parameter, "Data") : NULL;
+
+		if ((NULL != data) && (CN_CBOR_BYTES == data->type) && (BENCHMARK_DATA_SIZE == data->length) &&
+		    (!check || (0 == memcmp(data->v.bytes, g_data[i], BENCHMARK_DATA_SIZE))))
+		{
+			++found;
+		}
+	}
+	return found;
+}
+
+PAL_PRIVATE palStatus_t benchmarkBundle(uint32_t entries)
+{
+	cn_cbor_errback err;
+	cn_cbor* bundle = NULL;
+	const uint32_t rounds = BENCHMARK_ROUNDS_ENTRIES / entries;
+	uint64_t start = 0;
+	uint64_t decodeUs = 0;
+	uint64_t lookupUs = 0;
+	uint32_t found = 0;
+	uint32_t round = 0;
+	int size = 0;
+	uint8_t* encoded = benchmarkEncode(entries, &size);
+	palStatus_t status = PAL_SUCCESS;
+
+	if (NULL == encoded)
+	{
+		return PAL_ERR_NO_MEMORY;
+	}
+
+	start = pal_osKernelSysTick();
+	for (round = 0; (round < rounds) && (PAL_SUCCESS == status); ++round)
+	{
+		bundle = cn_cbor_decode(encoded, (size_t)size, &err);
+		if (NULL == bundle)
+		{
+			status = PAL_ERR_GENERIC_FAILURE;
+		}
+		cn_cbor_free(bundle);
+	}
+	decodeUs = benchmarkTicksToMicroSec(pal_osKernelSysTick() - start);
+
+	start = pal_osKernelSysTick();
+	for (round = 0; (round < rounds) && (PAL_SUCCESS == status); ++round)
+	{
+		bundle = cn_cbor_decode(encoded, (size_t)size, &err);
+		if (NULL == bundle)
+		{
+			status = PAL_ERR_GENERIC_FAILURE;
+		}
+		found += benchmarkLookup(bundle, entries, false);
+		cn_cbor_free(bundle);
+	}
+	lookupUs = benchmarkTicksToMicroSec(pal_osKernelSysTick() - start);
+
+	if (PAL_SUCCESS == status)
+	{
+		BENCHMARK_PRINTF("%-5s %4lu entries, %6lu bytes: decode %7lu ns per bundle, %4lu ns per entry; decode and lookup %8lu ns per bundle, %4lu ns per entry\r\n",
+		            BENCHMARK_LOOKUP, (unsigned long)entries, (unsigned long)size,
+		            (unsigned long)((decodeUs * 1000) / rounds), (unsigned long)((decodeUs * 1000) / (rounds * entries)),
+		            (unsigned long)((lookupUs * 1000) / rounds), (unsigned long)((lookupUs * 1000) / (rounds * entries)));
+	}
+
+	// Checked after the timing, so that only the lookups are measured
+	if ((PAL_SUCCESS == status) && (found == (rounds * entries)))
+	{
+		bundle = cn_cbor_decode(encoded, (size_t)size, &err);
+		found = benchmarkLookup(bundle, entries, true);
+		cn_cbor_free(bundle);
+	}
+	if (found != entries)
+	{
+		status = PAL_ERR_GENERIC_FAILURE;
+	}
+	free(encoded);
+	return status;
+}
+
+void palTestMain(pal_args_t* args)
+{
+	palStatus_t status = PAL_SUCCESS;
+	uint32_t i = 0;
+	uint32_t j = 0;
+	(void)args;
+
+	status = pal_init();
+	for (i = 0; i < (sizeof(g_names) / sizeof(g_names[0])); ++i)
+	{
+		snprintf(g_names[i], BENCHMARK_NAME_SIZE, "mbed.param_%04lu", (unsigned long)i);
+		for (j = 0; j < BENCHMARK_DATA_SIZE; ++j)
+		{
+			g_data[i][j] = (uint8_t)(i + j);
+		}
+	}
+
+	BENCHMARK_PRINTF("*****PAL_CBOR_DECODE_BENCHMARK_START*****\r\n");
+	for (i = 0; (i < (sizeof(g_bundleEntries) / sizeof(g_bundleEntries[0]))) && (PAL_SUCCESS == status); ++i)
+	{
+		status = benchmarkBundle(g_bundleEntries[i]);
+	}
+	if (PAL_SUCCESS != status)
+	{
+		BENCHMARK_PRINTF("benchmark failed with status 0x%lx\r\n", (unsigned long)(uint32_t)status);
+	}
+	BENCHMARK_PRINTF("*****PAL_CBOR_DECODE_BENCHMARK_END*****\r\n");
+
+	pal_destroy();
+}
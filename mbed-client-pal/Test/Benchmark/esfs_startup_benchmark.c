@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2016 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Startup benchmark of the ESFS item store.
+ *
+ * A client start opens and reads every stored item (credentials, certificates
+ * and configuration), and every esfs_open() verifies the CMAC of the whole
+ * file. The benchmark stores BENCHMARK_ITEMS items and reads all of them in
+ * passes:
+ *  - "boot" right after esfs_init(), the way the first start reads the store,
+ *  - "restart" the following passes in the same process, where the files did
+ *    not change and the CMAC verification cache (ESFS_VERIFIED_CACHE_SIZE) can
+ *    accept them without reading them twice.
+ *
+ * For every pass the benchmark prints the time of the pass and the average
+ * time of one open, read and close.
+ */
+
+#include "pal.h"
+#include "pal_test_main.h"
+#include "esfs.h"
+#include "stdio.h"
+#include "string.h"
+
+// The figures are the output of the benchmark, so they do not depend on DEBUG like PAL_PRINTF
+#define BENCHMARK_PRINTF(ARGS...) printf(ARGS)
+
+#define BENCHMARK_ITEMS 8
+#define BENCHMARK_ITEM_SIZE 1024
+#define BENCHMARK_PASSES 5
+#define BENCHMARK_NAME_SIZE 16
+
+PAL_PRIVATE uint8_t g_item[BENCHMARK_ITEM_SIZE];
+PAL_PRIVATE uint8_t g_readBuffer[BENCHMARK_ITEM_SIZE];
+
+
+PAL_PRIVATE uint64_t benchmarkTicksToMicroSec(uint64_t ticks)
+{
+	return (ticks * 1000000) / pal_osKernelSysTickFrequency();
+}
+
+PAL_PRIVATE size_t benchmarkItemName(uint32_t index, uint8_t* name)
+{
+	return (size_t)snprintf((char*)name, BENCHMARK_NAME_SIZE, "bench_item_%lu", (unsigned long)index);
+}
+
+PAL_PRIVATE palStatus_t benchmarkStore(void)
+{
+	uint8_t name[BENCHMARK_NAME_SIZE];
+	esfs_file_t file;
+	uint32_t i = 0;
+
+	for (i = 0; i < sizeof(g_item); ++i)
+	{
+		g_item[i] = (uint8_t)i;
+	}
+	for (i = 0; i < BENCHMARK_ITEMS; ++i)
+	{
+		size_t nameLength = benchmarkItemName(i, name);
+		memset(&file, 0, sizeof(file));
+		if ((esfs_create(name, nameLength, NULL, 0, ESFS_ENCRYPTED, &file) != ESFS_SUCCESS) ||
+		    (esfs_write(&file, g_item, sizeof(g_item)) != ESFS_SUCCESS) ||
+		    (esfs_close(&file) != ESFS_SUCCESS))
+		{
+			return PAL_ERR_GENERIC_FAILURE;
+		}
+	}
+	return PAL_SUCCESS;
+}
+
+PAL_PRIVATE palStatus_t benchmarkReadAll(const char* name)
+{
+	uint8_t itemName[BENCHMARK_NAME_SIZE];
+	esfs_file_t file;
+	uint16_t mode = 0;
+	size_t bytesRead = 0;
+	uint64_t start = 0;
+	uint64_t elapsedUs = 0;
+	uint32_t i = 0;
+
+	start = pal_osKernelSysTick();
+	for (i = 0; i < BENCHMARK_ITEMS; ++i)
+	{
+		size_t nameLength = benchmarkItemName(i, itemName);
+		memset(&file, 0, sizeof(file));
+		if (esfs_open(itemName, nameLength, &mode, &file) != ESFS_SUCCESS)
+		{
+			return PAL_ERR_GENERIC_FAILURE;
+		}
+		if ((esfs_read(&file, g_readBuffer, sizeof(g_readBuffer), &bytesRead) != ESFS_SUCCESS) ||
+		    (bytesRead != sizeof(g_readBuffer)) || (memcmp(g_readBuffer, g_item, sizeof(g_item)) != 0))
+		{
+			esfs_close(&file);
+			return PAL_ERR_GENERIC_FAILURE;
+		}
+		esfs_close(&file);
+	}
+	elapsedUs = benchmarkTicksToMicroSec(pal_osKernelSysTick() - start);
+
+	BENCHMARK_PRINTF("%-8s %lu items in %lu us, %lu us per item\r\n", name, (unsigned long)BENCHMARK_ITEMS,
+	            (unsigned long)elapsedUs, (unsigned long)(elapsedUs / BENCHMARK_ITEMS));
+	return PAL_SUCCESS;
+}
+
+
+void palTestMain(pal_args_t* args)
+{
+	palStatus_t status = PAL_SUCCESS;
+	uint32_t i = 0;
+	(void)args;
+
+	status = pal_init();
+	if ((PAL_SUCCESS == status) && ((esfs_init() != ESFS_SUCCESS) || (esfs_reset() != ESFS_SUCCESS)))
+	{
+		status = PAL_ERR_GENERIC_FAILURE;
+	}
+	if (PAL_SUCCESS == status)
+	{
+		status = benchmarkStore();
+	}
+	// Start from an empty cache, the way the store is found after a boot
+	if ((PAL_SUCCESS == status) && ((esfs_finalize() != ESFS_SUCCESS) || (esfs_init() != ESFS_SUCCESS)))
+	{
+		status = PAL_ERR_GENERIC_FAILURE;
+	}
+
+	BENCHMARK_PRINTF("*****PAL_ESFS_BENCHMARK_START*****\r\n");
+	if (PAL_SUCCESS == status)
+	{
+		status = benchmarkReadAll("boot");
+	}
+	for (i = 1; (i < BENCHMARK_PASSES) && (PAL_SUCCESS == status); ++i)
+	{
+		status = benchmarkReadAll("restart");
+	}
+	if (PAL_SUCCESS != status)
+	{
+		BENCHMARK_PRINTF("benchmark failed with status 0x%lx\r\n", (unsigned long)(uint32_t)status);
+	}
+	BENCHMARK_PRINTF("*****PAL_ESFS_BENCHMARK_END*****\r\n");
+
+	esfs_reset();
+	esfs_finalize();
+	pal_destroy();
+}
@@ -0,0 +1,247 @@
+/*
+ * Copyright (c) 2016 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Store, read and reset benchmark of the ESFS backends.
+ *
+ * The same source is built once for the per file layout (esfs.c) and once with
+ * ESFS_LOG_STORE for the single log container (esfs_log.c). The benchmark
+ * provisions BENCHMARK_ITEMS encrypted factory items, the way a factory tool
+ * stores the credentials of a device, and then measures:
+ *  - "store" the create, write and close of every item,
+ *  - "init" esfs_init() of the stored items, the first step of a boot,
+ *  - "read" the open, read and close of every item,
+ *  - "update" the delete and create of every item with a new value,
+ *  - "reset" esfs_factory_reset() back to the provisioned items.
+ *
+ * For every step the benchmark prints the time of the step and the average
+ * time per item, and it checks that the items read back after the reset are
+ * the provisioned ones.
+ */
+
+#include "pal.h"
+#include "pal_test_main.h"
+#include "esfs.h"
+#include "stdio.h"
+#include "string.h"
+
+// The figures are the output of the benchmark, so they do not depend on DEBUG like PAL_PRINTF
+#define BENCHMARK_PRINTF(ARGS...) printf(ARGS)
+
+#define BENCHMARK_ITEMS 32
+#define BENCHMARK_ITEM_SIZE 1024
+#define BENCHMARK_NAME_SIZE 16
+
+#ifdef ESFS_LOG_STORE
+#define BENCHMARK_BACKEND "log"
+#else
+#define BENCHMARK_BACKEND "per file"
+#endif
+
+PAL_PRIVATE uint8_t g_item[BENCHMARK_ITEM_SIZE];
+PAL_PRIVATE uint8_t g_readBuffer[BENCHMARK_ITEM_SIZE];
+
+
+PAL_PRIVATE uint64_t benchmarkTicksToMicroSec(uint64_t ticks)
+{
+	return (ticks * 1000000) / pal_osKernelSysTickFrequency();
+}
+
+PAL_PRIVATE size_t benchmarkItemName(uint32_t index, uint8_t* name)
+{
+	return (size_t)snprintf((char*)name, BENCHMARK_NAME_SIZE, "bench_item_%lu", (unsigned long)index);
+}
+
+// The value of an item depends on its index and on the generation of the value
+PAL_PRIVATE void benchmarkItemValue(uint32_t index, uint8_t generation)
+{
+	uint32_t i = 0;
+
+	for (i = 0; i < sizeof(g_item); ++i)
+	{
+		g_item[i] = (uint8_t)(i + index + generation);
+	}
+}
+
+PAL_PRIVATE void benchmarkReport(const char* step, uint64_t start)
+{
+	uint64_t elapsedUs = benchmarkTicksToMicroSec(pal_osKernelSysTick() - start);
+
+	BENCHMARK_PRINTF("%-8s %-8s %lu items in %lu us, %lu us per item\r\n", BENCHMARK_BACKEND, step, (unsigned long)BENCHMARK_ITEMS,
+	            (unsigned long)elapsedUs, (unsigned long)(elapsedUs / BENCHMARK_ITEMS));
+}
+
+PAL_PRIVATE palStatus_t benchmarkStore(const char* step, uint16_t mode, uint8_t generation, bool deleteFirst)
+{
+	uint8_t name[BENCHMARK_NAME_SIZE];
+	esfs_file_t file;
+	uint64_t start = 0;
+	uint32_t i = 0;
+
+	start = pal_osKernelSysTick();
+	for (i = 0; i < BENCHMARK_ITEMS; ++i)
+	{
+		size_t nameLength = benchmarkItemName(i, name);
+		benchmarkItemValue(i, generation);
+		if (deleteFirst && (esfs_delete(name, nameLength) != ESFS_SUCCESS))
+		{
+			return PAL_ERR_GENERIC_FAILURE;
+		}
+		memset(&file, 0, sizeof(file));
+		if ((esfs_create(name, nameLength, NULL, 0, mode, &file) != ESFS_SUCCESS) ||
+		    (esfs_write(&file, g_item, sizeof(g_item)) != ESFS_SUCCESS) ||
+		    (esfs_close(&file) != ESFS_SUCCESS))
+		{
+			return PAL_ERR_GENERIC_FAILURE;
+		}
+	}
+	benchmarkReport(step, start);
+	return PAL_SUCCESS;
+}
+
+PAL_PRIVATE palStatus_t benchmarkReadAll(const char* step, uint8_t generation)
+{
+	uint8_t name[BENCHMARK_NAME_SIZE];
+	esfs_file_t file;
+	uint16_t mode = 0;
+	size_t bytesRead = 0;
+	uint64_t start = 0;
+	uint32_t i = 0;
+	palStatus_t status = PAL_SUCCESS;
+
+	start = pal_osKernelSysTick();
+	for (i = 0; (i < BENCHMARK_ITEMS) && (PAL_SUCCESS == status); ++i)
+	{
+		size_t nameLength = benchmarkItemName(i, name);
+		memset(&file, 0, sizeof(file));
+		if (esfs_open(name, nameLength, &mode, &file) != ESFS_SUCCESS)
+		{
+			return PAL_ERR_GENERIC_FAILURE;
+		}
+		if ((esfs_read(&file, g_readBuffer, sizeof(g_readBuffer), &bytesRead) != ESFS_SUCCESS) ||
+		    (bytesRead != sizeof(g_readBuffer)))
+		{
+			status = PAL_ERR_GENERIC_FAILURE;
+		}
+		esfs_close(&file);
+	}
+	if (PAL_SUCCESS != status)
+	{
+		return status;
+	}
+	benchmarkReport(step, start);
+
+	// Checked after the timing, so that only the store is measured
+	for (i = 0; i < BENCHMARK_ITEMS; ++i)
+	{
+		size_t nameLength = benchmarkItemName(i, name);
+		benchmarkItemValue(i, generation);
+		memset(&file, 0, sizeof(file));
+		if (esfs_open(name, nameLength, &mode, &file) != ESFS_SUCCESS)
+		{
+			return PAL_ERR_GENERIC_FAILURE;
+		}
+		if ((esfs_read(&file, g_readBuffer, sizeof(g_readBuffer), &bytesRead) != ESFS_SUCCESS) ||
+		    (memcmp(g_readBuffer, g_item, sizeof(g_item)) != 0))
+		{
+			status = PAL_ERR_GENERIC_FAILURE;
+		}
+		esfs_close(&file);
+		if (PAL_SUCCESS != status)
+		{
+			return status;
+		}
+	}
+	return PAL_SUCCESS;
+}
+
+PAL_PRIVATE palStatus_t benchmarkInit(void)
+{
+	uint64_t start = 0;
+
+	if (esfs_finalize() != ESFS_SUCCESS)
+	{
+		return PAL_ERR_GENERIC_FAILURE;
+	}
+	start = pal_osKernelSysTick();
+	if (esfs_init() != ESFS_SUCCESS)
+	{
+		return PAL_ERR_GENERIC_FAILURE;
+	}
+	benchmarkReport("init", start);
+	return PAL_SUCCESS;
+}
+
+PAL_PRIVATE palStatus_t benchmarkFactoryReset(void)
+{
+	uint64_t start = 0;
+
+	start = pal_osKernelSysTick();
+	if (esfs_factory_reset() != ESFS_SUCCESS)
+	{
+		return PAL_ERR_GENERIC_FAILURE;
+	}
+	benchmarkReport("reset", start);
+	return PAL_SUCCESS;
+}
+
+
+void palTestMain(pal_args_t* args)
+{
+	palStatus_t status = PAL_SUCCESS;
+	(void)args;
+
+	status = pal_init();
+	if ((PAL_SUCCESS == status) && ((esfs_init() != ESFS_SUCCESS) || (esfs_reset() != ESFS_SUCCESS)))
+	{
+		status = PAL_ERR_GENERIC_FAILURE;
+	}
+
+	BENCHMARK_PRINTF("*****PAL_ESFS_STORE_BENCHMARK_START*****\r\n");
+	if (PAL_SUCCESS == status)
+	{
+		status = benchmarkStore("store", ESFS_ENCRYPTED | ESFS_FACTORY_VAL, 0, false);
+	}
+	if (PAL_SUCCESS == status)
+	{
+		status = benchmarkInit();
+	}
+	if (PAL_SUCCESS == status)
+	{
+		status = benchmarkReadAll("read", 0);
+	}
+	if (PAL_SUCCESS == status)
+	{
+		status = benchmarkStore("update", ESFS_ENCRYPTED, 1, true);
+	}
+	if (PAL_SUCCESS == status)
+	{
+		status = benchmarkFactoryReset();
+	}
+	if (PAL_SUCCESS == status)
+	{
+		status = benchmarkReadAll("read", 0);
+	}
+	if (PAL_SUCCESS != status)
+	{
+		BENCHMARK_PRINTF("benchmark failed with status 0x%lx\r\n", (unsigned long)(uint32_t)status);
+	}
+	BENCHMARK_PRINTF("*****PAL_ESFS_STORE_BENCHMARK_END*****\r\n");
+
+	esfs_reset();
+	esfs_finalize();
+	pal_destroy();
+}
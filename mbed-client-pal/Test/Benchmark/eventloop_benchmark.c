@@ -0,0 +1,229 @@
+/*
+ * Copyright (c) 2016 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Throughput benchmark and check of the event scheduler workers.
+ *
+ * BENCHMARK_TASKLETS synthetic tasklets are pinned round robin to the
+ * NS_EVENTLOOP_WORKERS workers that ns-hal-pal runs, and the test thread sends
+ * them BENCHMARK_EVENTS events, each of which does a fixed amount of work.
+ * While the events flow, one tasklet moves itself to the next worker from its
+ * own handler and the test thread moves another one, so that events are
+ * running when the moves happen.
+ *
+ * Every handler checks that no other event of its tasklet is running and that
+ * its events arrive in the order they were sent. The benchmark prints the
+ * events per second and the number of overlaps and reorders, and fails if
+ * there is any.
+ */
+
+#include "pal.h"
+#include "pal_test_main.h"
+#include "ns_hal_init.h"
+#include "ns_event_loop.h"
+#include "eventOS_event.h"
+#include "platform/eventloop_config.h"
+#include "stdio.h"
+#include "string.h"
+
+// The figures are the output of the benchmark, so they do not depend on DEBUG like PAL_PRINTF
+#define BENCHMARK_PRINTF(ARGS...) printf(ARGS)
+
+#define BENCHMARK_HEAP_SIZE (512 * 1024)
+#define BENCHMARK_TASKLETS 8
+#define BENCHMARK_EVENTS 200000
+#define BENCHMARK_IN_FLIGHT 1024
+#define BENCHMARK_WORK_ROUNDS 2000
+#define BENCHMARK_SELF_MOVE_INTERVAL 64 //!< Events between the moves of tasklet 0 by itself
+#define BENCHMARK_MOVE_INTERVAL 1000    //!< Events sent between the moves of tasklet 1 by the test thread
+#define BENCHMARK_TIMEOUT_MS 60000
+
+#define BENCHMARK_EVENT_TYPE 1
+
+typedef struct benchmarkTasklet{
+	int8_t id;
+	uint32_t running;   //!< Events of the tasklet being run, never more than 1
+	uint32_t expected;  //!< Sequence number of the next event
+	uint8_t worker;     //!< Worker the tasklet is pinned to
+}benchmarkTasklet_t;
+
+PAL_PRIVATE benchmarkTasklet_t g_tasklets[BENCHMARK_TASKLETS];
+PAL_PRIVATE uint32_t g_handled;
+PAL_PRIVATE uint32_t g_overlaps;
+PAL_PRIVATE uint32_t g_reorders;
+PAL_PRIVATE volatile uint32_t g_workSink;
+
+
+PAL_PRIVATE uint64_t benchmarkTicksToMicroSec(uint64_t ticks)
+{
+	return (ticks * 1000000) / pal_osKernelSysTickFrequency();
+}
+
+PAL_PRIVATE void benchmarkWork(uint32_t seed)
+{
+	uint32_t x = seed | 1;
+	uint32_t i = 0;
+
+	for (i = 0; i < BENCHMARK_WORK_ROUNDS; ++i)
+	{
+		x ^= x << 13;
+		x ^= x >> 17;
+		x ^= x << 5;
+	}
+	g_workSink = x;
+}
+
+PAL_PRIVATE void benchmarkHandle(benchmarkTasklet_t* tasklet, arm_event_t* event)
+{
+	uint32_t sequence = event->event_data;
+
+	if (BENCHMARK_EVENT_TYPE != event->event_type)
+	{
+		return;
+	}
+	if (__atomic_add_fetch(&tasklet->running, 1, __ATOMIC_SEQ_CST) != 1)
+	{
+		__atomic_add_fetch(&g_overlaps, 1, __ATOMIC_RELAXED);
+	}
+	if (sequence != tasklet->expected)
+	{
+		__atomic_add_fetch(&g_reorders, 1, __ATOMIC_RELAXED);
+	}
+	tasklet->expected = sequence + 1;
+
+	benchmarkWork(sequence);
+	if ((tasklet == &g_tasklets[0]) && (0 == (sequence % BENCHMARK_SELF_MOVE_INTERVAL)))
+	{
+		tasklet->worker = (tasklet->worker + 1) % NS_EVENTLOOP_WORKERS;
+		eventOS_event_handler_set_worker(tasklet->id, tasklet->worker);
+	}
+
+	__atomic_sub_fetch(&tasklet->running, 1, __ATOMIC_SEQ_CST);
+	__atomic_add_fetch(&g_handled, 1, __ATOMIC_RELEASE);
+}
+
+// The scheduler refuses a second tasklet with the same handler
+#define BENCHMARK_HANDLER(INDEX) \
+	PAL_PRIVATE void benchmarkHandler##INDEX(arm_event_t* event) { benchmarkHandle(&g_tasklets[INDEX], event); }
+BENCHMARK_HANDLER(0)
+BENCHMARK_HANDLER(1)
+BENCHMARK_HANDLER(2)
+BENCHMARK_HANDLER(3)
+BENCHMARK_HANDLER(4)
+BENCHMARK_HANDLER(5)
+BENCHMARK_HANDLER(6)
+BENCHMARK_HANDLER(7)
+
+PAL_PRIVATE void (*const g_handlers[BENCHMARK_TASKLETS])(arm_event_t*) = {
+	benchmarkHandler0, benchmarkHandler1, benchmarkHandler2, benchmarkHandler3,
+	benchmarkHandler4, benchmarkHandler5, benchmarkHandler6, benchmarkHandler7
+};
+
+PAL_PRIVATE palStatus_t benchmarkSetup(void)
+{
+	uint32_t i = 0;
+
+	ns_hal_init(NULL, BENCHMARK_HEAP_SIZE, NULL, NULL);
+	for (i = 0; i < BENCHMARK_TASKLETS; ++i)
+	{
+		g_tasklets[i].id = eventOS_event_handler_create(g_handlers[i], 0);
+		if (g_tasklets[i].id < 0)
+		{
+			return PAL_ERR_GENERIC_FAILURE;
+		}
+		g_tasklets[i].worker = i % NS_EVENTLOOP_WORKERS;
+		eventOS_event_handler_set_worker(g_tasklets[i].id, g_tasklets[i].worker);
+	}
+	return PAL_SUCCESS;
+}
+
+PAL_PRIVATE palStatus_t benchmarkRun(void)
+{
+	arm_event_t event;
+	uint32_t sequence[BENCHMARK_TASKLETS] = {0};
+	uint8_t moveTo = 0;
+	uint64_t start = 0;
+	uint64_t elapsedUs = 0;
+	uint32_t i = 0;
+
+	memset(&event, 0, sizeof(event));
+	event.event_type = BENCHMARK_EVENT_TYPE;
+	event.priority = ARM_LIB_LOW_PRIORITY_EVENT;
+
+	start = pal_osKernelSysTick();
+	for (i = 0; i < BENCHMARK_EVENTS; ++i)
+	{
+		uint32_t index = i % BENCHMARK_TASKLETS;
+
+		while ((i - __atomic_load_n(&g_handled, __ATOMIC_ACQUIRE)) >= BENCHMARK_IN_FLIGHT)
+		{
+			pal_osDelay(1);
+		}
+		if ((0 == (i % BENCHMARK_MOVE_INTERVAL)) && (NS_EVENTLOOP_WORKERS > 1))
+		{
+			moveTo = (moveTo + 1) % NS_EVENTLOOP_WORKERS;
+			eventOS_event_handler_set_worker(g_tasklets[1].id, moveTo);
+		}
+		event.receiver = g_tasklets[index].id;
+		event.event_data = sequence[index]++;
+		if (eventOS_event_send(&event) != 0)
+		{
+			return PAL_ERR_NO_MEMORY;
+		}
+	}
+	while (__atomic_load_n(&g_handled, __ATOMIC_ACQUIRE) != BENCHMARK_EVENTS)
+	{
+		if (benchmarkTicksToMicroSec(pal_osKernelSysTick() - start) > (BENCHMARK_TIMEOUT_MS * 1000ULL))
+		{
+			return PAL_ERR_TIMEOUT_EXPIRED;
+		}
+		pal_osDelay(1);
+	}
+	elapsedUs = benchmarkTicksToMicroSec(pal_osKernelSysTick() - start);
+
+	BENCHMARK_PRINTF("workers %d: %lu events in %lu ms, %lu events/s, %lu overlaps, %lu reorders\r\n", NS_EVENTLOOP_WORKERS,
+	            (unsigned long)BENCHMARK_EVENTS, (unsigned long)(elapsedUs / 1000),
+	            (unsigned long)((BENCHMARK_EVENTS * 1000000ULL) / (elapsedUs ? elapsedUs : 1)),
+	            (unsigned long)g_overlaps, (unsigned long)g_reorders);
+	return ((0 == g_overlaps) && (0 == g_reorders)) ? PAL_SUCCESS : PAL_ERR_GENERIC_FAILURE;
+}
+
+
+void palTestMain(pal_args_t* args)
+{
+	palStatus_t status = PAL_SUCCESS;
+	(void)args;
+
+	status = pal_init();
+	if (PAL_SUCCESS == status)
+	{
+		status = benchmarkSetup();
+	}
+
+	BENCHMARK_PRINTF("*****PAL_EVENTLOOP_BENCHMARK_START*****\r\n");
+	if (PAL_SUCCESS == status)
+	{
+		status = benchmarkRun();
+	}
+	if (PAL_SUCCESS != status)
+	{
+		BENCHMARK_PRINTF("benchmark failed with status 0x%lx\r\n", (unsigned long)(uint32_t)status);
+	}
+	BENCHMARK_PRINTF("*****PAL_EVENTLOOP_BENCHMARK_END*****\r\n");
+
+	ns_event_loop_thread_stop();
+	pal_destroy();
+}
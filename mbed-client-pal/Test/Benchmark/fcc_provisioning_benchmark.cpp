@@ -0,0 +1,735 @@
+/*
+ * Copyright (c) 2016 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Factory provisioning benchmark of the factory configurator client.
+ *
+ * The device side is FtcdCommSocket::serve_sessions() on the loopback
+ * interface, and the benchmark is the factory tool: it connects, sends the
+ * bundle of a device (its private key, its certificate, the server CA and
+ * update certificates and its configuration parameters) in the FTCD framing,
+ * and reads the response. The items of the bundle are validated by
+ * kcm_items_store_batch() on KCM_BATCH_VALIDATION_THREADS threads and then
+ * written. After every device the storage is deleted, so the next bundle
+ * provisions a blank device again. The benchmark prints:
+ *  - "batch" the time of kcm_items_store_batch() for BENCHMARK_BATCH_ITEMS
+ *    certificates,
+ *  - "provision" the time from the connection to the response of a device,
+ *    and the devices per minute it gives,
+ *  - "boot" the time of fcc_verify_device_configured_4mbed_cloud() on a
+ *    provisioned device after kcm_item_cache_invalidate(), the verification
+ *    of a boot, which reads and parses the certificates,
+ *  - "verify" the same verification again, with the parsed certificates in
+ *    the KCM cache.
+ *
+ * Before the figures, it checks that a batch either stores all its items or
+ * none of them:
+ *  - "validation" a batch with a corrupted certificate fails at it, and
+ *    nothing is written,
+ *  - "rollback" a batch whose write fails at an item that is already stored
+ *    fails at it, the items written before it are deleted and the stored item
+ *    is kept.
+ */
+
+#include "pal.h"
+#include "pal_test_main.h"
+#include "factory_configurator_client.h"
+#include "key_config_manager.h"
+#include "cn-cbor.h"
+#include "fcc_bundle_handler.h"
+#include "fcc_bundle_utils.h"
+#include "ftcd_comm_base.h"
+#include "ftcd_comm_socket.h"
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+
+// The figures are the output of the benchmark, so they do not depend on DEBUG like PAL_PRINTF
+#define BENCHMARK_PRINTF(ARGS...) printf(ARGS)
+
+#ifdef USE_CBOR_CONTEXT
+#define BENCHMARK_CBOR_CONTEXT , NULL
+#define BENCHMARK_CBOR_CONTEXT_COMMA NULL,
+#else
+#define BENCHMARK_CBOR_CONTEXT
+#define BENCHMARK_CBOR_CONTEXT_COMMA
+#endif
+
+#if defined(KCM_BATCH_VALIDATION_THREADS) && (KCM_BATCH_VALIDATION_THREADS == 1)
+#define BENCHMARK_VALIDATION "1 thread"
+#else
+#define BENCHMARK_VALIDATION "threads"
+#endif
+
+#define BENCHMARK_DEVICES 100
+#define BENCHMARK_VERIFY_ROUNDS 100
+#define BENCHMARK_BATCH_ITEMS 8
+#define BENCHMARK_FAILED_INDEX 5    //!< Item failing the validation and rollback checks
+#define BENCHMARK_NAME_SIZE 32
+
+#define BENCHMARK_INTERFACE "lo"
+#define BENCHMARK_PORT 7443
+#define BENCHMARK_SESSION_TIMEOUT_MS 1000   //!< serve_sessions() returns when no tool connects within it
+#define BENCHMARK_DEVICE_THREAD_STACK_SIZE (1024 * 64)
+
+#define BENCHMARK_LENGTH_SIZE 4     //!< Size of the LENGTH and STATUS fields of the FTCD framing
+
+// Device private key, the key of the device certificate
+PAL_PRIVATE const uint8_t g_devicePrivateKey[] =
+{
+	0x30, 0x77, 0x02, 0x01, 0x01, 0x04, 0x20, 0x18, 0x63, 0xd3, 0x9f, 0xbb,
+	0xe6, 0x6d, 0xaf, 0x52, 0x75, 0x72, 0x5f, 0x3c, 0xfa, 0x82, 0x9a, 0x58,
+	0xa2, 0xc2, 0x07, 0xd8, 0xba, 0xe4, 0xe4, 0x97, 0x5f, 0x2f, 0x6f, 0x1e,
+	0x8c, 0x2a, 0x1d, 0xa0, 0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d,
+	0x03, 0x01, 0x07, 0xa1, 0x44, 0x03, 0x42, 0x00, 0x04, 0x8b, 0x56, 0xad,
+	0x79, 0xf1, 0xdb, 0xd7, 0xf3, 0x00, 0xc9, 0xdd, 0x77, 0x7e, 0x60, 0x26,
+	0x6c, 0xb3, 0x27, 0x4c, 0xd4, 0xca, 0x46, 0xdb, 0x3f, 0x5e, 0xfd, 0x5c,
+	0x84, 0xd5, 0x57, 0x97, 0x2e, 0x5e, 0x9d, 0xc1, 0x1b, 0x36, 0x4c, 0xe9,
+	0xdd, 0xe4, 0x04, 0xea, 0x71, 0xeb, 0xc0, 0x20, 0x21, 0xad, 0x92, 0x18,
+	0x4c, 0x66, 0xf8, 0x7e, 0xf2, 0x07, 0x91, 0x84, 0xa2, 0x21, 0xad, 0x3e,
+	0x28
+};
+
+// Device certificate, issued by the CA certificate
+PAL_PRIVATE const uint8_t g_deviceCertificate[] =
+{
+	0x30, 0x82, 0x01, 0x39, 0x30, 0x81, 0xe0, 0x02, 0x01, 0x02, 0x30, 0x0a,
+	0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x04, 0x03, 0x02, 0x30, 0x26,
+	0x31, 0x15, 0x30, 0x13, 0x06, 0x03, 0x55, 0x04, 0x03, 0x0c, 0x0c, 0x42,
+	0x65, 0x6e, 0x63, 0x68, 0x6d, 0x61, 0x72, 0x6b, 0x20, 0x43, 0x41, 0x31,
+	0x0d, 0x30, 0x0b, 0x06, 0x03, 0x55, 0x04, 0x0a, 0x0c, 0x04, 0x6d, 0x62,
+	0x65, 0x64, 0x30, 0x20, 0x17, 0x0d, 0x32, 0x36, 0x31, 0x30, 0x31, 0x38,
+	0x31, 0x30, 0x33, 0x36, 0x33, 0x37, 0x5a, 0x18, 0x0f, 0x32, 0x30, 0x35,
+	0x36, 0x31, 0x30, 0x31, 0x30, 0x31, 0x30, 0x33, 0x36, 0x33, 0x37, 0x5a,
+	0x30, 0x2a, 0x31, 0x19, 0x30, 0x17, 0x06, 0x03, 0x55, 0x04, 0x03, 0x0c,
+	0x10, 0x62, 0x65, 0x6e, 0x63, 0x68, 0x6d, 0x61, 0x72, 0x6b, 0x2d, 0x64,
+	0x65, 0x76, 0x69, 0x63, 0x65, 0x31, 0x0d, 0x30, 0x0b, 0x06, 0x03, 0x55,
+	0x04, 0x0a, 0x0c, 0x04, 0x6d, 0x62, 0x65, 0x64, 0x30, 0x59, 0x30, 0x13,
+	0x06, 0x07, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x02, 0x01, 0x06, 0x08, 0x2a,
+	0x86, 0x48, 0xce, 0x3d, 0x03, 0x01, 0x07, 0x03, 0x42, 0x00, 0x04, 0x8b,
+	0x56, 0xad, 0x79, 0xf1, 0xdb, 0xd7, 0xf3, 0x00, 0xc9, 0xdd, 0x77, 0x7e,
+	0x60, 0x26, 0x6c, 0xb3, 0x27, 0x4c, 0xd4, 0xca, 0x46, 0xdb, 0x3f, 0x5e,
+	0xfd, 0x5c, 0x84, 0xd5, 0x57, 0x97, 0x2e, 0x5e, 0x9d, 0xc1, 0x1b, 0x36,
+	0x4c, 0xe9, 0xdd, 0xe4, 0x04, 0xea, 0x71, 0xeb, 0xc0, 0x20, 0x21, 0xad,
+	0x92, 0x18, 0x4c, 0x66, 0xf8, 0x7e, 0xf2, 0x07, 0x91, 0x84, 0xa2, 0x21,
+	0xad, 0x3e, 0x28, 0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d,
+	0x04, 0x03, 0x02, 0x03, 0x48, 0x00, 0x30, 0x45, 0x02, 0x20, 0x7e, 0xfc,
+	0xb5, 0x7c, 0x01, 0x1c, 0x95, 0xfb, 0x1d, 0x82, 0x5f, 0x42, 0xac, 0xd8,
+	0xd2, 0xdf, 0x08, 0x94, 0xc4, 0xb8, 0x67, 0x73, 0x9e, 0x55, 0x19, 0x6d,
+	0x07, 0xef, 0xb8, 0x67, 0x7e, 0xd9, 0x02, 0x21, 0x00, 0xd9, 0xdc, 0x36,
+	0x12, 0xc4, 0x88, 0xe4, 0x7f, 0x42, 0xec, 0x80, 0x92, 0xaa, 0x42, 0x2f,
+	0x7e, 0xe0, 0x71, 0x0a, 0x7d, 0x89, 0xff, 0x09, 0x4d, 0x4e, 0xd4, 0xb7,
+	0xc8, 0xc0, 0x9a, 0x41, 0xcf
+};
+
+// Self signed CA certificate
+PAL_PRIVATE const uint8_t g_caCertificate[] =
+{
+	0x30, 0x82, 0x01, 0x91, 0x30, 0x82, 0x01, 0x36, 0xa0, 0x03, 0x02, 0x01,
+	0x02, 0x02, 0x01, 0x01, 0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce,
+	0x3d, 0x04, 0x03, 0x02, 0x30, 0x26, 0x31, 0x15, 0x30, 0x13, 0x06, 0x03,
+	0x55, 0x04, 0x03, 0x0c, 0x0c, 0x42, 0x65, 0x6e, 0x63, 0x68, 0x6d, 0x61,
+	0x72, 0x6b, 0x20, 0x43, 0x41, 0x31, 0x0d, 0x30, 0x0b, 0x06, 0x03, 0x55,
+	0x04, 0x0a, 0x0c, 0x04, 0x6d, 0x62, 0x65, 0x64, 0x30, 0x20, 0x17, 0x0d,
+	0x32, 0x36, 0x31, 0x30, 0x31, 0x38, 0x31, 0x30, 0x33, 0x36, 0x33, 0x37,
+	0x5a, 0x18, 0x0f, 0x32, 0x30, 0x35, 0x36, 0x31, 0x30, 0x31, 0x30, 0x31,
+	0x30, 0x33, 0x36, 0x33, 0x37, 0x5a, 0x30, 0x26, 0x31, 0x15, 0x30, 0x13,
+	0x06, 0x03, 0x55, 0x04, 0x03, 0x0c, 0x0c, 0x42, 0x65, 0x6e, 0x63, 0x68,
+	0x6d, 0x61, 0x72, 0x6b, 0x20, 0x43, 0x41, 0x31, 0x0d, 0x30, 0x0b, 0x06,
+	0x03, 0x55, 0x04, 0x0a, 0x0c, 0x04, 0x6d, 0x62, 0x65, 0x64, 0x30, 0x59,
+	0x30, 0x13, 0x06, 0x07, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x02, 0x01, 0x06,
+	0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x03, 0x01, 0x07, 0x03, 0x42, 0x00,
+	0x04, 0xe4, 0xef, 0x44, 0xf7, 0xc5, 0xbc, 0x02, 0x2e, 0x5d, 0x1d, 0xc7,
+	0x71, 0x69, 0x70, 0x88, 0x30, 0xbf, 0xb3, 0xf3, 0xde, 0xed, 0x1e, 0x58,
+	0x11, 0x9d, 0xa6, 0x5d, 0xc4, 0x56, 0xc4, 0x2a, 0xe7, 0x48, 0xc3, 0x72,
+	0xbe, 0xb3, 0xfc, 0x16, 0x7f, 0x05, 0x54, 0x86, 0x79, 0x86, 0xa2, 0xcf,
+	0x2c, 0x4e, 0x83, 0xd2, 0x75, 0xe7, 0x67, 0x71, 0xe1, 0xd9, 0xb4, 0x50,
+	0x0a, 0x5b, 0x91, 0x15, 0x20, 0xa3, 0x53, 0x30, 0x51, 0x30, 0x1d, 0x06,
+	0x03, 0x55, 0x1d, 0x0e, 0x04, 0x16, 0x04, 0x14, 0xda, 0x3b, 0x68, 0x7f,
+	0x7e, 0xe0, 0xfa, 0x30, 0x2f, 0x56, 0xae, 0x14, 0x96, 0x3c, 0x77, 0x47,
+	0x49, 0x71, 0xf5, 0x79, 0x30, 0x1f, 0x06, 0x03, 0x55, 0x1d, 0x23, 0x04,
+	0x18, 0x30, 0x16, 0x80, 0x14, 0xda, 0x3b, 0x68, 0x7f, 0x7e, 0xe0, 0xfa,
+	0x30, 0x2f, 0x56, 0xae, 0x14, 0x96, 0x3c, 0x77, 0x47, 0x49, 0x71, 0xf5,
+	0x79, 0x30, 0x0f, 0x06, 0x03, 0x55, 0x1d, 0x13, 0x01, 0x01, 0xff, 0x04,
+	0x05, 0x30, 0x03, 0x01, 0x01, 0xff, 0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86,
+	0x48, 0xce, 0x3d, 0x04, 0x03, 0x02, 0x03, 0x49, 0x00, 0x30, 0x46, 0x02,
+	0x21, 0x00, 0xd4, 0x36, 0x08, 0xd3, 0x03, 0x42, 0x4d, 0x67, 0x79, 0xb2,
+	0x58, 0x4f, 0xc3, 0x91, 0x0c, 0x8b, 0xfc, 0x41, 0x31, 0x85, 0xb8, 0xd2,
+	0x96, 0x78, 0xd7, 0xfe, 0x36, 0xac, 0x62, 0x53, 0x83, 0xd1, 0x02, 0x21,
+	0x00, 0xab, 0x0d, 0xa0, 0x9b, 0x2a, 0xd7, 0xb2, 0xdd, 0x1a, 0x45, 0xac,
+	0x81, 0x2f, 0x9c, 0x1e, 0x59, 0xff, 0x80, 0x70, 0x68, 0xa9, 0x00, 0xc7,
+	0x63, 0xee, 0xf0, 0x33, 0x9b, 0xad, 0xd8, 0xbb, 0x92
+};
+
+PAL_PRIVATE uint8_t* g_bundle;
+PAL_PRIVATE size_t g_bundleSize;
+PAL_PRIVATE palSemaphoreID_t g_deviceDone;
+PAL_PRIVATE bool g_deviceServed;
+
+
+PAL_PRIVATE uint64_t benchmarkTicksToMicroSec(uint64_t ticks)
+{
+	return (ticks * 1000000) / pal_osKernelSysTickFrequency();
+}
+
+PAL_PRIVATE void benchmarkPutLe32(uint8_t* buffer, uint32_t value)
+{
+	buffer[0] = (uint8_t)value;
+	buffer[1] = (uint8_t)(value >> 8);
+	buffer[2] = (uint8_t)(value >> 16);
+	buffer[3] = (uint8_t)(value >> 24);
+}
+
+PAL_PRIVATE uint32_t benchmarkGetLe32(const uint8_t* buffer)
+{
+	return (uint32_t)buffer[0] | ((uint32_t)buffer[1] << 8) | ((uint32_t)buffer[2] << 16) | ((uint32_t)buffer[3] << 24);
+}
+
+/*
+ * Bundle of a device, the way the factory tool encodes it.
+ */
+PAL_PRIVATE bool benchmarkBundleAddItem(cn_cbor* group, const char* name, const char* type, const uint8_t* data, size_t dataSize)
+{
+	cn_cbor_errback err;
+	cn_cbor* item = cn_cbor_map_create(BENCHMARK_CBOR_CONTEXT_COMMA &err);
+
+	if (item == NULL)
+	{
+		return false;
+	}
+	if (!cn_cbor_array_append(group, item, &err) ||
+	    !cn_cbor_mapput_string(item, FCC_BUNDLE_DATA_PARAMETER_NAME, cn_cbor_string_create(name BENCHMARK_CBOR_CONTEXT, &err) BENCHMARK_CBOR_CONTEXT, &err) ||
+	    ((type != NULL) && !cn_cbor_mapput_string(item, FCC_BUNDLE_DATA_PARAMETER_SCHEME, cn_cbor_string_create(type BENCHMARK_CBOR_CONTEXT, &err) BENCHMARK_CBOR_CONTEXT, &err)) ||
+	    !cn_cbor_mapput_string(item, FCC_BUNDLE_DATA_PARAMETER_FORMAT, cn_cbor_string_create(FCC_BUNDLE_DER_DATA_FORMAT_NAME BENCHMARK_CBOR_CONTEXT, &err) BENCHMARK_CBOR_CONTEXT, &err) ||
+	    !cn_cbor_mapput_string(item, FCC_BUNDLE_DATA_PARAMETER_DATA, cn_cbor_data_create(data, (int)dataSize BENCHMARK_CBOR_CONTEXT, &err) BENCHMARK_CBOR_CONTEXT, &err))
+	{
+		return false;
+	}
+	return true;
+}
+
+PAL_PRIVATE bool benchmarkBundleAddConfig(cn_cbor* group, const char* name, const char* value)
+{
+	return benchmarkBundleAddItem(group, name, NULL, (const uint8_t*)value, strlen(value));
+}
+
+PAL_PRIVATE palStatus_t benchmarkBundleCreate(void)
+{
+	static const char* const configParams[][2] = {
+		{ "mbed.EndpointName", "benchmark-device" },
+		{ "mbed.BootstrapServerURI", "coaps://bootstrap.example.com:5684?aid=0123456789abcdef0123456789abcdef" },
+		{ "mbed.Manufacturer", "ARM" },
+		{ "mbed.ModelNumber", "benchmark" },
+		{ "mbed.DeviceType", "linux" },
+		{ "mbed.HardwareVersion", "1.0" },
+		{ "mbed.SerialNumber", "0123456789" },
+	};
+	// The integer parameters are 32 bit values, the way the developer flow stores them
+	static const char* const configIntNames[] = { "mbed.UseBootstrap", "mbed.MemoryTotalKB" };
+	static const uint32_t configIntValues[] = { 1, 512 };
+	cn_cbor_errback err;
+	cn_cbor* bundle = NULL;
+	cn_cbor* keys = NULL;
+	cn_cbor* certificates = NULL;
+	cn_cbor* configs = NULL;
+	bool success = false;
+	int size = 0;
+	size_t i = 0;
+
+	bundle = cn_cbor_map_create(BENCHMARK_CBOR_CONTEXT_COMMA &err);
+	keys = cn_cbor_array_create(BENCHMARK_CBOR_CONTEXT_COMMA &err);
+	certificates = cn_cbor_array_create(BENCHMARK_CBOR_CONTEXT_COMMA &err);
+	configs = cn_cbor_array_create(BENCHMARK_CBOR_CONTEXT_COMMA &err);
+	if ((bundle == NULL) || (keys == NULL) || (certificates == NULL) || (configs == NULL))
+	{
+		goto finish;
+	}
+
+	success = benchmarkBundleAddItem(keys, "mbed.BootstrapDevicePrivateKey", "ECCPrivate", g_devicePrivateKey, sizeof(g_devicePrivateKey)) &&
+	          benchmarkBundleAddItem(certificates, "mbed.BootstrapDeviceCert", NULL, g_deviceCertificate, sizeof(g_deviceCertificate)) &&
+	          benchmarkBundleAddItem(certificates, "mbed.BootstrapServerCACert", NULL, g_caCertificate, sizeof(g_caCertificate)) &&
+	          benchmarkBundleAddItem(certificates, "mbed.UpdateAuthCert", NULL, g_caCertificate, sizeof(g_caCertificate));
+	for (i = 0; success && (i < sizeof(configParams) / sizeof(configParams[0])); ++i)
+	{
+		success = benchmarkBundleAddConfig(configs, configParams[i][0], configParams[i][1]);
+	}
+	for (i = 0; success && (i < sizeof(configIntNames) / sizeof(configIntNames[0])); ++i)
+	{
+		success = benchmarkBundleAddItem(configs, configIntNames[i], NULL, (const uint8_t*)&configIntValues[i], sizeof(configIntValues[i]));
+	}
+
+	// The device verification needs the complete set of cloud items, it is not part of the figures
+	success = success &&
+	          cn_cbor_mapput_string(bundle, FCC_BUNDLE_SCHEME_GROUP_NAME, cn_cbor_string_create("0.0.1" BENCHMARK_CBOR_CONTEXT, &err) BENCHMARK_CBOR_CONTEXT, &err) &&
+	          cn_cbor_mapput_string(bundle, FCC_KEY_GROUP_NAME, keys BENCHMARK_CBOR_CONTEXT, &err) &&
+	          cn_cbor_mapput_string(bundle, FCC_CERTIFICATE_GROUP_NAME, certificates BENCHMARK_CBOR_CONTEXT, &err) &&
+	          cn_cbor_mapput_string(bundle, FCC_CONFIG_PARAM_GROUP_NAME, configs BENCHMARK_CBOR_CONTEXT, &err) &&
+	          cn_cbor_mapput_string(bundle, FCC_VERIFY_DEVICE_IS_READY_GROUP_NAME, cn_cbor_int_create(0 BENCHMARK_CBOR_CONTEXT, &err) BENCHMARK_CBOR_CONTEXT, &err);
+	keys = NULL;
+	certificates = NULL;
+	configs = NULL;
+
+	if (success)
+	{
+		size = cn_cbor_get_encoded_size(bundle, &err);
+		g_bundle = (size > 0) ? (uint8_t*)malloc(size) : NULL;
+		success = (g_bundle != NULL) && (cn_cbor_encoder_write(bundle, g_bundle, size, &err) == size);
+		g_bundleSize = (size_t)size;
+	}
+
+finish:
+	if (bundle != NULL)
+	{
+		cn_cbor_free(bundle BENCHMARK_CBOR_CONTEXT);
+	}
+	if (keys != NULL)
+	{
+		cn_cbor_free(keys BENCHMARK_CBOR_CONTEXT);
+	}
+	if (certificates != NULL)
+	{
+		cn_cbor_free(certificates BENCHMARK_CBOR_CONTEXT);
+	}
+	if (configs != NULL)
+	{
+		cn_cbor_free(configs BENCHMARK_CBOR_CONTEXT);
+	}
+	return success ? PAL_SUCCESS : PAL_ERR_GENERIC_FAILURE;
+}
+
+/*
+ * Factory tool side of the FTCD protocol.
+ */
+PAL_PRIVATE palStatus_t benchmarkSendAll(palSocket_t socket, const uint8_t* data, size_t size)
+{
+	palStatus_t status = PAL_SUCCESS;
+	size_t sent = 0;
+
+	while ((PAL_SUCCESS == status) && (size > 0))
+	{
+		status = pal_send(socket, data, size, &sent);
+		data += sent;
+		size -= sent;
+	}
+	return status;
+}
+
+PAL_PRIVATE palStatus_t benchmarkRecvAll(palSocket_t socket, uint8_t* data, size_t size)
+{
+	palStatus_t status = PAL_SUCCESS;
+	size_t received = 0;
+
+	while ((PAL_SUCCESS == status) && (size > 0))
+	{
+		status = pal_recv(socket, data, size, &received);
+		data += received;
+		size -= received;
+	}
+	return status;
+}
+
+// Checks the return status of the FCC in the response message
+PAL_PRIVATE palStatus_t benchmarkCheckResponse(const uint8_t* response, size_t responseSize)
+{
+	cn_cbor_errback err;
+	cn_cbor* message = cn_cbor_decode(response, responseSize BENCHMARK_CBOR_CONTEXT, &err);
+	cn_cbor* returnStatus = NULL;
+	palStatus_t status = PAL_ERR_GENERIC_FAILURE;
+
+	if (message != NULL)
+	{
+		returnStatus = cn_cbor_mapget_string(message, FCC_RETURN_STATUS_GROUP_NAME);
+		if ((returnStatus != NULL) && (returnStatus->type == CN_CBOR_UINT) && (returnStatus->v.uint == FCC_STATUS_SUCCESS))
+		{
+			status = PAL_SUCCESS;
+		}
+		cn_cbor_free(message BENCHMARK_CBOR_CONTEXT);
+	}
+	return status;
+}
+
+// Provisions one device: [TOKEN | LENGTH | BUNDLE | SHA256] and back [TOKEN | STATUS | LENGTH | RESPONSE | SHA256]
+PAL_PRIVATE palStatus_t benchmarkProvisionDevice(void)
+{
+	static const uint8_t token[] = FTCD_MSG_HEADER_TOKEN;
+	palIpV4Addr_t loopback = { 127, 0, 0, 1 };
+	palSocketAddress_t address;
+	palSocket_t socket = 0;
+	uint8_t header[FTCD_MSG_HEADER_TOKEN_SIZE_BYTES + BENCHMARK_LENGTH_SIZE];
+	uint8_t digest[PAL_SHA256_SIZE];
+	uint8_t* response = NULL;
+	uint32_t responseSize = 0;
+	palStatus_t status = PAL_SUCCESS;
+
+	memset(&address, 0, sizeof(address));
+	status = pal_setSockAddrIPV4Addr(&address, loopback);
+	if (PAL_SUCCESS == status)
+	{
+		status = pal_setSockAddrPort(&address, BENCHMARK_PORT);
+	}
+	if (PAL_SUCCESS == status)
+	{
+		status = pal_socket(PAL_AF_INET, PAL_SOCK_STREAM, false, 0, &socket);
+	}
+	if (PAL_SUCCESS != status)
+	{
+		return status;
+	}
+
+	status = pal_connect(socket, &address, sizeof(address));
+	if (PAL_SUCCESS == status)
+	{
+		memcpy(header, token, FTCD_MSG_HEADER_TOKEN_SIZE_BYTES);
+		benchmarkPutLe32(header + FTCD_MSG_HEADER_TOKEN_SIZE_BYTES, (uint32_t)g_bundleSize);
+		status = pal_sha256(g_bundle, g_bundleSize, digest);
+	}
+	if (PAL_SUCCESS == status)
+	{
+		status = benchmarkSendAll(socket, header, sizeof(header));
+	}
+	if (PAL_SUCCESS == status)
+	{
+		status = benchmarkSendAll(socket, g_bundle, g_bundleSize);
+	}
+	if (PAL_SUCCESS == status)
+	{
+		status = benchmarkSendAll(socket, digest, sizeof(digest));
+	}
+
+	// A failed message is answered with the token and the status only
+	if (PAL_SUCCESS == status)
+	{
+		status = benchmarkRecvAll(socket, header, sizeof(header));
+	}
+	if ((PAL_SUCCESS == status) &&
+	    ((memcmp(header, token, FTCD_MSG_HEADER_TOKEN_SIZE_BYTES) != 0) ||
+	     (benchmarkGetLe32(header + FTCD_MSG_HEADER_TOKEN_SIZE_BYTES) != FTCD_COMM_STATUS_SUCCESS)))
+	{
+		status = PAL_ERR_GENERIC_FAILURE;
+	}
+	if (PAL_SUCCESS == status)
+	{
+		status = benchmarkRecvAll(socket, header, BENCHMARK_LENGTH_SIZE);
+	}
+	if (PAL_SUCCESS == status)
+	{
+		responseSize = benchmarkGetLe32(header);
+		response = (uint8_t*)malloc(responseSize);
+		status = (response != NULL) ? benchmarkRecvAll(socket, response, responseSize) : PAL_ERR_NO_MEMORY;
+	}
+	if (PAL_SUCCESS == status)
+	{
+		status = benchmarkRecvAll(socket, digest, sizeof(digest));
+	}
+	if (PAL_SUCCESS == status)
+	{
+		status = benchmarkCheckResponse(response, responseSize);
+	}
+
+	free(response);
+	pal_close(&socket);
+	return status;
+}
+
+PAL_PRIVATE void benchmarkDeviceThread(void const* argument)
+{
+	FtcdCommSocket* device = (FtcdCommSocket*)argument;
+
+	g_deviceServed = device->serve_sessions();
+	pal_osSemaphoreRelease(g_deviceDone);
+}
+
+PAL_PRIVATE palStatus_t benchmarkProvision(void)
+{
+	FtcdCommSocket* device = NULL;
+	palThreadID_t thread = NULLPTR;
+	bool threadStarted = false;
+	uint64_t elapsedUs = 0;
+	uint64_t start = 0;
+	uint32_t i = 0;
+	int32_t count = 0;
+	palStatus_t status = PAL_SUCCESS;
+
+	status = benchmarkBundleCreate();
+	if (PAL_SUCCESS == status)
+	{
+		device = new FtcdCommSocket(BENCHMARK_INTERFACE, FTCD_IPV4, BENCHMARK_PORT, BENCHMARK_SESSION_TIMEOUT_MS);
+		status = ((device != NULL) && device->init()) ? PAL_SUCCESS : PAL_ERR_GENERIC_FAILURE;
+	}
+	if (PAL_SUCCESS == status)
+	{
+		status = pal_osSemaphoreCreate(0, &g_deviceDone);
+	}
+	if (PAL_SUCCESS == status)
+	{
+		status = pal_osThreadCreateWithAlloc(benchmarkDeviceThread, device, PAL_osPriorityHigh, BENCHMARK_DEVICE_THREAD_STACK_SIZE, NULL, &thread);
+		threadStarted = (PAL_SUCCESS == status);
+	}
+
+	for (i = 0; (i < BENCHMARK_DEVICES) && (PAL_SUCCESS == status); ++i)
+	{
+		start = pal_osKernelSysTick();
+		status = benchmarkProvisionDevice();
+		elapsedUs += benchmarkTicksToMicroSec(pal_osKernelSysTick() - start);
+
+		// The next device is a blank one
+		if ((PAL_SUCCESS == status) && (fcc_storage_delete() != FCC_STATUS_SUCCESS))
+		{
+			status = PAL_ERR_GENERIC_FAILURE;
+		}
+	}
+
+	if (threadStarted)
+	{
+		pal_osSemaphoreWait(g_deviceDone, PAL_RTOS_WAIT_FOREVER, &count);
+		pal_osThreadTerminate(&thread);
+		if (!g_deviceServed)
+		{
+			status = PAL_ERR_GENERIC_FAILURE;
+		}
+	}
+	if (NULLPTR != g_deviceDone)
+	{
+		pal_osSemaphoreDelete(&g_deviceDone);
+	}
+	if (device != NULL)
+	{
+		device->finish();
+		delete device;
+	}
+	free(g_bundle);
+	g_bundle = NULL;
+
+	if ((PAL_SUCCESS == status) && (elapsedUs > 0))
+	{
+		BENCHMARK_PRINTF("%-8s provision %lu devices of %lu bytes in %lu us, %lu us per device, %lu devices per minute\r\n",
+		            BENCHMARK_VALIDATION, (unsigned long)BENCHMARK_DEVICES, (unsigned long)g_bundleSize, (unsigned long)elapsedUs,
+		            (unsigned long)(elapsedUs / BENCHMARK_DEVICES), (unsigned long)((uint64_t)BENCHMARK_DEVICES * 60 * 1000000 / elapsedUs));
+	}
+	return status;
+}
+
+/*
+ * Timing of the verification of a provisioned device.
+ */
+PAL_PRIVATE palStatus_t benchmarkVerifyRounds(const char* step, bool invalidate)
+{
+	uint64_t elapsedUs = 0;
+	uint64_t start = 0;
+	uint32_t i = 0;
+
+	for (i = 0; i < BENCHMARK_VERIFY_ROUNDS; ++i)
+	{
+		if (invalidate)
+		{
+			kcm_item_cache_invalidate();
+		}
+		start = pal_osKernelSysTick();
+		if (fcc_verify_device_configured_4mbed_cloud() != FCC_STATUS_SUCCESS)
+		{
+			return PAL_ERR_GENERIC_FAILURE;
+		}
+		elapsedUs += benchmarkTicksToMicroSec(pal_osKernelSysTick() - start);
+	}
+
+	BENCHMARK_PRINTF("%-8s %s %lu verifications in %lu us, %lu us per verification\r\n", BENCHMARK_VALIDATION, step,
+	            (unsigned long)BENCHMARK_VERIFY_ROUNDS, (unsigned long)elapsedUs, (unsigned long)(elapsedUs / BENCHMARK_VERIFY_ROUNDS));
+	return PAL_SUCCESS;
+}
+
+PAL_PRIVATE palStatus_t benchmarkVerify(void)
+{
+	uint8_t* response = NULL;
+	size_t responseSize = 0;
+	palStatus_t status = PAL_SUCCESS;
+
+	status = benchmarkBundleCreate();
+	if ((PAL_SUCCESS == status) && (fcc_bundle_handler(g_bundle, g_bundleSize, &response, &responseSize) != FCC_STATUS_SUCCESS))
+	{
+		status = PAL_ERR_GENERIC_FAILURE;
+	}
+	free(response);
+	free(g_bundle);
+	g_bundle = NULL;
+
+	if (PAL_SUCCESS == status)
+	{
+		status = benchmarkVerifyRounds("boot", true);
+	}
+	if (PAL_SUCCESS == status)
+	{
+		status = benchmarkVerifyRounds("verify", false);
+	}
+	if ((PAL_SUCCESS == status) && (fcc_storage_delete() != FCC_STATUS_SUCCESS))
+	{
+		status = PAL_ERR_GENERIC_FAILURE;
+	}
+	return status;
+}
+
+/*
+ * Checks and timing of kcm_items_store_batch().
+ */
+PAL_PRIVATE void benchmarkBatchItems(kcm_item_batch_entry_s* items, uint8_t names[][BENCHMARK_NAME_SIZE])
+{
+	uint32_t i = 0;
+
+	memset(items, 0, sizeof(kcm_item_batch_entry_s) * BENCHMARK_BATCH_ITEMS);
+	for (i = 0; i < BENCHMARK_BATCH_ITEMS; ++i)
+	{
+		items[i].name = names[i];
+		items[i].name_len = (size_t)snprintf((char*)names[i], BENCHMARK_NAME_SIZE, "bench.cert.%lu", (unsigned long)i);
+		items[i].type = KCM_CERTIFICATE_ITEM;
+		items[i].data = g_deviceCertificate;
+		items[i].data_size = sizeof(g_deviceCertificate);
+	}
+}
+
+// Checks that no item of the batch, except the one at keptIndex, is in the storage
+PAL_PRIVATE palStatus_t benchmarkBatchCheckStored(const kcm_item_batch_entry_s* items, size_t keptIndex)
+{
+	size_t dataSize = 0;
+	uint32_t i = 0;
+
+	for (i = 0; i < BENCHMARK_BATCH_ITEMS; ++i)
+	{
+		kcm_status_e expected = (i == keptIndex) ? KCM_STATUS_SUCCESS : KCM_STATUS_ITEM_NOT_FOUND;
+		if (kcm_item_get_data_size(items[i].name, items[i].name_len, items[i].type, &dataSize) != expected)
+		{
+			BENCHMARK_PRINTF("item %lu of the batch is %s\r\n", (unsigned long)i, (i == keptIndex) ? "not stored" : "stored");
+			return PAL_ERR_GENERIC_FAILURE;
+		}
+	}
+	return PAL_SUCCESS;
+}
+
+PAL_PRIVATE palStatus_t benchmarkBatchValidation(void)
+{
+	kcm_item_batch_entry_s items[BENCHMARK_BATCH_ITEMS];
+	uint8_t names[BENCHMARK_BATCH_ITEMS][BENCHMARK_NAME_SIZE];
+	size_t failedIndex = 0;
+
+	benchmarkBatchItems(items, names);
+	// A truncated certificate can not be parsed
+	items[BENCHMARK_FAILED_INDEX].data_size = sizeof(g_deviceCertificate) / 2;
+
+	if ((kcm_items_store_batch(items, BENCHMARK_BATCH_ITEMS, true, &failedIndex) == KCM_STATUS_SUCCESS) ||
+	    (failedIndex != BENCHMARK_FAILED_INDEX))
+	{
+		BENCHMARK_PRINTF("validation failed at item %lu instead of %lu\r\n", (unsigned long)failedIndex, (unsigned long)BENCHMARK_FAILED_INDEX);
+		return PAL_ERR_GENERIC_FAILURE;
+	}
+	return benchmarkBatchCheckStored(items, BENCHMARK_BATCH_ITEMS);
+}
+
+PAL_PRIVATE palStatus_t benchmarkBatchRollback(void)
+{
+	kcm_item_batch_entry_s items[BENCHMARK_BATCH_ITEMS];
+	uint8_t names[BENCHMARK_BATCH_ITEMS][BENCHMARK_NAME_SIZE];
+	size_t failedIndex = 0;
+	kcm_status_e kcmStatus = KCM_STATUS_SUCCESS;
+	palStatus_t status = PAL_SUCCESS;
+
+	benchmarkBatchItems(items, names);
+	// Storing an item that is already stored fails, after the items before it have been written
+	kcmStatus = kcm_item_store(items[BENCHMARK_FAILED_INDEX].name, items[BENCHMARK_FAILED_INDEX].name_len, KCM_CERTIFICATE_ITEM, true,
+	                           g_caCertificate, sizeof(g_caCertificate), NULL);
+	if (kcmStatus != KCM_STATUS_SUCCESS)
+	{
+		return PAL_ERR_GENERIC_FAILURE;
+	}
+
+	kcmStatus = kcm_items_store_batch(items, BENCHMARK_BATCH_ITEMS, true, &failedIndex);
+	if ((kcmStatus != KCM_STATUS_FILE_EXIST) || (failedIndex != BENCHMARK_FAILED_INDEX))
+	{
+		BENCHMARK_PRINTF("rollback failed at item %lu (%d) instead of %lu\r\n", (unsigned long)failedIndex, (int)kcmStatus, (unsigned long)BENCHMARK_FAILED_INDEX);
+		status = PAL_ERR_GENERIC_FAILURE;
+	}
+	if (PAL_SUCCESS == status)
+	{
+		status = benchmarkBatchCheckStored(items, BENCHMARK_FAILED_INDEX);
+	}
+	if (kcm_item_delete(items[BENCHMARK_FAILED_INDEX].name, items[BENCHMARK_FAILED_INDEX].name_len, KCM_CERTIFICATE_ITEM) != KCM_STATUS_SUCCESS)
+	{
+		status = PAL_ERR_GENERIC_FAILURE;
+	}
+	return status;
+}
+
+PAL_PRIVATE palStatus_t benchmarkBatchStore(void)
+{
+	kcm_item_batch_entry_s items[BENCHMARK_BATCH_ITEMS];
+	uint8_t names[BENCHMARK_BATCH_ITEMS][BENCHMARK_NAME_SIZE];
+	size_t failedIndex = 0;
+	uint64_t elapsedUs = 0;
+	uint64_t start = 0;
+
+	benchmarkBatchItems(items, names);
+	start = pal_osKernelSysTick();
+	if (kcm_items_store_batch(items, BENCHMARK_BATCH_ITEMS, true, &failedIndex) != KCM_STATUS_SUCCESS)
+	{
+		return PAL_ERR_GENERIC_FAILURE;
+	}
+	elapsedUs = benchmarkTicksToMicroSec(pal_osKernelSysTick() - start);
+
+	BENCHMARK_PRINTF("%-8s batch %lu certificates in %lu us, %lu us per certificate\r\n", BENCHMARK_VALIDATION,
+	            (unsigned long)BENCHMARK_BATCH_ITEMS, (unsigned long)elapsedUs, (unsigned long)(elapsedUs / BENCHMARK_BATCH_ITEMS));
+	return (fcc_storage_delete() == FCC_STATUS_SUCCESS) ? PAL_SUCCESS : PAL_ERR_GENERIC_FAILURE;
+}
+
+
+void palTestMain(pal_args_t* args)
+{
+	palStatus_t status = PAL_SUCCESS;
+	(void)args;
+
+	status = pal_init();
+	if ((PAL_SUCCESS == status) && ((fcc_init() != FCC_STATUS_SUCCESS) || (fcc_storage_delete() != FCC_STATUS_SUCCESS)))
+	{
+		status = PAL_ERR_GENERIC_FAILURE;
+	}
+
+	BENCHMARK_PRINTF("*****PAL_FCC_PROVISIONING_BENCHMARK_START*****\r\n");
+	if (PAL_SUCCESS == status)
+	{
+		status = benchmarkBatchValidation();
+	}
+	if (PAL_SUCCESS == status)
+	{
+		status = benchmarkBatchRollback();
+	}
+	if (PAL_SUCCESS == status)
+	{
+		status = benchmarkBatchStore();
+	}
+	if (PAL_SUCCESS == status)
+	{
+		status = benchmarkProvision();
+	}
+	if (PAL_SUCCESS == status)
+	{
+		status = benchmarkVerify();
+	}
+	if (PAL_SUCCESS != status)
+	{
+		BENCHMARK_PRINTF("benchmark failed with status 0x%lx\r\n", (unsigned long)(uint32_t)status);
+	}
+	BENCHMARK_PRINTF("*****PAL_FCC_PROVISIONING_BENCHMARK_END*****\r\n");
+
+	fcc_storage_delete();
+	fcc_finalize();
+	pal_destroy();
+}
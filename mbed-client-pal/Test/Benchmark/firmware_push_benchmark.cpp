@@ -0,0 +1,337 @@
+/*
+ * Copyright (c) 2016 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Benchmark of a block-wise firmware push to the package resource /5/0/0.
+ *
+ * A BENCHMARK_IMAGE_SIZE image is pushed in 1024 byte blocks to the package
+ * resource of the firmware update object, the way M2MNsdlInterface hands each CoAP block to
+ * M2MResourceBase::handle_put_request(). The blocks are written by the default
+ * consumer, FirmwareBlockSink, to a firmware PAL that keeps the image in RAM:
+ *  - "copy" FirmwareBlockSink is called from an incoming block message
+ *    callback, which receives a copy of every block,
+ *  - "sink" FirmwareBlockSink is the incoming block sink of the resource,
+ *    which receives the payload of the CoAP message.
+ *
+ * For every push the benchmark prints the MB/s and the copies per byte, which
+ * are the bytes copied between the CoAP payload and the firmware PAL write,
+ * divided by the size of the image. The pushed image is compared with the
+ * written one.
+ */
+
+#include "pal.h"
+#include "pal_test_main.h"
+#include "sn_coap_header.h"
+#include "sn_nsdl_lib.h"
+#include "mbed-client/m2mobject.h"
+#include "mbed-client/m2mobjectinstance.h"
+#include "mbed-client/m2mresource.h"
+#include "mbed-client/m2mblockmessage.h"
+#include "update-client-lwm2m/FirmwareBlockSink.h"
+#include "update-client-paal/arm_uc_paal_update.h"
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+
+// The figures are the output of the benchmark, so they do not depend on DEBUG like PAL_PRINTF
+#define BENCHMARK_PRINTF(ARGS...) printf(ARGS)
+
+#define BENCHMARK_IMAGE_SIZE (10 * 1024 * 1024)
+#define BENCHMARK_LOCATION 0
+#define BENCHMARK_METADATA_SIZE 64
+
+#define BENCHMARK_BLOCK_SIZE 1024
+#define BENCHMARK_BLOCK_SZX 6 // 2^(6 + 4) = 1024
+#define BENCHMARK_BLOCK1(number, more) ((int32_t)(((number) << 4) | ((more) << 3) | BENCHMARK_BLOCK_SZX))
+
+PAL_PRIVATE struct nsdl_s* g_nsdl;
+PAL_PRIVATE uint8_t* g_image;       //!< Pushed image, the CoAP payloads point into it
+PAL_PRIVATE uint8_t* g_storage;     //!< Image written by the firmware PAL
+PAL_PRIVATE const uint8_t* g_payload;
+PAL_PRIVATE const uint8_t* g_blockData;
+PAL_PRIVATE uint64_t g_copiedBytes;
+PAL_PRIVATE uint32_t g_failedBlocks;
+PAL_PRIVATE uint32_t g_finalized;
+PAL_PRIVATE ARM_UC_PAAL_UPDATE_SignalEvent_t g_paalHandler;
+
+
+PAL_PRIVATE uint64_t benchmarkTicksToMicroSec(uint64_t ticks)
+{
+	return (ticks * 1000000) / pal_osKernelSysTickFrequency();
+}
+
+PAL_PRIVATE void* benchmarkAlloc(uint16_t size)
+{
+	return malloc(size);
+}
+
+PAL_PRIVATE void benchmarkFree(void* ptr)
+{
+	free(ptr);
+}
+
+PAL_PRIVATE uint8_t benchmarkSend(struct nsdl_s*, sn_nsdl_capab_e, uint8_t*, uint16_t, sn_nsdl_addr_s*)
+{
+	return 1;
+}
+
+PAL_PRIVATE uint8_t benchmarkReceived(struct nsdl_s*, sn_coap_hdr_s*, sn_nsdl_addr_s*)
+{
+	return 0;
+}
+
+/*
+ * Firmware PAL keeping the image in RAM, it completes every request at once.
+ */
+PAL_PRIVATE arm_uc_error_t benchmarkPaalInitialize(ARM_UC_PAAL_UPDATE_SignalEvent_t callback)
+{
+	g_paalHandler = callback;
+	return (arm_uc_error_t){ ERR_NONE };
+}
+
+PAL_PRIVATE arm_uc_error_t benchmarkPaalPrepare(uint32_t, const arm_uc_firmware_details_t* details, arm_uc_buffer_t*)
+{
+	arm_uc_error_t result = { ERR_INVALID_PARAMETER };
+
+	if (details && (details->size <= BENCHMARK_IMAGE_SIZE))
+	{
+		result.code = ERR_NONE;
+		g_paalHandler(ARM_UC_PAAL_EVENT_PREPARE_DONE);
+	}
+	return result;
+}
+
+PAL_PRIVATE arm_uc_error_t benchmarkPaalWrite(uint32_t, uint32_t offset, const arm_uc_buffer_t* buffer)
+{
+	arm_uc_error_t result = { ERR_INVALID_PARAMETER };
+
+	if (buffer && (offset <= BENCHMARK_IMAGE_SIZE) && (buffer->size <= (BENCHMARK_IMAGE_SIZE - offset)))
+	{
+		// Any buffer other than the one given to the consumer holds a copy
+		if (buffer->ptr != g_blockData)
+		{
+			g_copiedBytes += buffer->size;
+		}
+		memcpy(g_storage + offset, buffer->ptr, buffer->size);
+		result.code = ERR_NONE;
+		g_paalHandler(ARM_UC_PAAL_EVENT_WRITE_DONE);
+	}
+	return result;
+}
+
+PAL_PRIVATE arm_uc_error_t benchmarkPaalFinalize(uint32_t)
+{
+	g_paalHandler(ARM_UC_PAAL_EVENT_FINALIZE_DONE);
+	return (arm_uc_error_t){ ERR_NONE };
+}
+
+PAL_PRIVATE ARM_UC_PAAL_UPDATE g_benchmarkPaal;
+
+PAL_PRIVATE void benchmarkPaalEvent(uint32_t event)
+{
+	if (ARM_UC_PAAL_EVENT_FINALIZE_DONE == event)
+	{
+		++g_finalized;
+	}
+}
+
+/*
+ * Consumers, they count the copy of the block made before they are called.
+ */
+PAL_PRIVATE void benchmarkConsume(const M2MBlockMessage* message)
+{
+	g_blockData = message->block_data();
+	if (g_blockData != g_payload)
+	{
+		g_copiedBytes += message->block_data_len();
+	}
+	if (!FirmwareBlockSink::writeBlock(message))
+	{
+		++g_failedBlocks;
+	}
+}
+
+PAL_PRIVATE void benchmarkBlockMessage(M2MBlockMessage* message)
+{
+	benchmarkConsume(message);
+}
+
+PAL_PRIVATE bool benchmarkBlockSink(const M2MBlockMessage* message)
+{
+	benchmarkConsume(message);
+	return true;
+}
+
+PAL_PRIVATE palStatus_t benchmarkPush(M2MResource* package, const char* name)
+{
+	sn_coap_hdr_s request;
+	sn_coap_options_list_s options;
+	arm_uc_firmware_details_t details;
+	uint8_t metadata[BENCHMARK_METADATA_SIZE];
+	arm_uc_buffer_t metadataBuffer = { sizeof(metadata), 0, metadata };
+	uint32_t blocks = BENCHMARK_IMAGE_SIZE / BENCHMARK_BLOCK_SIZE;
+	uint64_t start = 0;
+	uint64_t elapsedUs = 0;
+	uint32_t i = 0;
+
+	memset(&details, 0, sizeof(details));
+	details.size = BENCHMARK_IMAGE_SIZE;
+	memset(g_storage, 0, BENCHMARK_IMAGE_SIZE);
+	if (ARM_UCP_Prepare(BENCHMARK_LOCATION, &details, &metadataBuffer).error != ERR_NONE)
+	{
+		return PAL_ERR_GENERIC_FAILURE;
+	}
+	g_copiedBytes = 0;
+	g_failedBlocks = 0;
+	g_finalized = 0;
+
+	start = pal_osKernelSysTick();
+	for (i = 0; i < blocks; ++i)
+	{
+		bool valueUpdated = false;
+		sn_coap_hdr_s* response = NULL;
+
+		memset(&request, 0, sizeof(request));
+		memset(&options, 0, sizeof(options));
+		options.block1 = BENCHMARK_BLOCK1(i, ((i + 1) < blocks) ? 1 : 0);
+		options.block2 = -1;
+		options.uri_port = -1;
+		options.observe = -1;
+		options.accept = COAP_CT_NONE;
+		request.msg_type = COAP_MSG_TYPE_CONFIRMABLE;
+		request.msg_code = COAP_MSG_CODE_REQUEST_PUT;
+		request.msg_id = (uint16_t)i;
+		request.content_format = COAP_CT_NONE;
+		request.options_list_ptr = &options;
+		request.payload_ptr = g_image + (i * BENCHMARK_BLOCK_SIZE);
+		request.payload_len = BENCHMARK_BLOCK_SIZE;
+		g_payload = request.payload_ptr;
+
+		response = package->handle_put_request(g_nsdl, &request, NULL, valueUpdated);
+		if ((NULL == response) || (COAP_MSG_CODE_RESPONSE_CHANGED != response->msg_code))
+		{
+			++g_failedBlocks;
+		}
+		sn_nsdl_release_allocated_coap_msg_mem(g_nsdl, response);
+	}
+	elapsedUs = benchmarkTicksToMicroSec(pal_osKernelSysTick() - start);
+
+	BENCHMARK_PRINTF("%-4s %lu bytes in %lu ms, %lu.%02lu MB/s, %lu.%02lu copies per byte\r\n", name,
+	            (unsigned long)BENCHMARK_IMAGE_SIZE, (unsigned long)(elapsedUs / 1000),
+	            (unsigned long)(BENCHMARK_IMAGE_SIZE / (elapsedUs ? elapsedUs : 1)),
+	            (unsigned long)(((BENCHMARK_IMAGE_SIZE * 100ULL) / (elapsedUs ? elapsedUs : 1)) % 100),
+	            (unsigned long)(g_copiedBytes / BENCHMARK_IMAGE_SIZE),
+	            (unsigned long)(((g_copiedBytes * 100) / BENCHMARK_IMAGE_SIZE) % 100));
+	if ((0 != g_failedBlocks) || (1 != g_finalized) || (0 != memcmp(g_image, g_storage, BENCHMARK_IMAGE_SIZE)))
+	{
+		return PAL_ERR_GENERIC_FAILURE;
+	}
+	return PAL_SUCCESS;
+}
+
+// Firmware update object /5, the way FirmwareUpdateResource creates it
+class BenchmarkUpdateObject : public M2MObject {
+public:
+	BenchmarkUpdateObject() : M2MObject("5", stringdup("5")) {}
+};
+
+PAL_PRIVATE palStatus_t benchmarkRun(void)
+{
+	BenchmarkUpdateObject object;
+	M2MResource* package[2] = { NULL, NULL };
+	palStatus_t status = PAL_SUCCESS;
+	uint16_t i = 0;
+
+	// The block message callback is only called while the resource has no sink, so each push has its own instance
+	for (i = 0; i < 2; ++i)
+	{
+		M2MObjectInstance* instance = object.create_object_instance(i);
+
+		package[i] = instance ? instance->create_dynamic_resource("0", "Package", M2MResourceInstance::OPAQUE, false) : NULL;
+		if (NULL == package[i])
+		{
+			return PAL_ERR_NO_MEMORY;
+		}
+		package[i]->set_operation(M2MBase::PUT_ALLOWED);
+	}
+	if ((FirmwareBlockSink::Attach(package[1], BENCHMARK_LOCATION, benchmarkPaalEvent) != 0) ||
+	    (ARM_UCP_Initialize(FirmwareBlockSink::eventHandler).error != ERR_NONE))
+	{
+		return PAL_ERR_GENERIC_FAILURE;
+	}
+
+	package[0]->set_incoming_block_message_callback(benchmarkBlockMessage);
+	status = benchmarkPush(package[0], "copy");
+
+	if (PAL_SUCCESS == status)
+	{
+		package[1]->set_incoming_block_sink_callback(benchmarkBlockSink);
+		status = benchmarkPush(package[1], "sink");
+	}
+	return status;
+}
+
+
+void palTestMain(pal_args_t* args)
+{
+	palStatus_t status = PAL_SUCCESS;
+	(void)args;
+
+	status = pal_init();
+	if (PAL_SUCCESS == status)
+	{
+		g_nsdl = sn_nsdl_init(benchmarkSend, benchmarkReceived, benchmarkAlloc, benchmarkFree, NULL);
+		g_image = (uint8_t*)malloc(BENCHMARK_IMAGE_SIZE);
+		g_storage = (uint8_t*)malloc(BENCHMARK_IMAGE_SIZE);
+		if ((NULL == g_nsdl) || (NULL == g_image) || (NULL == g_storage))
+		{
+			status = PAL_ERR_NO_MEMORY;
+		}
+	}
+	if (PAL_SUCCESS == status)
+	{
+		uint32_t i = 0;
+
+		for (i = 0; i < BENCHMARK_IMAGE_SIZE; ++i)
+		{
+			g_image[i] = (uint8_t)(i ^ (i >> 10));
+		}
+		g_benchmarkPaal.Initialize = benchmarkPaalInitialize;
+		g_benchmarkPaal.Prepare = benchmarkPaalPrepare;
+		g_benchmarkPaal.Write = benchmarkPaalWrite;
+		g_benchmarkPaal.Finalize = benchmarkPaalFinalize;
+		ARM_UCP_SetPAALUpdate(&g_benchmarkPaal);
+	}
+
+	BENCHMARK_PRINTF("*****PAL_FIRMWARE_PUSH_BENCHMARK_START*****\r\n");
+	if (PAL_SUCCESS == status)
+	{
+		status = benchmarkRun();
+	}
+	if (PAL_SUCCESS != status)
+	{
+		BENCHMARK_PRINTF("benchmark failed with status 0x%lx\r\n", (unsigned long)(uint32_t)status);
+	}
+	BENCHMARK_PRINTF("*****PAL_FIRMWARE_PUSH_BENCHMARK_END*****\r\n");
+
+	if (g_nsdl)
+	{
+		sn_nsdl_destroy(g_nsdl);
+	}
+	free(g_image);
+	free(g_storage);
+	pal_destroy();
+}
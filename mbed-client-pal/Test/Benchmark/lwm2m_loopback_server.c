@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) 2016 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "pal.h"
+#include "pal_network.h"
+#include "lwm2m_loopback_server.h"
+#include "string.h"
+
+#define LOOPBACK_SERVER_HEADER_LENGTH 4
+#define LOOPBACK_SERVER_TOKEN_LENGTH 4
+
+// Option values meaning "not present", the same as the defaults set by sn_coap_parser_alloc_options()
+#define LOOPBACK_SERVER_OPTION_NONE (-1)
+#define LOOPBACK_SERVER_MAX_AGE_DEFAULT 60
+
+PAL_PRIVATE void loopbackServerInitOptions(sn_coap_options_list_s* options)
+{
+	memset(options, 0, sizeof(*options));
+	options->max_age = LOOPBACK_SERVER_MAX_AGE_DEFAULT;
+	options->uri_port = LOOPBACK_SERVER_OPTION_NONE;
+	options->observe = LOOPBACK_SERVER_OPTION_NONE;
+	options->accept = COAP_CT_NONE;
+	options->block1 = LOOPBACK_SERVER_OPTION_NONE;
+	options->block2 = LOOPBACK_SERVER_OPTION_NONE;
+}
+
+PAL_PRIVATE palStatus_t loopbackServerSend(palLoopbackServer_t* server, sn_coap_hdr_s* message)
+{
+	palStatus_t status = PAL_SUCCESS;
+	size_t sent = 0;
+	int16_t length = 0;
+
+	if (!server->clientKnown)
+	{
+		return PAL_ERR_INVALID_ARGUMENT;
+	}
+	if (sn_coap_builder_calc_needed_packet_data_size_2(message, 0) > sizeof(server->txBuffer))
+	{
+		return PAL_ERR_BUFFER_TOO_SMALL;
+	}
+	length = sn_coap_builder_2(server->txBuffer, message, 0);
+	if (length < 0)
+	{
+		return PAL_ERR_INVALID_ARGUMENT;
+	}
+
+	status = pal_sendTo(server->socket, server->txBuffer, (size_t)length, &server->clientAddress, server->clientAddressLength, &sent);
+	if ((PAL_SUCCESS == status) && (sent != (size_t)length))
+	{
+		status = PAL_ERR_SOCKET_GENERIC;
+	}
+	return status;
+}
+
+
+palStatus_t loopbackServerOpen(palLoopbackServer_t* server, uint16_t port, int timeoutMs)
+{
+	palStatus_t status = PAL_SUCCESS;
+	palSocketAddress_t address = {0};
+	palIpV4Addr_t loopback = {127, 0, 0, 1};
+
+	memset(server, 0, sizeof(*server));
+	server->messageId = 1;
+
+	status = pal_socket(PAL_AF_INET, PAL_SOCK_DGRAM, false, PAL_NET_DEFAULT_INTERFACE, &server->socket);
+	if (PAL_SUCCESS != status)
+	{
+		return status;
+	}
+
+	status = pal_setSocketOptions(server->socket, PAL_SO_RCVTIMEO, &timeoutMs, sizeof(timeoutMs));
+	if (PAL_SUCCESS == status)
+	{
+		status = pal_setSockAddrIPV4Addr(&address, loopback);
+	}
+	if (PAL_SUCCESS == status)
+	{
+		status = pal_setSockAddrPort(&address, port);
+	}
+	if (PAL_SUCCESS == status)
+	{
+		status = pal_bind(server->socket, &address, sizeof(address));
+	}
+
+	if (PAL_SUCCESS != status)
+	{
+		pal_close(&server->socket);
+	}
+	return status;
+}
+
+
+palStatus_t loopbackServerClose(palLoopbackServer_t* server)
+{
+	return pal_close(&server->socket);
+}
+
+
+palStatus_t loopbackServerReceive(palLoopbackServer_t* server)
+{
+	palStatus_t status = PAL_SUCCESS;
+	palSocketAddress_t from = {0};
+	palSocketLength_t fromLength = sizeof(from);
+	size_t received = 0;
+
+	status = pal_receiveFrom(server->socket, server->rxBuffer, sizeof(server->rxBuffer), &from, &fromLength, &received);
+	if (PAL_SUCCESS != status)
+	{
+		return status;
+	}
+
+	if (!server->clientKnown)
+	{
+		server->clientAddress = from;
+		server->clientAddressLength = fromLength;
+		server->clientKnown = true;
+	}
+
+	if (sn_coap_parser_view(&server->message, server->rxBuffer, (uint16_t)received) != 0)
+	{
+		return PAL_ERR_INVALID_ARGUMENT;
+	}
+	return PAL_SUCCESS;
+}
+
+
+palStatus_t loopbackServerSendRequest(palLoopbackServer_t* server, sn_coap_msg_code_e code, const char* path,
+                                      const uint8_t* payload, uint16_t payloadLength, int32_t block1, uint16_t* messageId)
+{
+	palStatus_t status = PAL_SUCCESS;
+	sn_coap_hdr_s request;
+	sn_coap_options_list_s options;
+	uint8_t token[LOOPBACK_SERVER_TOKEN_LENGTH];
+
+	memset(&request, 0, sizeof(request));
+	request.msg_type = COAP_MSG_TYPE_CONFIRMABLE;
+	request.msg_code = code;
+	request.content_format = COAP_CT_NONE;
+	request.msg_id = server->messageId;
+
+	memcpy(token, &server->token, sizeof(token));
+	request.token_ptr = token;
+	request.token_len = sizeof(token);
+
+	request.uri_path_ptr = (uint8_t*)path;
+	request.uri_path_len = (uint16_t)strlen(path);
+	request.payload_ptr = (uint8_t*)payload;
+	request.payload_len = payloadLength;
+
+	if (LOOPBACK_SERVER_OPTION_NONE != block1)
+	{
+		loopbackServerInitOptions(&options);
+		options.block1 = block1;
+		request.options_list_ptr = &options;
+	}
+
+	status = loopbackServerSend(server, &request);
+	if (PAL_SUCCESS == status)
+	{
+		*messageId = server->messageId;
+		server->messageId++;
+		if (0 == server->messageId)
+		{
+			server->messageId = 1;
+		}
+		server->token++;
+	}
+	return status;
+}
+
+
+palStatus_t loopbackServerRespond(palLoopbackServer_t* server, sn_coap_msg_code_e code, const char* locationPath)
+{
+	sn_coap_hdr_s response;
+	sn_coap_options_list_s options;
+
+	memset(&response, 0, sizeof(response));
+	response.msg_type = COAP_MSG_TYPE_ACKNOWLEDGEMENT;
+	response.msg_code = code;
+	response.content_format = COAP_CT_NONE;
+	response.msg_id = server->message.msg_id;
+
+	// An empty acknowledgement carries no token
+	if ((COAP_MSG_CODE_EMPTY != code) && (server->message.token_len > 0))
+	{
+		response.token_ptr = (uint8_t*)server->message.packet_ptr + LOOPBACK_SERVER_HEADER_LENGTH;
+		response.token_len = server->message.token_len;
+	}
+
+	if (NULL != locationPath)
+	{
+		loopbackServerInitOptions(&options);
+		options.location_path_ptr = (uint8_t*)locationPath;
+		options.location_path_len = (uint16_t)strlen(locationPath);
+		response.options_list_ptr = &options;
+	}
+
+	return loopbackServerSend(server, &response);
+}
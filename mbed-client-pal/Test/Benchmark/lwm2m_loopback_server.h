@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2016 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _LWM2M_LOOPBACK_SERVER_H
+#define _LWM2M_LOOPBACK_SERVER_H
+
+#include "pal.h"
+#include "sn_coap_header.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//! Largest datagram handled by the server, a 1024 byte block with its header and options fits.
+#define LOOPBACK_SERVER_BUFFER_SIZE 1280
+
+/*! Minimal LwM2M server stand-in for the client benchmark.
+*
+* The server serves a single client over UDP on the loopback interface. It
+* only builds and parses CoAP messages, there is no resource directory, no
+* retransmission and no security. Messages are parsed into a view of the
+* receive buffer and built into the transmit buffer, so the server itself does
+* not allocate and does not disturb the heap figures of the client.
+*/
+typedef struct palLoopbackServer{
+	palSocket_t socket;
+	palSocketAddress_t clientAddress;      //!< Learned from the first message received.
+	palSocketLength_t clientAddressLength;
+	bool clientKnown;
+	uint16_t messageId;                    //!< Message ID of the next request.
+	uint32_t token;                        //!< Token of the next request.
+	sn_coap_hdr_view_s message;            //!< Last message received, refers to rxBuffer.
+	uint8_t rxBuffer[LOOPBACK_SERVER_BUFFER_SIZE];
+	uint8_t txBuffer[LOOPBACK_SERVER_BUFFER_SIZE];
+}palLoopbackServer_t;
+
+/*! \brief Open the server socket on 127.0.0.1.
+*
+* @param[out] server The server to open.
+* @param[in] port The UDP port to listen on.
+* @param[in] timeoutMs The receive timeout, in milliseconds.
+*
+* \return PAL_SUCCESS on success, a negative value indicating a specific error code in case of failure.
+*/
+palStatus_t loopbackServerOpen(palLoopbackServer_t* server, uint16_t port, int timeoutMs);
+
+/*! \brief Close the server socket.
+*
+* @param[in] server The server to close.
+*
+* \return PAL_SUCCESS on success, a negative value indicating a specific error code in case of failure.
+*/
+palStatus_t loopbackServerClose(palLoopbackServer_t* server);
+
+/*! \brief Wait for the next message from the client and parse it into `server->message`.
+*
+* @param[in] server The server.
+*
+* \return PAL_SUCCESS on success, a negative value indicating a specific error code in case of failure.
+*         PAL_ERR_INVALID_ARGUMENT is returned for a datagram that is not a valid CoAP message.
+*/
+palStatus_t loopbackServerReceive(palLoopbackServer_t* server);
+
+/*! \brief Send a confirmable request to the client.
+*
+* @param[in] server The server.
+* @param[in] code The request method.
+* @param[in] path The URI path without the leading '/', for example "3303/0/5700".
+* @param[in] payload The payload, NULL if not used.
+* @param[in] payloadLength The payload length.
+* @param[in] block1 The Block1 option value, -1 if not used.
+* @param[out] messageId The message ID of the request, to match the response against.
+*
+* \return PAL_SUCCESS on success, a negative value indicating a specific error code in case of failure.
+*/
+palStatus_t loopbackServerSendRequest(palLoopbackServer_t* server, sn_coap_msg_code_e code, const char* path,
+                                      const uint8_t* payload, uint16_t payloadLength, int32_t block1, uint16_t* messageId);
+
+/*! \brief Acknowledge `server->message` with a piggybacked response.
+*
+* @param[in] server The server.
+* @param[in] code The response code, COAP_MSG_CODE_EMPTY for an empty acknowledgement.
+* @param[in] locationPath The Location-Path of the response without the leading '/', NULL if not used.
+*
+* \return PAL_SUCCESS on success, a negative value indicating a specific error code in case of failure.
+*/
+palStatus_t loopbackServerRespond(palLoopbackServer_t* server, sn_coap_msg_code_e code, const char* locationPath);
+
+#ifdef __cplusplus
+}
+#endif
+#endif //_LWM2M_LOOPBACK_SERVER_H
@@ -0,0 +1,573 @@
+/*
+ * Copyright (c) 2016 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * End to end benchmark of the LwM2M client engine against the loopback server.
+ *
+ * The client side is the mbed-client-c (sn_nsdl) and mbed-coap engine that
+ * M2MNsdlInterface drives, with its allocator routed to malloc and free so
+ * that the memory profiler (PAL_MEMORY_STATISTICS) sees every allocation.
+ * Client and server run in the same thread and exchange every message over
+ * UDP on 127.0.0.1, so each exchange is measured from the first send to the
+ * processing of the last reply.
+ *
+ * For every workload the benchmark prints the exchanges per second, the
+ * messages per second, the p50 and p99 exchange latency and, when built with
+ * PAL_MEMORY_STATISTICS, the heap peak and the allocations per message.
+ */
+
+#include "pal.h"
+#include "pal_network.h"
+#include "PlatIncludes.h"
+#include "pal_test_main.h"
+#include "lwm2m_loopback_server.h"
+#include "sn_nsdl.h"
+#include "sn_coap_header.h"
+#include "sn_nsdl_lib.h"
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+
+// The figures are the output of the benchmark, so they do not depend on DEBUG like PAL_PRINTF
+#define BENCHMARK_PRINTF(ARGS...) printf(ARGS)
+
+#define BENCHMARK_SERVER_PORT 5683
+#define BENCHMARK_CLIENT_PORT 5684
+#define BENCHMARK_TIMEOUT_MS 1000
+
+#define BENCHMARK_REGISTRATIONS 200
+#define BENCHMARK_REQUESTS 2000
+#define BENCHMARK_NOTIFICATIONS 2000
+#define BENCHMARK_FIRMWARE_PUSHES 20
+#define BENCHMARK_FIRMWARE_SIZE (16 * 1024)
+
+//! Resources published in the registration in addition to the measured ones, the registration payload must fit one block.
+#define BENCHMARK_EXTRA_RESOURCES 16
+#define BENCHMARK_PATH_SIZE 16
+
+#define BENCHMARK_BLOCK_SIZE 1024
+#define BENCHMARK_BLOCK_SZX 6 // 2^(6 + 4) = 1024
+#define BENCHMARK_BLOCK1(number, more) ((int32_t)(((number) << 4) | ((more) << 3) | BENCHMARK_BLOCK_SZX))
+
+#define BENCHMARK_FIRMWARE_BLOCKS (BENCHMARK_FIRMWARE_PUSHES * (BENCHMARK_FIRMWARE_SIZE / BENCHMARK_BLOCK_SIZE))
+#define BENCHMARK_MAX_EXCHANGES BENCHMARK_REQUESTS
+
+#define BENCHMARK_GET_PATH "3303/0/5700"
+#define BENCHMARK_PUT_PATH "3303/0/5750"
+#define BENCHMARK_FIRMWARE_PATH "5/0/0"
+#define BENCHMARK_LOCATION_PATH "rd/benchmark"
+
+typedef palStatus_t (*benchmarkExchange_t)(uint32_t index);
+
+typedef struct benchmarkResource{
+	sn_nsdl_static_resource_parameters_s staticParameters;
+	sn_nsdl_dynamic_resource_parameters_s dynamicParameters;
+	char path[BENCHMARK_PATH_SIZE];
+}benchmarkResource_t;
+
+typedef struct benchmarkClient{
+	struct nsdl_s* nsdl;
+	palSocket_t socket;
+	palSocketAddress_t serverAddress;
+	bool registered;
+	uint32_t bytesReceived;   //!< Payload bytes seen by the firmware resource.
+	uint8_t rxBuffer[LOOPBACK_SERVER_BUFFER_SIZE];
+}benchmarkClient_t;
+
+PAL_PRIVATE benchmarkClient_t g_client;
+PAL_PRIVATE palLoopbackServer_t g_server;
+PAL_PRIVATE benchmarkResource_t g_resources[BENCHMARK_EXTRA_RESOURCES + 3];
+PAL_PRIVATE uint64_t g_latencies[BENCHMARK_MAX_EXCHANGES];
+PAL_PRIVATE uint8_t g_firmware[BENCHMARK_FIRMWARE_SIZE];
+
+
+PAL_PRIVATE void* benchmarkAlloc(uint16_t size)
+{
+	return malloc(size);
+}
+
+PAL_PRIVATE void benchmarkFree(void* ptr)
+{
+	free(ptr);
+}
+
+PAL_PRIVATE uint8_t benchmarkClientSend(struct nsdl_s* handle, sn_nsdl_capab_e protocol, uint8_t* data, uint16_t length, sn_nsdl_addr_s* address)
+{
+	size_t sent = 0;
+	(void)handle;
+	(void)protocol;
+	(void)address;
+
+	palStatus_t status = pal_sendTo(g_client.socket, data, length, &g_client.serverAddress, sizeof(g_client.serverAddress), &sent);
+	return ((PAL_SUCCESS == status) && (sent == length)) ? 1 : 0;
+}
+
+PAL_PRIVATE uint8_t benchmarkClientReceived(struct nsdl_s* handle, sn_coap_hdr_s* message, sn_nsdl_addr_s* address)
+{
+	(void)handle;
+	(void)address;
+
+	if ((COAP_MSG_CODE_RESPONSE_CREATED == message->msg_code) && (sn_nsdl_is_ep_registered(g_client.nsdl) == SN_NSDL_ENDPOINT_IS_REGISTERED))
+	{
+		g_client.registered = true;
+	}
+	return 0;
+}
+
+PAL_PRIVATE uint8_t benchmarkResourceCallback(struct nsdl_s* handle, sn_coap_hdr_s* request, sn_nsdl_addr_s* address, sn_nsdl_capab_e protocol)
+{
+	static uint8_t value[] = "23.5";
+	sn_coap_hdr_s* response = NULL;
+	uint8_t code = COAP_MSG_CODE_RESPONSE_CHANGED;
+	(void)protocol;
+
+	if (COAP_MSG_CODE_REQUEST_PUT == request->msg_code)
+	{
+		g_client.bytesReceived += request->payload_len;
+		// The protocol layer acknowledges the blocks before the last one itself
+		if (COAP_STATUS_PARSER_BLOCKWISE_MSG_RECEIVING == request->coap_status)
+		{
+			return 0;
+		}
+	}
+	else if (COAP_MSG_CODE_REQUEST_GET == request->msg_code)
+	{
+		code = COAP_MSG_CODE_RESPONSE_CONTENT;
+	}
+	else
+	{
+		code = COAP_MSG_CODE_RESPONSE_METHOD_NOT_ALLOWED;
+	}
+
+	response = sn_nsdl_build_response(handle, request, code);
+	if (NULL == response)
+	{
+		return 1;
+	}
+	if (COAP_MSG_CODE_RESPONSE_CONTENT == code)
+	{
+		response->payload_ptr = value;
+		response->payload_len = sizeof(value) - 1;
+		response->content_format = COAP_CT_TEXT_PLAIN;
+	}
+	sn_nsdl_send_coap_message(handle, address, response);
+	response->payload_ptr = NULL;
+	sn_nsdl_release_allocated_coap_msg_mem(handle, response);
+	return 0;
+}
+
+PAL_PRIVATE palStatus_t benchmarkAddResource(benchmarkResource_t* resource, const char* path, unsigned access, bool externalBlocks)
+{
+	memset(resource, 0, sizeof(*resource));
+	strncpy(resource->path, path, sizeof(resource->path) - 1);
+
+	resource->staticParameters.path = resource->path;
+	resource->staticParameters.mode = SN_GRS_DYNAMIC;
+	resource->staticParameters.external_memory_block = externalBlocks;
+
+	resource->dynamicParameters.sn_grs_dyn_res_callback = benchmarkResourceCallback;
+	resource->dynamicParameters.static_resource_parameters = &resource->staticParameters;
+	resource->dynamicParameters.access = access;
+	resource->dynamicParameters.publish_uri = true;
+	resource->dynamicParameters.coap_content_type = COAP_CT_TEXT_PLAIN;
+
+	return (sn_nsdl_put_resource(g_client.nsdl, &resource->dynamicParameters) == SN_NSDL_SUCCESS) ? PAL_SUCCESS : PAL_ERR_GENERIC_FAILURE;
+}
+
+//! Read one datagram from the server and hand it to the client engine.
+PAL_PRIVATE palStatus_t benchmarkClientProcess(void)
+{
+	palStatus_t status = PAL_SUCCESS;
+	palSocketAddress_t from = {0};
+	palSocketLength_t fromLength = sizeof(from);
+	palIpV4Addr_t fromAddress = {0};
+	sn_nsdl_addr_s source = {0};
+	size_t received = 0;
+
+	status = pal_receiveFrom(g_client.socket, g_client.rxBuffer, sizeof(g_client.rxBuffer), &from, &fromLength, &received);
+	if (PAL_SUCCESS == status)
+	{
+		status = pal_getSockAddrIPV4Addr(&from, fromAddress);
+	}
+	if (PAL_SUCCESS == status)
+	{
+		status = pal_getSockAddrPort(&from, &source.port);
+	}
+	if (PAL_SUCCESS != status)
+	{
+		return status;
+	}
+
+	source.type = SN_NSDL_ADDRESS_TYPE_IPV4;
+	source.addr_len = sizeof(fromAddress);
+	source.addr_ptr = fromAddress;
+	sn_nsdl_process_coap(g_client.nsdl, g_client.rxBuffer, (uint16_t)received, &source);
+	return PAL_SUCCESS;
+}
+
+//! Wait for the response to the request `messageId` of the server.
+PAL_PRIVATE palStatus_t benchmarkServerExpect(uint16_t messageId, sn_coap_msg_code_e code)
+{
+	palStatus_t status = loopbackServerReceive(&g_server);
+	if (PAL_SUCCESS != status)
+	{
+		return status;
+	}
+	if ((COAP_MSG_TYPE_ACKNOWLEDGEMENT != g_server.message.msg_type) || (messageId != g_server.message.msg_id) ||
+	    (code != g_server.message.msg_code))
+	{
+		return PAL_ERR_GENERIC_FAILURE;
+	}
+	return PAL_SUCCESS;
+}
+
+PAL_PRIVATE palStatus_t benchmarkRegister(uint32_t index)
+{
+	static uint8_t name[] = "benchmark";
+	static uint8_t type[] = "test";
+	static uint8_t lifetime[] = "3600";
+	sn_nsdl_ep_parameters_s endpoint;
+	palStatus_t status = PAL_SUCCESS;
+	(void)index;
+
+	memset(&endpoint, 0, sizeof(endpoint));
+	endpoint.endpoint_name_ptr = name;
+	endpoint.endpoint_name_len = sizeof(name) - 1;
+	endpoint.type_ptr = type;
+	endpoint.type_len = sizeof(type) - 1;
+	endpoint.lifetime_ptr = lifetime;
+	endpoint.lifetime_len = sizeof(lifetime) - 1;
+	endpoint.binding_and_mode = BINDING_MODE_U;
+	endpoint.ds_register_mode = REGISTER_WITH_RESOURCES;
+
+	g_client.registered = false;
+	if (0 == sn_nsdl_register_endpoint(g_client.nsdl, &endpoint, NULL, 0))
+	{
+		return PAL_ERR_GENERIC_FAILURE;
+	}
+
+	status = loopbackServerReceive(&g_server);
+	if (PAL_SUCCESS != status)
+	{
+		return status;
+	}
+	if ((COAP_MSG_CODE_REQUEST_POST != g_server.message.msg_code) || (-1 != g_server.message.block1))
+	{
+		// A blockwise registration needs more than this server implements
+		return PAL_ERR_GENERIC_FAILURE;
+	}
+
+	status = loopbackServerRespond(&g_server, COAP_MSG_CODE_RESPONSE_CREATED, BENCHMARK_LOCATION_PATH);
+	if (PAL_SUCCESS == status)
+	{
+		status = benchmarkClientProcess();
+	}
+	if ((PAL_SUCCESS == status) && !g_client.registered)
+	{
+		status = PAL_ERR_GENERIC_FAILURE;
+	}
+	return status;
+}
+
+PAL_PRIVATE palStatus_t benchmarkRequest(sn_coap_msg_code_e method, const char* path, const uint8_t* payload, uint16_t payloadLength,
+                                         int32_t block1, sn_coap_msg_code_e expected)
+{
+	uint16_t messageId = 0;
+	palStatus_t status = loopbackServerSendRequest(&g_server, method, path, payload, payloadLength, block1, &messageId);
+	if (PAL_SUCCESS == status)
+	{
+		status = benchmarkClientProcess();
+	}
+	if (PAL_SUCCESS == status)
+	{
+		status = benchmarkServerExpect(messageId, expected);
+	}
+	return status;
+}
+
+PAL_PRIVATE palStatus_t benchmarkGet(uint32_t index)
+{
+	(void)index;
+	return benchmarkRequest(COAP_MSG_CODE_REQUEST_GET, BENCHMARK_GET_PATH, NULL, 0, -1, COAP_MSG_CODE_RESPONSE_CONTENT);
+}
+
+PAL_PRIVATE palStatus_t benchmarkPut(uint32_t index)
+{
+	static const uint8_t value[] = "42";
+	(void)index;
+	return benchmarkRequest(COAP_MSG_CODE_REQUEST_PUT, BENCHMARK_PUT_PATH, value, sizeof(value) - 1, -1, COAP_MSG_CODE_RESPONSE_CHANGED);
+}
+
+PAL_PRIVATE palStatus_t benchmarkNotify(uint32_t index)
+{
+	static uint8_t token[] = {0xbe, 0xec};
+	static uint8_t value[] = "23.5";
+	palStatus_t status = PAL_SUCCESS;
+
+	int32_t messageId = sn_nsdl_send_observation_notification(g_client.nsdl, token, sizeof(token), value, sizeof(value) - 1,
+	                                                          (sn_coap_observe_e)(index & 0xffffff), COAP_MSG_TYPE_CONFIRMABLE,
+	                                                          COAP_CT_TEXT_PLAIN, -1);
+	if (messageId <= 0)
+	{
+		return PAL_ERR_GENERIC_FAILURE;
+	}
+
+	status = loopbackServerReceive(&g_server);
+	if ((PAL_SUCCESS == status) && ((uint16_t)messageId != g_server.message.msg_id))
+	{
+		status = PAL_ERR_GENERIC_FAILURE;
+	}
+	if (PAL_SUCCESS == status)
+	{
+		status = loopbackServerRespond(&g_server, COAP_MSG_CODE_EMPTY, NULL);
+	}
+	if (PAL_SUCCESS == status)
+	{
+		// Processing the acknowledgement frees the notification from the resend queue
+		status = benchmarkClientProcess();
+	}
+	return status;
+}
+
+//! One exchange per block, a push is complete when the last block is acknowledged with 2.04.
+PAL_PRIVATE palStatus_t benchmarkFirmwareBlock(uint32_t index)
+{
+	const uint32_t blocks = BENCHMARK_FIRMWARE_SIZE / BENCHMARK_BLOCK_SIZE;
+	uint32_t block = index % blocks;
+	bool more = (block + 1) < blocks;
+
+	return benchmarkRequest(COAP_MSG_CODE_REQUEST_PUT, BENCHMARK_FIRMWARE_PATH, g_firmware + (block * BENCHMARK_BLOCK_SIZE), BENCHMARK_BLOCK_SIZE,
+	                        BENCHMARK_BLOCK1(block, more ? 1 : 0),
+	                        more ? COAP_MSG_CODE_RESPONSE_CONTINUE : COAP_MSG_CODE_RESPONSE_CHANGED);
+}
+
+PAL_PRIVATE int benchmarkCompareLatency(const void* a, const void* b)
+{
+	uint64_t left = *(const uint64_t*)a;
+	uint64_t right = *(const uint64_t*)b;
+	return (left > right) - (left < right);
+}
+
+PAL_PRIVATE uint64_t benchmarkTicksToMicroSec(uint64_t ticks)
+{
+	return (ticks * 1000000) / pal_osKernelSysTickFrequency();
+}
+
+/*! \brief Run `count` exchanges of a workload and print its figures.
+*
+* @param[in] name The workload name.
+* @param[in] exchange The function doing one exchange.
+* @param[in] count The number of exchanges.
+* @param[in] messagesPerExchange The number of datagrams in one exchange, requests and responses together.
+*
+* \return PAL_SUCCESS on success, the status of the failed exchange otherwise.
+*/
+PAL_PRIVATE palStatus_t benchmarkRun(const char* name, benchmarkExchange_t exchange, uint32_t count, uint32_t messagesPerExchange)
+{
+	palStatus_t status = PAL_SUCCESS;
+	uint64_t start = 0;
+	uint64_t elapsedUs = 0;
+	uint32_t messages = count * messagesPerExchange;
+	uint32_t i = 0;
+#ifdef PAL_MEMORY_STATISTICS
+	palMemoryStats_t before = {0};
+	palMemoryStats_t after = {0};
+#endif
+
+	if ((0 == count) || (count > BENCHMARK_MAX_EXCHANGES))
+	{
+		return PAL_ERR_INVALID_ARGUMENT;
+	}
+
+#ifdef PAL_MEMORY_STATISTICS
+
+	resetMemoryStats();
+	getMemoryStats(&before);
+#endif
+
+	start = pal_osKernelSysTick();
+	for (i = 0; (i < count) && (PAL_SUCCESS == status); ++i)
+	{
+		uint64_t exchangeStart = pal_osKernelSysTick();
+		status = exchange(i);
+		g_latencies[i] = pal_osKernelSysTick() - exchangeStart;
+	}
+	elapsedUs = benchmarkTicksToMicroSec(pal_osKernelSysTick() - start);
+
+#ifdef PAL_MEMORY_STATISTICS
+	getMemoryStats(&after);
+#endif
+
+	if (PAL_SUCCESS != status)
+	{
+		BENCHMARK_PRINTF("%-14s failed at exchange %lu with status 0x%lx\r\n", name, (unsigned long)(i - 1), (unsigned long)(uint32_t)status);
+		return status;
+	}
+	if (0 == elapsedUs)
+	{
+		elapsedUs = 1;
+	}
+
+	qsort(g_latencies, count, sizeof(g_latencies[0]), benchmarkCompareLatency);
+	BENCHMARK_PRINTF("%-14s %8lu exchanges/s %8lu msgs/s  p50 %6lu us  p99 %6lu us",
+	            name,
+	            (unsigned long)(((uint64_t)count * 1000000) / elapsedUs),
+	            (unsigned long)(((uint64_t)messages * 1000000) / elapsedUs),
+	            (unsigned long)benchmarkTicksToMicroSec(g_latencies[count / 2]),
+	            (unsigned long)benchmarkTicksToMicroSec(g_latencies[(count * 99) / 100]));
+#ifdef PAL_MEMORY_STATISTICS
+	// Allocations per message are printed with two decimals
+	BENCHMARK_PRINTF("  heap peak %6ld B  allocs/msg %lu.%02lu\r\n",
+	            (long)(after.waterMark - before.totalSize),
+	            (unsigned long)(after.allocations / messages),
+	            (unsigned long)(((after.allocations % messages) * 100) / messages));
+#else
+	BENCHMARK_PRINTF("  heap peak n/a  allocs/msg n/a\r\n");
+#endif
+	return PAL_SUCCESS;
+}
+
+PAL_PRIVATE palStatus_t benchmarkSetup(void)
+{
+	palStatus_t status = PAL_SUCCESS;
+	palSocketAddress_t address = {0};
+	palIpV4Addr_t loopback = {127, 0, 0, 1};
+	int timeout = BENCHMARK_TIMEOUT_MS;
+	char path[BENCHMARK_PATH_SIZE];
+	uint32_t i = 0;
+
+	status = loopbackServerOpen(&g_server, BENCHMARK_SERVER_PORT, BENCHMARK_TIMEOUT_MS);
+	if (PAL_SUCCESS != status)
+	{
+		return status;
+	}
+
+	status = pal_socket(PAL_AF_INET, PAL_SOCK_DGRAM, false, PAL_NET_DEFAULT_INTERFACE, &g_client.socket);
+	if (PAL_SUCCESS == status)
+	{
+		status = pal_setSocketOptions(g_client.socket, PAL_SO_RCVTIMEO, &timeout, sizeof(timeout));
+	}
+	if (PAL_SUCCESS == status)
+	{
+		status = pal_setSockAddrIPV4Addr(&address, loopback);
+	}
+	if (PAL_SUCCESS == status)
+	{
+		status = pal_setSockAddrPort(&address, BENCHMARK_CLIENT_PORT);
+	}
+	if (PAL_SUCCESS == status)
+	{
+		status = pal_bind(g_client.socket, &address, sizeof(address));
+	}
+	if (PAL_SUCCESS == status)
+	{
+		g_client.serverAddress = address;
+		status = pal_setSockAddrPort(&g_client.serverAddress, BENCHMARK_SERVER_PORT);
+	}
+	if (PAL_SUCCESS != status)
+	{
+		return status;
+	}
+
+	g_client.nsdl = sn_nsdl_init(benchmarkClientSend, benchmarkClientReceived, benchmarkAlloc, benchmarkFree, NULL);
+	if ((NULL == g_client.nsdl) ||
+	    (set_NSP_address(g_client.nsdl, loopback, sizeof(loopback), BENCHMARK_SERVER_PORT, SN_NSDL_ADDRESS_TYPE_IPV4) != SN_NSDL_SUCCESS))
+	{
+		return PAL_ERR_GENERIC_FAILURE;
+	}
+
+	status = benchmarkAddResource(&g_resources[0], BENCHMARK_GET_PATH, SN_GRS_GET_ALLOWED, false);
+	if (PAL_SUCCESS == status)
+	{
+		status = benchmarkAddResource(&g_resources[1], BENCHMARK_PUT_PATH, SN_GRS_GET_ALLOWED | SN_GRS_PUT_ALLOWED, false);
+	}
+	if (PAL_SUCCESS == status)
+	{
+		status = benchmarkAddResource(&g_resources[2], BENCHMARK_FIRMWARE_PATH, SN_GRS_PUT_ALLOWED, true);
+	}
+	for (i = 0; (i < BENCHMARK_EXTRA_RESOURCES) && (PAL_SUCCESS == status); ++i)
+	{
+		snprintf(path, sizeof(path), "3303/%lu/5700", (unsigned long)(i + 1));
+		status = benchmarkAddResource(&g_resources[i + 3], path, SN_GRS_GET_ALLOWED, false);
+	}
+
+	for (i = 0; i < sizeof(g_firmware); ++i)
+	{
+		g_firmware[i] = (uint8_t)i;
+	}
+	return status;
+}
+
+PAL_PRIVATE void benchmarkTeardown(void)
+{
+	if (NULL != g_client.nsdl)
+	{
+		sn_nsdl_destroy(g_client.nsdl);
+		g_client.nsdl = NULL;
+	}
+	pal_close(&g_client.socket);
+	loopbackServerClose(&g_server);
+}
+
+
+void palTestMain(pal_args_t* args)
+{
+	palStatus_t status = PAL_SUCCESS;
+	(void)args;
+
+	status = pal_init();
+	if (PAL_SUCCESS == status)
+	{
+		status = benchmarkSetup();
+	}
+
+	BENCHMARK_PRINTF("*****PAL_CLIENT_BENCHMARK_START*****\r\n");
+	if (PAL_SUCCESS == status)
+	{
+		status = benchmarkRun("registration", benchmarkRegister, BENCHMARK_REGISTRATIONS, 2);
+	}
+	if (PAL_SUCCESS == status)
+	{
+		status = benchmarkRun("get", benchmarkGet, BENCHMARK_REQUESTS, 2);
+	}
+	if (PAL_SUCCESS == status)
+	{
+		status = benchmarkRun("put", benchmarkPut, BENCHMARK_REQUESTS, 2);
+	}
+	if (PAL_SUCCESS == status)
+	{
+		status = benchmarkRun("notification", benchmarkNotify, BENCHMARK_NOTIFICATIONS, 2);
+	}
+	if (PAL_SUCCESS == status)
+	{
+		g_client.bytesReceived = 0;
+		status = benchmarkRun("firmware block", benchmarkFirmwareBlock, BENCHMARK_FIRMWARE_BLOCKS, 2);
+	}
+	if ((PAL_SUCCESS == status) && (g_client.bytesReceived != BENCHMARK_FIRMWARE_PUSHES * BENCHMARK_FIRMWARE_SIZE))
+	{
+		BENCHMARK_PRINTF("firmware: %lu bytes delivered, expected %lu\r\n", (unsigned long)g_client.bytesReceived,
+		            (unsigned long)(BENCHMARK_FIRMWARE_PUSHES * BENCHMARK_FIRMWARE_SIZE));
+		status = PAL_ERR_GENERIC_FAILURE;
+	}
+	if (PAL_SUCCESS != status)
+	{
+		BENCHMARK_PRINTF("benchmark failed with status 0x%lx\r\n", (unsigned long)(uint32_t)status);
+	}
+	BENCHMARK_PRINTF("*****PAL_CLIENT_BENCHMARK_END*****\r\n");
+
+	benchmarkTeardown();
+	pal_destroy();
+}
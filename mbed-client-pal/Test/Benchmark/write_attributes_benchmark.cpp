@@ -0,0 +1,274 @@
+/*
+ * Copyright (c) 2016 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Benchmark of the handling of Write-Attributes requests.
+ *
+ * The benchmark creates BENCHMARK_RESOURCES integer resources and sends each
+ * of them, through M2MResource::handle_put_request(), BENCHMARK_ROUNDS PUT
+ * requests for every query of g_queries, the way M2MNsdlInterface hands a
+ * Write-Attributes request to the resource. The queries go from two
+ * attributes to the five of pmin, pmax, gt, lt and st, and include queries
+ * which are rejected: inconsistent attributes and a malformed value.
+ *
+ * For every query the benchmark prints the time per request and the requests
+ * per second. The code of every response and the notification attributes
+ * set on the resource are checked.
+ */
+
+#include "pal.h"
+#include "pal_test_main.h"
+#include "sn_coap_header.h"
+#include "sn_nsdl_lib.h"
+#include "mbed-client/m2mobject.h"
+#include "mbed-client/m2mobjectinstance.h"
+#include "mbed-client/m2mresource.h"
+#include "include/m2mreporthandler.h"
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+
+// The figures are the output of the benchmark, so they do not depend on DEBUG like PAL_PRINTF
+#define BENCHMARK_PRINTF(ARGS...) printf(ARGS)
+
+#define BENCHMARK_RESOURCES 10000
+#define BENCHMARK_RESOURCES_PER_INSTANCE 100
+#define BENCHMARK_ROUNDS 10
+#define BENCHMARK_NAME_SIZE 8
+
+typedef struct benchmarkQuery
+{
+	const char* query;
+	sn_coap_msg_code_e code;    //!< Expected response code
+	uint8_t attributes;         //!< Attributes the resource has after the request, M2MReportHandler flags
+} benchmarkQuery_t;
+
+// In order, each query is sent to the resources as the previous one left them
+PAL_PRIVATE const benchmarkQuery_t g_queries[] =
+{
+	{ "pmin=10&pmax=60", COAP_MSG_CODE_RESPONSE_CHANGED, M2MReportHandler::Pmin | M2MReportHandler::Pmax },
+	{ "gt=50.5&lt=-10.25&st=2", COAP_MSG_CODE_RESPONSE_CHANGED,
+	  M2MReportHandler::Pmin | M2MReportHandler::Pmax | M2MReportHandler::Gt | M2MReportHandler::Lt | M2MReportHandler::St },
+	{ "pmin=5&pmax=300&gt=1e3&lt=-40&st=2.5", COAP_MSG_CODE_RESPONSE_CHANGED,
+	  M2MReportHandler::Pmin | M2MReportHandler::Pmax | M2MReportHandler::Gt | M2MReportHandler::Lt | M2MReportHandler::St },
+	// A rejected query sets the default attributes back
+	{ "pmin=60&pmax=10", COAP_MSG_CODE_RESPONSE_BAD_REQUEST, 0 },
+	{ "pmin=10&pmax=60s", COAP_MSG_CODE_RESPONSE_BAD_REQUEST, 0 },
+};
+
+PAL_PRIVATE struct nsdl_s* g_nsdl;
+
+
+PAL_PRIVATE uint64_t benchmarkTicksToMicroSec(uint64_t ticks)
+{
+	return (ticks * 1000000) / pal_osKernelSysTickFrequency();
+}
+
+PAL_PRIVATE void* benchmarkAlloc(uint16_t size)
+{
+	return malloc(size);
+}
+
+PAL_PRIVATE void benchmarkFree(void* ptr)
+{
+	free(ptr);
+}
+
+PAL_PRIVATE uint8_t benchmarkSend(struct nsdl_s*, sn_nsdl_capab_e, uint8_t*, uint16_t, sn_nsdl_addr_s*)
+{
+	return 1;
+}
+
+PAL_PRIVATE uint8_t benchmarkReceived(struct nsdl_s*, sn_coap_hdr_s*, sn_nsdl_addr_s*)
+{
+	return 0;
+}
+
+// Object with BENCHMARK_RESOURCES_PER_INSTANCE resources in each of its instances
+class BenchmarkObject : public M2MObject {
+public:
+	BenchmarkObject() : M2MObject("32769", stringdup("32769")) {}
+
+	bool createResources(M2MResource** resources, uint32_t count)
+	{
+		char name[BENCHMARK_NAME_SIZE];
+		M2MObjectInstance* instance = NULL;
+		uint32_t i = 0;
+
+		for (i = 0; i < count; ++i)
+		{
+			if (0 == (i % BENCHMARK_RESOURCES_PER_INSTANCE))
+			{
+				instance = create_object_instance((uint16_t)(i / BENCHMARK_RESOURCES_PER_INSTANCE));
+				if (NULL == instance)
+				{
+					return false;
+				}
+			}
+			snprintf(name, sizeof(name), "%lu", (unsigned long)(i % BENCHMARK_RESOURCES_PER_INSTANCE));
+			resources[i] = instance->create_dynamic_resource(name, "Benchmark", M2MResourceInstance::INTEGER, true);
+			if (NULL == resources[i])
+			{
+				return false;
+			}
+			resources[i]->set_operation(M2MBase::GET_PUT_ALLOWED);
+		}
+		return true;
+	}
+};
+
+// Reads the protected M2MBase::report_handler() of a resource for the checks, without being a resource
+class BenchmarkReportHandler : public M2MBase {
+public:
+	static M2MReportHandler* get(const M2MBase* base)
+	{
+		M2MReportHandler* (M2MBase::*reportHandler)() const = &BenchmarkReportHandler::report_handler;
+		return (base->*reportHandler)();
+	}
+};
+
+// Sends the query to every resource for BENCHMARK_ROUNDS rounds, returns the number of unexpected results
+PAL_PRIVATE uint32_t benchmarkQuery(M2MResource** resources, const benchmarkQuery_t* query, uint64_t* elapsedUs)
+{
+	sn_coap_hdr_s request;
+	sn_coap_options_list_s options;
+	uint32_t failed = 0;
+	uint32_t round = 0;
+	uint32_t i = 0;
+	uint64_t start = 0;
+
+	memset(&request, 0, sizeof(request));
+	memset(&options, 0, sizeof(options));
+	options.block1 = -1;
+	options.block2 = -1;
+	options.uri_port = -1;
+	options.observe = -1;
+	options.accept = COAP_CT_NONE;
+	options.uri_query_ptr = (uint8_t*)query->query;
+	options.uri_query_len = (uint16_t)strlen(query->query);
+	request.msg_type = COAP_MSG_TYPE_CONFIRMABLE;
+	request.msg_code = COAP_MSG_CODE_REQUEST_PUT;
+	request.content_format = COAP_CT_NONE;
+	request.options_list_ptr = &options;
+
+	start = pal_osKernelSysTick();
+	for (round = 0; round < BENCHMARK_ROUNDS; ++round)
+	{
+		for (i = 0; i < BENCHMARK_RESOURCES; ++i)
+		{
+			bool valueUpdated = false;
+			sn_coap_hdr_s* response = NULL;
+
+			request.msg_id = (uint16_t)i;
+			response = resources[i]->handle_put_request(g_nsdl, &request, NULL, valueUpdated);
+			if ((NULL == response) || (query->code != response->msg_code))
+			{
+				++failed;
+			}
+			sn_nsdl_release_allocated_coap_msg_mem(g_nsdl, response);
+		}
+	}
+	*elapsedUs = benchmarkTicksToMicroSec(pal_osKernelSysTick() - start);
+
+	// Checked after the timing, so that only the requests are measured
+	for (i = 0; i < BENCHMARK_RESOURCES; ++i)
+	{
+		M2MReportHandler* handler = BenchmarkReportHandler::get(resources[i]);
+		const uint8_t attributes = handler ? handler->attribute_flags() : 0;
+
+		if (attributes != query->attributes)
+		{
+			++failed;
+		}
+	}
+	return failed;
+}
+
+PAL_PRIVATE palStatus_t benchmarkRun(void)
+{
+	BenchmarkObject* object = new BenchmarkObject();
+	M2MResource** resources = (M2MResource**)calloc(BENCHMARK_RESOURCES, sizeof(M2MResource*));
+	const uint32_t requests = BENCHMARK_RESOURCES * BENCHMARK_ROUNDS;
+	palStatus_t status = PAL_SUCCESS;
+	uint64_t elapsedUs = 0;
+	uint64_t totalUs = 0;
+	uint32_t failed = 0;
+	uint32_t i = 0;
+
+	if ((NULL == resources) || !object->createResources(resources, BENCHMARK_RESOURCES))
+	{
+		free(resources);
+		delete object;
+		return PAL_ERR_NO_MEMORY;
+	}
+
+	for (i = 0; i < (sizeof(g_queries) / sizeof(g_queries[0])); ++i)
+	{
+		failed += benchmarkQuery(resources, &g_queries[i], &elapsedUs);
+		totalUs += elapsedUs;
+		BENCHMARK_PRINTF("%-40s %lu requests in %lu us, %lu ns per request, %lu requests per second\r\n",
+		            g_queries[i].query, (unsigned long)requests, (unsigned long)elapsedUs,
+		            (unsigned long)((elapsedUs * 1000) / requests),
+		            (unsigned long)((requests * 1000000ULL) / (elapsedUs ? elapsedUs : 1)));
+	}
+	BENCHMARK_PRINTF("%-40s %lu requests in %lu us, %lu ns per request, %lu requests per second\r\n",
+	            "all", (unsigned long)(requests * i), (unsigned long)totalUs,
+	            (unsigned long)((totalUs * 1000) / (requests * i)),
+	            (unsigned long)((requests * i * 1000000ULL) / (totalUs ? totalUs : 1)));
+	if (0 != failed)
+	{
+		BENCHMARK_PRINTF("%lu unexpected responses or attributes\r\n", (unsigned long)failed);
+		status = PAL_ERR_GENERIC_FAILURE;
+	}
+
+	delete object;
+	free(resources);
+	return status;
+}
+
+
+void palTestMain(pal_args_t* args)
+{
+	palStatus_t status = PAL_SUCCESS;
+	(void)args;
+
+	status = pal_init();
+	if (PAL_SUCCESS == status)
+	{
+		g_nsdl = sn_nsdl_init(benchmarkSend, benchmarkReceived, benchmarkAlloc, benchmarkFree, NULL);
+		if (NULL == g_nsdl)
+		{
+			status = PAL_ERR_NO_MEMORY;
+		}
+	}
+
+	BENCHMARK_PRINTF("*****PAL_WRITE_ATTRIBUTES_BENCHMARK_START*****\r\n");
+	if (PAL_SUCCESS == status)
+	{
+		status = benchmarkRun();
+	}
+	if (PAL_SUCCESS != status)
+	{
+		BENCHMARK_PRINTF("benchmark failed with status 0x%lx\r\n", (unsigned long)(uint32_t)status);
+	}
+	BENCHMARK_PRINTF("*****PAL_WRITE_ATTRIBUTES_BENCHMARK_END*****\r\n");
+
+	if (g_nsdl)
+	{
+		sn_nsdl_destroy(g_nsdl);
+	}
+	pal_destroy();
+}
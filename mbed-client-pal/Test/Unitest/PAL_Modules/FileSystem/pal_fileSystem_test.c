@@ -15,6 +15,7 @@
 */
 
 #include "pal.h"
+#include "pal_test_main.h"
 #include "unity.h"
 #include "unity_fixture.h"
 
@@ -30,6 +31,8 @@
 #define TEST_BYTES_TO_WRITE 100
 #define TEST_FILE_NAME "%s/test_f%d"
 #define BUFFER_TEST_SIZE 1123
+#define TEST_CP_FOLDER_FILE_SIZE (64*1024)
+#define TEST_CP_FOLDER_KEEP_FILE "%s/keep"
 
 #if (false == PAL_PRIMARY_PARTITION_PRIVATE)
     #define PAL_TEST_PRIMARY_PATH "/pri"
@@ -1271,3 +1274,129 @@ TEST(pal_fileSystem, SequentialWriteAndRead)
     SequentialWriteAndRead(PAL_FS_PARTITION_PRIMARY);
     SequentialWriteAndRead(PAL_FS_PARTITION_SECONDARY);
 }
+
+/*! \brief Check that pal_fsCpFolder() overwrites files of the destination and keeps the others, that
+* pal_fsReplaceFolder() removes the others, and report how long the copy of a folder takes.
+*
+* | # |    Step                        |   Expected  |
+* |---|--------------------------------|-------------|
+* | 1 | create TEST_DIR and TEST_DIR2 with pal_fsMkDir                                                                  | PAL_SUCCESS |
+* | 2 | create TEST_NUMBER_OF_FILE_TO_CREATE files of TEST_CP_FOLDER_FILE_SIZE bytes in TEST_DIR                        | PAL_SUCCESS |
+* | 3 | create a file with the name of the first file and a file that only exists in TEST_DIR2                          | PAL_SUCCESS |
+* | 4 | copy TEST_DIR folder to TEST_DIR2 with pal_fsCpFolder or pal_fsReplaceFolder and print the time it took         | PAL_SUCCESS |
+* | 5 | compare the copied files and check that the file only in TEST_DIR2 was kept by the copy, removed by the replace | PAL_SUCCESS |
+* | 6 | remove all files and both folders                                                                               | PAL_SUCCESS |
+*/
+void CpFolderTests(pal_fsStorageID_t storageId, bool replace)
+{
+    palStatus_t status = PAL_SUCCESS;
+    char rootPathBuffer1[PAL_MAX_FILE_AND_FOLDER_LENGTH] = {0};
+    char rootPathBuffer2[PAL_MAX_FILE_AND_FOLDER_LENGTH] = {0};
+    char buffer1[PAL_MAX_FILE_AND_FOLDER_LENGTH] = {0};
+    char buffer2[PAL_MAX_FILE_AND_FOLDER_LENGTH] = {0};
+    uint64_t startTick = 0;
+    uint64_t copyTicks = 0;
+    size_t numOfBytes = 0;
+    int i = 0;
+
+    bufferTest = malloc(TEST_CP_FOLDER_FILE_SIZE);
+    TEST_ASSERT_NOT_NULL(bufferTest);
+    memset(bufferTest, 0xA5, TEST_CP_FOLDER_FILE_SIZE);
+
+/*#1*/
+    status = pal_fsMkDir(addRootToPath(TEST_DIR,rootPathBuffer1,storageId));
+    TEST_ASSERT_EQUAL(PAL_SUCCESS, status);
+    status = pal_fsMkDir(addRootToPath(TEST_DIR2,rootPathBuffer2,storageId));
+    TEST_ASSERT_EQUAL(PAL_SUCCESS, status);
+
+/*#2*/
+    for(i = 0; i < TEST_NUMBER_OF_FILE_TO_CREATE; i++)
+    {
+        snprintf(rootPathBuffer1, PAL_MAX_FILE_AND_FOLDER_LENGTH, TEST_FILE_NAME, TEST_DIR, i);
+        status =  pal_fsFopen(addRootToPath(rootPathBuffer1,buffer1,storageId), PAL_FS_FLAG_READWRITEEXCLUSIVE, &g_fd1);
+        TEST_ASSERT_EQUAL(PAL_SUCCESS, status);
+        bufferTest[0] = (uint8_t)i;
+        status =  pal_fsFwrite(&g_fd1, bufferTest, TEST_CP_FOLDER_FILE_SIZE, &numOfBytes);
+        TEST_ASSERT_EQUAL(PAL_SUCCESS, status);
+        status =  pal_fsFclose(&g_fd1);
+        TEST_ASSERT_EQUAL(PAL_SUCCESS, status);
+    }
+
+/*#3*/
+    snprintf(rootPathBuffer2, PAL_MAX_FILE_AND_FOLDER_LENGTH, TEST_FILE_NAME, TEST_DIR2, 0);
+    status =  pal_fsFopen(addRootToPath(rootPathBuffer2,buffer2,storageId), PAL_FS_FLAG_READWRITEEXCLUSIVE, &g_fd1);
+    TEST_ASSERT_EQUAL(PAL_SUCCESS, status);
+    status =  pal_fsFwrite(&g_fd1, (void *)rootPathBuffer2, TEST_BYTES_TO_WRITE, &numOfBytes);
+    TEST_ASSERT_EQUAL(PAL_SUCCESS, status);
+    status =  pal_fsFclose(&g_fd1);
+    TEST_ASSERT_EQUAL(PAL_SUCCESS, status);
+
+    snprintf(rootPathBuffer2, PAL_MAX_FILE_AND_FOLDER_LENGTH, TEST_CP_FOLDER_KEEP_FILE, TEST_DIR2);
+    status =  pal_fsFopen(addRootToPath(rootPathBuffer2,buffer2,storageId), PAL_FS_FLAG_READWRITEEXCLUSIVE, &g_fd1);
+    TEST_ASSERT_EQUAL(PAL_SUCCESS, status);
+    status =  pal_fsFclose(&g_fd1);
+    TEST_ASSERT_EQUAL(PAL_SUCCESS, status);
+
+/*#4*/
+    startTick = pal_osKernelSysTick();
+    if (replace)
+    {
+        status = pal_fsReplaceFolder(addRootToPath(TEST_DIR,rootPathBuffer1,storageId), addRootToPath(TEST_DIR2,rootPathBuffer2,storageId));
+    }
+    else
+    {
+        status = pal_fsCpFolder(addRootToPath(TEST_DIR,rootPathBuffer1,storageId), addRootToPath(TEST_DIR2,rootPathBuffer2,storageId));
+    }
+    copyTicks = pal_osKernelSysTick() - startTick;
+    TEST_ASSERT_EQUAL(PAL_SUCCESS, status);
+    TEST_PRINTF("%s() of %d files of %d bytes took %" PRIu64 " ms\n", replace ? "pal_fsReplaceFolder" : "pal_fsCpFolder",
+                TEST_NUMBER_OF_FILE_TO_CREATE, TEST_CP_FOLDER_FILE_SIZE, pal_osKernelSysMilliSecTick(copyTicks));
+    PAL_UNUSED_ARG(copyTicks); // TEST_PRINTF may be compiled out
+
+/*#5*/
+    for(i = 0; i < TEST_NUMBER_OF_FILE_TO_CREATE; i++)
+    {
+        snprintf(rootPathBuffer1, PAL_MAX_FILE_AND_FOLDER_LENGTH, TEST_FILE_NAME, TEST_DIR, i);
+        snprintf(rootPathBuffer2, PAL_MAX_FILE_AND_FOLDER_LENGTH, TEST_FILE_NAME, TEST_DIR2, i);
+
+        fileSystemCompareUtil(addRootToPath(rootPathBuffer1,buffer1,storageId), addRootToPath(rootPathBuffer2,buffer2,storageId));
+    }
+
+    snprintf(rootPathBuffer2, PAL_MAX_FILE_AND_FOLDER_LENGTH, TEST_CP_FOLDER_KEEP_FILE, TEST_DIR2);
+    status =  pal_fsFopen(addRootToPath(rootPathBuffer2,buffer2,storageId), PAL_FS_FLAG_READONLY, &g_fd1);
+    if (replace)
+    {
+        TEST_ASSERT_EQUAL(PAL_ERR_FS_NO_FILE, status);
+    }
+    else
+    {
+        TEST_ASSERT_EQUAL(PAL_SUCCESS, status);
+        status =  pal_fsFclose(&g_fd1);
+        TEST_ASSERT_EQUAL(PAL_SUCCESS, status);
+    }
+
+/*#6*/
+    status = pal_fsRmFiles(addRootToPath(TEST_DIR2,rootPathBuffer2,storageId));
+    TEST_ASSERT_EQUAL(PAL_SUCCESS, status);
+    status = pal_fsRmFiles(addRootToPath(TEST_DIR,rootPathBuffer1,storageId));
+    TEST_ASSERT_EQUAL(PAL_SUCCESS, status);
+    status = pal_fsRmDir(addRootToPath(TEST_DIR,buffer1,storageId));
+    TEST_ASSERT_EQUAL(PAL_SUCCESS, status);
+    status = pal_fsRmDir(addRootToPath(TEST_DIR2,buffer2,storageId));
+    TEST_ASSERT_EQUAL(PAL_SUCCESS, status);
+
+    free(bufferTest);
+    bufferTest = NULL;
+}
+
+TEST(pal_fileSystem, CpFolderTests)
+{
+    CpFolderTests(PAL_FS_PARTITION_PRIMARY, false);
+    CpFolderTests(PAL_FS_PARTITION_SECONDARY, false);
+}
+
+TEST(pal_fileSystem, ReplaceFolderTests)
+{
+    CpFolderTests(PAL_FS_PARTITION_PRIMARY, true);
+    CpFolderTests(PAL_FS_PARTITION_SECONDARY, true);
+}
@@ -30,4 +30,6 @@ TEST_GROUP_RUNNER(pal_fileSystem)
 	RUN_TEST_CASE(pal_fileSystem, create_write_and_read_pal_file);
     RUN_TEST_CASE(pal_fileSystem, WriteInTheMiddle);
     RUN_TEST_CASE(pal_fileSystem, SequentialWriteAndRead);
+    RUN_TEST_CASE(pal_fileSystem, CpFolderTests);
+    RUN_TEST_CASE(pal_fileSystem, ReplaceFolderTests);
 }
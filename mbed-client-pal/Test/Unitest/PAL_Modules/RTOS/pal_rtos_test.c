@@ -830,6 +830,67 @@ TEST(pal_rtos, loopRandomBigNumber)
 	}
 }
 
+/*! \brief Generate random buffers from several threads at once and report the throughput.
+*
+* | # |    Step                        |   Expected  |
+* |---|--------------------------------|-------------|
+* | 1 | Create a semaphore with count = 0 using `pal_osSemaphoreCreate`.                          | PAL_SUCCESS |
+* | 2 | Create PAL_RANDOM_THREADS_TEST_COUNT threads calling `pal_osRandomBuffer` in a loop.      | PAL_SUCCESS |
+* | 3 | Wait for all the threads using `pal_osSemaphoreWait` and print the bytes per second.     | PAL_SUCCESS |
+* | 4 | Check that every thread succeeded and got a different first buffer.                      | PAL_SUCCESS |
+* | 5 | Terminate the threads and delete the semaphore.                                          | PAL_SUCCESS |
+*/
+TEST(pal_rtos, RandomMultiThread)
+{
+    palStatus_t status = PAL_SUCCESS;
+    palSemaphoreID_t done = NULLPTR;
+    palThreadID_t threadIDs[PAL_RANDOM_THREADS_TEST_COUNT] = {0};
+    palRandomThreadArg_t args[PAL_RANDOM_THREADS_TEST_COUNT];
+    palThreadPriority_t priorities[PAL_RANDOM_THREADS_TEST_COUNT] = {PAL_osPriorityBelowNormal, PAL_osPriorityNormal, PAL_osPriorityAboveNormal};
+    uint64_t startTick = 0;
+    uint64_t elapsedMs = 0;
+    int32_t count = 0;
+
+    memset(args, 0, sizeof(args));
+    /*#1*/
+    status = pal_osSemaphoreCreate(0, &done);
+    TEST_ASSERT_EQUAL_HEX(PAL_SUCCESS, status);
+    /*#2*/
+    startTick = pal_osKernelSysTick();
+    for (int i = 0; i < PAL_RANDOM_THREADS_TEST_COUNT; ++i)
+    {
+        args[i].done = done;
+        status = pal_osThreadCreateWithAlloc(palThreadFuncRandom, &args[i], priorities[i], PAL_TEST_THREAD_STACK_SIZE, NULL, &threadIDs[i]);
+        TEST_ASSERT_EQUAL_HEX(PAL_SUCCESS, status);
+    }
+    /*#3*/
+    for (int i = 0; i < PAL_RANDOM_THREADS_TEST_COUNT; ++i)
+    {
+        status = pal_osSemaphoreWait(done, PAL_RTOS_WAIT_FOREVER, &count);
+        TEST_ASSERT_EQUAL_HEX(PAL_SUCCESS, status);
+    }
+    elapsedMs = pal_osKernelSysMilliSecTick(pal_osKernelSysTick() - startTick);
+    TEST_PRINTF("pal_osRandomBuffer() from %d threads: %d bytes in %lu ms\n", PAL_RANDOM_THREADS_TEST_COUNT, PAL_RANDOM_THREADS_TEST_COUNT * PAL_RANDOM_THREADS_TEST_LOOP * PAL_RANDOM_THREADS_TEST_SIZE, (unsigned long)elapsedMs);
+    PAL_UNUSED_ARG(elapsedMs); // TEST_PRINTF may be compiled out
+    /*#4*/
+    for (int i = 0; i < PAL_RANDOM_THREADS_TEST_COUNT; ++i)
+    {
+        TEST_ASSERT_EQUAL_HEX(PAL_SUCCESS, args[i].status);
+        for (int j = i + 1; j < PAL_RANDOM_THREADS_TEST_COUNT; ++j)
+        {
+            TEST_ASSERT_NOT_EQUAL(0, memcmp(args[i].first, args[j].first, sizeof(args[i].first)));
+        }
+    }
+    /*#5*/
+    for (int i = 0; i < PAL_RANDOM_THREADS_TEST_COUNT; ++i)
+    {
+        status = pal_osThreadTerminate(&threadIDs[i]);
+        TEST_ASSERT_EQUAL_HEX(PAL_SUCCESS, status);
+    }
+    status = pal_osSemaphoreDelete(&done);
+    TEST_ASSERT_EQUAL_HEX(PAL_SUCCESS, status);
+}
+
 /*! \brief Verify that PAL can handle multiple calls for `pal_init()` and `pal_destroy()`.
 *
 * | # |    Step                        |   Expected  |
@@ -50,6 +50,7 @@ TEST_GROUP_RUNNER(pal_rtos)
 	RUN_TEST_CASE(pal_rtos, SemaphoreBasicTest);
 	RUN_TEST_CASE(pal_rtos, RandomUnityTest);
 	RUN_TEST_CASE(pal_rtos, loopRandomBigNumber);
+	RUN_TEST_CASE(pal_rtos, RandomMultiThread);
 	RUN_TEST_CASE(pal_rtos, pal_init_test);
 	RUN_TEST_CASE(pal_rtos, Recursive_Mutex_Test);
 }
@@ -271,6 +271,19 @@ void palThreadFuncWaitForEverTest(void const *argument)
 	pal_osSemaphoreRelease(*((palSemaphoreID_t*)(argument)));
 }
 
+void palThreadFuncRandom(void const *argument)
+{
+	palRandomThreadArg_t* randomArg = (palRandomThreadArg_t*)argument;
+	uint8_t randomBuf[PAL_RANDOM_THREADS_TEST_SIZE];
+
+	randomArg->status = pal_osRandomBuffer(randomArg->first, sizeof(randomArg->first));
+	for (int i = 0; (i < PAL_RANDOM_THREADS_TEST_LOOP) && (PAL_SUCCESS == randomArg->status); ++i)
+	{
+		randomArg->status = pal_osRandomBuffer(randomBuf, sizeof(randomBuf));
+	}
+	pal_osSemaphoreRelease(randomArg->done);
+}
+
 void palRunThreads()
 {
 	palStatus_t status = PAL_SUCCESS;
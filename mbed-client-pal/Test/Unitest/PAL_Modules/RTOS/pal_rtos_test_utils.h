@@ -35,6 +35,9 @@
 #define PAL_RANDOM_TEST_LOOP 100000
 #define PAL_RANDOM_ARRAY_TEST_SIZE 100
 #define PAL_RANDOM_BUFFER_ARRAY_TEST_SIZE 60
+#define PAL_RANDOM_THREADS_TEST_COUNT 3
+#define PAL_RANDOM_THREADS_TEST_LOOP 10000
+#define PAL_RANDOM_THREADS_TEST_SIZE 32
 #define PAL_TIME_TO_WAIT_MS	5000 //in [ms]
 #define PAL_TIME_TO_WAIT_SHORT_MS	300 //in [ms]
 #define PAL_TIMER_TEST_TIME_TO_WAIT_MS_SHORT 40 //in [ms]
@@ -85,6 +88,14 @@ void palThreadFuncCustom3(void const *argument);
 void palThreadFuncCustom4(void const *argument);
 void palThreadFuncWaitForEverTest(void const *argument);
 
+typedef struct palRandomThreadArg{
+    palSemaphoreID_t done;
+    palStatus_t status;
+    uint8_t first[PAL_RANDOM_THREADS_TEST_SIZE];
+}palRandomThreadArg_t;
+
+void palThreadFuncRandom(void const *argument);
+
 void RecursiveLockThread(void const *param);
 typedef struct palRecursiveMutexParam{
 	palMutexID_t mtx;
@@ -15,6 +15,7 @@
  */
 
 #include "pal.h"
+#include "pal_plat_internalFlash.h"
 #include "unity.h"
 #include "unity_fixture.h"
 
@@ -314,3 +315,86 @@ TEST(pal_internalFlash, NegativeTest)
 	TEST_ASSERT_EQUAL_HEX(status, PAL_ERR_INTERNAL_FLASH_BUFFER_ADDRESS_NOT_ALIGNED);
 
 }
+
+#if PAL_INTERNAL_FLASH_EMULATOR
+/*! \brief Check the NOR semantics and the wear counters of the flash emulator
+*
+* | # |    Step                                                             |   Expected  |
+* |---|---------------------------------------------------------------------|-------------|
+* | 1 | reset the counters and erase the first sector of area one           | PAL_SUCCESS |
+* | 2 | write a page and write it again with other bits cleared             | PAL_SUCCESS |
+* | 3 | read the page back, only the bits cleared by both writes are zero   | PAL_SUCCESS |
+* | 4 | check the erase count and the number of bytes programmed            | PAL_SUCCESS |
+* | 5 | program a page at an address that is not page aligned               | PAL_ERR_INTERNAL_FLASH_ADDRESS_NOT_ALIGNED |
+* | 6 | program two pages across a sector boundary, each sector counts one  | PAL_SUCCESS |
+*/
+TEST(pal_internalFlash, EmulatorTest)
+{
+	palStatus_t status = PAL_SUCCESS;
+	palFlashEmulatorSectorStats_t stats;
+	uint32_t sectorSize = pal_internalFlashGetSectorSize(areaOneData.address);
+	uint32_t page[4] = {0x0F0F0F0F, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF};
+	uint32_t readPage[4] = {0};
+	size_t pageSize = pal_internalFlashGetPageSize();
+	TEST_ASSERT_NOT_EQUAL(0, sectorSize);
+	TEST_ASSERT_TRUE(pageSize * 2 <= sizeof(page));
+
+	/*1*/
+	status = pal_plat_internalFlashEmulatorResetStats();
+	TEST_ASSERT_EQUAL_HEX(PAL_SUCCESS, status);
+	status = pal_internalFlashErase(areaOneData.address, sectorSize);
+	TEST_ASSERT_EQUAL_HEX(PAL_SUCCESS, status);
+
+	/*2*/
+	status = pal_internalFlashWrite(pageSize, areaOneData.address, page);
+	TEST_ASSERT_EQUAL_HEX(PAL_SUCCESS, status);
+	page[0] = 0xFF00FF00;
+	status = pal_internalFlashWrite(pageSize, areaOneData.address, page);
+#if PAL_INTERNAL_FLASH_EMULATOR_STRICT_WRITE
+	TEST_ASSERT_EQUAL_HEX(PAL_ERR_INTERNAL_FLASH_WRITE_ERROR, status);
+#else
+	TEST_ASSERT_EQUAL_HEX(PAL_SUCCESS, status);
+
+	/*3*/
+	status = pal_internalFlashRead(pageSize, areaOneData.address, readPage);
+	TEST_ASSERT_EQUAL_HEX(PAL_SUCCESS, status);
+	TEST_ASSERT_EQUAL_HEX32(0x0F000F00, readPage[0]);
+#endif
+
+	/*4*/
+	status = pal_plat_internalFlashEmulatorGetStats(areaOneData.address / sectorSize, &stats);
+	TEST_ASSERT_EQUAL_HEX(PAL_SUCCESS, status);
+	TEST_ASSERT_EQUAL(1, stats.eraseCount);
+#if PAL_INTERNAL_FLASH_EMULATOR_STRICT_WRITE
+	TEST_ASSERT_EQUAL(pageSize, stats.bytesProgrammed);
+#else
+	TEST_ASSERT_EQUAL(2 * pageSize, stats.bytesProgrammed);
+#endif
+
+	/*5*/
+	if (pageSize > 1)
+	{
+	    status = pal_plat_internalFlashWrite(pageSize, areaOneData.address + 1, page);
+	    TEST_ASSERT_EQUAL_HEX(PAL_ERR_INTERNAL_FLASH_ADDRESS_NOT_ALIGNED, status);
+	}
+
+	/*6*/
+	status = pal_internalFlashErase(areaOneData.address, sectorSize * 2);
+	TEST_ASSERT_EQUAL_HEX(PAL_SUCCESS, status);
+	status = pal_plat_internalFlashEmulatorResetStats();
+	TEST_ASSERT_EQUAL_HEX(PAL_SUCCESS, status);
+	page[0] = 0xFFFFFFFF;
+	memcpy((uint8_t *)page + pageSize, page, pageSize);
+	status = pal_plat_internalFlashWrite(pageSize * 2, areaOneData.address + sectorSize - pageSize, page);
+	TEST_ASSERT_EQUAL_HEX(PAL_SUCCESS, status);
+	status = pal_plat_internalFlashEmulatorGetStats(areaOneData.address / sectorSize, &stats);
+	TEST_ASSERT_EQUAL_HEX(PAL_SUCCESS, status);
+	TEST_ASSERT_EQUAL(pageSize, stats.bytesProgrammed);
+	status = pal_plat_internalFlashEmulatorGetStats(areaOneData.address / sectorSize + 1, &stats);
+	TEST_ASSERT_EQUAL_HEX(PAL_SUCCESS, status);
+	TEST_ASSERT_EQUAL(pageSize, stats.bytesProgrammed);
+
+	status = pal_internalFlashErase(areaOneData.address, sectorSize * 2);
+	TEST_ASSERT_EQUAL_HEX(PAL_SUCCESS, status);
+}
+#endif //PAL_INTERNAL_FLASH_EMULATOR
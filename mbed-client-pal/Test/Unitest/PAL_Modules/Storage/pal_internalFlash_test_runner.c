@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+#include "pal.h"
 #include "unity.h"
 #include "unity_fixture.h"
 
@@ -22,4 +23,7 @@ TEST_GROUP_RUNNER(pal_internalFlash)
 {
 	RUN_TEST_CASE(pal_internalFlash, BasicTest);
 	RUN_TEST_CASE(pal_internalFlash, NegativeTest);
+#if PAL_INTERNAL_FLASH_EMULATOR
+	RUN_TEST_CASE(pal_internalFlash, EmulatorTest);
+#endif
 }
@@ -87,6 +87,56 @@ TEST(pal_tls, tlsConfiguration)
     TEST_ASSERT_EQUAL_HEX(PAL_SUCCESS, status);
 }
 
+/**
+* @brief Test TLS configuration reuse and report the configuration setup time.
+*
+*
+* | # |    Step                        |   Expected  |
+* |---|--------------------------------|-------------|
+* | 1 | Initialize and free a TLS configuration, timing the first (seeding) initialization. | PAL_SUCCESS |
+* | 2 | Initialize and free a DTLS configuration in a loop, timing the pooled initializations. | PAL_SUCCESS |
+* | 3 | Check that the configurations were reused when the pool is enabled.   | PAL_SUCCESS |
+*/
+TEST(pal_tls, tlsConfigurationReuse)
+{
+    palStatus_t status = PAL_SUCCESS;
+    palTLSConfHandle_t palTLSConf = NULLPTR;
+    palTLSConfHandle_t firstConf = NULLPTR;
+    uint64_t startTick = 0;
+    uint64_t firstTicks = 0;
+    uint64_t reuseTicks = 0;
+    bool reused = true;
+
+    /*#1*/
+    startTick = pal_osKernelSysTick();
+    status = pal_initTLSConfiguration(&palTLSConf, PAL_TLS_MODE);
+    firstTicks = pal_osKernelSysTick() - startTick;
+    TEST_ASSERT_EQUAL_HEX(PAL_SUCCESS, status);
+    firstConf = palTLSConf;
+    status = pal_tlsConfigurationFree(&palTLSConf);
+    TEST_ASSERT_EQUAL_HEX(PAL_SUCCESS, status);
+    /*#2*/
+    startTick = pal_osKernelSysTick();
+    for (int i = 0; i < PAL_TLS_CONF_REUSE_TEST_LOOP; ++i)
+    {
+        status = pal_initTLSConfiguration(&palTLSConf, PAL_DTLS_MODE);
+        TEST_ASSERT_EQUAL_HEX(PAL_SUCCESS, status);
+        reused = reused && (firstConf == palTLSConf);
+        status = pal_tlsConfigurationFree(&palTLSConf);
+        TEST_ASSERT_EQUAL_HEX(PAL_SUCCESS, status);
+    }
+    reuseTicks = pal_osKernelSysTick() - startTick;
+    TEST_PRINTF("pal_initTLSConfiguration(): first %lu ticks, reused %lu ticks on average\n", (unsigned long)firstTicks, (unsigned long)(reuseTicks / PAL_TLS_CONF_REUSE_TEST_LOOP));
+    PAL_UNUSED_ARG(firstTicks); // TEST_PRINTF may be compiled out
+    PAL_UNUSED_ARG(reuseTicks);
+    /*#3*/
+#if PAL_TLS_CONF_POOL_SIZE > 0
+    TEST_ASSERT_TRUE(reused);
+#else
+    PAL_UNUSED_ARG(reused);
+#endif
+}
+
 int palTestEntropySource(void *data, unsigned char *output, size_t len, size_t *olen)
 {
     palStatus_t status = PAL_SUCCESS;
@@ -343,6 +393,80 @@ TEST(pal_tls, tlsInitTLS)
 }
 
 
+/**
+* @brief Stress the TLS context table by opening and closing thousands of TLS contexts.
+*
+*
+* | # |    Step                        |   Expected  |
+* |---|--------------------------------|-------------|
+* | 1 | Initialize TLS configuration using `pal_initTLSConfiguration`.                        | PAL_SUCCESS |
+* | 2 | Initialize `PAL_MAX_NUM_OF_TLS_CTX` TLS contexts and one more using `pal_initTLS`.   | PAL_ERR_TLS_RESOURCE |
+* | 3 | Uninitialize the TLS contexts using `pal_freeTLS`.                                    | PAL_SUCCESS |
+* | 4 | Repeatedly initialize and uninitialize a batch of TLS contexts and print the time.    | PAL_SUCCESS |
+* | 5 | Use a handle of a freed TLS context with `pal_sslGetVerifyResult` and `pal_freeTLS`.  | PAL_ERR_TLS_CONTEXT_NOT_INITIALIZED |
+* | 6 | Uninitialize TLS configuration using `pal_tlsConfigurationFree`.                      | PAL_SUCCESS |
+*/
+TEST(pal_tls, tlsContextStress)
+{
+    palStatus_t status = PAL_SUCCESS;
+    palTLSConfHandle_t palTLSConf = NULLPTR;
+    palTLSHandle_t palTLSHandles[PAL_MAX_NUM_OF_TLS_CTX] = {0};
+    palTLSHandle_t extraHandle = NULLPTR;
+    palTLSHandle_t staleHandle = NULLPTR;
+    uint32_t batch = (PAL_MAX_NUM_OF_TLS_CTX < PAL_TLS_CTX_STRESS_TEST_BATCH) ? PAL_MAX_NUM_OF_TLS_CTX : PAL_TLS_CTX_STRESS_TEST_BATCH;
+    uint64_t startTick = 0;
+    uint64_t elapsedMs = 0;
+    /*#1*/
+    status = pal_initTLSConfiguration(&palTLSConf, PAL_TLS_MODE);
+    TEST_ASSERT_EQUAL_HEX(PAL_SUCCESS, status);
+    /*#2*/
+    for (uint32_t i = 0; i < PAL_MAX_NUM_OF_TLS_CTX; ++i)
+    {
+        status = pal_initTLS(palTLSConf, &palTLSHandles[i]);
+        TEST_ASSERT_EQUAL_HEX(PAL_SUCCESS, status);
+    }
+    status = pal_initTLS(palTLSConf, &extraHandle);
+    TEST_ASSERT_EQUAL_HEX(PAL_ERR_TLS_RESOURCE, status);
+    /*#3*/
+    for (uint32_t i = 0; i < PAL_MAX_NUM_OF_TLS_CTX; ++i)
+    {
+        status = pal_freeTLS(&palTLSHandles[i]);
+        TEST_ASSERT_EQUAL_HEX(PAL_SUCCESS, status);
+    }
+    /*#4*/
+    startTick = pal_osKernelSysTick();
+    for (uint32_t loop = 0; loop < PAL_TLS_CTX_STRESS_TEST_LOOP; loop += batch)
+    {
+        for (uint32_t i = 0; i < batch; ++i)
+        {
+            status = pal_initTLS(palTLSConf, &palTLSHandles[i]);
+            TEST_ASSERT_EQUAL_HEX(PAL_SUCCESS, status);
+        }
+        staleHandle = palTLSHandles[0];
+        for (uint32_t i = 0; i < batch; ++i)
+        {
+            status = pal_freeTLS(&palTLSHandles[i]);
+            TEST_ASSERT_EQUAL_HEX(PAL_SUCCESS, status);
+        }
+    }
+    elapsedMs = pal_osKernelSysMilliSecTick(pal_osKernelSysTick() - startTick);
+    TEST_PRINTF("pal_initTLS()/pal_freeTLS() of %d contexts: %lu ms\n", PAL_TLS_CTX_STRESS_TEST_LOOP, (unsigned long)elapsedMs);
+    PAL_UNUSED_ARG(elapsedMs); // TEST_PRINTF may be compiled out
+    /*#5*/
+    status = pal_initTLS(palTLSConf, &palTLSHandles[0]);
+    TEST_ASSERT_EQUAL_HEX(PAL_SUCCESS, status);
+    TEST_ASSERT_TRUE(staleHandle != palTLSHandles[0]);
+    status = pal_sslGetVerifyResult(staleHandle);
+    TEST_ASSERT_EQUAL_HEX(PAL_ERR_TLS_CONTEXT_NOT_INITIALIZED, status);
+    status = pal_freeTLS(&staleHandle);
+    TEST_ASSERT_EQUAL_HEX(PAL_ERR_TLS_CONTEXT_NOT_INITIALIZED, status);
+    status = pal_freeTLS(&palTLSHandles[0]);
+    TEST_ASSERT_EQUAL_HEX(PAL_SUCCESS, status);
+    /*#6*/
+    status = pal_tlsConfigurationFree(&palTLSConf);
+    TEST_ASSERT_EQUAL_HEX(PAL_SUCCESS, status);
+}
+
 /**
 * @brief Test TLS initialization and uninitialization with additional keys.
 *
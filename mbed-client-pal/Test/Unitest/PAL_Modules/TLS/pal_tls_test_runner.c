@@ -20,7 +20,9 @@
 TEST_GROUP_RUNNER(pal_tls)
 {
   RUN_TEST_CASE(pal_tls, tlsConfiguration);
+  RUN_TEST_CASE(pal_tls, tlsConfigurationReuse);
   RUN_TEST_CASE(pal_tls, tlsInitTLS);
+  RUN_TEST_CASE(pal_tls, tlsContextStress);
   RUN_TEST_CASE(pal_tls, tlsPrivateAndPublicKeys);
   RUN_TEST_CASE(pal_tls, tlsCACertandPSK);
 	RUN_TEST_CASE(pal_tls, tlsHandshakeUDPTimeOut);
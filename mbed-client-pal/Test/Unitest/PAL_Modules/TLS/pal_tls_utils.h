@@ -35,6 +35,9 @@ typedef struct palTLSSocketTest{
 }palTLSSocketTest_t;
 
 #define PAL_TLS_MESSAGE_SIZE 256
+#define PAL_TLS_CONF_REUSE_TEST_LOOP 20
+#define PAL_TLS_CTX_STRESS_TEST_LOOP 2000
+#define PAL_TLS_CTX_STRESS_TEST_BATCH 4
 #define TLS_GET_REQUEST "GET / HTTP/1.0\r\n\r\n"
 #ifndef PAL_TLS_TEST_SERVER_ADDRESS
     #include "pal_tls_test_address.h"
@@ -6,7 +6,10 @@
  */
 #ifdef PAL_MEMORY_STATISTICS
 #include "stdio.h"
+#include "string.h"
+#include "pal.h"
 #include "mbed-trace/mbed_trace.h"
+#include "PlatIncludes.h"
 
 
 #define TRACE_GROUP "PAL_MEMORY"
@@ -32,12 +35,17 @@ typedef struct _memoryAllocationData
 {
 	int32_t totalsize;
 	int32_t waterMark;
+	int32_t allocations;
 	int32_t buckets[PAL_BUCKET_NUMBER];
 	int32_t waterMarkBuckets[PAL_BUCKET_NUMBER];
 }memoryAllocationData;
 
 static memoryAllocationData memoryStats = {0};
 
+// Provided by the linker for the --wrap=malloc and --wrap=free options
+void* __real_malloc(size_t c);
+void __real_free(void* ptr);
+
 
 static inline memoryBucketSizes getBucketNumber(size_t size)
 {
@@ -74,6 +82,8 @@ void* __wrap_malloc(size_t c)
 		memoryStats.waterMark = currentTotal; // need to make this thread safe
 	}
 
+	pal_osAtomicIncrement(&memoryStats.allocations, 1);
+
 	*(size_t*)ptr = c;
 	ptr = ((size_t*)ptr+1);
 	*(size_t*)ptr = (size_t)getBucketNumber(c);
@@ -112,11 +122,33 @@ void* __wrap_calloc(size_t num, size_t size)
 }
 
 
+void getMemoryStats(palMemoryStats_t* stats)
+{
+	stats->totalSize = memoryStats.totalsize;
+	stats->waterMark = memoryStats.waterMark;
+	stats->allocations = memoryStats.allocations;
+}
+
+
+void resetMemoryStats(void)
+{
+	// Only the water marks and the allocation count are reset, the memory
+	// still allocated stays accounted for
+	memoryStats.waterMark = memoryStats.totalsize;
+	memoryStats.allocations = 0;
+	for (int i = 0; i < PAL_BUCKET_NUMBER; ++i)
+	{
+		memoryStats.waterMarkBuckets[i] = memoryStats.buckets[i];
+	}
+}
+
+
 void printMemoryStats(void)
 {
 	tr_info("\n*******************************************************\r\n");
 	tr_info("water mark size = %ld\r\n",memoryStats.waterMark);
 	tr_info("total size = %ld\r\n",memoryStats.totalsize);
+	tr_info("allocations = %ld\r\n",memoryStats.allocations);
 	tr_info("bucket 32    allocation number %ld\r\n",memoryStats.buckets[0]);
 	tr_info("bucket 64    allocation number %ld\r\n",memoryStats.buckets[1]);
 	tr_info("bucket 128   allocation number %ld\r\n",memoryStats.buckets[2]);
@@ -46,6 +46,19 @@
  * \brief If enabled this will print out the CoAP package payload.
  */
 #define MBED_CLIENT_PRINT_COAP_PAYLOAD
+
+/**
+ * \def MBED_CLIENT_COMPACT_PATH
+ * \brief If enabled, resources whose path is fully numeric (eg. 3303/0/5700)
+ * store it as packed ids instead of a heap allocated string. The text path is
+ * rendered only when it is needed, for example in the registration message.
+ */
+#define MBED_CLIENT_COMPACT_PATH
+#endif
+
+// The option is tested with #ifdef, so it is defined only when "compact-path" is true
+#if defined MBED_CONF_MBED_CLIENT_COMPACT_PATH && MBED_CONF_MBED_CLIENT_COMPACT_PATH && !defined MBED_CLIENT_COMPACT_PATH
+#define MBED_CLIENT_COMPACT_PATH
 #endif
 
 #ifdef MBED_CLIENT_USER_CONFIG_FILE
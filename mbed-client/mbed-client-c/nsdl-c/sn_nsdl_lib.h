@@ -185,6 +185,20 @@ typedef enum {
 } NoticationDeliveryStatus;
 
 
+#ifdef MBED_CLIENT_COMPACT_PATH
+/**
+ * \brief Maximum number of ids in a numeric path.
+ */
+#define SN_NSDL_MAX_PATH_DEPTH      4
+
+/**
+ * \brief Size of a buffer that can hold any numeric path rendered as text, eg. "65535/65535/65535/65535".
+ */
+#define SN_NSDL_PATH_BUFFER_SIZE    24
+#else
+#define SN_NSDL_PATH_BUFFER_SIZE    1
+#endif
+
 /**
  * \brief Defines static parameters for the resource.
  */
@@ -204,6 +218,10 @@ typedef struct sn_nsdl_static_resource_parameters_ {
                                                  otherwise block messages are passed to application */
     unsigned    mode:2;                     /**< STATIC etc.. */
     bool        free_on_delete:1;           /**< 1 if struct is dynamic allocted --> to be freed */
+#ifdef MBED_CLIENT_COMPACT_PATH
+    unsigned    path_depth:3;               /**< Number of ids in path_id, 0 if the path is a string */
+    uint16_t    path_id[SN_NSDL_MAX_PATH_DEPTH]; /**< Object, object instance, resource and resource instance ids */
+#endif
 } sn_nsdl_static_resource_parameters_s;
 
 /**
@@ -497,6 +515,50 @@ extern int8_t sn_nsdl_delete_resource(struct nsdl_s *handle, const char *path);
  */
 extern sn_nsdl_dynamic_resource_parameters_s *sn_nsdl_get_resource(struct nsdl_s *handle, const char *path);
 
+/**
+ * \fn extern const char *sn_nsdl_get_path(const sn_nsdl_static_resource_parameters_s *params, char *buffer)
+ *
+ * \brief Returns the path of a resource as a string.
+ *
+ * With MBED_CLIENT_COMPACT_PATH, a numeric path is rendered into the given buffer.
+ *
+ * \param   *params     Static parameters of the resource.
+ * \param   *buffer     Buffer of SN_NSDL_PATH_BUFFER_SIZE bytes.
+ *
+ * \return  Path of the resource, or NULL if it has none.
+ */
+extern const char *sn_nsdl_get_path(const sn_nsdl_static_resource_parameters_s *params, char *buffer);
+
+#ifdef MBED_CLIENT_COMPACT_PATH
+/**
+ * \fn extern uint8_t sn_nsdl_parse_numeric_path(const char *path, uint16_t path_len, uint16_t *path_id)
+ *
+ * \brief Parses a path made only of decimal ids, eg. "3303/0/5700".
+ *
+ * Only the canonical form is accepted, i.e. no leading zeros and no empty segments,
+ * so that the path renders back to the same string.
+ *
+ * \param   *path       Path to parse, without leading or trailing '/'.
+ * \param   path_len    Length of the path.
+ * \param   *path_id    Array of SN_NSDL_MAX_PATH_DEPTH ids to fill.
+ *
+ * \return  Number of ids parsed, 0 if the path is not a numeric path.
+ */
+extern uint8_t sn_nsdl_parse_numeric_path(const char *path, uint16_t path_len, uint16_t *path_id);
+
+/**
+ * \fn extern bool sn_nsdl_set_numeric_path(sn_nsdl_static_resource_parameters_s *params, const char *path)
+ *
+ * \brief Stores a numeric path as packed ids.
+ *
+ * \param   *params     Static parameters of the resource.
+ * \param   *path       Path of the resource.
+ *
+ * \return  true if the path was numeric and has been stored, false otherwise.
+ */
+extern bool sn_nsdl_set_numeric_path(sn_nsdl_static_resource_parameters_s *params, const char *path);
+#endif
+
 /**
  * \fn extern sn_grs_resource_list_s *sn_nsdl_list_resource(struct nsdl_s *handle, char *path)
  *
@@ -180,8 +180,10 @@ extern sn_grs_resource_list_s *sn_grs_list_resource(struct grs_s *handle, const
         i = 0;
         size_t len = 0;
         ns_list_foreach(sn_nsdl_dynamic_resource_parameters_s, grs_resource_ptr, &handle->resource_root_list) {
+            char path_buffer[SN_NSDL_PATH_BUFFER_SIZE];
+            const char *path = sn_nsdl_get_path(grs_resource_ptr->static_resource_parameters, path_buffer);
             /* Copy pathlen to resource list */
-            len = strlen(grs_resource_ptr->static_resource_parameters->path);
+            len = strlen(path);
 
             /* Allocate memory for path string */
             grs_resource_list_ptr->res[i].path = handle->sn_grs_alloc(len);
@@ -191,7 +193,7 @@ extern sn_grs_resource_list_s *sn_grs_list_resource(struct grs_s *handle, const
 
             /* Copy pathstring to resource list */
             memcpy(grs_resource_list_ptr->res[i].path,
-                   grs_resource_ptr->static_resource_parameters->path,
+                   path,
                    len);
 
             i++;
@@ -277,13 +279,15 @@ int8_t sn_grs_put_resource(struct grs_s *handle, sn_nsdl_dynamic_resource_parame
     }
 
     /* Check path validity */
-    if (!res->static_resource_parameters->path || res->static_resource_parameters->path[0] == '\0') {
+    char path_buffer[SN_NSDL_PATH_BUFFER_SIZE];
+    const char *path = sn_nsdl_get_path(res->static_resource_parameters, path_buffer);
+    if (!path || path[0] == '\0') {
         return SN_GRS_INVALID_PATH;
     }
 
     /* Check if resource already exists */
     if (sn_grs_search_resource(handle,
-                               res->static_resource_parameters->path, SN_GRS_SEARCH_METHOD) != (sn_nsdl_dynamic_resource_parameters_s *)NULL) {
+                               path, SN_GRS_SEARCH_METHOD) != (sn_nsdl_dynamic_resource_parameters_s *)NULL) {
         return SN_GRS_RESOURCE_ALREADY_EXISTS;
     }
 
@@ -302,13 +306,15 @@ int8_t sn_grs_pop_resource(struct grs_s *handle, sn_nsdl_dynamic_resource_parame
     }
 
     /* Check path validity */
-    if (!res->static_resource_parameters->path || res->static_resource_parameters->path[0] == '\0') {
+    char path_buffer[SN_NSDL_PATH_BUFFER_SIZE];
+    const char *path = sn_nsdl_get_path(res->static_resource_parameters, path_buffer);
+    if (!path || path[0] == '\0') {
         return SN_GRS_INVALID_PATH;
     }
 
     /* Check if resource exists on list. */
     if (sn_grs_search_resource(handle,
-                               res->static_resource_parameters->path, SN_GRS_SEARCH_METHOD) == (sn_nsdl_dynamic_resource_parameters_s *)NULL) {
+                               path, SN_GRS_SEARCH_METHOD) == (sn_nsdl_dynamic_resource_parameters_s *)NULL) {
         return SN_NSDL_FAILURE;
     }
 
@@ -666,11 +672,27 @@ sn_nsdl_dynamic_resource_parameters_s *sn_grs_search_resource(struct grs_s *hand
     uint16_t pathlen = strlen(path);
     /* Remove '/' - marks from the end and beginning */
     path_temp_ptr = sn_grs_convert_uri(&pathlen, path);
+#ifdef MBED_CLIENT_COMPACT_PATH
+    /* Numeric paths are compared by id. A path which is not in the canonical numeric
+     * form cannot match any of them, as they render only in that form. */
+    uint16_t path_id[SN_NSDL_MAX_PATH_DEPTH];
+    uint8_t path_depth = sn_nsdl_parse_numeric_path(path_temp_ptr, pathlen, path_id);
+#endif
 
     /* Searchs exact path */
     if (search_method == SN_GRS_SEARCH_METHOD) {
         /* Scan all nodes on list */
         ns_list_foreach(sn_nsdl_dynamic_resource_parameters_s, resource_search_temp, &handle->resource_root_list) {
+#ifdef MBED_CLIENT_COMPACT_PATH
+            const sn_nsdl_static_resource_parameters_s *params = resource_search_temp->static_resource_parameters;
+            if (params && params->path_depth) {
+                if (params->path_depth == path_depth &&
+                        0 == memcmp(params->path_id, path_id, path_depth * sizeof(uint16_t))) {
+                    return resource_search_temp;
+                }
+                continue;
+            }
+#endif
             /* If length equals.. */
             size_t len = 0;
             if(resource_search_temp &&
@@ -693,6 +715,16 @@ sn_nsdl_dynamic_resource_parameters_s *sn_grs_search_resource(struct grs_s *hand
     else if (search_method == SN_GRS_DELETE_METHOD) {
         /* Scan all nodes on list */
         ns_list_foreach(sn_nsdl_dynamic_resource_parameters_s, resource_search_temp, &handle->resource_root_list) {
+#ifdef MBED_CLIENT_COMPACT_PATH
+            const sn_nsdl_static_resource_parameters_s *params = resource_search_temp->static_resource_parameters;
+            if (params && params->path_depth) {
+                if (path_depth && params->path_depth > path_depth &&
+                        0 == memcmp(params->path_id, path_id, path_depth * sizeof(uint16_t))) {
+                    return resource_search_temp;
+                }
+                continue;
+            }
+#endif
             char *temp_path = resource_search_temp->static_resource_parameters->path;
             if (strlen(resource_search_temp->static_resource_parameters->path) > pathlen &&
                     (*(temp_path + (uint8_t)pathlen) == '/') &&
@@ -870,6 +870,68 @@ sn_nsdl_dynamic_resource_parameters_s *sn_nsdl_get_resource(struct nsdl_s *handl
     return sn_grs_search_resource(handle->grs, path_ptr, SN_GRS_SEARCH_METHOD);
 }
 
+const char *sn_nsdl_get_path(const sn_nsdl_static_resource_parameters_s *params, char *buffer)
+{
+#ifdef MBED_CLIENT_COMPACT_PATH
+    if (params->path_depth) {
+        char *temp_ptr = buffer;
+        for (uint8_t i = 0; i < params->path_depth; i++) {
+            if (i) {
+                *temp_ptr++ = '/';
+            }
+            temp_ptr = (char *)sn_nsdl_itoa((uint8_t *)temp_ptr, params->path_id[i]);
+        }
+        *temp_ptr = '\0';
+        return buffer;
+    }
+#else
+    (void)buffer;
+#endif
+    return params->path;
+}
+
+#ifdef MBED_CLIENT_COMPACT_PATH
+uint8_t sn_nsdl_parse_numeric_path(const char *path, uint16_t path_len, uint16_t *path_id)
+{
+    uint8_t depth = 0;
+    uint16_t i = 0;
+    while (i < path_len) {
+        uint32_t value = 0;
+        uint16_t start = i;
+        if (depth == SN_NSDL_MAX_PATH_DEPTH) {
+            return 0;
+        }
+        while (i < path_len && path[i] >= '0' && path[i] <= '9') {
+            value = value * 10 + (path[i] - '0');
+            if (value > UINT16_MAX) {
+                return 0;
+            }
+            i++;
+        }
+        /* Empty segment, leading zero or a character other than a digit */
+        if (i == start || (path[start] == '0' && i - start > 1) ||
+                (i < path_len && (path[i] != '/' || i + 1 == path_len))) {
+            return 0;
+        }
+        path_id[depth++] = (uint16_t)value;
+        i++;
+    }
+    return depth;
+}
+
+bool sn_nsdl_set_numeric_path(sn_nsdl_static_resource_parameters_s *params, const char *path)
+{
+    uint16_t path_id[SN_NSDL_MAX_PATH_DEPTH];
+    uint8_t depth = sn_nsdl_parse_numeric_path(path, strlen(path), path_id);
+    if (depth == 0) {
+        return false;
+    }
+    memcpy(params->path_id, path_id, sizeof(path_id));
+    params->path_depth = depth;
+    return true;
+}
+#endif
+
 
 /**
  * \fn static int32_t sn_nsdl_internal_coap_send(struct nsdl_s *handle, sn_coap_hdr_s *coap_header_ptr, sn_nsdl_addr_s *dst_addr_ptr, uint8_t message_description)
@@ -1044,12 +1106,14 @@ int8_t sn_nsdl_build_registration_body(struct nsdl_s *handle, sn_coap_hdr_s *mes
 
             *temp_ptr++ = '<';
             *temp_ptr++ = '/';
+            char path_buffer[SN_NSDL_PATH_BUFFER_SIZE];
+            const char *path = sn_nsdl_get_path(resource_temp_ptr->static_resource_parameters, path_buffer);
             size_t path_len = 0;
-            if (resource_temp_ptr->static_resource_parameters->path) {
-                path_len = strlen(resource_temp_ptr->static_resource_parameters->path);
+            if (path) {
+                path_len = strlen(path);
             }
             memcpy(temp_ptr,
-                   resource_temp_ptr->static_resource_parameters->path,
+                   path,
                    path_len);
             temp_ptr += path_len;
             *temp_ptr++ = '>';
@@ -1129,7 +1193,7 @@ int8_t sn_nsdl_build_registration_body(struct nsdl_s *handle, sn_coap_hdr_s *mes
             if (resource_temp_ptr->auto_observable) {
                 uint8_t token[MAX_TOKEN_SIZE] = {0};
                 uint8_t len = handle->sn_nsdl_auto_obs_token_callback(handle,
-                                                                      resource_temp_ptr->static_resource_parameters->path,
+                                                                      path,
                                                                       (uint8_t*)token);
                 if (len > 0) {
                     *temp_ptr++ = ';';
@@ -1195,9 +1259,11 @@ static uint16_t sn_nsdl_calculate_registration_body_size(struct nsdl_s *handle,
             }
 
             /* Count length for the resource path </path> */
+            char path_buffer[SN_NSDL_PATH_BUFFER_SIZE];
+            const char *path = sn_nsdl_get_path(resource_temp_ptr->static_resource_parameters, path_buffer);
             size_t path_len = 0;
-            if (resource_temp_ptr->static_resource_parameters->path) {
-                path_len = strlen(resource_temp_ptr->static_resource_parameters->path);
+            if (path) {
+                path_len = strlen(path);
             }
 
             if (sn_nsdl_check_uint_overflow(return_value, 3, path_len)) {
@@ -1307,7 +1373,7 @@ static uint16_t sn_nsdl_calculate_registration_body_size(struct nsdl_s *handle,
                 /* ;aobs="" */
                 uint8_t token[MAX_TOKEN_SIZE] = {0};
                 uint8_t len = handle->sn_nsdl_auto_obs_token_callback(handle,
-                                                                      resource_temp_ptr->static_resource_parameters->path,
+                                                                      path,
                                                                       (uint8_t*)token);
 
                 if (len > 0) {
@@ -96,6 +96,12 @@ public:
      */
     uint64_t get_still_left_time() const;
 
+    /**
+     * @brief Get current time of the event loop timer
+     * @return Time in milliseconds, wraps around
+     */
+    static uint32_t get_time_ms();
+
 private:
 
     void start();
@@ -55,3 +55,8 @@ bool M2MTimer::is_intermediate_interval_passed(){
 bool M2MTimer::is_total_interval_passed(){
     return _private_impl->is_total_interval_passed();
 }
+
+uint32_t M2MTimer::get_time_ms()
+{
+    return M2MTimerPimpl::get_time_ms();
+}
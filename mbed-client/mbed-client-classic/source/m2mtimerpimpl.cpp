@@ -172,6 +172,11 @@ void M2MTimerPimpl::stop_timer()
 void M2MTimerPimpl::timer_expired()
 {
     _status++;
+    if (_single_shot && !_dtls_type) {
+        // Nothing of the timer is used after the callback, so the observer may delete it
+        _observer.timer_expired(_type);
+        return;
+    }
     _observer.timer_expired(_type);
 
     if ((!_dtls_type) && (!_single_shot)) {
@@ -205,6 +210,11 @@ uint64_t M2MTimerPimpl::get_still_left_time() const
    return _still_left;
 }
 
+uint32_t M2MTimerPimpl::get_time_ms()
+{
+    return eventOS_event_timer_ticks_to_ms(eventOS_event_timer_ticks());
+}
+
 void M2MTimerPimpl::start_still_left_timer()
 {
     if (_still_left > 0) {
@@ -223,9 +233,12 @@ void M2MTimerPimpl::start_still_left_timer()
         }
         assert(status == 0);
     } else {
-        _observer.timer_expired(_type);
-        if(!_single_shot) {
-            start_timer(_interval, _type, _single_shot);
+        if (_single_shot) {
+            // As in timer_expired(), the observer may delete a single shot timer
+            _observer.timer_expired(_type);
+            return;
         }
+        _observer.timer_expired(_type);
+        start_timer(_interval, _type, _single_shot);
     }
 }
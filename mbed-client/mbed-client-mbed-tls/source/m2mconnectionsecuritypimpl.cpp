@@ -38,6 +38,15 @@
 
 #define TRACE_GROUP "mClt"
 
+// Validity period of the last parsed client certificate, so that reconnecting with
+// the same certificate does not parse it again. Keyed by a hash of the certificate.
+static struct {
+    bool            valid;
+    unsigned char   hash[PAL_SHA256_SIZE];
+    uint64_t        valid_from;
+    uint64_t        valid_to;
+} certificate_valid_time_cache;
+
 M2MConnectionSecurityPimpl::M2MConnectionSecurityPimpl(M2MConnectionSecurity::SecurityMode mode)
     :_init_done(M2MConnectionSecurityPimpl::INIT_NOT_STARTED),
      _conf(0),
@@ -302,9 +311,19 @@ bool M2MConnectionSecurityPimpl::certificate_parse_valid_time(const char *certif
     palX509Handle_t cert = 0;
     size_t len;
     palStatus_t ret;
+    unsigned char hash[PAL_SHA256_SIZE];
+    bool hashed;
 
     tr_debug("certificate_validfrom_time");
 
+    hashed = (PAL_SUCCESS == pal_sha256((const unsigned char*)certificate, certificate_len, hash));
+    if (hashed && certificate_valid_time_cache.valid &&
+        memcmp(certificate_valid_time_cache.hash, hash, sizeof(hash)) == 0) {
+        *valid_from = certificate_valid_time_cache.valid_from;
+        *valid_to = certificate_valid_time_cache.valid_to;
+        return true;
+    }
+
     if(PAL_SUCCESS != (ret = pal_x509Initiate(&cert))) {
         tr_error("certificate_validfrom_time - cert init failed: %u", (int)ret);
         pal_x509Free(&cert);
@@ -327,6 +346,13 @@ bool M2MConnectionSecurityPimpl::certificate_parse_valid_time(const char *certif
     }
 
     pal_x509Free(&cert);
+
+    certificate_valid_time_cache.valid = hashed;
+    if (hashed) {
+        memcpy(certificate_valid_time_cache.hash, hash, sizeof(hash));
+        certificate_valid_time_cache.valid_from = *valid_from;
+        certificate_valid_time_cache.valid_to = *valid_to;
+    }
     return true;
 }
 
@@ -297,12 +297,6 @@ public:
     */
     virtual void set_observation_handler(M2MObservationHandler *handler) = 0;
 
-    /**
-     * \brief Sets the instance ID of the object.
-     * \param instance_id The instance ID of the object.
-     */
-    void set_instance_id(const uint16_t instance_id);
-
     /**
      * \brief Sets the max age for the resource value to be cached.
      * \param max_age The max age in seconds.
@@ -341,9 +335,21 @@ public:
 
     /**
      * \brief Returns the path of the object.
+     * \param buffer A buffer of SN_NSDL_PATH_BUFFER_SIZE bytes. With MBED_CLIENT_COMPACT_PATH,
+     * a numeric path is rendered into it, otherwise it is not used.
+     * \return The path of the object (eg. 3/0/1), valid as long as the object and the buffer.
+     */
+    const char* uri_path(char *buffer) const;
+
+#ifndef MBED_CLIENT_COMPACT_PATH
+    /**
+     * \brief Returns the path of the object.
+     * \note Not available with MBED_CLIENT_COMPACT_PATH, where a numeric path is not
+     * stored as a string. Use uri_path(char *buffer) instead.
      * \return The path of the object (eg. 3/0/1).
      */
     const char* uri_path() const;
+#endif
 
     /**
      * \brief Returns the CoAP content type of the object.
@@ -632,8 +638,23 @@ protected:
     void set_observation_token(const uint8_t *token,
                                const uint8_t length);
 
+    /**
+     * \brief Converts a name to the integer form returned by name_id().
+     * \param name The name to be converted.
+     * \return The name in integer, -1 if the name is not a valid integer id.
+     */
+    static int32_t name_to_id(const char *name);
+
 private:
 
+    /**
+     * \brief Sets the instance ID of the object.
+     * \note Only called before the object is added to its parent, as the parent
+     * keeps its children sorted by ID.
+     * \param instance_id The instance ID of the object.
+     */
+    void set_instance_id(const uint16_t instance_id);
+
     static bool is_integer(const String &value);
 
     static bool is_integer(const char *value);
@@ -643,11 +664,14 @@ private:
 private:
     lwm2m_parameters_s          *_sn_resource;
     M2MReportHandler            *_report_handler; // TODO: can be broken down to smaller classes with inheritance.
+    int32_t                     _name_id; // name_id() of a named object, converted once as lookups compare it
 
 friend class Test_M2MBase;
 friend class Test_M2MObject;
 friend class M2MNsdlInterface;
 friend class M2MInterfaceFactory;
+friend class M2MObject;
+friend class M2MObjectInstance;
 };
 
 #endif // M2M_BASE_H
@@ -49,14 +49,22 @@ public:
     /**
      * \brief Store the data from a CoAP message.
      * \param coap_header The message to parse.
+     * \param copy_payload If true, the payload is copied and owned by this object.
+     * If false, block_data() refers to the payload of the CoAP message and is
+     * valid only until the message is freed or clear_block_data() is called.
      */
-    void set_message_info(sn_coap_hdr_s *coap_header);
+    void set_message_info(sn_coap_hdr_s *coap_header, bool copy_payload = true);
 
     /**
      * \brief Clear values.
      */
     void clear_values();
 
+    /**
+     * \brief Release the payload, the block number and the other values are kept.
+     */
+    void clear_block_data();
+
     /**
      * \brief Check if the message is a block message.
      * \param coap_header The message to check.
@@ -108,6 +116,7 @@ private:
     Error       _error_code;
     bool        _is_last_block;
     bool        _is_block_message;
+    bool        _is_payload_borrowed;
 };
 
 #endif // M2MBLOCKMESSAGE_H
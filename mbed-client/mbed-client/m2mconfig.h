@@ -74,6 +74,17 @@ using namespace m2m;
  */
 #undef MBED_CLIENT_EVENT_LOOP_SIZE      /* 1024 */
 
+/**
+ * \def MBED_CLIENT_TYPED_RESOURCE_VALUE
+ *
+ * \brief Keeps the values of dynamic INTEGER, BOOLEAN, TIME
+ * and FLOAT resources in their native binary form inside the
+ * resource object. The text representation is rendered only
+ * when it is requested, for example by a GET or a notification.
+ * By default, this is disabled.
+ */
+#undef MBED_CLIENT_TYPED_RESOURCE_VALUE
+
 #ifdef YOTTA_CFG_RECONNECTION_COUNT
 #define MBED_CLIENT_RECONNECTION_COUNT YOTTA_CFG_RECONNECTION_COUNT
 #elif defined MBED_CONF_MBED_CLIENT_RECONNECTION_COUNT
@@ -138,6 +149,11 @@ using namespace m2m;
 #define DISABLE_BLOCK_MESSAGE MBED_CONF_MBED_CLIENT_DISABLE_BLOCK_MESSAGE
 #endif
 
+// The option is tested with #ifdef, so it is defined only when "typed-resource-value" is true
+#if defined MBED_CONF_MBED_CLIENT_TYPED_RESOURCE_VALUE && MBED_CONF_MBED_CLIENT_TYPED_RESOURCE_VALUE && !defined MBED_CLIENT_TYPED_RESOURCE_VALUE
+#define MBED_CLIENT_TYPED_RESOURCE_VALUE
+#endif
+
 #ifdef MBED_CONF_MBED_CLIENT_DTLS_PEER_MAX_TIMEOUT
 #define MBED_CLIENT_DTLS_PEER_MAX_TIMEOUT MBED_CONF_MBED_CLIENT_DTLS_PEER_MAX_TIMEOUT
 #endif
@@ -257,6 +257,14 @@ public:
      * \return true if successfully set, else false.
      */
     bool set_package_block_message_callback(incoming_block_message_callback callback);
+
+    /**
+     * \brief Set incoming_block_sink_callback for the package resource.
+     *        The callback will be called with each block of the package, without a copy.
+     * \param callback The function pointer to be called.
+     * \return true if successfully set, else false.
+     */
+    bool set_package_block_sink_callback(incoming_block_sink_callback callback);
 #endif
 
 private:
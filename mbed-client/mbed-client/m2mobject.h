@@ -180,7 +180,19 @@ protected :
 
 private:
 
-    M2MObjectInstanceList     _instance_list; // owned
+    /**
+     * \brief Finds an object instance from the instance list, which is kept
+     * sorted by instance ID.
+     * \param instance_id The ID of the object instance.
+     * \param position[OUT] The position of the instance, or the position
+     * where an instance with the given ID is to be inserted.
+     * \return True if the instance was found, else false.
+     */
+    bool find_object_instance(uint16_t instance_id, int &position) const;
+
+private:
+
+    M2MObjectInstanceList     _instance_list; // owned, sorted by instance ID
 
     M2MObservationHandler    *_observation_handler; // Not owned
 
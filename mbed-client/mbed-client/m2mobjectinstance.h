@@ -305,11 +305,27 @@ private:
      */
     M2MBase::DataType convert_resource_type(M2MResourceInstance::ResourceType);
 
+    /**
+     * \brief Finds a resource from the resource list, which is kept sorted
+     * by the integer form of the resource name (see M2MBase::name_id()).
+     * \param resource_name The name of the resource.
+     * \param position[OUT] The position of the resource, or the position
+     * where a resource with the given name is to be inserted.
+     * \return True if the resource was found, else false.
+     */
+    bool find_resource(const char *resource_name, int &position) const;
+
+    /**
+     * \brief Adds a resource to its position in the sorted resource list.
+     * \param res The resource to be added.
+     */
+    void add_resource(M2MResource *res);
+
 private:
 
     M2MObject      &_parent;
 
-    M2MResourceList     _resource_list; // owned
+    M2MResourceList     _resource_list; // owned, sorted by name_id()
 
     friend class Test_M2MObjectInstance;
     friend class Test_M2MObject;
@@ -262,10 +262,22 @@ public:
     virtual const char* object_name() const;
 
     virtual M2MResource& get_parent_resource() const;
+private:
+
+    /**
+     * \brief Finds a resource instance from the instance list, which is kept
+     * sorted by instance ID.
+     * \param instance_id The ID of the resource instance.
+     * \param position[OUT] The position of the instance, or the position
+     * where an instance with the given ID is to be inserted.
+     * \return True if the instance was found, else false.
+     */
+    bool find_resource_instance(uint16_t instance_id, int &position) const;
+
 private:
     M2MObjectInstance &_parent;
 
-    M2MResourceInstanceList     _resource_instance_list; // owned
+    M2MResourceInstanceList     _resource_instance_list; // owned, sorted by instance ID
 #ifndef DISABLE_DELAYED_RESPONSE
     uint8_t                     *_delayed_token;
     uint8_t                     _delayed_token_len;
@@ -35,6 +35,7 @@ typedef void(*notification_sent_callback_2) (void);
 
 #ifndef DISABLE_BLOCK_MESSAGE
 typedef FP1<void, M2MBlockMessage *> incoming_block_message_callback;
+typedef FP1<bool, const M2MBlockMessage *> incoming_block_sink_callback;
 typedef FP3<void, const String &, uint8_t *&, uint32_t &> outgoing_block_message_callback;
 #endif
 
@@ -197,6 +198,14 @@ public:
      */
     bool set_value(int64_t value);
 
+    /**
+     * \brief Sets a floating point value of a given resource.
+     * \param value A new value, which is stored in the resource
+     * as a string with six decimals.
+     * \return True if successfully set, else false.
+     */
+    bool set_value_float(float value);
+
     /**
      * \brief Clears the value of a given resource.
      */
@@ -221,6 +230,12 @@ public:
      */
     int64_t get_value_int() const;
 
+    /**
+     * \brief Converts a value to float and returns it. Note: Conversion
+     * errors are not detected.
+     */
+    float get_value_float() const;
+
     /**
      * Get the value as a string object. No encoding/charset conversions
      * are done for the value, just a raw copy.
@@ -287,6 +302,17 @@ public:
      */
     bool set_incoming_block_message_callback(incoming_block_message_callback callback);
 
+    /**
+     * @brief Sets the function that consumes the blocks of a block-wise message
+     * without a copy. The block data given to the function refers to the payload of
+     * the CoAP message and is valid only during the call, so a consumer which needs
+     * the data afterwards must copy it to its own storage. While a sink is set, the
+     * incoming block message callback is not called.
+     * @param callback The function pointer that is called. It returns false to reject
+     * the block, which fails the block-wise message.
+     */
+    bool set_incoming_block_sink_callback(incoming_block_sink_callback callback);
+
     /**
      * @brief Sets the function that is executed when this
      * object receives a GET request.
@@ -363,12 +389,35 @@ private:
 
     M2MResourceBase::ResourceType convert_data_type(M2MBase::DataType type) const;
 
+    bool store_value(const uint8_t *value, const uint32_t value_length);
+
+#ifdef MBED_CLIENT_TYPED_RESOURCE_VALUE
+    bool uses_native_value() const;
+
+    void render_value();
+
+    void clear_native_value();
+#endif
+
 private:
 
+#ifdef MBED_CLIENT_TYPED_RESOURCE_VALUE
+    typedef union {
+        int64_t     int_value;
+        float       float_value;
+    } native_value_u;
+
+    native_value_u      _native_value;
+    bool                _native_value_valid : 1;   // _native_value holds the current value
+    bool                _text_value_stale : 1;     // nsdl value must be rendered from _native_value
+#endif
+
 #ifndef DISABLE_BLOCK_MESSAGE
     M2MBlockMessage     *_block_message_data;
 #endif
 
+    uint32_t            _value_capacity;           // value length the nsdl buffer can hold, 0 if not allocated by store_value()
+
     NoticationStatus    _notification_status : 2;
 
     friend class Test_M2MResourceInstance;
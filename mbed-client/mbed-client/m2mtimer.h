@@ -50,6 +50,7 @@ public:
     * \brief Starts the timer.
     * \param interval The timer interval in milliseconds.
     * \param single_shot Defines whether the timer is ticked once or restarted every time at expiry.
+    * A single shot timer may be deleted by its observer in M2MTimerObserver::timer_expired().
     */
     void start_timer(uint64_t interval, M2MTimerObserver::Type type, bool single_shot = true);
 
@@ -79,6 +80,14 @@ public:
      */
     bool is_total_interval_passed();
 
+    /**
+     * \brief Returns the current time of the timer service in milliseconds.
+     * The counter wraps around, so only the difference between two
+     * readings is meaningful.
+     * \return The current time in milliseconds.
+     */
+    static uint32_t get_time_ms();
+
 private:
 
     M2MTimerObserver&   _observer;
@@ -107,6 +107,17 @@ class Vector
         _size++;
     }
 
+    void insert(int position, const ObjectTemplate& x) {
+        if(_size == _capacity) {
+            reserve(2 * _capacity + 1);
+        }
+        for(int k = _size; k > position; k--) {
+            _object_template[k] = _object_template[k - 1];
+        }
+        _object_template[position] = x;
+        _size++;
+    }
+
     void pop_back() {
         _size--;
     }
@@ -16,6 +16,7 @@
 #ifndef __M2M_CALLBACK_STORAGE_H__
 #define __M2M_CALLBACK_STORAGE_H__
 
+#include <stdint.h>
 #include "mbed-client/m2mvector.h"
 
 class M2MBase;
@@ -51,6 +52,9 @@ public:
         // typedef FP3<void, const String &, uint8_t *&, uint32_t &> outgoing_block_message_callback;
         M2MResourceInstanceOutgoingBlockMessageCallback,
 
+        // typedef FP1<bool, const M2MBlockMessage *> incoming_block_sink_callback;
+        M2MResourceInstanceIncomingBlockSinkCallback,
+
         // class M2MResourceCallback
         M2MResourceInstanceM2MResourceCallback,
 
@@ -68,7 +72,10 @@ public:
 
         // typedef void(*notification_delivery_status_cb) (const M2MBase& base,
         // const M2MBase::NoticationDeliveryStatus status, void *client_args);
-        M2MBaseNotificationDeliveryStatusCallback
+        M2MBaseNotificationDeliveryStatusCallback,
+
+        // Number of callback types, not a type of its own. Add new types above it.
+        M2MCallbackTypeCount
 
     };
 
@@ -105,6 +112,8 @@ class M2MCallbackStorage
 {
 public:
 
+    M2MCallbackStorage();
+
     ~M2MCallbackStorage();
 
     // get the shared instance of the storage.
@@ -138,8 +147,6 @@ public:
     static void* get_callback(const M2MBase &object, M2MCallbackAssociation::M2MCallbackType type);
 
     static M2MCallbackAssociation* get_association_item(const M2MBase &object, M2MCallbackAssociation::M2MCallbackType type);
-    // XXX: this is actually not needed unless the client has multiple callbacks per object and type.
-    inline const M2MCallbackAssociationList& get_callbacks() const;
 
 private:
     bool does_callback_exist(const M2MBase &object, void *callback, M2MCallbackAssociation::M2MCallbackType type) const;
@@ -150,6 +157,13 @@ private:
 
     M2MCallbackAssociation* do_get_association_item(const M2MBase &object, M2MCallbackAssociation::M2MCallbackType type) const;
 
+    // index of the first association of <object>+<type>, or -1 if there is none
+    int find(const M2MBase &object, M2MCallbackAssociation::M2MCallbackType type) const;
+    uint32_t home_slot(const M2MBase *object, M2MCallbackAssociation::M2MCallbackType type) const;
+    void insert(const M2MCallbackAssociation &association);
+    void remove_at(uint32_t index);
+    bool resize(uint32_t table_size);
+
 private:
 
     /**
@@ -164,13 +178,15 @@ private:
      * But that should not be too hard if the feature was added to M2M object API too, it just
      * requires the M2M objects to iterate through the callbacks associated to it, not just call
      * the get_callback(<object>,<type>) and call the first one.
+     *
+     * The associations are kept in an open addressing hash table keyed by <object>+<type>,
+     * using linear probing. Empty slots have a null _object. Removal shifts the following
+     * entries of the probe sequence back instead of leaving tombstones, so lookups never
+     * slow down after many objects have been deleted.
      */
-    M2MCallbackAssociationList _callbacks;
+    M2MCallbackAssociation  *_table;
+    uint32_t                _table_size;
+    uint32_t                _count;
 };
 
-inline const M2MCallbackAssociationList& M2MCallbackStorage::get_callbacks() const
-{
-    return _callbacks;
-}
-
 #endif // !__M2M_CALLBACK_STORAGE_H__
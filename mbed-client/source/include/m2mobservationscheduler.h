@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2017 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef M2M_OBSERVATION_SCHEDULER_H
+#define M2M_OBSERVATION_SCHEDULER_H
+
+#include <stdint.h>
+#include "mbed-client/m2mtimerobserver.h"
+#include "mbed-client/m2mvector.h"
+
+class M2MTimer;
+class M2MReportHandler;
+
+/**
+ *  @brief M2MObservationScheduler.
+ *  Keeps the pmin and pmax deadlines of all the report handlers in a single
+ *  binary min-heap and services them with one shared timer. A report handler
+ *  only stores the heap position of its two deadlines, so arming, re-arming
+ *  and cancelling an observation timer is O(log n) and does not allocate a
+ *  timer object or an event loop timer entry per observed resource.
+ */
+class M2MObservationScheduler : public M2MTimerObserver
+{
+private:
+    // Prevents the use of assignment operator
+    M2MObservationScheduler& operator=(const M2MObservationScheduler& other);
+
+    // Prevents the use of copy constructor
+    M2MObservationScheduler(const M2MObservationScheduler& other);
+
+    M2MObservationScheduler();
+
+    virtual ~M2MObservationScheduler();
+
+public:
+
+    /**
+     * Value of a heap slot which is not scheduled.
+     */
+    static const uint16_t NotScheduled = 0;
+
+    /**
+     * @brief Registers a report handler as a user of the scheduler.
+     * The shared scheduler is created on first use.
+     */
+    static void attach();
+
+    /**
+     * @brief Releases a report handler's reference to the scheduler.
+     * The shared scheduler is deleted when the last user is gone.
+     */
+    static void detach();
+
+    /**
+     * @brief Schedules a pmin or pmax deadline for the report handler, replacing
+     * any earlier deadline of the same type.
+     * @param handler Report handler to be notified.
+     * @param type PMinTimer or PMaxTimer.
+     * @param interval Interval from now in milliseconds.
+     * @return True if the deadline was scheduled, false if out of memory.
+     */
+    static bool schedule(M2MReportHandler &handler, M2MTimerObserver::Type type, uint64_t interval);
+
+    /**
+     * @brief Cancels a pmin or pmax deadline of the report handler, if any.
+     * @param handler Report handler owning the deadline.
+     * @param type PMinTimer or PMaxTimer.
+     */
+    static void cancel(M2MReportHandler &handler, M2MTimerObserver::Type type);
+
+protected: // from M2MTimerObserver
+
+    virtual void timer_expired(M2MTimerObserver::Type type =
+                               M2MTimerObserver::Notdefined);
+
+private:
+
+    struct Entry {
+        uint64_t                deadline;
+        M2MReportHandler        *handler;
+        M2MTimerObserver::Type  type;
+    };
+
+    uint64_t current_time();
+
+    bool insert(M2MReportHandler &handler, M2MTimerObserver::Type type, uint64_t deadline);
+
+    void remove(uint16_t &slot);
+
+    void sift_up(int position);
+
+    void sift_down(int position);
+
+    void place(int position, const Entry &entry);
+
+    void arm_timer();
+
+    static uint16_t &slot_of(M2MReportHandler &handler, M2MTimerObserver::Type type);
+
+private:
+    M2MTimer                *_timer;
+    m2m::Vector<Entry>      _heap;
+    uint64_t                _now;
+    uint64_t                _armed_deadline;
+    uint32_t                _last_time;
+    uint32_t                _users;
+    bool                    _armed;
+    bool                    _dispatching;
+
+    static M2MObservationScheduler *_instance;
+
+friend class Test_M2MObservationScheduler;
+};
+
+#endif // M2M_OBSERVATION_SCHEDULER_H
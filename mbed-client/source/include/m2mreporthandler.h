@@ -23,11 +23,9 @@
 #include "mbed-client/m2mtimerobserver.h"
 #include "mbed-client/m2mresourceinstance.h"
 #include "mbed-client/m2mvector.h"
-#include "mbed-client/m2mtimer.h"
 
 //FORWARD DECLARATION
 class M2MReportObserver;
-class M2MTimer;
 class M2MResourceInstance;
 
 /**
@@ -156,11 +154,13 @@ protected : // from M2MTimerObserver
 
 private:
 
-
-
-    bool set_notification_attribute(const char* option,
-            M2MBase::BaseType type,
-            M2MResourceInstance::ResourceType resource_type);
+    /**
+     * @brief Converts a pmin or pmax value to whole seconds.
+     * @param value Parsed attribute value.
+     * @param result [OUT] Value in seconds.
+     * @return False if the value is not an integer within int32_t range.
+     */
+    static bool attribute_to_int32(float value, int32_t &result);
 
     /**
      * @brief Schedule a report, if the pmin is exceeded
@@ -219,8 +219,8 @@ private:
     bool                        _pmin_exceeded;
     bool                        _pmax_exceeded;
     unsigned                    _observation_number : 24;
-    M2MTimer                    _pmin_timer;
-    M2MTimer                    _pmax_timer;
+    uint16_t                    _pmin_slot;
+    uint16_t                    _pmax_slot;
     uint8_t                     *_token;
     int32_t                     _pmax;
     int32_t                     _pmin;
@@ -234,6 +234,7 @@ private:
     m2m::Vector<uint16_t>       _changed_instance_ids;
 
 friend class Test_M2MReportHandler;
+friend class M2MObservationScheduler;
 
 };
 
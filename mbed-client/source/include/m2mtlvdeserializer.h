@@ -116,29 +116,25 @@ private:
 
     static M2MTLVDeserializer::Error deserialize_object_instances(const uint8_t *tlv,
                                                            uint32_t tlv_size,
-                                                           uint32_t offset,
                                                            M2MObject &object,
                                                            M2MTLVDeserializer::Operation operation,
                                                            bool update_value);
 
     static M2MTLVDeserializer::Error deserialize_resources(const uint8_t *tlv,
                                                     uint32_t tlv_size,
-                                                    uint32_t offset,
                                                     M2MObjectInstance &object_instance,
                                                     M2MTLVDeserializer::Operation operation,
                                                     bool update_value);
 
     static M2MTLVDeserializer::Error deserialize_resource_instances(const uint8_t *tlv,
                                                              uint32_t tlv_size,
-                                                             uint32_t offset,
-                                                             M2MResource &resource,
+                                                             M2MResource *resource,
                                                              M2MObjectInstance &object_instance,
                                                              M2MTLVDeserializer::Operation operation,
                                                              bool update_value);
 
     static M2MTLVDeserializer::Error deserialize_resource_instances(const uint8_t *tlv,
                                                              uint32_t tlv_size,
-                                                             uint32_t offset,
                                                              M2MResource &resource,
                                                              M2MTLVDeserializer::Operation operation,
                                                              bool update_value);
@@ -151,17 +147,29 @@ private:
 
     static bool is_resource_instance(const uint8_t *tlv, uint32_t offset);
 
+    static M2MResource* find_resource(const M2MObjectInstance &object_instance,
+                                      uint16_t id,
+                                      bool multiple_instances);
+
+    static M2MResource* create_resource(M2MObjectInstance &object_instance,
+                                        uint16_t id,
+                                        bool multiple_instances);
+
+    static M2MTLVDeserializer::Error update_resource_value(M2MResourceBase *res,
+                                                           const uint8_t *value,
+                                                           const uint32_t size);
+
     static bool set_resource_instance_value(M2MResourceBase *res, const uint8_t *tlv, const uint32_t size);
 
+    static bool contains_id(const uint8_t *tlv, uint32_t tlv_size, uint16_t id);
+
     static void remove_resources(const uint8_t *tlv,
                                  uint32_t tlv_size,
-                                 M2MObjectInstance &object_instance,
-                                 uint32_t offset_size);
+                                 M2MObjectInstance &object_instance);
 
     static void remove_resource_instances(const uint8_t *tlv,
                                  uint32_t tlv_size,
-                                 M2MResource &resource,
-                                 uint32_t offset_size);
+                                 M2MResource &resource);
 };
 
 class TypeIdLength {
@@ -183,3 +191,34 @@ public:
 
     friend class Test_M2MTLVDeserializer;
 };
+
+/**
+ * @brief TLVIterator
+ * Walks the TLV elements of one nesting level of a buffer. Every element is
+ * exposed as a view into the buffer (type, id and value span), nothing is
+ * copied. Iteration stops with _error set if an element does not fit into
+ * the buffer.
+ */
+class TLVIterator {
+
+public:
+    TLVIterator(const uint8_t *tlv, uint32_t tlv_size);
+
+    /**
+     * Moves to the next element.
+     * @return true if an element is available, false at the end of the
+     * buffer or if the next element is malformed.
+     */
+    bool next();
+
+    const uint8_t     *_tlv;
+    uint32_t    _size;
+    uint32_t    _offset;
+    bool        _error;
+    uint32_t    _type;
+    uint16_t    _id;
+    const uint8_t     *_value;
+    uint32_t    _length;
+
+    friend class Test_M2MTLVDeserializer;
+};
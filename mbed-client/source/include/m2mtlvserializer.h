@@ -78,25 +78,35 @@ public:
 
 private :
 
-    static uint8_t* serialize_object_instances(const M2MObjectInstanceList &object_instance_list, uint32_t &size);
+    static uint32_t size_of_object_instances(const M2MObjectInstanceList &object_instance_list);
 
-    static uint8_t* serialize_resources(const M2MResourceList &resource_list, uint32_t &size, bool &valid);
+    static uint32_t size_of_resources(const M2MResourceList &resource_list, bool &valid);
 
-    static bool serialize(uint16_t id, const M2MObjectInstance *object_instance, uint8_t *&data, uint32_t &size);
-    
-    static bool serialize(const M2MResource *resource, uint8_t *&data, uint32_t &size);
+    static uint32_t size_of_resource(const M2MResource *resource, bool &valid);
 
-    static bool serialize_resource(const M2MResource *resource, uint8_t *&data, uint32_t &size);
+    static uint32_t size_of_resource_instances(const M2MResource *resource);
 
-    static bool serialize_multiple_resource(const M2MResource *resource, uint8_t *&data, uint32_t &size);
+    static uint32_t size_of_value(const M2MResourceBase *resource);
 
-    static bool serialize_resource_instance(uint16_t id, const M2MResourceInstance *resource, uint8_t *&data, uint32_t &size);
-    
-    static bool serialize_TILV (uint8_t type, uint16_t id, uint8_t *value, uint32_t value_length, uint8_t *&data, uint32_t &size);
+    static uint32_t size_of_TILV(uint16_t id, uint32_t value_length);
+
+    static uint8_t* serialize_object_instances(const M2MObjectInstanceList &object_instance_list, uint8_t *ptr);
+
+    static uint8_t* serialize_resources(const M2MResourceList &resource_list, uint8_t *ptr);
+
+    static uint8_t* serialize_resource(const M2MResource *resource, uint8_t *ptr);
+
+    static uint8_t* serialize_multiple_resource(const M2MResource *resource, uint8_t *ptr);
+
+    static uint8_t* serialize_value(const M2MResourceBase *resource, uint8_t type, uint16_t id, uint8_t *ptr);
+
+    static uint8_t* serialize_TLV_binary_int(const M2MResourceBase *resource, uint8_t type, uint16_t id, uint8_t *ptr);
+
+    static uint8_t* serialize_TILV(uint8_t type, uint16_t id, const uint8_t *value, uint32_t value_length, uint8_t *ptr);
+
+    static uint8_t* serialize_TIL(uint8_t type, uint16_t id, uint32_t value_length, uint8_t *ptr);
 
     static void serialize_id(uint16_t id, uint32_t &size, uint8_t *id_ptr);
 
     static void serialize_length(uint32_t length, uint32_t &size, uint8_t *length_ptr);
-
-    static bool serialize_TLV_binary_int(const M2MResourceBase *resource, uint8_t type, uint16_t id, uint8_t *&data, uint32_t &size);
 };
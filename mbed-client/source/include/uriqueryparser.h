@@ -48,6 +48,44 @@ int8_t query_param_count(char *query);
  */
 bool uri_query_parameters(char* query, char *uri_query_parameters[], int index);
 
+/**
+ * \brief Maximum number of write attributes parsed from one query.
+ */
+#define QUERY_ATTRIBUTE_MAX_COUNT 5
+
+/**
+ * \brief Keys of the write attributes recognized by query_attributes().
+ * "st" and "stp" both map to QUERY_ATTRIBUTE_ST.
+ */
+typedef enum {
+    QUERY_ATTRIBUTE_PMIN = 0,
+    QUERY_ATTRIBUTE_PMAX,
+    QUERY_ATTRIBUTE_GT,
+    QUERY_ATTRIBUTE_LT,
+    QUERY_ATTRIBUTE_ST
+} query_attribute_key_t;
+
+/**
+ * \brief Write attribute parsed from a query.
+ */
+typedef struct query_attribute_s {
+    query_attribute_key_t   key;
+    float                   value;
+} query_attribute_t;
+
+/**
+ * \brief Parses write attributes such as "pmin=10&gt=20.5" in a single pass
+ * without modifying the query. Every parameter must be a known attribute with
+ * a decimal value, optionally signed and with a fraction and an exponent.
+ * \param query Query string.
+ * \param attributes [OUT] Parsed attributes, in query order.
+ * \param max_count Size of the attributes array.
+ * \return Count of parsed attributes, or -1 if the query is empty, contains
+ * an unknown attribute or a malformed value, or has more than max_count
+ * parameters.
+ */
+int8_t query_attributes(const char *query, query_attribute_t attributes[], uint8_t max_count);
+
 #ifdef __cplusplus
 }
 #endif
@@ -48,7 +48,8 @@ M2MBase::M2MBase(const String& resource_name,
                  M2MBase::DataType type)
 :
   _sn_resource(NULL),
-  _report_handler(NULL)
+  _report_handler(NULL),
+  _name_id(-1)
 {
     // Checking the name length properly, i.e returning error is impossible from constructor without exceptions
     assert(resource_name.length() <= MAX_ALLOWED_STRING_LENGTH);
@@ -89,6 +90,13 @@ M2MBase::M2MBase(const String& resource_name,
 #endif
                 }
                 params->path = path;
+#ifdef MBED_CLIENT_COMPACT_PATH
+                // A numeric path is kept as packed ids, the string is rendered only when needed
+                if (path && sn_nsdl_set_numeric_path(params, path)) {
+                    free(path);
+                    params->path = NULL;
+                }
+#endif
                 params->mode = (unsigned)mode;
                 params->free_on_delete = true;
                 params->external_memory_block = external_blockwise_store;
@@ -99,6 +107,7 @@ M2MBase::M2MBase(const String& resource_name,
         if((!resource_name.empty())) {
             _sn_resource->identifier_int_type = false;
             _sn_resource->identifier.name = stringdup((char*)resource_name.c_str());
+            _name_id = name_to_id(resource_name.c_str());
         } else {
             tr_debug("M2MBase::M2Mbase resource name is EMPTY ===========");
             _sn_resource->identifier_int_type = true;
@@ -113,9 +122,13 @@ M2MBase::M2MBase(const String& resource_name,
 
 M2MBase::M2MBase(const lwm2m_parameters_s *s):
     _sn_resource((lwm2m_parameters_s*) s),
-    _report_handler(NULL)
+    _report_handler(NULL),
+    _name_id(-1)
 {
     tr_debug("M2MBase::M2MBase(const lwm2m_parameters_s *s)");
+    if (!_sn_resource->identifier_int_type) {
+        _name_id = name_to_id(_sn_resource->identifier.name);
+    }
     // Set callback function in case of both dynamic and static resource
     _sn_resource->dynamic_resource_params->sn_grs_dyn_res_callback = __nsdl_c_callback;
 }
@@ -137,7 +150,8 @@ char* M2MBase::create_path_base(const M2MBase &parent, const char *name)
     char * result = NULL;
     // Expectation is that every element can be MAX_NAME_SZE, + 4 /'s + \0
     StringBuffer<(MAX_NAME_SIZE * 4 + (4 + 1))> path;
-    path.append(parent.uri_path());
+    char path_buffer[SN_NSDL_PATH_BUFFER_SIZE];
+    path.append(parent.uri_path(path_buffer));
     path.append('/');
     path.append(name);
     result = stringdup(path.c_str());
@@ -362,10 +376,15 @@ const char* M2MBase::name() const
 
 int32_t M2MBase::name_id() const
 {
-    int32_t name_id = -1;
     assert(_sn_resource->identifier_int_type == false);
-    if(is_integer(_sn_resource->identifier.name) && strlen(_sn_resource->identifier.name) <= MAX_ALLOWED_STRING_LENGTH) {
-        name_id = strtoul(_sn_resource->identifier.name, NULL, 10);
+    return _name_id;
+}
+
+int32_t M2MBase::name_to_id(const char *name)
+{
+    int32_t name_id = -1;
+    if(is_integer(name) && strlen(name) <= MAX_ALLOWED_STRING_LENGTH) {
+        name_id = strtoul(name, NULL, 10);
         if(name_id > 65535){
             name_id = -1;
         }
@@ -410,11 +429,18 @@ const char* M2MBase::resource_type() const
 }
 #endif
 #endif // RESOURCE_ATTRIBUTES_LIST
+const char* M2MBase::uri_path(char *buffer) const
+{
+    return sn_nsdl_get_path(_sn_resource->dynamic_resource_params->static_resource_parameters, buffer);
+}
+
+#ifndef MBED_CLIENT_COMPACT_PATH
 const char* M2MBase::uri_path() const
 {
     return (reinterpret_cast<char*>(
         _sn_resource->dynamic_resource_params->static_resource_parameters->path));
 }
+#endif
 
 uint16_t M2MBase::coap_content_type() const
 {
@@ -25,17 +25,17 @@ M2MBlockMessage::M2MBlockMessage() :
     _block_number(0),
     _error_code(M2MBlockMessage::ErrorNone),
     _is_last_block(false),
-    _is_block_message(false)
+    _is_block_message(false),
+    _is_payload_borrowed(false)
 {
 }
 
 M2MBlockMessage::~M2MBlockMessage()
 {
-    free(_block_data_ptr);
-    _block_data_ptr = NULL;
+    clear_block_data();
 }
 
-void M2MBlockMessage::set_message_info(sn_coap_hdr_s *coap_header)
+void M2MBlockMessage::set_message_info(sn_coap_hdr_s *coap_header, bool copy_payload)
 {
     _is_block_message = (coap_header &&
                 coap_header->options_list_ptr &&
@@ -85,13 +85,17 @@ void M2MBlockMessage::set_message_info(sn_coap_hdr_s *coap_header)
 //            }
 
             // Payload
-            free(_block_data_ptr);
-            _block_data_ptr = NULL;
+            clear_block_data();
             _block_data_len = coap_header->payload_len;
             if(_block_data_len > 0) {
-                _block_data_ptr = (uint8_t *)malloc(_block_data_len);
-                if (_block_data_ptr) {
-                    memcpy(_block_data_ptr, coap_header->payload_ptr, _block_data_len);
+                if (copy_payload) {
+                    _block_data_ptr = (uint8_t *)malloc(_block_data_len);
+                    if (_block_data_ptr) {
+                        memcpy(_block_data_ptr, coap_header->payload_ptr, _block_data_len);
+                    }
+                } else {
+                    _block_data_ptr = coap_header->payload_ptr;
+                    _is_payload_borrowed = true;
                 }
             }
         }
@@ -100,15 +104,23 @@ void M2MBlockMessage::set_message_info(sn_coap_hdr_s *coap_header)
 
 void M2MBlockMessage::clear_values()
 {
-    free(_block_data_ptr);
-    _block_data_ptr = NULL;
-    _block_data_len = 0;
+    clear_block_data();
     _block_number = 0;
     _total_message_size = 0;
     _is_last_block = false;
     _error_code = M2MBlockMessage::ErrorNone;
 }
 
+void M2MBlockMessage::clear_block_data()
+{
+    if (!_is_payload_borrowed) {
+        free(_block_data_ptr);
+    }
+    _block_data_ptr = NULL;
+    _block_data_len = 0;
+    _is_payload_borrowed = false;
+}
+
 bool M2MBlockMessage::is_block_message() const
 {
     return _is_block_message;
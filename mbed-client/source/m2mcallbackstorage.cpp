@@ -17,6 +17,10 @@
 #include "include/m2mcallbackstorage.h"
 
 #include <cstddef>
+#include <stdint.h>
+
+// Initial and minimum size of the hash table, must be a power of two.
+#define MIN_TABLE_SIZE 16
 
 // Dummy constructor, which does not init any value to something meaningful but needed for array construction.
 // It is better to leave values unintialized, so the Valgrind will point out if the Vector is used without
@@ -46,11 +50,19 @@ void M2MCallbackStorage::delete_instance()
     M2MCallbackStorage::_static_instance = NULL;
 }
 
+M2MCallbackStorage::M2MCallbackStorage()
+: _table(NULL),
+  _table_size(0),
+  _count(0)
+{
+}
+
 M2MCallbackStorage::~M2MCallbackStorage()
 {
     // TODO: go through the list and delete all the FP<n> objects if there are any.
     // On the other hand, if the system is done properly, each m2mobject should actually
     // remove its callbacks from its destructor so there is nothing here to do
+    delete [] _table;
 }
 
 bool M2MCallbackStorage::add_callback(const M2MBase &object,
@@ -74,8 +86,13 @@ bool M2MCallbackStorage::do_add_callback(const M2MBase &object, void *callback,
     // verify that the same callback is not re-added.
     if (does_callback_exist(object, callback, type) == false) {
 
+        // keep the load factor at or below 3/4 so that the probe sequences stay short
+        if ((_count + 1) * 4 > _table_size * 3 &&
+            !resize(_table_size ? _table_size * 2 : MIN_TABLE_SIZE)) {
+            return false;
+        }
         const M2MCallbackAssociation association(&object, callback, type, client_args);
-        _callbacks.push_back(association);
+        insert(association);
         add_success = true;
     }
 
@@ -95,12 +112,12 @@ void M2MCallbackStorage::remove_callbacks(const M2MBase &object)
 
 void M2MCallbackStorage::do_remove_callbacks(const M2MBase &object)
 {
-    // find any association to given object and delete them from the vector
-    for (int index = 0; index < _callbacks.size();) {
-        if (_callbacks[index]._object == &object) {
-            _callbacks.erase(index);
-        } else {
-            index++;
+    // find any association to given object and delete them from the table
+    for (int type = M2MCallbackAssociation::M2MBaseValueUpdatedCallback;
+         type < M2MCallbackAssociation::M2MCallbackTypeCount; type++) {
+        int index;
+        while ((index = find(object, (M2MCallbackAssociation::M2MCallbackType)type)) >= 0) {
+            remove_at(index);
         }
     }
 }
@@ -122,13 +139,10 @@ void* M2MCallbackStorage::remove_callback(const M2MBase &object, M2MCallbackAsso
 void* M2MCallbackStorage::do_remove_callback(const M2MBase &object, M2MCallbackAssociation::M2MCallbackType type)
 {
     void* callback = NULL;
-    for (int index = 0; index < _callbacks.size(); index++) {
-
-        if ((_callbacks[index]._object == &object) && (_callbacks[index]._type == type)) {
-            callback = _callbacks[index]._callback;
-            _callbacks.erase(index);
-            break;
-        }
+    const int index = find(object, type);
+    if (index >= 0) {
+        callback = _table[index]._callback;
+        remove_at(index);
     }
     return callback;
 }
@@ -147,16 +161,9 @@ void* M2MCallbackStorage::get_callback(const M2MBase &object, M2MCallbackAssocia
 void* M2MCallbackStorage::do_get_callback(const M2MBase &object, M2MCallbackAssociation::M2MCallbackType type) const
 {
     void* callback = NULL;
-    if (!_callbacks.empty()) {
-        M2MCallbackAssociationList::const_iterator it = _callbacks.begin();
-
-        for ( ; it != _callbacks.end(); it++ ) {
-
-            if ((it->_object == &object) && (it->_type == type)) {
-                callback = it->_callback;
-                break;
-            }
-        }
+    const int index = find(object, type);
+    if (index >= 0) {
+        callback = _table[index]._callback;
     }
     return callback;
 }
@@ -175,16 +182,9 @@ M2MCallbackAssociation* M2MCallbackStorage::get_association_item(const M2MBase &
 M2MCallbackAssociation* M2MCallbackStorage::do_get_association_item(const M2MBase &object, M2MCallbackAssociation::M2MCallbackType type) const
 {
     M2MCallbackAssociation* callback_association = NULL;
-    if (!_callbacks.empty()) {
-        M2MCallbackAssociationList::const_iterator it = _callbacks.begin();
-
-        for ( ; it != _callbacks.end(); it++ ) {
-
-            if ((it->_object == &object) && (it->_type == type)) {
-                callback_association = (M2MCallbackAssociation*)it;
-                break;
-            }
-        }
+    const int index = find(object, type);
+    if (index >= 0) {
+        callback_association = &_table[index];
     }
     return callback_association;
 }
@@ -202,12 +202,11 @@ bool M2MCallbackStorage::does_callback_exist(const M2MBase &object, void *callba
 {
     bool match_found = false;
 
-    if (!_callbacks.empty()) {
-        M2MCallbackAssociationList::const_iterator it = _callbacks.begin();
-
-        for ( ; it != _callbacks.end(); it++ ) {
+    if (_count) {
+        const uint32_t mask = _table_size - 1;
+        for (uint32_t index = home_slot(&object, type); _table[index]._object; index = (index + 1) & mask) {
 
-            if ((it->_object == &object) && (it->_callback == callback) && (it->_type == type)) {
+            if ((_table[index]._object == &object) && (_table[index]._callback == callback) && (_table[index]._type == type)) {
                 match_found = true;
                 break;
             }
@@ -216,3 +215,98 @@ bool M2MCallbackStorage::does_callback_exist(const M2MBase &object, void *callba
 
     return match_found;
 }
+
+int M2MCallbackStorage::find(const M2MBase &object, M2MCallbackAssociation::M2MCallbackType type) const
+{
+    if (_count) {
+        const uint32_t mask = _table_size - 1;
+        for (uint32_t index = home_slot(&object, type); _table[index]._object; index = (index + 1) & mask) {
+
+            if ((_table[index]._object == &object) && (_table[index]._type == type)) {
+                return index;
+            }
+        }
+    }
+    return -1;
+}
+
+uint32_t M2MCallbackStorage::home_slot(const M2MBase *object, M2MCallbackAssociation::M2MCallbackType type) const
+{
+    // multiplicative hash of the object address, with the callback type mixed in so that
+    // the callbacks of one object do not all land on the same probe sequence
+    uint32_t hash = ((uint32_t)((uintptr_t)object >> 2) ^ ((uint32_t)type * 0x9E3779B9u)) * 2654435761u;
+    hash ^= hash >> 16;
+    return hash & (_table_size - 1);
+}
+
+void M2MCallbackStorage::insert(const M2MCallbackAssociation &association)
+{
+    // the caller guarantees that there is a free slot
+    const uint32_t mask = _table_size - 1;
+    uint32_t index = home_slot(association._object, association._type);
+    while (_table[index]._object) {
+        index = (index + 1) & mask;
+    }
+    _table[index] = association;
+    _count++;
+}
+
+void M2MCallbackStorage::remove_at(uint32_t index)
+{
+    // Backward shift deletion: move each following entry of the probe sequence into the
+    // hole, unless its home slot lies cyclically after the hole, where it would not be found.
+    const uint32_t mask = _table_size - 1;
+    uint32_t hole = index;
+    for (uint32_t next = (hole + 1) & mask; _table[next]._object; next = (next + 1) & mask) {
+        const uint32_t home = home_slot(_table[next]._object, _table[next]._type);
+        if (((next - home) & mask) >= ((next - hole) & mask)) {
+            _table[hole] = _table[next];
+            hole = next;
+        }
+    }
+    _table[hole]._object = NULL;
+    _count--;
+
+    if (_count == 0) {
+        delete [] _table;
+        _table = NULL;
+        _table_size = 0;
+    } else if (_table_size > MIN_TABLE_SIZE && _count * 8 < _table_size) {
+        // failing to shrink is harmless, the current table stays valid
+        resize(_table_size / 2);
+    }
+}
+
+bool M2MCallbackStorage::resize(uint32_t table_size)
+{
+    M2MCallbackAssociation *table = new M2MCallbackAssociation[table_size];
+    if (table == NULL) {
+        return false;
+    }
+    for (uint32_t index = 0; index < table_size; index++) {
+        table[index]._object = NULL;
+    }
+
+    M2MCallbackAssociation *old_table = _table;
+    const uint32_t old_size = _table_size;
+    _table = table;
+    _table_size = table_size;
+    _count = 0;
+
+    if (old_table) {
+        // Start right after an empty slot, so that the entries of a probe sequence are
+        // reinserted in their current order and the first added one is still found first.
+        uint32_t start = 0;
+        while (old_table[start]._object) {
+            start++;
+        }
+        for (uint32_t offset = 1; offset <= old_size; offset++) {
+            const uint32_t index = (start + offset) & (old_size - 1);
+            if (old_table[index]._object) {
+                insert(old_table[index]);
+            }
+        }
+        delete [] old_table;
+    }
+    return true;
+}
@@ -91,7 +91,11 @@ static sn_nsdl_static_resource_parameters_s firmware_package_params_static = {
 //    0,                      // resourcelen
     false,                  // external_memory_block
     SN_GRS_DYNAMIC,         // mode
-    false                   // free_on_delete
+    false,                  // free_on_delete
+#ifdef MBED_CLIENT_COMPACT_PATH
+    0,                      // path_depth, path is a string
+    {0}                     // path_id
+#endif
 };
 
 #define PACKAGE_URI_PATH FIRMWARE_PATH_PREFIX FIRMWARE_PACKAGE_URI
@@ -113,7 +117,11 @@ static sn_nsdl_static_resource_parameters_s firmware_package_uri_params_static =
 //    0,                      // resourcelen
     false,                  // external_memory_block
     SN_GRS_DYNAMIC,         // mode
-    false                   // free_on_delete
+    false,                  // free_on_delete
+#ifdef MBED_CLIENT_COMPACT_PATH
+    0,                      // path_depth, path is a string
+    {0}                     // path_id
+#endif
 };
 
 #define UPDATE_PATH FIRMWARE_PATH_PREFIX FIRMWARE_UPDATE
@@ -135,7 +143,11 @@ static sn_nsdl_static_resource_parameters_s firmware_update_params_static = {
 //    0,                      // resourcelen
     false,                  // external_memory_block
     SN_GRS_DYNAMIC,         // mode
-    false                   // free_on_delete
+    false,                  // free_on_delete
+#ifdef MBED_CLIENT_COMPACT_PATH
+    0,                      // path_depth, path is a string
+    {0}                     // path_id
+#endif
 };
 
 #define STATE_URI_PATH FIRMWARE_PATH_PREFIX FIRMWARE_STATE
@@ -155,7 +167,11 @@ static sn_nsdl_static_resource_parameters_s firmware_state_params_static = {
     (char*)STATE_URI_PATH,   // path
     false,                  // external_memory_block
     SN_GRS_DYNAMIC,         // mode
-    false                   // free_on_delete
+    false,                  // free_on_delete
+#ifdef MBED_CLIENT_COMPACT_PATH
+    0,                      // path_depth, path is a string
+    {0}                     // path_id
+#endif
 };
 
 #define UPDATE_RESULT_PATH FIRMWARE_PATH_PREFIX FIRMWARE_UPDATE_RESULT
@@ -175,7 +191,11 @@ static sn_nsdl_static_resource_parameters_s firmware_update_result_params_static
     (char*)UPDATE_RESULT_PATH, // path
     false,                  // external_memory_block
     SN_GRS_DYNAMIC,         // mode
-    false                   // free_on_delete
+    false,                  // free_on_delete
+#ifdef MBED_CLIENT_COMPACT_PATH
+    0,                      // path_depth, path is a string
+    {0}                     // path_id
+#endif
 };
 
 static sn_nsdl_dynamic_resource_parameters_s firmware_package_params_dynamic = {
@@ -753,4 +773,17 @@ bool M2MFirmware::set_package_block_message_callback(incoming_block_message_call
 
     return false;
 }
+
+bool M2MFirmware::set_package_block_sink_callback(incoming_block_sink_callback callback)
+{
+    M2MResource* m2mresource;
+
+    m2mresource = get_resource(Package);
+
+    if(m2mresource) {
+        return m2mresource->set_incoming_block_sink_callback(callback);
+    }
+
+    return false;
+}
 #endif // DISABLE_BLOCK_MESSAGE
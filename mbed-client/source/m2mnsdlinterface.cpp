@@ -904,7 +904,8 @@ uint8_t M2MNsdlInterface::resource_callback(struct nsdl_s */*nsdl_handle*/,
             // Delete the object instance
             M2MBase::BaseType type = base->base_type();
             if(M2MBase::ObjectInstance == type) {
-                M2MBase* base_object = find_resource(base->uri_path(), 0);
+                char path_buffer[SN_NSDL_PATH_BUFFER_SIZE];
+                M2MBase* base_object = find_resource(base->uri_path(path_buffer), 0);
                 if(base_object) {
                     M2MObject &object = ((M2MObjectInstance*)base_object)->get_parent_object();
                     int slash_found = resource_name.find_last_of('/');
@@ -935,15 +936,27 @@ uint8_t M2MNsdlInterface::resource_callback(struct nsdl_s */*nsdl_handle*/,
                                                msg_code);
     }
 
-    // This copy will be passed to resource instance
-    payload = (uint8_t*)memory_alloc(received_coap_header->payload_len + 1);
-    if (payload) {
-        memcpy(payload, received_coap_header->payload_ptr, received_coap_header->payload_len);
-        payload[received_coap_header->payload_len] = '\0';
+    // A block of a resource with external block storage has already been
+    // handed to its incoming block message callback, so it is not copied.
+    bool external_block_store = false;
+    if (base && COAP_MSG_CODE_REQUEST_PUT == received_coap_header->msg_code &&
+            (base->base_type() == M2MBase::Resource ||
+             base->base_type() == M2MBase::ResourceInstance)) {
+        M2MResourceBase* res = (M2MResourceBase*)base;
+        external_block_store = res->block_message() && res->block_message()->is_block_message();
     }
-    else {
-        if (coap_response) {
-            coap_response->msg_code = COAP_MSG_CODE_RESPONSE_REQUEST_ENTITY_TOO_LARGE;
+
+    if (!external_block_store) {
+        // This copy will be passed to resource instance
+        payload = (uint8_t*)memory_alloc(received_coap_header->payload_len + 1);
+        if (payload) {
+            memcpy(payload, received_coap_header->payload_ptr, received_coap_header->payload_len);
+            payload[received_coap_header->payload_len] = '\0';
+        }
+        else {
+            if (coap_response) {
+                coap_response->msg_code = COAP_MSG_CODE_RESPONSE_REQUEST_ENTITY_TOO_LARGE;
+            }
         }
     }
 
@@ -966,11 +979,6 @@ uint8_t M2MNsdlInterface::resource_callback(struct nsdl_s */*nsdl_handle*/,
             (base->base_type() == M2MBase::Resource ||
              base->base_type() == M2MBase::ResourceInstance)) {
             M2MResourceBase* res = (M2MResourceBase*)base;
-            bool external_block_store = false;
-
-            if (res->block_message() && res->block_message()->is_block_message()) {
-                external_block_store = true;
-            }
             if (!external_block_store) {
                 // Ownership of payload moved to resource, skip the freeing.
                 free_payload = false;
@@ -1316,12 +1324,13 @@ M2MBase* M2MNsdlInterface::find_resource(const String &object_name,
                                          const uint16_t msg_id) const
 {
     M2MBase *object = NULL;
+    char path_buffer[SN_NSDL_PATH_BUFFER_SIZE];
     if(!_object_list.empty()) {
         M2MObjectList::const_iterator it;
         it = _object_list.begin();
         for ( ; it != _object_list.end(); it++ ) {
             if (!msg_id) {
-                if (strcmp((char*)(*it)->uri_path(), object_name.c_str()) == 0) {
+                if (strcmp((*it)->uri_path(path_buffer), object_name.c_str()) == 0) {
                     object = (*it);
                     tr_debug("M2MNsdlInterface::find_resource(%s) found", object_name.c_str());
                     break;
@@ -1348,6 +1357,7 @@ M2MBase* M2MNsdlInterface::find_resource(const M2MObject *object,
                                          const uint16_t msg_id) const
 {
     M2MBase *instance = NULL;
+    char path_buffer[SN_NSDL_PATH_BUFFER_SIZE];
     if(object) {
         const M2MObjectInstanceList &list = object->instances();
         if(!list.empty()) {
@@ -1355,10 +1365,10 @@ M2MBase* M2MNsdlInterface::find_resource(const M2MObject *object,
             it = list.begin();
             for ( ; it != list.end(); it++ ) {
                 if (!msg_id) {
-                    if(!strcmp((char*)(*it)->uri_path(), object_instance.c_str())){
+                    const char *path = (*it)->uri_path(path_buffer);
+                    if(!strcmp(path, object_instance.c_str())){
                         instance = (*it);
-                        tr_debug("M2MNsdlInterface::find_resource(object instance level) - found (%s)",
-                                 (char*)(*it)->uri_path());
+                        tr_debug("M2MNsdlInterface::find_resource(object instance level) - found (%s)", path);
                         break;
                     }
                 } else {
@@ -1384,6 +1394,7 @@ M2MBase* M2MNsdlInterface::find_resource(const M2MObjectInstance *object_instanc
                                          const uint16_t msg_id) const
 {
     M2MBase *instance = NULL;
+    char path_buffer[SN_NSDL_PATH_BUFFER_SIZE];
     if(object_instance) {
         const M2MResourceList &list = object_instance->resources();
         if(!list.empty()) {
@@ -1391,12 +1402,12 @@ M2MBase* M2MNsdlInterface::find_resource(const M2MObjectInstance *object_instanc
             it = list.begin();
             for ( ; it != list.end(); it++ ) {
                 if (!msg_id) {
-                    if(!strcmp((char*)(*it)->uri_path(), resource_instance.c_str())) {
+                    if(!strcmp((*it)->uri_path(path_buffer), resource_instance.c_str())) {
                         instance = *it;
                         break;
                     }
                     else if((*it)->supports_multiple_instances()) {
-                        instance = find_resource((*it), (*it)->uri_path(),
+                        instance = find_resource((*it), (*it)->uri_path(path_buffer),
                                                  resource_instance);
                         if(instance != NULL){
                             break;
@@ -1421,6 +1432,7 @@ M2MBase* M2MNsdlInterface::find_resource(const M2MResource *resource,
                                          const String &resource_instance) const
 {
     M2MBase *res = NULL;
+    char path_buffer[SN_NSDL_PATH_BUFFER_SIZE];
     if(resource) {
         if(resource->supports_multiple_instances()) {
             const M2MResourceInstanceList &list = resource->resource_instances();
@@ -1428,7 +1440,7 @@ M2MBase* M2MNsdlInterface::find_resource(const M2MResource *resource,
                 M2MResourceInstanceList::const_iterator it;
                 it = list.begin();
                 for ( ; it != list.end(); it++ ) {
-                    if(!strcmp((char*)(*it)->uri_path(), resource_instance.c_str())){
+                    if(!strcmp((*it)->uri_path(path_buffer), resource_instance.c_str())){
                         res = (*it);
                         break;
                     }
@@ -1629,7 +1641,9 @@ void M2MNsdlInterface::send_resource_observation(M2MResource *resource,
                                                  bool resend)
 {
     if(resource) {
-        tr_info("M2MNsdlInterface::send_resource_observation - uri %s", resource->uri_path());
+        char path_buffer[SN_NSDL_PATH_BUFFER_SIZE];
+        tr_info("M2MNsdlInterface::send_resource_observation - uri %s", resource->uri_path(path_buffer));
+        (void) path_buffer;
         uint8_t *value = 0;
         uint32_t length = 0;
         uint8_t token[MAX_TOKEN_SIZE];
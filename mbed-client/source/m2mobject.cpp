@@ -87,7 +87,8 @@ M2MObjectInstance* M2MObject::create_object_instance(uint16_t instance_id)
 {
     tr_debug("M2MObject::create_object_instance - id: %d", instance_id);
     M2MObjectInstance *instance = NULL;
-    if(!object_instance(instance_id)) {
+    int position;
+    if(!find_object_instance(instance_id, position)) {
         char* path = create_path(*this, instance_id);
         if (path) {
             // Note: the object instance's name contains actually object's name.
@@ -98,7 +99,7 @@ M2MObjectInstance* M2MObject::create_object_instance(uint16_t instance_id)
                 if(M2MBase::name_id() != -1) {
                     instance->set_coap_content_type(COAP_CONTENT_OMA_TLV_TYPE_OLD);
                 }
-                _instance_list.push_back(instance);
+                _instance_list.insert(position, instance);
             }
         }
     }
@@ -110,7 +111,8 @@ M2MObjectInstance* M2MObject::create_object_instance(const lwm2m_parameters_s* s
 {
     tr_debug("M2MObject::create_object_instance - id: %d", s->identifier.instance_id);
     M2MObjectInstance *instance = NULL;
-    if(!object_instance(s->identifier.instance_id)) {
+    int position;
+    if(!find_object_instance(s->identifier.instance_id, position)) {
 
         instance = new M2MObjectInstance(*this, s);
         if(instance) {
@@ -119,7 +121,7 @@ M2MObjectInstance* M2MObject::create_object_instance(const lwm2m_parameters_s* s
             //if(M2MBase::name_id() != -1) {
               //  instance->set_coap_content_type(COAP_CONTENT_OMA_TLV_TYPE_OLD);
             //}
-            _instance_list.push_back(instance);
+            _instance_list.insert(position, instance);
         }
     }
     return instance;
@@ -129,22 +131,14 @@ bool M2MObject::remove_object_instance(uint16_t inst_id)
 {
     tr_debug("M2MObject::remove_object_instance(inst_id %d)", inst_id);
     bool success = false;
-    if(!_instance_list.empty()) {
-        M2MObjectInstance* obj = NULL;
-        M2MObjectInstanceList::const_iterator it;
-        it = _instance_list.begin();
-        int pos = 0;
-        for ( ; it != _instance_list.end(); it++, pos++ ) {
-            if((*it)->instance_id() == inst_id) {
-                // Instance found and deleted.
-                obj = *it;
-
-                _instance_list.erase(pos);
-                delete obj;
-                success = true;
-                break;
-            }
-        }
+    int pos;
+    if(find_object_instance(inst_id, pos)) {
+        // Instance found and deleted.
+        M2MObjectInstance* obj = _instance_list[pos];
+
+        _instance_list.erase(pos);
+        delete obj;
+        success = true;
     }
     return success;
 }
@@ -153,20 +147,31 @@ M2MObjectInstance* M2MObject::object_instance(uint16_t inst_id) const
 {
     tr_debug("M2MObject::object_instance(inst_id %d)", inst_id);
     M2MObjectInstance *obj = NULL;
-    if(!_instance_list.empty()) {
-        M2MObjectInstanceList::const_iterator it;
-        it = _instance_list.begin();
-        for ( ; it != _instance_list.end(); it++ ) {
-            if((*it)->instance_id() == inst_id) {
-                // Instance found.
-                obj = *it;
-                break;
-            }
-        }
+    int pos;
+    if(find_object_instance(inst_id, pos)) {
+        // Instance found.
+        obj = _instance_list[pos];
     }
     return obj;
 }
 
+bool M2MObject::find_object_instance(uint16_t inst_id, int &position) const
+{
+    // Binary search for the first instance with an ID not less than inst_id
+    int low = 0;
+    int high = _instance_list.size();
+    while (low < high) {
+        int mid = low + (high - low) / 2;
+        if (_instance_list[mid]->instance_id() < inst_id) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    position = low;
+    return (low < _instance_list.size() && _instance_list[low]->instance_id() == inst_id);
+}
+
 const M2MObjectInstanceList& M2MObject::instances() const
 {
     return _instance_list;
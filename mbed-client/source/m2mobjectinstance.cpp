@@ -90,7 +90,7 @@ M2MResource* M2MObjectInstance::create_static_resource(const lwm2m_parameters_s*
             //if (multiple_instance) {
                 //res->set_coap_content_type(COAP_CONTENT_OMA_TLV_TYPE_OLD);
             //}
-            _resource_list.push_back(res);
+            add_resource(res);
         }
     }
     return res;
@@ -121,7 +121,7 @@ M2MResource* M2MObjectInstance::create_static_resource(const String &resource_na
                 if (multiple_instance) {
                     res->set_coap_content_type(COAP_CONTENT_OMA_TLV_TYPE_OLD);
                 }
-                _resource_list.push_back(res);
+                add_resource(res);
             }
         }
     }
@@ -145,7 +145,7 @@ M2MResource* M2MObjectInstance::create_dynamic_resource(const lwm2m_parameters_s
               //  res->set_coap_content_type(COAP_CONTENT_OMA_TLV_TYPE);
             //}
             res->add_observation_level(observation_level());
-            _resource_list.push_back(res);
+            add_resource(res);
         }
     }
     return res;
@@ -174,7 +174,7 @@ M2MResource* M2MObjectInstance::create_dynamic_resource(const String &resource_n
                     res->set_coap_content_type(COAP_CONTENT_OMA_TLV_TYPE_OLD);
                 }
                 res->add_observation_level(observation_level());
-                _resource_list.push_back(res);
+                add_resource(res);
             }
         }
     }
@@ -202,7 +202,7 @@ M2MResourceInstance* M2MObjectInstance::create_static_resource_instance(const St
             res = new M2MResource(*this, resource_name, M2MBase::Static, resource_type, convert_resource_type(type),
                                   value, value_length, path,
                                   true, external_blockwise_store);
-            _resource_list.push_back(res);
+            add_resource(res);
             res->set_operation(M2MBase::GET_ALLOWED);
             res->set_observable(false);
             res->set_register_uri(false);
@@ -242,7 +242,7 @@ M2MResourceInstance* M2MObjectInstance::create_dynamic_resource_instance(const S
         if (path) {
             res = new M2MResource(*this, resource_name, M2MBase::Dynamic, resource_type, convert_resource_type(type),
                                   false, path, true, external_blockwise_store);
-            _resource_list.push_back(res);
+            add_resource(res);
             res->set_register_uri(false);
             res->set_operation(M2MBase::GET_ALLOWED);
         }
@@ -273,21 +273,13 @@ bool M2MObjectInstance::remove_resource(const char *resource_name)
     tr_debug("M2MObjectInstance::remove_resource(resource_name %s)", resource_name);
 
     bool success = false;
-    if(!_resource_list.empty()) {
-         M2MResource* res = NULL;
-         M2MResourceList::const_iterator it;
-         it = _resource_list.begin();
-         int pos = 0;
-         for ( ; it != _resource_list.end(); it++, pos++ ) {
-             if(strcmp((*it)->name(), resource_name) == 0) {
-                // Resource found and deleted.
-                res = *it;
-                delete res;
-                _resource_list.erase(pos);
-                success = true;
-                break;
-             }
-         }
+    int pos;
+    if(find_resource(resource_name, pos)) {
+        // Resource found and deleted.
+        M2MResource* res = _resource_list[pos];
+        delete res;
+        _resource_list.erase(pos);
+        success = true;
     }
     return success;
 }
@@ -298,27 +290,14 @@ bool M2MObjectInstance::remove_resource_instance(const String &resource_name,
     tr_debug("M2MObjectInstance::remove_resource_instance(resource_name %s inst_id %d)",
              resource_name.c_str(), inst_id);
     bool success = false;
-    M2MResource *res = resource(resource_name);
-    if(res) {
-        M2MResourceInstanceList list = res->resource_instances();
-        M2MResourceInstanceList::const_iterator it;
-        it = list.begin();
-        for ( ; it != list.end(); it++) {
-            if((*it)->instance_id() == inst_id) {
-                success = res->remove_resource_instance(inst_id);
-                if(res->resource_instance_count() == 0) {
-                    M2MResourceList::const_iterator itr;
-                    itr = _resource_list.begin();
-                    int pos = 0;
-                    for ( ; itr != _resource_list.end(); itr++, pos++ ) {
-                        if(strcmp((*itr)->name(),resource_name.c_str()) == 0) {
-                            delete res;
-                            _resource_list.erase(pos);
-                            break;
-                        }
-                    }
-                }
-                break;
+    int pos;
+    if(find_resource(resource_name.c_str(), pos)) {
+        M2MResource *res = _resource_list[pos];
+        if(res->resource_instance(inst_id)) {
+            success = res->remove_resource_instance(inst_id);
+            if(res->resource_instance_count() == 0) {
+                delete res;
+                _resource_list.erase(pos);
             }
         }
     }
@@ -333,19 +312,47 @@ M2MResource* M2MObjectInstance::resource(const String &resource_name) const
 M2MResource* M2MObjectInstance::resource(const char *resource_name) const
 {
     M2MResource *res = NULL;
-    if(!_resource_list.empty()) {
-        M2MResourceList::const_iterator it;
-        it = _resource_list.begin();
-        for (; it!=_resource_list.end(); it++ ) {
-            if(strcmp((*it)->name(), resource_name) == 0) {
-                res = *it;
-                break;
-            }
-        }
+    int pos;
+    if(find_resource(resource_name, pos)) {
+        res = _resource_list[pos];
     }
     return res;
 }
 
+bool M2MObjectInstance::find_resource(const char *resource_name, int &position) const
+{
+    const int32_t id = name_to_id(resource_name);
+
+    // Binary search for the first resource with a name_id not less than id.
+    // Resources without an integer name share the id -1 at the start of the list.
+    int low = 0;
+    int high = _resource_list.size();
+    while (low < high) {
+        int mid = low + (high - low) / 2;
+        if (_resource_list[mid]->name_id() < id) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    position = low;
+
+    for (int pos = low; pos < _resource_list.size() && _resource_list[pos]->name_id() == id; pos++) {
+        if (strcmp(_resource_list[pos]->name(), resource_name) == 0) {
+            position = pos;
+            return true;
+        }
+    }
+    return false;
+}
+
+void M2MObjectInstance::add_resource(M2MResource *res)
+{
+    int position;
+    find_resource(res->name(), position);
+    _resource_list.insert(position, res);
+}
+
 const M2MResourceList& M2MObjectInstance::resources() const
 {
     return _resource_list;
@@ -0,0 +1,236 @@
+/*
+ * Copyright (c) 2017 ARM Limited. All rights reserved.
+ * SPDX-License-Identifier: Apache-2.0
+ * Licensed under the Apache License, Version 2.0 (the License); you may
+ * not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an AS IS BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stddef.h>
+#include "mbed-client/m2mtimer.h"
+#include "include/m2mobservationscheduler.h"
+#include "include/m2mreporthandler.h"
+#include "mbed-trace/mbed_trace.h"
+
+#define TRACE_GROUP "mClt"
+
+// The shared timer is never armed for longer than this, so that the
+// wrapping time source of the timer service is sampled often enough.
+#define MAX_ARM_INTERVAL 3600000
+
+M2MObservationScheduler *M2MObservationScheduler::_instance = NULL;
+
+M2MObservationScheduler::M2MObservationScheduler()
+: _timer(NULL),
+  _now(0),
+  _armed_deadline(0),
+  _last_time(0),
+  _users(0),
+  _armed(false),
+  _dispatching(false)
+{
+    _timer = new M2MTimer(*this);
+    _last_time = M2MTimer::get_time_ms();
+}
+
+M2MObservationScheduler::~M2MObservationScheduler()
+{
+    delete _timer;
+}
+
+void M2MObservationScheduler::attach()
+{
+    if (!_instance) {
+        _instance = new M2MObservationScheduler();
+    }
+    _instance->_users++;
+}
+
+void M2MObservationScheduler::detach()
+{
+    if (_instance && --_instance->_users == 0 && !_instance->_dispatching) {
+        // When the last user goes away in the middle of a dispatch the instance
+        // is deleted by timer_expired() once the dispatch is over.
+        delete _instance;
+        _instance = NULL;
+    }
+}
+
+bool M2MObservationScheduler::schedule(M2MReportHandler &handler, M2MTimerObserver::Type type, uint64_t interval)
+{
+    if (!_instance) {
+        return false;
+    }
+    // A zero interval must not expire within the dispatch that scheduled it.
+    if (interval == 0) {
+        interval = 1;
+    }
+    return _instance->insert(handler, type, _instance->current_time() + interval);
+}
+
+void M2MObservationScheduler::cancel(M2MReportHandler &handler, M2MTimerObserver::Type type)
+{
+    uint16_t &slot = slot_of(handler, type);
+    if (_instance && slot != NotScheduled) {
+        _instance->remove(slot);
+        _instance->arm_timer();
+    }
+}
+
+void M2MObservationScheduler::timer_expired(M2MTimerObserver::Type /*type*/)
+{
+    _armed = false;
+    _dispatching = true;
+    const uint64_t now = current_time();
+    while (!_heap.empty() && _heap[0].deadline <= now) {
+        Entry entry = _heap[0];
+        remove(slot_of(*entry.handler, entry.type));
+        entry.handler->timer_expired(entry.type);
+    }
+    _dispatching = false;
+    if (_users == 0) {
+        // The last user detached during the dispatch. The timer is single shot,
+        // so it is not used after this callback returns.
+        _instance = NULL;
+        delete this;
+        return;
+    }
+    arm_timer();
+}
+
+uint64_t M2MObservationScheduler::current_time()
+{
+    const uint32_t time = M2MTimer::get_time_ms();
+    _now += (uint32_t)(time - _last_time);
+    _last_time = time;
+    return _now;
+}
+
+bool M2MObservationScheduler::insert(M2MReportHandler &handler, M2MTimerObserver::Type type, uint64_t deadline)
+{
+    uint16_t &slot = slot_of(handler, type);
+    int position;
+    if (slot != NotScheduled) {
+        position = slot - 1;
+        const uint64_t previous = _heap[position].deadline;
+        _heap[position].deadline = deadline;
+        if (deadline < previous) {
+            sift_up(position);
+        } else {
+            sift_down(position);
+        }
+    } else {
+        if (_heap.size() >= UINT16_MAX) {
+            tr_error("M2MObservationScheduler::insert() - too many observations");
+            return false;
+        }
+        Entry entry;
+        entry.deadline = deadline;
+        entry.handler = &handler;
+        entry.type = type;
+        _heap.push_back(entry);
+        position = _heap.size() - 1;
+        slot = position + 1;
+        sift_up(position);
+    }
+    arm_timer();
+    return true;
+}
+
+void M2MObservationScheduler::remove(uint16_t &slot)
+{
+    const int position = slot - 1;
+    const int last = _heap.size() - 1;
+    slot = NotScheduled;
+    if (position != last) {
+        const Entry moved = _heap[last];
+        _heap.pop_back();
+        place(position, moved);
+        sift_up(position);
+        sift_down(position);
+    } else {
+        _heap.pop_back();
+    }
+}
+
+void M2MObservationScheduler::sift_up(int position)
+{
+    const Entry entry = _heap[position];
+    while (position > 0) {
+        const int parent = (position - 1) / 2;
+        if (_heap[parent].deadline <= entry.deadline) {
+            break;
+        }
+        place(position, _heap[parent]);
+        position = parent;
+    }
+    place(position, entry);
+}
+
+void M2MObservationScheduler::sift_down(int position)
+{
+    const Entry entry = _heap[position];
+    const int count = _heap.size();
+    for (;;) {
+        int child = 2 * position + 1;
+        if (child >= count) {
+            break;
+        }
+        if (child + 1 < count && _heap[child + 1].deadline < _heap[child].deadline) {
+            child++;
+        }
+        if (entry.deadline <= _heap[child].deadline) {
+            break;
+        }
+        place(position, _heap[child]);
+        position = child;
+    }
+    place(position, entry);
+}
+
+void M2MObservationScheduler::place(int position, const Entry &entry)
+{
+    _heap[position] = entry;
+    slot_of(*entry.handler, entry.type) = position + 1;
+}
+
+void M2MObservationScheduler::arm_timer()
+{
+    // The dispatch loop re-arms once all the expired deadlines are handled.
+    if (_dispatching) {
+        return;
+    }
+    if (_heap.empty()) {
+        if (_armed) {
+            _timer->stop_timer();
+            _armed = false;
+        }
+        return;
+    }
+    const uint64_t deadline = _heap[0].deadline;
+    if (_armed && _armed_deadline == deadline) {
+        return;
+    }
+    const uint64_t now = current_time();
+    uint64_t interval = deadline > now ? deadline - now : 0;
+    if (interval > MAX_ARM_INTERVAL) {
+        interval = MAX_ARM_INTERVAL;
+    }
+    _timer->stop_timer();
+    _timer->start_timer(interval, M2MTimerObserver::Notdefined, true);
+    _armed_deadline = deadline;
+    _armed = true;
+}
+
+uint16_t &M2MObservationScheduler::slot_of(M2MReportHandler &handler, M2MTimerObserver::Type type)
+{
+    return (type == M2MTimerObserver::PMinTimer) ? handler._pmin_slot : handler._pmax_slot;
+}
@@ -20,8 +20,9 @@
 
 #include "mbed-client/m2mreportobserver.h"
 #include "mbed-client/m2mconstants.h"
-#include "mbed-client/m2mtimer.h"
 #include "include/m2mreporthandler.h"
+#include "include/m2mobservationscheduler.h"
+#include "include/uriqueryparser.h"
 #include "mbed-trace/mbed_trace.h"
 #include <string.h>
 #include <stdlib.h>
@@ -38,8 +39,8 @@ M2MReportHandler::M2MReportHandler(M2MReportObserver &observer)
   _pmin_exceeded(false),
   _pmax_exceeded(false),
   _observation_number(0),
-  _pmin_timer(*this),
-  _pmax_timer(*this),
+  _pmin_slot(M2MObservationScheduler::NotScheduled),
+  _pmax_slot(M2MObservationScheduler::NotScheduled),
   _token(NULL),
   _pmax(-1.0f),
   _pmin(1.0f),
@@ -52,11 +53,15 @@ M2MReportHandler::M2MReportHandler(M2MReportObserver &observer)
   _last_value(-1.0f)
 {
     tr_debug("M2MReportHandler::M2MReportHandler()");
+    M2MObservationScheduler::attach();
 }
 
 M2MReportHandler::~M2MReportHandler()
 {
     tr_debug("M2MReportHandler::~M2MReportHandler()");
+    M2MObservationScheduler::cancel(*this, M2MTimerObserver::PMinTimer);
+    M2MObservationScheduler::cancel(*this, M2MTimerObserver::PMaxTimer);
+    M2MObservationScheduler::detach();
     free(_token);
 }
 
@@ -92,7 +97,7 @@ void M2MReportHandler::set_value(float value)
                     (_attribute_state & M2MReportHandler::Gt) == M2MReportHandler::Gt ||
                     (_attribute_state & M2MReportHandler::St) == M2MReportHandler::St) {
                 tr_debug("M2MReportHandler::set_value - stop pmin timer");
-                _pmin_timer.stop_timer();
+                M2MObservationScheduler::cancel(*this, M2MTimerObserver::PMinTimer);
                 _pmin_exceeded = true;
             }
         }
@@ -128,71 +133,84 @@ bool M2MReportHandler::parse_notification_attribute(const char *query,
                                                     M2MResourceInstance::ResourceType resource_type)
 {
     tr_debug("M2MReportHandler::parse_notification_attribute(Query %s, Base type %d)", query, (int)type);
-    bool success = false;
-    const char* sep_pos = strchr(query, '&');
-    const char* rest = query;
-    if( sep_pos != NULL ){
-        char query_options[5][20];
-        float pmin = _pmin;
-        float pmax = _pmax;
-        float lt = _lt;
-        float gt = _gt;
-        float st = _st;
-        float high = _high_step;
-        float low = _low_step;
-        uint8_t attr = _attribute_state;
-
-        memset(query_options, 0, sizeof(query_options[0][0]) * 5 * 20);
-        uint8_t num_options = 0;
-        while( sep_pos != NULL && num_options < 5){
-            size_t len = (size_t)(sep_pos-rest);
-            if( len > 19 ){
-                len = 19;
-            }
-            memcpy(query_options[num_options], rest, len);
-            sep_pos++;
-            rest = sep_pos;
-            sep_pos = strchr(rest, '&');
-            num_options++;
-        }
-        if( num_options < 5 && strlen(rest) > 0){
-            size_t len = (size_t)strlen(rest);
-            if( len > 19 ){
-                len = 19;
-            }
-            memcpy(query_options[num_options++], rest, len);
-        }
+    query_attribute_t attributes[QUERY_ATTRIBUTE_MAX_COUNT];
+    const int8_t count = query_attributes(query, attributes, QUERY_ATTRIBUTE_MAX_COUNT);
+    if (count <= 0) {
+        tr_debug("M2MReportHandler::parse_notification_attribute - not valid query");
+        return false;
+    }
 
-        for (int option = 0; option < num_options; option++) {
-            success = set_notification_attribute(query_options[option],type, resource_type);
-            if (!success) {
-                tr_debug("M2MReportHandler::parse_notification_attribute - break");
+    // Attributes are applied to copies first so that a rejected query
+    // leaves the current ones untouched.
+    int32_t pmin = _pmin;
+    int32_t pmax = _pmax;
+    float gt = _gt;
+    float lt = _lt;
+    float st = _st;
+    bool st_set = false;
+    uint8_t attribute_state = _attribute_state;
+
+    for (int8_t i = 0; i < count; i++) {
+        const float value = attributes[i].value;
+        switch (attributes[i].key) {
+            case QUERY_ATTRIBUTE_PMIN:
+                if (!attribute_to_int32(value, pmin)) {
+                    tr_debug("M2MReportHandler::parse_notification_attribute - invalid pmin");
+                    return false;
+                }
+                attribute_state |= M2MReportHandler::Pmin;
+                break;
+            case QUERY_ATTRIBUTE_PMAX:
+                if (!attribute_to_int32(value, pmax)) {
+                    tr_debug("M2MReportHandler::parse_notification_attribute - invalid pmax");
+                    return false;
+                }
+                attribute_state |= M2MReportHandler::Pmax;
+                break;
+            case QUERY_ATTRIBUTE_GT:
+            case QUERY_ATTRIBUTE_LT:
+            case QUERY_ATTRIBUTE_ST:
+                if (M2MBase::Resource != type) {
+                    tr_debug("M2MReportHandler::parse_notification_attribute - gt, lt and st are for resources only");
+                    return false;
+                }
+                if (attributes[i].key == QUERY_ATTRIBUTE_GT) {
+                    gt = value;
+                    attribute_state |= M2MReportHandler::Gt;
+                } else if (attributes[i].key == QUERY_ATTRIBUTE_LT) {
+                    lt = value;
+                    attribute_state |= M2MReportHandler::Lt;
+                } else {
+                    st = value;
+                    st_set = true;
+                    attribute_state |= M2MReportHandler::St;
+                }
                 break;
-            }
         }
+    }
 
-        if(success) {
-             success = check_attribute_validity();
-        }
-        else {
-            tr_debug("M2MReportHandler::parse_notification_attribute - not valid query");
-            _pmin = pmin;
-            _pmax = pmax;
-            _st = st;
-            _lt = lt;
-            _gt = gt;
-            _high_step = high;
-            _low_step = low;
-            _attribute_state = attr;
-        }
+    // Return false if try to set gt,lt or st when the resource type is something else than numerical
+    if ((resource_type != M2MResourceInstance::INTEGER &&
+            resource_type != M2MResourceInstance::FLOAT) &&
+            (attribute_state & (M2MReportHandler::Gt | M2MReportHandler::Lt | M2MReportHandler::St))) {
+        tr_debug("M2MReportHandler::parse_notification_attribute - not numerical resource");
+        return false;
     }
-    else {
-        if(set_notification_attribute(query, type, resource_type)) {
-            success = check_attribute_validity();
-        }
+
+    _pmin = pmin;
+    _pmax = pmax;
+    _gt = gt;
+    _lt = lt;
+    _st = st;
+    if (st_set) {
+        _high_step = _current_value + _st;
+        _low_step = _current_value - _st;
     }
+    _attribute_state = attribute_state;
+    tr_info("M2MReportHandler::parse_notification_attribute pmin %" PRId32 " pmax %" PRId32 " gt %f lt %f st %f",
+            _pmin, _pmax, _gt, _lt, _st);
 
-    return success;
+    return check_attribute_validity();
 }
 
 void M2MReportHandler::timer_expired(M2MTimerObserver::Type type)
@@ -222,73 +240,15 @@ void M2MReportHandler::timer_expired(M2MTimerObserver::Type type)
     }
 }
 
-bool M2MReportHandler::set_notification_attribute(const char* option,
-                                                  M2MBase::BaseType type,
-                                                  M2MResourceInstance::ResourceType resource_type)
+bool M2MReportHandler::attribute_to_int32(float value, int32_t &result)
 {
-    tr_debug("M2MReportHandler::set_notification_attribute()");
-    bool success = false;
-    char attribute[20];
-    char value[20];
-    memset(&attribute, 0, 20);
-    memset(&value, 0, 20);
-
-    const char* pos = strstr(option, EQUAL);
-    if( pos != NULL ){
-        memcpy(attribute, option, (size_t)(pos-option));
-        pos++;
-        memcpy(value, pos, strlen(pos));
-    }else{
-        memcpy(attribute, option, (size_t)strlen(option) + 1);
-    }
-
-    if (strlen(value)) {
-        if (strcmp(attribute, PMIN) == 0) {
-           _pmin = atoi(value);
-            success = true;
-            _attribute_state |= M2MReportHandler::Pmin;
-            tr_info("M2MReportHandler::set_notification_attribute %s to %" PRId32, attribute, _pmin);
-        }
-        else if(strcmp(attribute, PMAX) == 0) {
-            _pmax = atoi(value);
-            success = true;
-            _attribute_state |= M2MReportHandler::Pmax;
-            tr_info("M2MReportHandler::set_notification_attribute %s to %" PRId32, attribute, _pmax);
-        }
-        else if(strcmp(attribute, GT) == 0 &&
-                (M2MBase::Resource == type)){
-            _gt = atof(value);
-            success = true;
-            _attribute_state |= M2MReportHandler::Gt;
-            tr_info("M2MReportHandler::set_notification_attribute %s to %f", attribute, _gt);
-        }
-        else if(strcmp(attribute, LT) == 0 &&
-                (M2MBase::Resource == type)){
-            _lt = atof(value);
-            success = true;
-            _attribute_state |= M2MReportHandler::Lt;
-            tr_info("M2MReportHandler::set_notification_attribute %s to %f", attribute, _lt);
-        }
-        else if((strcmp(attribute, ST_SIZE) == 0 || (strcmp(attribute, STP) == 0))
-                && (M2MBase::Resource == type)){
-            _st = atof(value);
-            success = true;
-            _high_step = _current_value + _st;
-            _low_step = _current_value - _st;
-            _attribute_state |= M2MReportHandler::St;
-            tr_info("M2MReportHandler::set_notification_attribute %s to %f", attribute, _st);
-        }
-        // Return false if try to set gt,lt or st when the resource type is something else than numerical
-        if ((resource_type != M2MResourceInstance::INTEGER &&
-                resource_type != M2MResourceInstance::FLOAT) &&
-                ((_attribute_state & M2MReportHandler::Gt) == M2MReportHandler::Gt ||
-                (_attribute_state & M2MReportHandler::Lt) == M2MReportHandler::Lt ||
-                (_attribute_state & M2MReportHandler::St) == M2MReportHandler::St)) {
-            tr_debug("M2MReportHandler::set_notification_attribute - not numerical resource");
-            success = false;
-        }
+    // pmin and pmax are whole seconds
+    if (!(value >= -2147483648.0f && value < 2147483648.0f) ||
+            value != (float)(int32_t)value) {
+        return false;
     }
-    return success;
+    result = (int32_t)value;
+    return true;
 }
 
 void M2MReportHandler::schedule_report()
@@ -320,7 +280,7 @@ void M2MReportHandler::report()
         }
         _observer.observation_to_be_sent(_changed_instance_ids, observation_number());
         _changed_instance_ids.clear();
-        _pmax_timer.stop_timer();
+        M2MObservationScheduler::cancel(*this, M2MTimerObserver::PMaxTimer);
     }
     else {
         if (_pmax_exceeded) {
@@ -352,18 +312,18 @@ void M2MReportHandler::handle_timers()
             _pmin_exceeded = false;
             time_interval = (uint64_t) ((uint64_t)_pmin * 1000);
             tr_debug("M2MReportHandler::handle_timers() - Start PMIN interval: %d", (int)time_interval);
-            _pmin_timer.start_timer(time_interval,
-                                     M2MTimerObserver::PMinTimer,
-                                     true);
+            if (!M2MObservationScheduler::schedule(*this, M2MTimerObserver::PMinTimer, time_interval)) {
+                tr_error("M2MReportHandler::handle_timers() - failed to schedule PMIN");
+            }
         }
     }
     if ((_attribute_state & M2MReportHandler::Pmax) == M2MReportHandler::Pmax) {
         if (_pmax > 0) {
             time_interval = (uint64_t) ((uint64_t)_pmax * 1000);
             tr_debug("M2MReportHandler::handle_timers() - Start PMAX interval: %d", (int)time_interval);
-            _pmax_timer.start_timer(time_interval,
-                                     M2MTimerObserver::PMaxTimer,
-                                     true);
+            if (!M2MObservationScheduler::schedule(*this, M2MTimerObserver::PMaxTimer, time_interval)) {
+                tr_error("M2MReportHandler::handle_timers() - failed to schedule PMAX");
+            }
         }
     }
 }
@@ -388,10 +348,10 @@ void M2MReportHandler::stop_timers()
     tr_debug("M2MReportHandler::stop_timers()");
 
     _pmin_exceeded = false;
-    _pmin_timer.stop_timer();
+    M2MObservationScheduler::cancel(*this, M2MTimerObserver::PMinTimer);
 
     _pmax_exceeded = false;
-    _pmax_timer.stop_timer();
+    M2MObservationScheduler::cancel(*this, M2MTimerObserver::PMaxTimer);
 
     tr_debug("M2MReportHandler::stop_timers() - out");
 }
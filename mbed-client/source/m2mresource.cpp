@@ -163,21 +163,13 @@ bool M2MResource::remove_resource_instance(uint16_t inst_id)
 {
     tr_debug("M2MResource::remove_resource(inst_id %d)", inst_id);
     bool success = false;
-    if(!_resource_instance_list.empty()) {
-        M2MResourceInstance* res = NULL;
-        M2MResourceInstanceList::const_iterator it;
-        it = _resource_instance_list.begin();
-        int pos = 0;
-        for ( ; it != _resource_instance_list.end(); it++, pos++ ) {
-            if(((*it)->instance_id() == inst_id)) {
-                // Resource found and deleted.
-                res = *it;
-                delete res;
-                _resource_instance_list.erase(pos);
-                success = true;
-                break;
-            }
-        }
+    int pos;
+    if(find_resource_instance(inst_id, pos)) {
+        // Resource found and deleted.
+        M2MResourceInstance* res = _resource_instance_list[pos];
+        delete res;
+        _resource_instance_list.erase(pos);
+        success = true;
     }
     return success;
 }
@@ -186,20 +178,32 @@ M2MResourceInstance* M2MResource::resource_instance(uint16_t inst_id) const
 {
     tr_debug("M2MResource::resource(resource_name inst_id %d)", inst_id);
     M2MResourceInstance *res = NULL;
-    if(!_resource_instance_list.empty()) {
-        M2MResourceInstanceList::const_iterator it;
-        it = _resource_instance_list.begin();
-        for ( ; it != _resource_instance_list.end(); it++ ) {
-            if(((*it)->instance_id() == inst_id)) {
-                // Resource found.
-                res = *it;
-                break;
-            }
-        }
+    int pos;
+    if(find_resource_instance(inst_id, pos)) {
+        // Resource found.
+        res = _resource_instance_list[pos];
     }
     return res;
 }
 
+bool M2MResource::find_resource_instance(uint16_t inst_id, int &position) const
+{
+    // Binary search for the first instance with an ID not less than inst_id
+    int low = 0;
+    int high = _resource_instance_list.size();
+    while (low < high) {
+        int mid = low + (high - low) / 2;
+        if (_resource_instance_list[mid]->instance_id() < inst_id) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    position = low;
+    return (low < _resource_instance_list.size() &&
+            _resource_instance_list[low]->instance_id() == inst_id);
+}
+
 const M2MResourceInstanceList& M2MResource::resource_instances() const
 {
     return _resource_instance_list;
@@ -298,7 +302,9 @@ void M2MResource::add_resource_instance(M2MResourceInstance *res)
 {
     tr_debug("M2MResource::add_resource_instance()");
     if(res) {
-        _resource_instance_list.push_back(res);
+        int position;
+        find_resource_instance(res->instance_id(), position);
+        _resource_instance_list.insert(position, res);
     }
 }
 
@@ -42,6 +42,9 @@
 
 #define TRACE_GROUP "mClt"
 
+// "%f" of -FLT_MAX is a sign, 39 integer digits and ".000000", plus zero termination
+#define FLOAT_STRING_BUFFER_SIZE 48
+
 M2MResourceBase::M2MResourceBase(
                                          const String &res_name,
                                          M2MBase::Mode resource_mode,
@@ -59,10 +62,15 @@ M2MResourceBase::M2MResourceBase(
           external_blockwise_store,
           multiple_instance,
           type)
+#ifdef MBED_CLIENT_TYPED_RESOURCE_VALUE
+ ,_native_value_valid(false),
+  _text_value_stale(false)
+#endif
 #ifndef DISABLE_BLOCK_MESSAGE
- ,_block_message_data(NULL),
+ ,_block_message_data(NULL)
 #endif
-  _notification_status(M2MResourceBase::INIT)
+ ,_value_capacity(0)
+ ,_notification_status(M2MResourceBase::INIT)
 {
 }
 
@@ -85,16 +93,22 @@ M2MResourceBase::M2MResourceBase(
           external_blockwise_store,
           multiple_instance,
           type)
+#ifdef MBED_CLIENT_TYPED_RESOURCE_VALUE
+ ,_native_value_valid(false),
+  _text_value_stale(false)
+#endif
 #ifndef DISABLE_BLOCK_MESSAGE
- ,_block_message_data(NULL),
+ ,_block_message_data(NULL)
 #endif
- _notification_status(M2MResourceBase::INIT)
+ ,_value_capacity(0)
+ ,_notification_status(M2MResourceBase::INIT)
 {
     M2MBase::set_base_type(M2MBase::ResourceInstance);
     if( value != NULL && value_length > 0 ) {
         sn_nsdl_dynamic_resource_parameters_s* res = get_nsdl_resource();
         res->resource = alloc_string_copy(value, value_length);
         res->resourcelen = value_length;
+        _value_capacity = res->resource ? value_length : 0;
     }
 }
 
@@ -102,10 +116,15 @@ M2MResourceBase::M2MResourceBase(
                                          const lwm2m_parameters_s* s,
                                          M2MBase::DataType /*type*/)
 : M2MBase(s)
+#ifdef MBED_CLIENT_TYPED_RESOURCE_VALUE
+ ,_native_value_valid(false),
+  _text_value_stale(false)
+#endif
 #ifndef DISABLE_BLOCK_MESSAGE
-  ,_block_message_data(NULL),
+ ,_block_message_data(NULL)
 #endif
-  _notification_status(M2MResourceBase::INIT)
+ ,_value_capacity(0)
+ ,_notification_status(M2MResourceBase::INIT)
 {
     // we are not there yet for this check as this is called from M2MResource(): assert(base_type() == M2MBase::ResourceInstance);
 }
@@ -122,6 +141,10 @@ M2MResourceBase::~M2MResourceBase()
                                                         M2MCallbackAssociation::M2MResourceInstanceIncomingBlockMessageCallback);
     delete in_callback;
 
+    incoming_block_sink_callback *sink_callback = (incoming_block_sink_callback*)M2MCallbackStorage::remove_callback(*this,
+                                                        M2MCallbackAssociation::M2MResourceInstanceIncomingBlockSinkCallback);
+    delete sink_callback;
+
     outgoing_block_message_callback *out_callback = (outgoing_block_message_callback*)M2MCallbackStorage::remove_callback(*this,
                                                         M2MCallbackAssociation::M2MResourceInstanceOutgoingBlockMessageCallback);
     delete out_callback;
@@ -173,10 +196,14 @@ bool M2MResourceBase::set_execute_function(execute_callback_2 callback)
 void M2MResourceBase::clear_value()
 {
     tr_debug("M2MResourceBase::clear_value");
+#ifdef MBED_CLIENT_TYPED_RESOURCE_VALUE
+    clear_native_value();
+#endif
     sn_nsdl_dynamic_resource_parameters_s* res = get_nsdl_resource();
     free(res->resource);
     res->resource = NULL;
     res->resourcelen = 0;
+    _value_capacity = 0;
 
     report();
 }
@@ -184,6 +211,22 @@ void M2MResourceBase::clear_value()
 bool M2MResourceBase::set_value(int64_t value)
 {
     bool success;
+#ifdef MBED_CLIENT_TYPED_RESOURCE_VALUE
+    if (uses_native_value() && resource_instance_type() != M2MResourceBase::FLOAT) {
+        bool changed = !_native_value_valid || _native_value.int_value != value;
+        if (changed && !_native_value_valid) {
+            // Compare against the current text value, if there is one
+            changed = !value_length() || get_value_int() != value;
+        }
+        _native_value.int_value = value;
+        _native_value_valid = true;
+        _text_value_stale = true;
+        if (changed) {
+            report_value_change();
+        }
+        return true;
+    }
+#endif
     // max len of "-9223372036854775808" plus zero termination
     char buffer[20+1];
     uint32_t size = m2m::itoa_c(value, buffer);
@@ -193,6 +236,33 @@ bool M2MResourceBase::set_value(int64_t value)
     return success;
 }
 
+bool M2MResourceBase::set_value_float(float value)
+{
+    bool success;
+#ifdef MBED_CLIENT_TYPED_RESOURCE_VALUE
+    if (uses_native_value() && resource_instance_type() == M2MResourceBase::FLOAT) {
+        bool changed = !_native_value_valid || _native_value.float_value != value;
+        if (changed && !_native_value_valid) {
+            changed = !value_length() || get_value_float() != value;
+        }
+        _native_value.float_value = value;
+        _native_value_valid = true;
+        _text_value_stale = true;
+        if (changed) {
+            report_value_change();
+        }
+        return true;
+    }
+#endif
+    char buffer[FLOAT_STRING_BUFFER_SIZE];
+    int size = snprintf(buffer, sizeof(buffer), "%f", value);
+
+    success = (size > 0) && ((size_t)size < sizeof(buffer)) &&
+              set_value((const uint8_t*)buffer, (uint32_t)size);
+
+    return success;
+}
+
 bool M2MResourceBase::set_value(const uint8_t *value,
                                 const uint32_t value_length)
 {
@@ -200,20 +270,37 @@ bool M2MResourceBase::set_value(const uint8_t *value,
     bool success = false;
     bool changed = has_value_changed(value,value_length);
     if( value != NULL && value_length > 0 ) {
-        sn_nsdl_dynamic_resource_parameters_s* res = get_nsdl_resource();
+#ifdef MBED_CLIENT_TYPED_RESOURCE_VALUE
+        clear_native_value();
+#endif
+        success = store_value(value, value_length);
+        if (success && changed) {
+            report_value_change();
+        }
+    }
+    return success;
+}
+
+bool M2MResourceBase::store_value(const uint8_t *value,
+                                  const uint32_t value_length)
+{
+    sn_nsdl_dynamic_resource_parameters_s* res = get_nsdl_resource();
+    if (res->resource && value_length <= _value_capacity) {
+        // New value fits into the buffer allocated by alloc_string_copy(),
+        // which also has room for the terminator, overwrite it in place.
+        memmove(res->resource, value, value_length);
+        res->resource[value_length] = '\0';
+    } else {
         free(res->resource);
-        res->resource = NULL;
         res->resourcelen = 0;
         res->resource = alloc_string_copy(value, value_length);
-        if(res->resource) {
-            success = true;
-            res->resourcelen = value_length;
-            if (changed) {
-                report_value_change();
-            }
-        }
+        _value_capacity = res->resource ? value_length : 0;
     }
-    return success;
+    if (res->resource) {
+        res->resourcelen = value_length;
+        return true;
+    }
+    return false;
 }
 
 bool M2MResourceBase::set_value_raw(uint8_t *value,
@@ -224,11 +311,15 @@ bool M2MResourceBase::set_value_raw(uint8_t *value,
     bool success = false;
     bool changed = has_value_changed(value,value_length);
     if( value != NULL && value_length > 0 ) {
+#ifdef MBED_CLIENT_TYPED_RESOURCE_VALUE
+        clear_native_value();
+#endif
         success = true;
         sn_nsdl_dynamic_resource_parameters_s* res = get_nsdl_resource();
         free(res->resource);
         res->resource = value;
         res->resourcelen = value_length;
+        _value_capacity = 0;
         if (changed) {
             report_value_change();
         }
@@ -236,6 +327,50 @@ bool M2MResourceBase::set_value_raw(uint8_t *value,
     return success;
 }
 
+#ifdef MBED_CLIENT_TYPED_RESOURCE_VALUE
+bool M2MResourceBase::uses_native_value() const
+{
+    // Static resources are served directly from the nsdl buffer by mbed-client-c.
+    if (M2MBase::Static == mode()) {
+        return false;
+    }
+    switch (resource_instance_type()) {
+        case M2MResourceBase::INTEGER:
+        case M2MResourceBase::BOOLEAN:
+        case M2MResourceBase::TIME:
+        case M2MResourceBase::FLOAT:
+            return true;
+        default:
+            return false;
+    }
+}
+
+void M2MResourceBase::render_value()
+{
+    if (!_text_value_stale) {
+        return;
+    }
+    char buffer[FLOAT_STRING_BUFFER_SIZE];
+    uint32_t size;
+    if (resource_instance_type() == M2MResourceBase::FLOAT) {
+        int len = snprintf(buffer, sizeof(buffer), "%f", _native_value.float_value);
+        size = (len > 0 && (size_t)len < sizeof(buffer)) ? (uint32_t)len : 0;
+    } else {
+        size = m2m::itoa_c(_native_value.int_value, buffer);
+    }
+    // On allocation failure the text stays stale and rendering is retried on next access
+    if (size > 0 && store_value((const uint8_t*)buffer, size)) {
+        _text_value_stale = false;
+    }
+}
+
+void M2MResourceBase::clear_native_value()
+{
+    _native_value_valid = false;
+    _text_value_stale = false;
+}
+#endif
+
 void M2MResourceBase::report()
 {
     M2MBase::Observation observation_level = M2MBase::observation_level();
@@ -268,12 +403,7 @@ void M2MResourceBase::report()
              (observation_level != M2MBase::None)) {
             M2MReportHandler *report_handler = M2MBase::report_handler();
             if (report_handler && is_observable()) {
-                sn_nsdl_dynamic_resource_parameters_s* res = get_nsdl_resource();
-                if(res->resource) {
-                    report_handler->set_value(atof((const char*)res->resource));
-                } else {
-                    report_handler->set_value(0);
-                }
+                report_handler->set_value(get_value_float());
             }
         }
         else {
@@ -292,7 +422,9 @@ void M2MResourceBase::report()
         }
     } else {
         if (is_observable()) {
-            tr_warn("M2MResourceBase::report() - resource %s is observable but not yet subscribed!", uri_path());
+            char path_buffer[SN_NSDL_PATH_BUFFER_SIZE];
+            tr_warn("M2MResourceBase::report() - resource %s is observable but not yet subscribed!", uri_path(path_buffer));
+            (void) path_buffer;
         }
         tr_debug("M2MResourceBase::report() - mode = %d, is_observable = %d", mode(), is_observable());
     }
@@ -301,6 +433,9 @@ void M2MResourceBase::report()
 bool M2MResourceBase::has_value_changed(const uint8_t* value, const uint32_t value_len)
 {
     bool changed = false;
+#ifdef MBED_CLIENT_TYPED_RESOURCE_VALUE
+    render_value();
+#endif
     sn_nsdl_dynamic_resource_parameters_s* res = get_nsdl_resource();
 
     if(value_len != res->resourcelen) {
@@ -356,6 +491,9 @@ void M2MResourceBase::get_value(uint8_t *&value, uint32_t &value_length)
         free(value);
         value = NULL;
     }
+#ifdef MBED_CLIENT_TYPED_RESOURCE_VALUE
+    render_value();
+#endif
     sn_nsdl_dynamic_resource_parameters_s* res = get_nsdl_resource();
     if(res->resource && res->resourcelen > 0) {
         value = alloc_string_copy(res->resource, res->resourcelen);
@@ -368,6 +506,14 @@ void M2MResourceBase::get_value(uint8_t *&value, uint32_t &value_length)
 int64_t M2MResourceBase::get_value_int() const
 {
     int64_t value_int = 0;
+#ifdef MBED_CLIENT_TYPED_RESOURCE_VALUE
+    if (_native_value_valid) {
+        if (resource_instance_type() == M2MResourceBase::FLOAT) {
+            return (int64_t)_native_value.float_value;
+        }
+        return _native_value.int_value;
+    }
+#endif
 
     // XXX: this relies on having a zero terminated value?!
     const char *value_string = (char *)value();
@@ -377,10 +523,33 @@ int64_t M2MResourceBase::get_value_int() const
     return value_int;
 }
 
+float M2MResourceBase::get_value_float() const
+{
+    float value_float = 0;
+#ifdef MBED_CLIENT_TYPED_RESOURCE_VALUE
+    if (_native_value_valid) {
+        if (resource_instance_type() == M2MResourceBase::FLOAT) {
+            return _native_value.float_value;
+        }
+        return (float)_native_value.int_value;
+    }
+#endif
+
+    const char *value_string = (char *)value();
+    if (value_string) {
+        value_float = atof(value_string);
+    }
+    return value_float;
+}
+
 String M2MResourceBase::get_value_string() const
 {
     // XXX: do a better constructor to avoid pointless malloc
     String value;
+#ifdef MBED_CLIENT_TYPED_RESOURCE_VALUE
+    // Rendering the text of a native value only fills the nsdl buffer the getters read
+    const_cast<M2MResourceBase*>(this)->render_value();
+#endif
     if (get_nsdl_resource()->resource) {
         value.append_raw((char*)get_nsdl_resource()->resource, get_nsdl_resource()->resourcelen);
     }
@@ -389,11 +558,17 @@ String M2MResourceBase::get_value_string() const
 
 uint8_t* M2MResourceBase::value() const
 {
+#ifdef MBED_CLIENT_TYPED_RESOURCE_VALUE
+    const_cast<M2MResourceBase*>(this)->render_value();
+#endif
     return get_nsdl_resource()->resource;
 }
 
 uint32_t M2MResourceBase::value_length() const
 {
+#ifdef MBED_CLIENT_TYPED_RESOURCE_VALUE
+    const_cast<M2MResourceBase*>(this)->render_value();
+#endif
     return get_nsdl_resource()->resourcelen;
 }
 
@@ -559,12 +734,25 @@ sn_coap_hdr_s* M2MResourceBase::handle_put_request(nsdl_s *nsdl,
             } else {
 #ifndef DISABLE_BLOCK_MESSAGE
                 if (block_message()) {
-                    block_message()->set_message_info(received_coap_header);
+                    // A sink takes the payload of the CoAP message as it is, without a copy
+                    incoming_block_sink_callback* incoming_block_sink_cb = (incoming_block_sink_callback*)M2MCallbackStorage::get_callback(*this,
+                                                                            M2MCallbackAssociation::M2MResourceInstanceIncomingBlockSinkCallback);
+                    block_message()->set_message_info(received_coap_header, (incoming_block_sink_cb == NULL));
                     if (block_message()->is_block_message()) {
-                        incoming_block_message_callback* incoming_block_message_cb = (incoming_block_message_callback*)M2MCallbackStorage::get_callback(*this,
-                                                                                M2MCallbackAssociation::M2MResourceInstanceIncomingBlockMessageCallback);
-                        if (incoming_block_message_cb) {
-                            (*incoming_block_message_cb)(_block_message_data);
+                        if (incoming_block_sink_cb) {
+                            if (block_message()->error_code() == M2MBlockMessage::ErrorNone &&
+                                !(*incoming_block_sink_cb)(_block_message_data)) {
+                                tr_error("M2MResourceBase::handle_put_request() - block rejected by the sink");
+                                msg_code = COAP_MSG_CODE_RESPONSE_INTERNAL_SERVER_ERROR;
+                                block_message()->clear_values();
+                            }
+                            block_message()->clear_block_data();
+                        } else {
+                            incoming_block_message_callback* incoming_block_message_cb = (incoming_block_message_callback*)M2MCallbackStorage::get_callback(*this,
+                                                                                    M2MCallbackAssociation::M2MResourceInstanceIncomingBlockMessageCallback);
+                            if (incoming_block_message_cb) {
+                                (*incoming_block_message_cb)(_block_message_data);
+                            }
                         }
                         if (block_message()->is_last_block()) {
                             block_message()->clear_values();
@@ -578,11 +766,13 @@ sn_coap_hdr_s* M2MResourceBase::handle_put_request(nsdl_s *nsdl,
                     }
                 }
 #endif
+                char path_buffer[SN_NSDL_PATH_BUFFER_SIZE];
+                const char *path = uri_path(path_buffer);
                 // Firmware object uri path is limited to be max 255 bytes
-                if ((strcmp(uri_path(), FIRMAWARE_PACKAGE_URI_PATH) == 0) &&
+                if ((strcmp(path, FIRMAWARE_PACKAGE_URI_PATH) == 0) &&
                     received_coap_header->payload_len > 255) {
                     msg_code = COAP_MSG_CODE_RESPONSE_NOT_ACCEPTABLE;
-                } else if ((strcmp(uri_path(), SERVER_LIFETIME_PATH) == 0)) {
+                } else if ((strcmp(path, SERVER_LIFETIME_PATH) == 0)) {
                     // Check that lifetime can't go below 60s
                     char *query = (char*)alloc_string_copy(received_coap_header->payload_ptr,
                                                            received_coap_header->payload_len);
@@ -649,6 +839,23 @@ bool M2MResourceBase::set_incoming_block_message_callback(incoming_block_message
                                             M2MCallbackAssociation::M2MResourceInstanceIncomingBlockMessageCallback);
 }
 
+bool M2MResourceBase::set_incoming_block_sink_callback(incoming_block_sink_callback callback)
+{
+    incoming_block_sink_callback* old_callback = (incoming_block_sink_callback*)M2MCallbackStorage::remove_callback(*this,
+                                                        M2MCallbackAssociation::M2MResourceInstanceIncomingBlockSinkCallback);
+    delete old_callback;
+
+    incoming_block_sink_callback* new_callback = new incoming_block_sink_callback(callback);
+
+    if (!_block_message_data) {
+        _block_message_data = new M2MBlockMessage();
+    }
+
+    return M2MCallbackStorage::add_callback(*this,
+                                            new_callback,
+                                            M2MCallbackAssociation::M2MResourceInstanceIncomingBlockSinkCallback);
+}
+
 bool M2MResourceBase::set_outgoing_block_message_callback(outgoing_block_message_callback callback)
 {
     outgoing_block_message_callback *old_callback = (outgoing_block_message_callback*)M2MCallbackStorage::remove_callback(*this,
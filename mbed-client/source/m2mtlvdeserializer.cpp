@@ -53,6 +53,11 @@ bool M2MTLVDeserializer::is_resource_instance(const uint8_t *tlv)
     return is_resource_instance(tlv, 0);
 }
 
+/* All deserialize_* methods are run twice over the payload. The first pass
+ * (update_value == false) only checks the structure and the permissions and
+ * does not touch the object tree, the second pass applies the values. Values
+ * are read through TLVIterator views directly from the CoAP payload. */
+
 M2MTLVDeserializer::Error M2MTLVDeserializer::deserialise_object_instances(const uint8_t* tlv,
                                                                            uint32_t tlv_size,
                                                                            M2MObject &object,
@@ -61,9 +66,9 @@ M2MTLVDeserializer::Error M2MTLVDeserializer::deserialise_object_instances(const
     M2MTLVDeserializer::Error error = M2MTLVDeserializer::None;
     if (is_object_instance(tlv) ) {
         tr_debug("M2MTLVDeserializer::deserialise_object_instances");
-        error = deserialize_object_instances(tlv, tlv_size, 0, object,operation,false);
+        error = deserialize_object_instances(tlv, tlv_size, object, operation, false);
         if(M2MTLVDeserializer::None == error) {
-            error = deserialize_object_instances(tlv, tlv_size, 0, object,operation,true);
+            error = deserialize_object_instances(tlv, tlv_size, object, operation, true);
         }
     } else {
         tr_debug("M2MTLVDeserializer::deserialise_object_instances ::NotValid");
@@ -81,12 +86,12 @@ M2MTLVDeserializer::Error M2MTLVDeserializer::deserialize_resources(const uint8_
     if (!is_resource(tlv) && !is_multiple_resource(tlv)) {
         error = M2MTLVDeserializer::NotValid;
     } else {
-        error = deserialize_resources(tlv, tlv_size, 0, object_instance, operation,false);
+        error = deserialize_resources(tlv, tlv_size, object_instance, operation, false);
         if(M2MTLVDeserializer::None == error) {
             if (M2MTLVDeserializer::Put == operation) {
-                remove_resources(tlv, tlv_size, object_instance, 0);
+                remove_resources(tlv, tlv_size, object_instance);
             }
-            error = deserialize_resources(tlv, tlv_size, 0, object_instance, operation,true);
+            error = deserialize_resources(tlv, tlv_size, object_instance, operation, true);
         }
     }
     return error;
@@ -98,30 +103,17 @@ M2MTLVDeserializer::Error M2MTLVDeserializer::deserialize_resource_instances(con
                                                                              M2MTLVDeserializer::Operation operation)
 {
     M2MTLVDeserializer::Error error = M2MTLVDeserializer::None;
-    if (!is_multiple_resource(tlv)) {
+    TLVIterator it(tlv, tlv_size);
+    if (!is_multiple_resource(tlv) || !it.next()) {
         error = M2MTLVDeserializer::NotValid;
     } else {
         tr_debug("M2MTLVDeserializer::deserialize_resource_instances()");
-        uint8_t offset = 2;
-
-        ((tlv[0] & 0x20) == 0) ? offset : offset++;
-
-        uint8_t length = tlv[0] & 0x18;
-        if(length == 0x08) {
-            offset += 1;
-        } else if(length == 0x10) {
-            offset += 2;
-        } else if(length == 0x18) {
-            offset += 3;
-        }
-
-        tr_debug("M2MTLVDeserializer::deserialize_resource_instances() Offset %d", offset);
-        error = deserialize_resource_instances(tlv, tlv_size, offset, resource, operation,false);
+        error = deserialize_resource_instances(it._value, it._length, resource, operation, false);
         if(M2MTLVDeserializer::None == error) {
             if (M2MTLVDeserializer::Put == operation) {
-                remove_resource_instances(tlv, tlv_size, resource, offset);
+                remove_resource_instances(it._value, it._length, resource);
             }
-            error = deserialize_resource_instances(tlv, tlv_size, offset, resource, operation,true);
+            error = deserialize_resource_instances(it._value, it._length, resource, operation, true);
         }
     }
     return error;
@@ -129,237 +121,166 @@ M2MTLVDeserializer::Error M2MTLVDeserializer::deserialize_resource_instances(con
 
 M2MTLVDeserializer::Error M2MTLVDeserializer::deserialize_object_instances(const uint8_t *tlv,
                                                                            uint32_t tlv_size,
-                                                                           uint32_t offset,
                                                                            M2MObject &object,
                                                                            M2MTLVDeserializer::Operation operation,
                                                                            bool update_value)
 {
     tr_debug("M2MTLVDeserializer::deserialize_object_instances()");
     M2MTLVDeserializer::Error error = M2MTLVDeserializer::None;
-    TypeIdLength til(tlv, offset);
-    til.deserialize();
-    offset = til._offset;
-
-    const M2MObjectInstanceList &list = object.instances();
-    M2MObjectInstanceList::const_iterator it;
-    it = list.begin();
+    TLVIterator it(tlv, tlv_size);
 
-    if (TYPE_OBJECT_INSTANCE == til._type) {
-        for (; it!=list.end(); it++) {
-            if((*it)->instance_id() == til._id) {
-                error = deserialize_resources(tlv, tlv_size, offset, (**it),operation, update_value);
-            }
+    while (M2MTLVDeserializer::None == error && it.next()) {
+        if (TYPE_OBJECT_INSTANCE != it._type) {
+            error = M2MTLVDeserializer::NotValid;
+            break;
         }
-        offset += til._length;
-
-        if(offset < tlv_size) {
-            error = deserialize_object_instances(tlv, tlv_size, offset, object, operation, update_value);
+        M2MObjectInstance *object_instance = object.object_instance(it._id);
+        if (object_instance) {
+            error = deserialize_resources(it._value, it._length, *object_instance, operation, update_value);
         }
     }
+
+    if (M2MTLVDeserializer::None == error && it._error) {
+        error = M2MTLVDeserializer::NotValid;
+    }
     return error;
 }
 
 M2MTLVDeserializer::Error M2MTLVDeserializer::deserialize_resources(const uint8_t *tlv,
                                                                     uint32_t tlv_size,
-                                                                    uint32_t offset,
                                                                     M2MObjectInstance &object_instance,
                                                                     M2MTLVDeserializer::Operation operation,
                                                                     bool update_value)
 {
     tr_debug("M2MTLVDeserializer::deserialize_resources()");
     M2MTLVDeserializer::Error error = M2MTLVDeserializer::None;
-    TypeIdLength til(tlv, offset);
-    til.deserialize();
-    offset = til._offset;
-
-    const M2MResourceList &list = object_instance.resources();
-    M2MResourceList::const_iterator it;
-    it = list.begin();
-
-    bool found = false;
-    bool multi = false;
-    if (TYPE_RESOURCE == til._type || TYPE_RESOURCE_INSTANCE == til._type) {
-        multi = false;
-        for (; it!=list.end(); it++) {
-            if((*it)->name_id() == til._id){
-                tr_debug("M2MTLVDeserializer::deserialize_resources() - Resource ID %d ", til._id);
-                found = true;
-                if(update_value) {
-                    if(til._length > 0) {
-                        tr_debug("M2MTLVDeserializer::deserialize_resources() - Update value");
-                        if (!set_resource_instance_value((*it), tlv+offset, til._length)) {
-                            error = M2MTLVDeserializer::OutOfMemory;
-                            break;
-                        }
-                    } else {
-                        tr_debug("M2MTLVDeserializer::deserialize_resources() - Clear Value");
-                        (*it)->clear_value();
-                    }
-                    break;
-                } else if(0 == ((*it)->operation() & SN_GRS_PUT_ALLOWED)) {
+    TLVIterator it(tlv, tlv_size);
+
+    while (M2MTLVDeserializer::None == error && it.next()) {
+        M2MResource *resource = NULL;
+        if (TYPE_RESOURCE == it._type || TYPE_RESOURCE_INSTANCE == it._type) {
+            resource = find_resource(object_instance, it._id, false);
+            if (resource) {
+                tr_debug("M2MTLVDeserializer::deserialize_resources() - Resource ID %d ", it._id);
+                if (update_value) {
+                    error = update_resource_value(resource, it._value, it._length);
+                } else if (0 == (resource->operation() & SN_GRS_PUT_ALLOWED)) {
                     tr_debug("M2MTLVDeserializer::deserialize_resources() - NOT_ALLOWED");
                     error = M2MTLVDeserializer::NotAllowed;
-                    break;
                 }
+            } else if (M2MTLVDeserializer::Post == operation) {
+                if (update_value) {
+                    resource = create_resource(object_instance, it._id, false);
+                    error = resource ? update_resource_value(resource, it._value, it._length) :
+                                       M2MTLVDeserializer::OutOfMemory;
+                }
+            } else if (M2MTLVDeserializer::Put == operation) {
+                error = M2MTLVDeserializer::NotFound;
             }
-        }
-    } else if (TYPE_MULTIPLE_RESOURCE == til._type) {
-        multi = true;
-        for (; it!=list.end(); it++) {
-            if((*it)->supports_multiple_instances() &&
-                    (*it)->name_id() == til._id) {
-                found = true;
-                error = deserialize_resource_instances(tlv, tlv_size, offset, (**it), object_instance, operation, update_value);
-            }
-        }
-    } else {
-        error = M2MTLVDeserializer::NotValid;
-        return error;
-    }
-
-    if(!found) {
-        if(M2MTLVDeserializer::Post == operation) {
-            //Create a new Resource
-            String id;
-            id.append_int(til._id);
-            M2MResource *resource = object_instance.create_dynamic_resource(id,"",M2MResourceInstance::OPAQUE,true,multi);
-            if(resource) {
-                resource->set_operation(M2MBase::GET_PUT_POST_DELETE_ALLOWED);
+        } else if (TYPE_MULTIPLE_RESOURCE == it._type) {
+            resource = find_resource(object_instance, it._id, true);
+            if (!resource && M2MTLVDeserializer::Post == operation && update_value) {
+                resource = create_resource(object_instance, it._id, true);
+                if (!resource) {
+                    error = M2MTLVDeserializer::OutOfMemory;
+                    break;
+                }
             }
-            if( TYPE_MULTIPLE_RESOURCE == til._type ) {
-                error = deserialize_resource_instances(tlv, tlv_size, offset, (*resource), object_instance, operation, update_value);
+            if (resource || M2MTLVDeserializer::Post == operation) {
+                // A resource that is still to be created by a POST is only validated here
+                error = deserialize_resource_instances(it._value, it._length, resource, object_instance,
+                                                       operation, update_value);
+            } else if (M2MTLVDeserializer::Put == operation) {
+                error = M2MTLVDeserializer::NotFound;
             }
-        } else if(M2MTLVDeserializer::Put == operation) {
-            error = M2MTLVDeserializer::NotFound;
+        } else {
+            error = M2MTLVDeserializer::NotValid;
         }
     }
 
-
-    offset += til._length;
-
-    if(offset < tlv_size) {
-        error = deserialize_resources(tlv, tlv_size, offset, object_instance, operation, update_value);
+    if (M2MTLVDeserializer::None == error && it._error) {
+        error = M2MTLVDeserializer::NotValid;
     }
     return error;
 }
 
 M2MTLVDeserializer::Error M2MTLVDeserializer::deserialize_resource_instances(const uint8_t *tlv,
                                                                              uint32_t tlv_size,
-                                                                             uint32_t offset,
-                                                                             M2MResource &resource,
+                                                                             M2MResource *resource,
                                                                              M2MObjectInstance &object_instance,
                                                                              M2MTLVDeserializer::Operation operation,
                                                                              bool update_value)
 {
     M2MTLVDeserializer::Error error = M2MTLVDeserializer::None;
-    TypeIdLength til(tlv, offset);
-    til.deserialize();
-    offset = til._offset;
-
-    if (TYPE_MULTIPLE_RESOURCE == til._type || TYPE_RESOURCE_INSTANCE == til._type) {
-        const M2MResourceInstanceList &list = resource.resource_instances();
-        M2MResourceInstanceList::const_iterator it;
-        it = list.begin();
-        bool found = false;
-        for (; it!=list.end(); it++) {
-            if((*it)->instance_id() == til._id && TYPE_RESOURCE_INSTANCE == til._type) {
-                found = true;
-                if(update_value) {
-                    if(til._length > 0) {
-                        if (!set_resource_instance_value((*it), tlv+offset, til._length)) {
-                            error = M2MTLVDeserializer::OutOfMemory;
-                            break;
-                        }
-                    } else {
-                        (*it)->clear_value();
-                    }
-                    break;
-                } else if(0 == ((*it)->operation() & SN_GRS_PUT_ALLOWED)) {
-                    error = M2MTLVDeserializer::NotAllowed;
-                    break;
-                }
-            }
-        }
+    TLVIterator it(tlv, tlv_size);
 
-        if(!found) {
-            if(M2MTLVDeserializer::Post == operation) {
+    while (M2MTLVDeserializer::None == error && it.next()) {
+        if (TYPE_RESOURCE_INSTANCE != it._type) {
+            error = M2MTLVDeserializer::NotValid;
+            break;
+        }
+        M2MResourceInstance *res_instance = resource ? resource->resource_instance(it._id) : NULL;
+        if (res_instance) {
+            if (update_value) {
+                error = update_resource_value(res_instance, it._value, it._length);
+            } else if (0 == (res_instance->operation() & SN_GRS_PUT_ALLOWED)) {
+                error = M2MTLVDeserializer::NotAllowed;
+            }
+        } else if (M2MTLVDeserializer::Post == operation) {
+            if (update_value) {
                 // Create a new Resource Instance
-                M2MResourceInstance *res_instance = object_instance.create_dynamic_resource_instance(resource.name(),"",
-                                                                                                 resource.resource_instance_type(),
-                                                                                                 true,
-                                                                                                 til._id);
-                if(res_instance) {
+                res_instance = object_instance.create_dynamic_resource_instance(resource->name(),"",
+                                                                                resource->resource_instance_type(),
+                                                                                true,
+                                                                                it._id);
+                if (res_instance) {
                     res_instance->set_operation(M2MBase::GET_PUT_POST_DELETE_ALLOWED);
+                    error = update_resource_value(res_instance, it._value, it._length);
+                } else {
+                    error = M2MTLVDeserializer::OutOfMemory;
                 }
-            } else if(M2MTLVDeserializer::Put == operation) {
-                error = M2MTLVDeserializer::NotFound;
             }
+        } else if (M2MTLVDeserializer::Put == operation) {
+            error = M2MTLVDeserializer::NotFound;
         }
-    } else {
-        error = M2MTLVDeserializer::NotValid;
-        return error;
     }
 
-    offset += til._length;
-
-    if(offset < tlv_size) {
-      error = deserialize_resource_instances(tlv, tlv_size, offset, resource, object_instance, operation, update_value);
+    if (M2MTLVDeserializer::None == error && it._error) {
+        error = M2MTLVDeserializer::NotValid;
     }
     return error;
 }
 
 M2MTLVDeserializer::Error M2MTLVDeserializer::deserialize_resource_instances(const uint8_t *tlv,
                                                                              uint32_t tlv_size,
-                                                                             uint32_t offset,
                                                                              M2MResource &resource,
                                                                              M2MTLVDeserializer::Operation operation,
                                                                              bool update_value)
 {
     M2MTLVDeserializer::Error error = M2MTLVDeserializer::None;
-    TypeIdLength til(tlv, offset);
-    til.deserialize();
-    offset = til._offset;
-
-    if (TYPE_RESOURCE_INSTANCE == til._type) {
-        const M2MResourceInstanceList &list = resource.resource_instances();
-        M2MResourceInstanceList::const_iterator it;
-        it = list.begin();
-        bool found = false;
-        for (; it!=list.end(); it++) {
-            if((*it)->instance_id() == til._id) {
-                found = true;
-                if(update_value) {
-                    if(til._length > 0) {
-                        if (!set_resource_instance_value((*it),tlv+offset, til._length)) {
-                            error = M2MTLVDeserializer::OutOfMemory;
-                            break;
-                        }
-                    } else {
-                        (*it)->clear_value();
-                    }
-                    break;
-                } else if(0 == ((*it)->operation() & SN_GRS_PUT_ALLOWED)) {
-                    error = M2MTLVDeserializer::NotAllowed;
-                    break;
-                }
-            }
+    TLVIterator it(tlv, tlv_size);
+
+    while (M2MTLVDeserializer::None == error && it.next()) {
+        if (TYPE_RESOURCE_INSTANCE != it._type) {
+            error = M2MTLVDeserializer::NotValid;
+            break;
         }
-        if(!found) {
-            if(M2MTLVDeserializer::Post == operation) {
+        M2MResourceInstance *res_instance = resource.resource_instance(it._id);
+        if (res_instance) {
+            if (update_value) {
+                error = update_resource_value(res_instance, it._value, it._length);
+            } else if (0 == (res_instance->operation() & SN_GRS_PUT_ALLOWED)) {
                 error = M2MTLVDeserializer::NotAllowed;
-            } else if(M2MTLVDeserializer::Put == operation) {
-                error = M2MTLVDeserializer::NotFound;
             }
+        } else if (M2MTLVDeserializer::Post == operation) {
+            error = M2MTLVDeserializer::NotAllowed;
+        } else if (M2MTLVDeserializer::Put == operation) {
+            error = M2MTLVDeserializer::NotFound;
         }
-    } else {
-        error = M2MTLVDeserializer::NotValid;
-        return error;
     }
 
-    offset += til._length;
-
-    if(offset < tlv_size) {
-         error = deserialize_resource_instances(tlv, tlv_size, offset, resource, operation, update_value);
+    if (M2MTLVDeserializer::None == error && it._error) {
+        error = M2MTLVDeserializer::NotValid;
     }
     return error;
 }
@@ -409,6 +330,52 @@ bool M2MTLVDeserializer::is_resource_instance(const uint8_t *tlv, uint32_t offse
     return ret;
 }
 
+M2MResource* M2MTLVDeserializer::find_resource(const M2MObjectInstance &object_instance,
+                                               uint16_t id,
+                                               bool multiple_instances)
+{
+    // max len of "65535" plus zero termination
+    char name[5+1];
+    m2m::itoa_c(id, name);
+    M2MResource *resource = object_instance.resource(name);
+    if (resource && multiple_instances && !resource->supports_multiple_instances()) {
+        resource = NULL;
+    }
+    return resource;
+}
+
+M2MResource* M2MTLVDeserializer::create_resource(M2MObjectInstance &object_instance,
+                                                 uint16_t id,
+                                                 bool multiple_instances)
+{
+    //Create a new Resource
+    String name;
+    name.append_int(id);
+    M2MResource *resource = object_instance.create_dynamic_resource(name, "", M2MResourceInstance::OPAQUE,
+                                                                    true, multiple_instances);
+    if (resource) {
+        resource->set_operation(M2MBase::GET_PUT_POST_DELETE_ALLOWED);
+    }
+    return resource;
+}
+
+M2MTLVDeserializer::Error M2MTLVDeserializer::update_resource_value(M2MResourceBase *res,
+                                                                    const uint8_t *value,
+                                                                    const uint32_t size)
+{
+    M2MTLVDeserializer::Error error = M2MTLVDeserializer::None;
+    if (size > 0) {
+        tr_debug("M2MTLVDeserializer::update_resource_value() - Update value");
+        if (!set_resource_instance_value(res, value, size)) {
+            error = M2MTLVDeserializer::OutOfMemory;
+        }
+    } else {
+        tr_debug("M2MTLVDeserializer::update_resource_value() - Clear Value");
+        res->clear_value();
+    }
+    return error;
+}
+
 bool M2MTLVDeserializer::set_resource_instance_value(M2MResourceBase *res, const uint8_t *tlv, const uint32_t size)
 {
     int64_t value = 0;
@@ -438,34 +405,29 @@ bool M2MTLVDeserializer::set_resource_instance_value(M2MResourceBase *res, const
     return success;
 }
 
+bool M2MTLVDeserializer::contains_id(const uint8_t *tlv, uint32_t tlv_size, uint16_t id)
+{
+    TLVIterator it(tlv, tlv_size);
+    while (it.next()) {
+        if (it._id == id) {
+            return true;
+        }
+    }
+    return false;
+}
+
 void M2MTLVDeserializer::remove_resources(const uint8_t *tlv,
                                           uint32_t tlv_size,
-                                          M2MObjectInstance &object_instance,
-                                          uint32_t offset_size)
+                                          M2MObjectInstance &object_instance)
 {
     tr_debug("M2MTLVDeserializer::remove_resources");
-    uint32_t offset = offset_size;
     const M2MResourceList &list = object_instance.resources();
     M2MResourceList::const_iterator it;
 
     it = list.begin();
     for (; it!=list.end();) {
-        bool found = false;
-        while(offset < tlv_size) {
-            TypeIdLength til(tlv, offset);
-            til.deserialize();
-            offset = til._offset;
-            offset += til._length;
-            if((*it)->name_id() == til._id){
-                offset = offset_size;
-                found = true;
-                break;
-            }
-        }
-        offset = offset_size;
-
         // Remove resource if not part of the TLV message
-        if (!found) {
+        if (!contains_id(tlv, tlv_size, (*it)->name_id())) {
             tr_debug("M2MTLVDeserializer::remove_resources - remove resource %" PRId32, (*it)->name_id());
             object_instance.remove_resource((*it)->name());
         } else {
@@ -476,32 +438,16 @@ void M2MTLVDeserializer::remove_resources(const uint8_t *tlv,
 
 void M2MTLVDeserializer::remove_resource_instances(const uint8_t *tlv,
                                           uint32_t tlv_size,
-                                          M2MResource &resource,
-                                          uint32_t offset_size)
+                                          M2MResource &resource)
 {
     tr_debug("M2MTLVDeserializer::remove_resource_instances");
-    uint32_t offset = offset_size;
     const M2MResourceInstanceList &list = resource.resource_instances();
     M2MResourceInstanceList::const_iterator it;
     it = list.begin();
 
     for (; it!=list.end();) {
-        bool found = false;
-        while (offset < tlv_size) {
-            TypeIdLength til(tlv, offset);
-            til.deserialize();
-            offset = til._offset;
-            offset += til._length;
-            if ((*it)->instance_id() == til._id){
-                offset = offset_size;
-                found = true;
-                break;
-            }
-        }
-        offset = offset_size;
-
         // Remove resource instance if not part of the TLV message
-        if (!found) {
+        if (!contains_id(tlv, tlv_size, (*it)->instance_id())) {
             tr_debug("M2MTLVDeserializer::remove_resource_instances - remove resource instance %d", (*it)->instance_id());
             resource.remove_resource_instance((*it)->instance_id());
         } else {
@@ -548,3 +494,38 @@ void TypeIdLength::deserialiseLength(uint32_t lengthType)
         _length = (_length << 8) + (_tlv[_offset++] & 0xFF);
     }
 }
+
+TLVIterator::TLVIterator(const uint8_t *tlv, uint32_t tlv_size)
+: _tlv(tlv), _size(tlv ? tlv_size : 0), _offset(0), _error(false),
+  _type(0), _id(0), _value(NULL), _length(0)
+{
+}
+
+bool TLVIterator::next()
+{
+    if (_error || _offset >= _size) {
+        return false;
+    }
+
+    // Type byte, one or two bytes of id and zero to three bytes of length
+    const uint8_t type = _tlv[_offset];
+    const uint32_t header_size = 1 + ((type & ID16) ? 2 : 1) + ((type & LENGTH24) >> 3);
+    if (header_size > _size - _offset) {
+        _error = true;
+        return false;
+    }
+
+    TypeIdLength til(_tlv, _offset);
+    til.deserialize();
+    if (til._length > _size - til._offset) {
+        _error = true;
+        return false;
+    }
+
+    _type = til._type;
+    _id = til._id;
+    _value = _tlv + til._offset;
+    _length = til._length;
+    _offset = til._offset + til._length;
+    return true;
+}
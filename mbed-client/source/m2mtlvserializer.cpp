@@ -25,233 +25,248 @@
 #define MAX_TLV_ID_SIZE 2
 #define TLV_TYPE_SIZE 1
 
+/* The serializer works in two passes: the exact size of the encoded payload
+ * is computed first, the output is allocated once and the TLV elements are
+ * then written directly into it. */
+
 uint8_t* M2MTLVSerializer::serialize(const M2MObjectInstanceList &object_instance_list, uint32_t &size)
 {
-    return serialize_object_instances(object_instance_list, size);
+    uint8_t *data = NULL;
+    const uint32_t data_size = size_of_object_instances(object_instance_list);
+    if (data_size > 0) {
+        data = (uint8_t*)malloc(data_size);
+        if (data) {
+            serialize_object_instances(object_instance_list, data);
+            size = data_size;
+        }
+    }
+    return data;
 }
 
 uint8_t* M2MTLVSerializer::serialize(const M2MResourceList &resource_list, uint32_t &size)
 {
+    uint8_t *data = NULL;
     bool valid = true;
-    return serialize_resources(resource_list, size,valid);
+    const uint32_t data_size = size_of_resources(resource_list, valid);
+    if (valid && data_size > 0) {
+        data = (uint8_t*)malloc(data_size);
+        if (data) {
+            serialize_resources(resource_list, data);
+            size = data_size;
+        }
+    }
+    return data;
 }
 
 uint8_t* M2MTLVSerializer::serialize(const M2MResource *resource, uint32_t &size)
 {
-    uint8_t* data = NULL;
-    serialize(resource, data, size);
+    uint8_t *data = NULL;
+    bool valid = true;
+    const uint32_t data_size = size_of_resource(resource, valid);
+    if (valid && data_size > 0) {
+        data = (uint8_t*)malloc(data_size);
+        if (data) {
+            serialize_resource(resource, data);
+            size = data_size;
+        }
+    }
     return data;
 }
 
-uint8_t* M2MTLVSerializer::serialize_object_instances(const M2MObjectInstanceList &object_instance_list, uint32_t &size)
+uint32_t M2MTLVSerializer::size_of_object_instances(const M2MObjectInstanceList &object_instance_list)
 {
-    uint8_t *data = NULL;
-
-    if(!object_instance_list.empty()) {
-        M2MObjectInstanceList::const_iterator it;
-        it = object_instance_list.begin();
-        for (; it!=object_instance_list.end(); it++) {            
-            uint16_t id = (*it)->instance_id();
-            serialize(id, *it, data, size);            
+    uint32_t size = 0;
+    M2MObjectInstanceList::const_iterator it;
+    it = object_instance_list.begin();
+    for (; it!=object_instance_list.end(); it++) {
+        bool valid = true;
+        const uint32_t resources_size = size_of_resources((*it)->resources(), valid);
+        /* object instances with invalid resources are left out */
+        if (valid) {
+            size += size_of_TILV((*it)->instance_id(), resources_size);
         }
     }
-    return data;
+    return size;
 }
 
-uint8_t* M2MTLVSerializer::serialize_resources(const M2MResourceList &resource_list, uint32_t &size, bool &valid)
+uint32_t M2MTLVSerializer::size_of_resources(const M2MResourceList &resource_list, bool &valid)
 {
-    uint8_t *data = NULL;
-
-    if(!resource_list.empty()) {
-        M2MResourceList::const_iterator it;
-        it = resource_list.begin();
-        for (; it!=resource_list.end(); it++) {
-            if((*it)->name_id() == -1) {
-                valid = false;
-                break;
-            }
+    uint32_t size = 0;
+    M2MResourceList::const_iterator it;
+    it = resource_list.begin();
+    for (; it!=resource_list.end(); it++) {
+        if((*it)->name_id() == -1) {
+            valid = false;
+            return 0;
         }
-        if(valid) {
-            it = resource_list.begin();
-            for (; it!=resource_list.end(); it++) {
-                if (((*it)->operation() & M2MBase::GET_ALLOWED) == M2MBase::GET_ALLOWED) {
-                    if(!serialize(*it, data, size)) {
-                        /* serializing has failed */
-                        /* free data so far */
-                        free(data);
-                        /* invalidate */
-                        valid = false;
-                        /* return NULL immediately */
-                        return NULL;
-                    }
-                }
+    }
+    it = resource_list.begin();
+    for (; it!=resource_list.end(); it++) {
+        if (((*it)->operation() & M2MBase::GET_ALLOWED) == M2MBase::GET_ALLOWED) {
+            size += size_of_resource(*it, valid);
+            if (!valid) {
+                return 0;
             }
         }
     }
-    return data;
+    return size;
 }
 
-bool M2MTLVSerializer::serialize(uint16_t id, const M2MObjectInstance *object_instance, uint8_t *&data, uint32_t &size)
+uint32_t M2MTLVSerializer::size_of_resource(const M2MResource *resource, bool &valid)
 {
-    uint8_t *resource_data = NULL;
-    uint32_t resource_size = 0;
-    bool success;
+    if (resource->name_id() == -1) {
+        valid = false;
+        return 0;
+    }
+    if (resource->supports_multiple_instances()) {
+        if ((resource->operation() & M2MBase::GET_ALLOWED) != M2MBase::GET_ALLOWED) {
+            valid = false;
+            return 0;
+        }
+        return size_of_TILV(resource->name_id(), size_of_resource_instances(resource));
+    }
+    return size_of_TILV(resource->name_id(), size_of_value(resource));
+}
 
-    bool valid = true;
-    resource_data = serialize_resources(object_instance->resources(),resource_size,valid);
-    if(valid) {
-        if(serialize_TILV(TYPE_OBJECT_INSTANCE, id, resource_data, resource_size, data, size)) {
-            success = true;
-        } else {
-            /* serializing object instance failed */
-            success = false;
+uint32_t M2MTLVSerializer::size_of_resource_instances(const M2MResource *resource)
+{
+    uint32_t size = 0;
+    const M2MResourceInstanceList &instance_list = resource->resource_instances();
+    M2MResourceInstanceList::const_iterator it;
+    it = instance_list.begin();
+    for (; it!=instance_list.end(); it++) {
+        if (((*it)->operation() & M2MBase::GET_ALLOWED) == M2MBase::GET_ALLOWED) {
+            size += size_of_TILV((*it)->instance_id(), size_of_value(*it));
         }
-        free(resource_data);
-    } else {
-        /* serializing resources failed */
-        success = false;
     }
-    return success;
+    return size;
 }
 
-bool M2MTLVSerializer::serialize(const M2MResource *resource, uint8_t *&data, uint32_t &size)
+uint32_t M2MTLVSerializer::size_of_value(const M2MResourceBase *resource)
 {
-    bool success = false;
-    if(resource->name_id() != -1) {
-        success = resource->supports_multiple_instances() ?
-                serialize_multiple_resource(resource, data, size) :
-                serialize_resource(resource, data, size);
+    switch (resource->resource_instance_type()) {
+        case M2MResourceBase::BOOLEAN:
+            return 1;
+        case M2MResourceBase::INTEGER:
+        case M2MResourceBase::TIME:
+            return 8;
+        default:
+            return resource->value_length();
     }
-    return success;
 }
 
-bool M2MTLVSerializer::serialize_resource(const M2MResource *resource, uint8_t *&data, uint32_t &size)
+uint32_t M2MTLVSerializer::size_of_TILV(uint16_t id, uint32_t value_length)
 {
-    bool success = false;
-    if(resource->name_id() != -1) {
-        if ( (resource->resource_instance_type() == M2MResourceBase::INTEGER) ||
-             (resource->resource_instance_type() == M2MResourceBase::BOOLEAN) ||
-             (resource->resource_instance_type() == M2MResourceBase::TIME) ) {
-            success = serialize_TLV_binary_int(resource, TYPE_RESOURCE, resource->name_id(), data, size);
+    uint32_t id_size = id > 255 ? 2 : 1;
+    uint32_t length_size = value_length > 65535 ? 3 :
+                           value_length > 255 ? 2 :
+                           value_length > 7 ? 1 : 0;
+    return TLV_TYPE_SIZE + id_size + length_size + value_length;
+}
+
+uint8_t* M2MTLVSerializer::serialize_object_instances(const M2MObjectInstanceList &object_instance_list, uint8_t *ptr)
+{
+    M2MObjectInstanceList::const_iterator it;
+    it = object_instance_list.begin();
+    for (; it!=object_instance_list.end(); it++) {
+        bool valid = true;
+        const M2MResourceList &resource_list = (*it)->resources();
+        const uint32_t resources_size = size_of_resources(resource_list, valid);
+        if (valid) {
+            ptr = serialize_TIL(TYPE_OBJECT_INSTANCE, (*it)->instance_id(), resources_size, ptr);
+            ptr = serialize_resources(resource_list, ptr);
         }
-        else {
-             success = serialize_TILV(TYPE_RESOURCE, resource->name_id(),
-                      resource->value(), resource->value_length(), data, size);
+    }
+    return ptr;
+}
+
+uint8_t* M2MTLVSerializer::serialize_resources(const M2MResourceList &resource_list, uint8_t *ptr)
+{
+    M2MResourceList::const_iterator it;
+    it = resource_list.begin();
+    for (; it!=resource_list.end(); it++) {
+        if (((*it)->operation() & M2MBase::GET_ALLOWED) == M2MBase::GET_ALLOWED) {
+            ptr = serialize_resource(*it, ptr);
         }
     }
-    return success;
+    return ptr;
 }
 
-bool M2MTLVSerializer::serialize_multiple_resource(const M2MResource *resource, uint8_t *&data, uint32_t &size)
+uint8_t* M2MTLVSerializer::serialize_resource(const M2MResource *resource, uint8_t *ptr)
 {
-    bool success = false;
-    uint8_t *nested_data = NULL;
-    uint32_t nested_data_size = 0;
+    if (resource->supports_multiple_instances()) {
+        return serialize_multiple_resource(resource, ptr);
+    }
+    return serialize_value(resource, TYPE_RESOURCE, resource->name_id(), ptr);
+}
+
+uint8_t* M2MTLVSerializer::serialize_multiple_resource(const M2MResource *resource, uint8_t *ptr)
+{
+    ptr = serialize_TIL(TYPE_MULTIPLE_RESOURCE, resource->name_id(),
+                        size_of_resource_instances(resource), ptr);
 
     const M2MResourceInstanceList &instance_list = resource->resource_instances();
-    if(!instance_list.empty()) {
-        M2MResourceInstanceList::const_iterator it;
-        it = instance_list.begin();
-        for (; it!=instance_list.end(); it++) {
-            uint16_t id = (*it)->instance_id();
-            if (((*it)->operation() & M2MBase::GET_ALLOWED) == M2MBase::GET_ALLOWED) {
-                if(!serialize_resource_instance(id, (*it), nested_data, nested_data_size)) {
-                    /* serializing instance has failed */
-                    /* free data so far allocated */
-                    free(nested_data);
-                    /* return fail immediately*/
-                    success = false;
-                    return success;
-                }
-            }
+    M2MResourceInstanceList::const_iterator it;
+    it = instance_list.begin();
+    for (; it!=instance_list.end(); it++) {
+        if (((*it)->operation() & M2MBase::GET_ALLOWED) == M2MBase::GET_ALLOWED) {
+            ptr = serialize_value(*it, TYPE_RESOURCE_INSTANCE, (*it)->instance_id(), ptr);
         }
     }
-    if(resource->name_id() != -1 &&
-            (resource->operation() & M2MBase::GET_ALLOWED) == M2MBase::GET_ALLOWED) {
-        success = serialize_TILV(TYPE_MULTIPLE_RESOURCE, resource->name_id(),
-                                    nested_data, nested_data_size, data, size);
-    }
-
-    free(nested_data);
-    return success;
+    return ptr;
 }
 
-bool M2MTLVSerializer::serialize_resource_instance(uint16_t id, const M2MResourceInstance *resource, uint8_t *&data, uint32_t &size)
+uint8_t* M2MTLVSerializer::serialize_value(const M2MResourceBase *resource, uint8_t type, uint16_t id, uint8_t *ptr)
 {
-    bool success;
-
     if ( (resource->resource_instance_type() == M2MResourceBase::INTEGER) ||
          (resource->resource_instance_type() == M2MResourceBase::BOOLEAN) ||
          (resource->resource_instance_type() == M2MResourceBase::TIME) ) {
-        success=serialize_TLV_binary_int(resource, TYPE_RESOURCE_INSTANCE, id, data, size);
-        }
-    else {
-        success=serialize_TILV(TYPE_RESOURCE_INSTANCE, id, resource->value(), resource->value_length(), data, size);
+        return serialize_TLV_binary_int(resource, type, id, ptr);
     }
-
-    return success;
+    return serialize_TILV(type, id, resource->value(), resource->value_length(), ptr);
 }
 
 /* See, OMA-TS-LightweightM2M-V1_0-20170208-A, Appendix C,
  * Data Types, Integer, Boolean and TY
  * Yime, TLV Format */
-bool M2MTLVSerializer::serialize_TLV_binary_int(const M2MResourceBase *resource, uint8_t type, uint16_t id, uint8_t *&data, uint32_t &size)
+uint8_t* M2MTLVSerializer::serialize_TLV_binary_int(const M2MResourceBase *resource, uint8_t type, uint16_t id, uint8_t *ptr)
 {
     int64_t valueInt = resource->get_value_int();
-    uint32_t buffer_size;
-    /* max len 8 bytes */
-    uint8_t buffer[8];
 
     if (resource->resource_instance_type() == M2MResourceBase::BOOLEAN) {
-        buffer_size = 1;
-        buffer[0] = valueInt;
-    } else {
-        buffer_size = 8;
-        common_write_64_bit(valueInt, buffer);
+        ptr = serialize_TIL(type, id, 1, ptr);
+        *ptr++ = valueInt;
+        return ptr;
     }
 
-    return serialize_TILV(type, id, buffer, buffer_size, data, size);
+    ptr = serialize_TIL(type, id, 8, ptr);
+    return common_write_64_bit(valueInt, ptr);
 }
 
+uint8_t* M2MTLVSerializer::serialize_TILV(uint8_t type, uint16_t id, const uint8_t *value, uint32_t value_length, uint8_t *ptr)
+{
+    ptr = serialize_TIL(type, id, value_length, ptr);
+    if (value_length > 0) {
+        memcpy(ptr, value, value_length);
+    }
+    return ptr + value_length;
+}
 
-bool M2MTLVSerializer::serialize_TILV(uint8_t type, uint16_t id, uint8_t *value, uint32_t value_length, uint8_t *&data, uint32_t &size)
+uint8_t* M2MTLVSerializer::serialize_TIL(uint8_t type, uint16_t id, uint32_t value_length, uint8_t *ptr)
 {
-    uint8_t *tlv = 0;
-    const uint32_t type_length = TLV_TYPE_SIZE;
     type += id < 256 ? 0 : ID16;
     type += value_length < 8 ? value_length :
             value_length < 256 ? LENGTH8 :
             value_length < 65536 ? LENGTH16 : LENGTH24;
-    uint8_t tlv_type;
-    tlv_type = type & 0xFF;
+    *ptr++ = type & 0xFF;
 
     uint32_t id_size;
-    uint8_t id_array[MAX_TLV_ID_SIZE];
-    serialize_id(id, id_size, id_array);
+    serialize_id(id, id_size, ptr);
+    ptr += id_size;
 
     uint32_t length_size;
-    uint8_t length_array[MAX_TLV_LENGTH_SIZE];
-    serialize_length(value_length, length_size, length_array);
-
-    tlv = (uint8_t*)malloc(size + type_length + id_size + length_size + value_length);
-    if (!tlv) {
-        /* memory allocation has failed */
-        /* return failure immediately */
-        return false;
-        /* eventually NULL will be returned to serializer public method caller */
-    }
-    if(data) {
-        memcpy(tlv, data, size);
-        free(data);
-    }
-    memcpy(tlv+size, &tlv_type, type_length);
-    memcpy(tlv+size+type_length, id_array, id_size);
-    memcpy(tlv+size+type_length+id_size, length_array, length_size);
-    memcpy(tlv+size+type_length+id_size+length_size, value, value_length);
-
-    data = tlv;
-    size += type_length + id_size + length_size + value_length;
-    return true;
+    serialize_length(value_length, length_size, ptr);
+    return ptr + length_size;
 }
 
 void M2MTLVSerializer::serialize_id(uint16_t id, uint32_t &size, uint8_t *id_ptr)
@@ -17,8 +17,122 @@
 // ----------------------------------------------------------------------------
 
 #include <string.h>
+#include <float.h>
 #include "include/uriqueryparser.h"
 
+// Perfect hash of the write attribute names, see attribute_hash().
+#define ATTRIBUTE_HASH_SIZE 8
+
+typedef struct attribute_name_s {
+    const char  *name;
+    uint8_t     length;
+    int8_t      key;
+} attribute_name_t;
+
+static const attribute_name_t attribute_names[ATTRIBUTE_HASH_SIZE] = {
+    { "pmin", 4, QUERY_ATTRIBUTE_PMIN },
+    { "st",   2, QUERY_ATTRIBUTE_ST },
+    { "stp",  3, QUERY_ATTRIBUTE_ST },
+    { NULL,   0, -1 },
+    { "pmax", 4, QUERY_ATTRIBUTE_PMAX },
+    { "gt",   2, QUERY_ATTRIBUTE_GT },
+    { "lt",   2, QUERY_ATTRIBUTE_LT },
+    { NULL,   0, -1 }
+};
+
+static uint8_t attribute_hash(const char *name, size_t length)
+{
+    return (uint8_t)(5 * (uint8_t)name[0] + 2 * (uint8_t)name[length - 1] + length) & (ATTRIBUTE_HASH_SIZE - 1);
+}
+
+static int8_t attribute_key(const char *name, size_t length)
+{
+    if (length == 0) {
+        return -1;
+    }
+    const attribute_name_t *entry = &attribute_names[attribute_hash(name, length)];
+    if (entry->length != length || memcmp(entry->name, name, length) != 0) {
+        return -1;
+    }
+    return entry->key;
+}
+
+static bool is_digit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+// Unlike atof(), accepts only [+-]digits[.digits][(e|E)[+-]digits] covering
+// the whole range between pos and end, and rejects values out of float range.
+static bool attribute_value(const char *pos, const char *end, float *value)
+{
+    bool negative = false;
+    bool has_digits = false;
+    double mantissa = 0;
+    int exponent = 0;
+
+    if (pos < end && (*pos == '+' || *pos == '-')) {
+        negative = (*pos == '-');
+        pos++;
+    }
+    for (; pos < end && is_digit(*pos); pos++) {
+        mantissa = mantissa * 10 + (*pos - '0');
+        has_digits = true;
+    }
+    if (pos < end && *pos == '.') {
+        for (pos++; pos < end && is_digit(*pos); pos++) {
+            mantissa = mantissa * 10 + (*pos - '0');
+            exponent--;
+            has_digits = true;
+        }
+    }
+    if (!has_digits) {
+        return false;
+    }
+    if (pos < end && (*pos == 'e' || *pos == 'E')) {
+        bool exponent_negative = false;
+        bool exponent_digits = false;
+        int exponent_value = 0;
+        pos++;
+        if (pos < end && (*pos == '+' || *pos == '-')) {
+            exponent_negative = (*pos == '-');
+            pos++;
+        }
+        for (; pos < end && is_digit(*pos); pos++) {
+            if (exponent_value < 1000) {
+                exponent_value = exponent_value * 10 + (*pos - '0');
+            }
+            exponent_digits = true;
+        }
+        if (!exponent_digits) {
+            return false;
+        }
+        exponent += exponent_negative ? -exponent_value : exponent_value;
+    }
+    if (pos != end) {
+        return false;
+    }
+
+    if (mantissa != 0 && exponent != 0) {
+        double scale = 1;
+        double power = 10;
+        unsigned int count = (exponent < 0) ? -exponent : exponent;
+        while (count) {
+            if (count & 1) {
+                scale *= power;
+            }
+            power *= power;
+            count >>= 1;
+        }
+        mantissa = (exponent < 0) ? mantissa / scale : mantissa * scale;
+    }
+    if (!(mantissa <= FLT_MAX)) {
+        return false;
+    }
+    *value = (float)(negative ? -mantissa : mantissa);
+    return true;
+}
+
 char* query_string(char* uri)
 {
     char* query = strchr((char*)uri, '?');
@@ -59,3 +173,43 @@ bool uri_query_parameters(char* query, char *uri_query_parameters[], int index)
 
     return true;
 }
+
+int8_t query_attributes(const char *query, query_attribute_t attributes[], uint8_t max_count)
+{
+    if (query == NULL || *query == '\0') {
+        return -1;
+    }
+
+    int8_t count = 0;
+    const char *name = query;
+    const char *equal = NULL;
+    for (const char *pos = query; ; pos++) {
+        if (*pos == '=' && equal == NULL) {
+            equal = pos;
+        } else if (*pos == '&' || *pos == '\0') {
+            if (pos == name) {
+                // Empty parameter, e.g. a trailing '&'
+                if (*pos == '\0') {
+                    break;
+                }
+                name = pos + 1;
+                continue;
+            }
+            if (equal == NULL || count >= max_count || count == INT8_MAX) {
+                return -1;
+            }
+            const int8_t key = attribute_key(name, (size_t)(equal - name));
+            if (key < 0 || !attribute_value(equal + 1, pos, &attributes[count].value)) {
+                return -1;
+            }
+            attributes[count].key = (query_attribute_key_t)key;
+            count++;
+            if (*pos == '\0') {
+                break;
+            }
+            name = pos + 1;
+            equal = NULL;
+        }
+    }
+    return count;
+}
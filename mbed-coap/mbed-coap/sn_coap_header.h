@@ -227,6 +227,61 @@ typedef struct sn_coap_hdr_ {
     sn_coap_options_list_s *options_list_ptr;   /**< Must be set to NULL if not used */
 } sn_coap_hdr_s;
 
+/**
+ * \brief View of an option inside a parsed packet.
+ *
+ * Repeatable options are stored in the packet as consecutive option
+ * instances, the view points to the value of the first one. The values can
+ * be joined with sn_coap_parser_view_join().
+ */
+typedef struct sn_coap_option_view_ {
+    uint16_t    offset;             /**< Offset of the first option value in the packet */
+    uint16_t    len;                /**< Length of the first option value */
+    uint16_t    joined_len;         /**< Length of all the values joined with one byte separators */
+    uint8_t     count;              /**< Count of option instances, 0 if not present */
+} sn_coap_option_view_s;
+
+/**
+ * \brief CoAP message parsed without allocations
+ *
+ * Filled by sn_coap_parser_view(). Token, payload and the variable length
+ * options are not copied, but refer to the parsed packet, which must stay
+ * valid as long as the view is used.
+ */
+typedef struct sn_coap_hdr_view_ {
+    const uint8_t          *packet_ptr;         /**< Parsed packet */
+    uint16_t                packet_len;         /**< Length of the parsed packet */
+
+    coap_version_e          coap_version;       /**< CoAP specification version */
+    sn_coap_msg_type_e      msg_type;           /**< Confirmable, Non-Confirmable, Acknowledgement or Reset */
+    sn_coap_msg_code_e      msg_code;           /**< Empty: 0; Requests: 1-31; Responses: 64-191 */
+    uint16_t                msg_id;             /**< Message ID */
+
+    uint8_t                 token_len;          /**< 0-8 bytes, token starts right after the fixed header */
+    uint16_t                payload_offset;     /**< Offset of the payload in the packet */
+    uint16_t                payload_len;        /**< Zero if there is no payload */
+
+    sn_coap_content_format_e content_format;    /**< COAP_CT_NONE if not used */
+    sn_coap_content_format_e accept;            /**< COAP_CT_NONE if not used */
+    uint32_t                max_age;            /**< Value in seconds (default is 60) */
+    uint32_t                size1;              /**< Valid if use_size1 is set */
+    uint32_t                size2;              /**< Valid if use_size2 is set */
+    unsigned int            use_size1:1;
+    unsigned int            use_size2:1;
+    int32_t                 uri_port;           /**< Value 0-65535. -1 if not used */
+    int32_t                 observe;            /**< Value 0-0xffffff. -1 if not used */
+    int32_t                 block1;             /**< Value 0-0xffffff. -1 if not used */
+    int32_t                 block2;             /**< Value 0-0xffffff. -1 if not used */
+
+    sn_coap_option_view_s   uri_path;           /**< Repeatable, joined with '/' */
+    sn_coap_option_view_s   uri_query;          /**< Repeatable, joined with '&' */
+    sn_coap_option_view_s   uri_host;
+    sn_coap_option_view_s   location_path;      /**< Repeatable, joined with '/' */
+    sn_coap_option_view_s   location_query;     /**< Repeatable, joined with '&' */
+    sn_coap_option_view_s   proxy_uri;
+    sn_coap_option_view_s   etag;               /**< Repeatable */
+} sn_coap_hdr_view_s;
+
 /* * * * * * * * * * * * * * */
 /* * * * ENUMERATIONS  * * * */
 /* * * * * * * * * * * * * * */
@@ -317,6 +372,44 @@ extern sn_coap_hdr_s *sn_coap_parser(struct coap_s *handle, uint16_t packet_data
  */
 extern void sn_coap_parser_release_allocated_coap_msg_mem(struct coap_s *handle, sn_coap_hdr_s *freed_coap_msg_ptr);
 
+/**
+ * \fn int8_t sn_coap_parser_view(sn_coap_hdr_view_s *dst_view_ptr, const uint8_t *packet_data_ptr, uint16_t packet_data_len)
+ *
+ * \brief Parses CoAP message from given Packet data without allocating or copying
+ *
+ *        The same checks are applied as in sn_coap_parser(). The view refers
+ *        to the given Packet data, which must outlive it.
+ *
+ * \param *dst_view_ptr is caller provided destination for the parsed message
+ *
+ * \param *packet_data_ptr is source for Packet data to be parsed
+ *
+ * \param packet_data_len is length of given Packet data
+ *
+ * \return Return value is 0 in ok case and -1 if the packet is not valid
+ */
+extern int8_t sn_coap_parser_view(sn_coap_hdr_view_s *dst_view_ptr, const uint8_t *packet_data_ptr, uint16_t packet_data_len);
+
+/**
+ * \fn uint16_t sn_coap_parser_view_join(const sn_coap_hdr_view_s *view_ptr, const sn_coap_option_view_s *option_ptr, uint8_t separator, uint8_t *dst_ptr, uint16_t dst_len)
+ *
+ * \brief Joins the values of a repeatable option, e.g. Uri-Path segments into temp1/temp2
+ *
+ * \param *view_ptr is the parsed message
+ *
+ * \param *option_ptr is the option of the parsed message to be joined
+ *
+ * \param separator is written between the option values
+ *
+ * \param *dst_ptr is destination for the joined value
+ *
+ * \param dst_len is size of the destination, at least option_ptr->joined_len
+ *
+ * \return Return value is count of bytes written, 0 if the option is not present
+ *          or the destination is too small
+ */
+extern uint16_t sn_coap_parser_view_join(const sn_coap_hdr_view_s *view_ptr, const sn_coap_option_view_s *option_ptr, uint8_t separator, uint8_t *dst_ptr, uint16_t dst_len);
+
 /**
  * \fn int16_t sn_coap_builder(uint8_t *dst_packet_data_ptr, sn_coap_hdr_s *src_coap_msg_ptr)
  *
@@ -47,6 +47,9 @@ static int8_t   sn_coap_parser_options_parse(struct coap_s *handle, uint8_t **pa
 static int8_t   sn_coap_parser_options_parse_multiple_options(struct coap_s *handle, uint8_t **packet_data_pptr, uint16_t packet_left_len,  uint8_t **dst_pptr, uint16_t *dst_len_ptr, sn_coap_option_numbers_e option, uint16_t option_number_len);
 static int16_t  sn_coap_parser_options_count_needed_memory_multiple_option(uint8_t *packet_data_ptr, uint16_t packet_left_len, sn_coap_option_numbers_e option, uint16_t option_number_len);
 static int8_t   sn_coap_parser_payload_parse(uint16_t packet_data_len, uint8_t *packet_data_start_ptr, uint8_t **packet_data_pptr, sn_coap_hdr_s *dst_coap_msg_ptr);
+static int8_t   sn_coap_parser_option_header(const uint8_t *packet_data_ptr, uint16_t packet_data_len, uint16_t *offset_ptr, uint32_t *option_delta_ptr, uint16_t *option_len_ptr);
+static int8_t   sn_coap_parser_view_option_add(sn_coap_option_view_s *dst_option_ptr, uint16_t value_offset, uint16_t option_len, uint16_t min_len, uint16_t max_len, bool repeatable);
+static uint32_t sn_coap_parser_view_uint(const uint8_t *value_ptr, uint16_t option_len);
 
 sn_coap_hdr_s *sn_coap_parser_init_message(sn_coap_hdr_s *coap_msg_ptr)
 {
@@ -196,6 +199,218 @@ void sn_coap_parser_release_allocated_coap_msg_mem(struct coap_s *handle, sn_coa
     }
 }
 
+int8_t sn_coap_parser_view(sn_coap_hdr_view_s *dst_view_ptr, const uint8_t *packet_data_ptr, uint16_t packet_data_len)
+{
+    uint16_t offset        = COAP_HEADER_LENGTH;
+    uint32_t option_number = 0;
+
+    /* * * * Check given pointers * * * */
+    if (dst_view_ptr == NULL || packet_data_ptr == NULL || packet_data_len < COAP_HEADER_LENGTH) {
+        return -1;
+    }
+
+    memset(dst_view_ptr, 0x00, sizeof(sn_coap_hdr_view_s));
+    dst_view_ptr->packet_ptr = packet_data_ptr;
+    dst_view_ptr->packet_len = packet_data_len;
+    dst_view_ptr->content_format = COAP_CT_NONE;
+    dst_view_ptr->accept = COAP_CT_NONE;
+    dst_view_ptr->max_age = COAP_OPTION_MAX_AGE_DEFAULT;
+    dst_view_ptr->uri_port = COAP_OPTION_URI_PORT_NONE;
+    dst_view_ptr->observe = COAP_OBSERVE_NONE;
+    dst_view_ptr->block1 = COAP_OPTION_BLOCK_NONE;
+    dst_view_ptr->block2 = COAP_OPTION_BLOCK_NONE;
+
+    /* * * * Fixed header * * * */
+    dst_view_ptr->coap_version = (coap_version_e)(packet_data_ptr[0] & COAP_HEADER_VERSION_MASK);
+    dst_view_ptr->msg_type = (sn_coap_msg_type_e)(packet_data_ptr[0] & COAP_HEADER_MSG_TYPE_MASK);
+    dst_view_ptr->msg_code = (sn_coap_msg_code_e)packet_data_ptr[1];
+    dst_view_ptr->msg_id = (packet_data_ptr[2] << COAP_HEADER_MSG_ID_MSB_SHIFT) + packet_data_ptr[3];
+
+    /* * * * Token * * * */
+    dst_view_ptr->token_len = packet_data_ptr[0] & COAP_HEADER_TOKEN_LENGTH_MASK;
+    if (dst_view_ptr->token_len > 8 || dst_view_ptr->token_len > packet_data_len - COAP_HEADER_LENGTH) {
+        tr_error("sn_coap_parser_view - token not valid!");
+        return -1;
+    }
+    offset += dst_view_ptr->token_len;
+
+    /* * * * Options, every option is parsed in place in one pass * * * */
+    while (offset < packet_data_len && packet_data_ptr[offset] != 0xff) {
+        uint32_t option_delta;
+        uint16_t option_len;
+        const uint8_t *value_ptr;
+        int8_t ret_status = 0;
+
+        if (sn_coap_parser_option_header(packet_data_ptr, packet_data_len, &offset, &option_delta, &option_len) != 0) {
+            tr_error("sn_coap_parser_view - invalid option header!");
+            return -1;
+        }
+        option_number += option_delta;
+        value_ptr = packet_data_ptr + offset;
+
+        switch (option_number) {
+            case COAP_OPTION_CONTENT_FORMAT:
+                if ((option_len > 2) || (dst_view_ptr->content_format != COAP_CT_NONE)) {
+                    ret_status = -1;
+                    break;
+                }
+                dst_view_ptr->content_format = (sn_coap_content_format_e) sn_coap_parser_view_uint(value_ptr, option_len);
+                break;
+
+            case COAP_OPTION_MAX_AGE:
+                if (option_len > 4) {
+                    ret_status = -1;
+                    break;
+                }
+                dst_view_ptr->max_age = sn_coap_parser_view_uint(value_ptr, option_len);
+                break;
+
+            case COAP_OPTION_PROXY_URI:
+                ret_status = sn_coap_parser_view_option_add(&dst_view_ptr->proxy_uri, offset, option_len, 1, 1034, false);
+                break;
+
+            case COAP_OPTION_ETAG:
+                ret_status = sn_coap_parser_view_option_add(&dst_view_ptr->etag, offset, option_len, 0, 8, true);
+                break;
+
+            case COAP_OPTION_URI_HOST:
+                ret_status = sn_coap_parser_view_option_add(&dst_view_ptr->uri_host, offset, option_len, 1, 255, false);
+                break;
+
+            case COAP_OPTION_LOCATION_PATH:
+                ret_status = sn_coap_parser_view_option_add(&dst_view_ptr->location_path, offset, option_len, 0, 255, true);
+                break;
+
+            case COAP_OPTION_URI_PORT:
+                if ((option_len > 2) || dst_view_ptr->uri_port != COAP_OPTION_URI_PORT_NONE) {
+                    ret_status = -1;
+                    break;
+                }
+                dst_view_ptr->uri_port = sn_coap_parser_view_uint(value_ptr, option_len);
+                break;
+
+            case COAP_OPTION_LOCATION_QUERY:
+                ret_status = sn_coap_parser_view_option_add(&dst_view_ptr->location_query, offset, option_len, 0, 255, true);
+                break;
+
+            case COAP_OPTION_URI_PATH:
+                ret_status = sn_coap_parser_view_option_add(&dst_view_ptr->uri_path, offset, option_len, 0, 255, true);
+                break;
+
+            case COAP_OPTION_OBSERVE:
+                if ((option_len > 2) || dst_view_ptr->observe != COAP_OBSERVE_NONE) {
+                    ret_status = -1;
+                    break;
+                }
+                dst_view_ptr->observe = sn_coap_parser_view_uint(value_ptr, option_len);
+                break;
+
+            case COAP_OPTION_URI_QUERY:
+                ret_status = sn_coap_parser_view_option_add(&dst_view_ptr->uri_query, offset, option_len, 0, 255, true);
+                break;
+
+            case COAP_OPTION_BLOCK2:
+                if ((option_len > 3) || dst_view_ptr->block2 != COAP_OPTION_BLOCK_NONE) {
+                    ret_status = -1;
+                    break;
+                }
+                dst_view_ptr->block2 = sn_coap_parser_view_uint(value_ptr, option_len);
+                break;
+
+            case COAP_OPTION_BLOCK1:
+                if ((option_len > 3) || dst_view_ptr->block1 != COAP_OPTION_BLOCK_NONE) {
+                    ret_status = -1;
+                    break;
+                }
+                dst_view_ptr->block1 = sn_coap_parser_view_uint(value_ptr, option_len);
+                break;
+
+            case COAP_OPTION_ACCEPT:
+                if ((option_len > 2) || (dst_view_ptr->accept != COAP_CT_NONE)) {
+                    ret_status = -1;
+                    break;
+                }
+                dst_view_ptr->accept = (sn_coap_content_format_e) sn_coap_parser_view_uint(value_ptr, option_len);
+                break;
+
+            case COAP_OPTION_SIZE1:
+                if ((option_len > 4) || dst_view_ptr->use_size1) {
+                    ret_status = -1;
+                    break;
+                }
+                dst_view_ptr->use_size1 = true;
+                dst_view_ptr->size1 = sn_coap_parser_view_uint(value_ptr, option_len);
+                break;
+
+            case COAP_OPTION_SIZE2:
+                if ((option_len > 4) || dst_view_ptr->use_size2) {
+                    ret_status = -1;
+                    break;
+                }
+                dst_view_ptr->use_size2 = true;
+                dst_view_ptr->size2 = sn_coap_parser_view_uint(value_ptr, option_len);
+                break;
+
+            default:
+                ret_status = -1;
+                break;
+        }
+
+        if (ret_status != 0) {
+            tr_error("sn_coap_parser_view - option %d not valid!", (int)option_number);
+            return -1;
+        }
+
+        offset += option_len;
+    }
+
+    /* * * * Payload * * * */
+    if (offset < packet_data_len) {
+        offset++;
+        /* The presence of a marker followed by a zero-length payload MUST be processed as a message format error */
+        if (offset == packet_data_len) {
+            tr_error("sn_coap_parser_view - empty payload after marker!");
+            return -1;
+        }
+        dst_view_ptr->payload_offset = offset;
+        dst_view_ptr->payload_len = packet_data_len - offset;
+    }
+
+    return 0;
+}
+
+uint16_t sn_coap_parser_view_join(const sn_coap_hdr_view_s *view_ptr, const sn_coap_option_view_s *option_ptr, uint8_t separator, uint8_t *dst_ptr, uint16_t dst_len)
+{
+    uint16_t offset;
+    uint16_t option_len;
+    uint16_t written = 0;
+    uint8_t  i;
+
+    if (view_ptr == NULL || option_ptr == NULL || dst_ptr == NULL ||
+            option_ptr->count == 0 || option_ptr->joined_len > dst_len) {
+        return 0;
+    }
+
+    offset = option_ptr->offset;
+    option_len = option_ptr->len;
+
+    for (i = 0; i < option_ptr->count; i++) {
+        if (i > 0) {
+            uint32_t option_delta;
+            dst_ptr[written++] = separator;
+            /* Instances of a repeatable option follow each other, validated when parsed */
+            if (sn_coap_parser_option_header(view_ptr->packet_ptr, view_ptr->packet_len, &offset, &option_delta, &option_len) != 0) {
+                return 0;
+            }
+        }
+        memcpy(dst_ptr + written, view_ptr->packet_ptr + offset, option_len);
+        written += option_len;
+        offset += option_len;
+    }
+
+    return written;
+}
+
 /**
  * \fn static void sn_coap_parser_header_parse(uint8_t **packet_data_pptr, sn_coap_hdr_s *dst_coap_msg_ptr, coap_version_e *coap_version_ptr)
  *
@@ -792,3 +1007,117 @@ static int8_t sn_coap_parser_payload_parse(uint16_t packet_data_len, uint8_t *pa
     return 0;
 }
 
+/**
+ * \fn static int8_t sn_coap_parser_option_header(const uint8_t *packet_data_ptr, uint16_t packet_data_len, uint16_t *offset_ptr, uint32_t *option_delta_ptr, uint16_t *option_len_ptr)
+ *
+ * \brief Parses one option header, checking that the header and the option value fit in the packet
+ *
+ * \param *offset_ptr is offset of the option header, moved to the start of the option value
+ *
+ * \param *option_delta_ptr is destination for the option delta
+ *
+ * \param *option_len_ptr is destination for the option value length
+ *
+ * \return Return value is 0 in ok case and -1 in failure case
+ */
+static int8_t sn_coap_parser_option_header(const uint8_t *packet_data_ptr, uint16_t packet_data_len, uint16_t *offset_ptr, uint32_t *option_delta_ptr, uint16_t *option_len_ptr)
+{
+    uint32_t offset = *offset_ptr;
+    uint32_t option_delta;
+    uint32_t option_len;
+
+    if (offset >= packet_data_len) {
+        return -1;
+    }
+
+    option_delta = packet_data_ptr[offset] >> COAP_OPTIONS_OPTION_NUMBER_SHIFT;
+    option_len = packet_data_ptr[offset] & 0x0F;
+    offset++;
+
+    /* Option delta and length 15 are reserved for payload marker and future use */
+    if (option_delta == 15 || option_len == 15) {
+        return -1;
+    }
+
+    if (option_delta == 13) {
+        if (offset + 1 > packet_data_len) {
+            return -1;
+        }
+        option_delta = packet_data_ptr[offset] + 13;
+        offset++;
+    } else if (option_delta == 14) {
+        if (offset + 2 > packet_data_len) {
+            return -1;
+        }
+        option_delta = (packet_data_ptr[offset] << 8) + packet_data_ptr[offset + 1] + 269;
+        offset += 2;
+    }
+
+    if (option_len == 13) {
+        if (offset + 1 > packet_data_len) {
+            return -1;
+        }
+        option_len = packet_data_ptr[offset] + 13;
+        offset++;
+    } else if (option_len == 14) {
+        if (offset + 2 > packet_data_len) {
+            return -1;
+        }
+        option_len = (packet_data_ptr[offset] << 8) + packet_data_ptr[offset + 1] + 269;
+        offset += 2;
+    }
+
+    if (offset + option_len > packet_data_len) {
+        return -1;
+    }
+
+    *offset_ptr = offset;
+    *option_delta_ptr = option_delta;
+    *option_len_ptr = option_len;
+    return 0;
+}
+
+/**
+ * \fn static int8_t sn_coap_parser_view_option_add(sn_coap_option_view_s *dst_option_ptr, uint16_t value_offset, uint16_t option_len, uint16_t min_len, uint16_t max_len, bool repeatable)
+ *
+ * \brief Adds one option instance to an option view
+ *
+ * \return Return value is 0 in ok case and -1 if the option is not valid
+ */
+static int8_t sn_coap_parser_view_option_add(sn_coap_option_view_s *dst_option_ptr, uint16_t value_offset, uint16_t option_len, uint16_t min_len, uint16_t max_len, bool repeatable)
+{
+    if (option_len < min_len || option_len > max_len) {
+        return -1;
+    }
+
+    if (dst_option_ptr->count == 0) {
+        dst_option_ptr->offset = value_offset;
+        dst_option_ptr->len = option_len;
+        dst_option_ptr->joined_len = option_len;
+    } else if (repeatable && dst_option_ptr->count < UINT8_MAX) {
+        dst_option_ptr->joined_len += option_len + 1;
+    } else {
+        return -1;
+    }
+
+    dst_option_ptr->count++;
+    return 0;
+}
+
+/**
+ * \brief Parses a variable-length uint value of an option
+ *
+ * \param *value_ptr is option value to be parsed
+ * \param option_len is length of option value (will be 0-4)
+ *
+ * \return Return value is value of uint
+ */
+static uint32_t sn_coap_parser_view_uint(const uint8_t *value_ptr, uint16_t option_len)
+{
+    uint32_t value = 0;
+    while (option_len--) {
+        value <<= 8;
+        value |= *value_ptr++;
+    }
+    return value;
+}
@@ -21,6 +21,11 @@
  * nsdynmemlib provides access to one default heap, along with the ability to use extra user heaps.
  * ns_dyn_mem_alloc/free always access the default heap initialised by ns_dyn_mem_init.
  * ns_mem_alloc/free access a user heap initialised by ns_mem_init. User heaps are identified by a book-keeping pointer.
+ *
+ * By default free space is found with a first-fit walk of the free blocks. Defining NSDYNMEM_TLSF at build time
+ * switches to a two-level segregated fit, where allocation and free take constant time independent of fragmentation.
+ * It costs a few hundred bytes of book-keeping at the start of each heap, and the smallest block is rounded up to
+ * hold a free list link.
  */
 
 #ifndef NSDYNMEMLIB_H_
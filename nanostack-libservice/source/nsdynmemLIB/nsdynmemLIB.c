@@ -27,9 +27,24 @@ typedef enum mem_stat_update_t {
     DEV_HEAP_FREE,
 } mem_stat_update_t;
 
+#ifdef NSDYNMEM_TLSF
+/* Two-level segregated fit: free blocks are kept in lists by size class,
+ * first level is the power of two of the size in words and second level
+ * divides that range linearly into TLSF_SL_COUNT classes. Bitmaps of non-empty
+ * lists give a suitable class in constant time. */
+#define TLSF_SL_LOG2    3
+#define TLSF_SL_COUNT   (1 << TLSF_SL_LOG2)
+#define TLSF_FL_COUNT   (16 - TLSF_SL_LOG2 + 1)
+
+typedef struct hole {
+    struct hole *next;
+    struct hole *prev;
+} hole_t;
+#else
 typedef struct {
     ns_list_link_t link;
 } hole_t;
+#endif
 
 typedef int ns_mem_word_size_t; // internal signed heap block size type
 
@@ -39,7 +54,13 @@ struct ns_mem_book {
     ns_mem_word_size_t     *heap_main_end;
     mem_stat_t *mem_stat_info_ptr;
     void (*heap_failure_callback)(heap_fail_t);
+#ifdef NSDYNMEM_TLSF
+    uint32_t fl_bitmap;
+    uint8_t sl_bitmap[TLSF_FL_COUNT];
+    hole_t *free_lists[TLSF_FL_COUNT][TLSF_SL_COUNT];
+#else
     NS_LIST_HEAD(hole_t, link) holes_list;
+#endif
     ns_mem_heap_size_t heap_size;
 };
 
@@ -65,6 +86,126 @@ static void heap_failure(ns_mem_book_t *book, heap_fail_t reason)
     }
 }
 
+#ifdef NSDYNMEM_TLSF
+// Index of the most significant set bit, value must be non-zero
+static int tlsf_fls(uint32_t value)
+{
+    int bit = 0;
+    if (value & 0xFFFF0000) {
+        bit += 16;
+        value >>= 16;
+    }
+    if (value & 0xFF00) {
+        bit += 8;
+        value >>= 8;
+    }
+    if (value & 0xF0) {
+        bit += 4;
+        value >>= 4;
+    }
+    if (value & 0xC) {
+        bit += 2;
+        value >>= 2;
+    }
+    if (value & 0x2) {
+        bit += 1;
+    }
+    return bit;
+}
+
+// Index of the least significant set bit, value must be non-zero
+static NS_INLINE int tlsf_ffs(uint32_t value)
+{
+    return tlsf_fls(value & (~value + 1));
+}
+
+static void tlsf_mapping(ns_mem_word_size_t size, int *fl, int *sl)
+{
+    if (size < TLSF_SL_COUNT) {
+        *fl = 0;
+        *sl = size;
+    } else {
+        int bit = tlsf_fls(size);
+        *sl = (size >> (bit - TLSF_SL_LOG2)) ^ TLSF_SL_COUNT;
+        *fl = bit - TLSF_SL_LOG2 + 1;
+    }
+}
+
+static void tlsf_hole_insert(ns_mem_book_t *book, ns_mem_word_size_t *block_start)
+{
+    hole_t *hole = hole_from_block_start(block_start);
+    int fl, sl;
+
+    tlsf_mapping(-*block_start, &fl, &sl);
+    hole->prev = NULL;
+    hole->next = book->free_lists[fl][sl];
+    if (hole->next) {
+        hole->next->prev = hole;
+    }
+    book->free_lists[fl][sl] = hole;
+    book->fl_bitmap |= 1U << fl;
+    book->sl_bitmap[fl] |= 1U << sl;
+}
+
+// Block size must still be the one the hole was inserted with
+static void tlsf_hole_remove(ns_mem_book_t *book, ns_mem_word_size_t *block_start)
+{
+    hole_t *hole = hole_from_block_start(block_start);
+    int fl, sl;
+
+    tlsf_mapping(-*block_start, &fl, &sl);
+    if (hole->next) {
+        hole->next->prev = hole->prev;
+    }
+    if (hole->prev) {
+        hole->prev->next = hole->next;
+    } else {
+        book->free_lists[fl][sl] = hole->next;
+        if (!hole->next) {
+            book->sl_bitmap[fl] &= ~(1U << sl);
+            if (!book->sl_bitmap[fl]) {
+                book->fl_bitmap &= ~(1U << fl);
+            }
+        }
+    }
+}
+
+static hole_t *tlsf_hole_find(ns_mem_book_t *book, ns_mem_word_size_t data_size)
+{
+    ns_mem_word_size_t size = data_size;
+    uint32_t map;
+    int fl, sl;
+
+    // Round up to the next class, so that any block found there is big enough
+    if (size >= TLSF_SL_COUNT) {
+        size += (1 << (tlsf_fls(size) - TLSF_SL_LOG2)) - 1;
+    }
+    tlsf_mapping(size, &fl, &sl);
+    if (fl < TLSF_FL_COUNT) {
+        map = book->sl_bitmap[fl] & (~0U << sl);
+        if (!map) {
+            map = book->fl_bitmap & (~0U << (fl + 1));
+            if (map) {
+                fl = tlsf_ffs(map);
+                map = book->sl_bitmap[fl];
+            }
+        }
+        if (map) {
+            return book->free_lists[fl][tlsf_ffs(map)];
+        }
+    }
+
+    // Nothing in the larger classes, a block of the requested class may still fit
+    tlsf_mapping(data_size, &fl, &sl);
+    for (hole_t *hole = book->free_lists[fl][sl]; hole; hole = hole->next) {
+        if (-*block_start_from_hole(hole) >= data_size) {
+            return hole;
+        }
+    }
+    return NULL;
+}
+#endif
+
 #endif
 
 void ns_dyn_mem_init(void *heap, ns_mem_heap_size_t h_size,
@@ -115,8 +256,15 @@ ns_mem_book_t *ns_mem_init(void *heap, ns_mem_heap_size_t h_size,
     *ptr = -(temp_int);
     book->heap_main_end = ptr;
 
+#ifdef NSDYNMEM_TLSF
+    book->fl_bitmap = 0;
+    memset(book->sl_bitmap, 0, sizeof(book->sl_bitmap));
+    memset(book->free_lists, 0, sizeof(book->free_lists));
+    tlsf_hole_insert(book, book->heap_main);
+#else
     ns_list_init(&book->holes_list);
     ns_list_add_to_start(&book->holes_list, hole_from_block_start(book->heap_main));
+#endif
 
     book->mem_stat_info_ptr = info_ptr;
     //RESET Memory by Hea Len
@@ -212,6 +360,23 @@ static void *ns_mem_internal_alloc(ns_mem_book_t *book, const ns_mem_block_size_
         goto done;
     }
 
+#ifdef NSDYNMEM_TLSF
+    // Every free block must be able to hold its list descriptor
+    if (data_size < HOLE_T_SIZE) {
+        data_size = HOLE_T_SIZE;
+    }
+
+    hole_t *found_hole = tlsf_hole_find(book, data_size);
+    if (found_hole) {
+        ns_mem_word_size_t *p = block_start_from_hole(found_hole);
+        if (ns_mem_block_validate(p, direction) != 0 || *p >= 0) {
+            heap_failure(book, NS_DYN_MEM_HEAP_SECTOR_CORRUPTED);
+        } else {
+            block_ptr = p;
+            tlsf_hole_remove(book, block_ptr);
+        }
+    }
+#else
     // ns_list_foreach, either forwards or backwards, result to ptr
     for (hole_t *cur_hole = direction > 0 ? ns_list_get_first(&book->holes_list)
                                           : ns_list_get_last(&book->holes_list);
@@ -232,6 +397,8 @@ static void *ns_mem_internal_alloc(ns_mem_book_t *book, const ns_mem_block_size_
         }
     }
 
+#endif
+
     if (!block_ptr) {
         goto done;
     }
@@ -241,6 +408,17 @@ static void *ns_mem_internal_alloc(ns_mem_book_t *book, const ns_mem_block_size_
         ns_mem_word_size_t hole_size = block_data_size - data_size - 2;
         ns_mem_word_size_t *hole_ptr;
         //There is enough room for a new hole so create it first
+#ifdef NSDYNMEM_TLSF
+        if ( direction > 0 ) {
+            hole_ptr = block_ptr + 1 + data_size + 1;
+        } else {
+            hole_ptr = block_ptr;
+            block_ptr += 1 + hole_size + 1;
+        }
+        hole_ptr[0] = -hole_size;
+        hole_ptr[1 + hole_size] = -hole_size;
+        tlsf_hole_insert(book, hole_ptr);
+#else
         if ( direction > 0 ) {
             hole_ptr = block_ptr + 1 + data_size + 1;
             // Hole will be left at end of area.
@@ -262,10 +440,13 @@ static void *ns_mem_internal_alloc(ns_mem_book_t *book, const ns_mem_block_size_
 
         hole_ptr[0] = -hole_size;
         hole_ptr[1 + hole_size] = -hole_size;
+#endif
     } else {
         // Not enough room for a left-over hole, so use the whole block
         data_size = block_data_size;
+#ifndef NSDYNMEM_TLSF
         ns_list_remove(&book->holes_list, hole_from_block_start(block_ptr));
+#endif
     }
     block_ptr[0] = data_size;
     block_ptr[1 + data_size] = data_size;
@@ -316,6 +497,45 @@ void *ns_dyn_mem_temporary_alloc(ns_mem_block_size_t alloc_size)
 }
 
 #ifndef STANDARD_MALLOC
+#ifdef NSDYNMEM_TLSF
+static void ns_mem_free_and_merge_with_adjacent_blocks(ns_mem_book_t *book, ns_mem_word_size_t *cur_block, ns_mem_word_size_t data_size)
+{
+    // All free blocks are in the segregated lists, so adjacent free blocks
+    // are taken out of their lists and the merged block is inserted once.
+    ns_mem_word_size_t *start = cur_block;
+    ns_mem_word_size_t *end = cur_block + data_size + 1;
+    ns_mem_word_size_t merged_data_size = data_size;
+
+    if (start != book->heap_main && *(start - 1) < 0) {
+        ns_mem_word_size_t *block_end = start - 1;
+        ns_mem_word_size_t block_size = 1 + (-*block_end) + 1;
+        ns_mem_word_size_t *block_start = start - block_size;
+        if (*block_start != *block_end) {
+            heap_failure(book, NS_DYN_MEM_HEAP_SECTOR_CORRUPTED);
+        } else {
+            tlsf_hole_remove(book, block_start);
+            merged_data_size += block_size;
+            start = block_start;
+        }
+    }
+
+    if (end != book->heap_main_end && *(end + 1) < 0) {
+        ns_mem_word_size_t *block_start = end + 1;
+        ns_mem_word_size_t block_size = 1 + (-*block_start) + 1;
+        if (*(end + block_size) != *block_start) {
+            heap_failure(book, NS_DYN_MEM_HEAP_SECTOR_CORRUPTED);
+        } else {
+            tlsf_hole_remove(book, block_start);
+            merged_data_size += block_size;
+            end += block_size;
+        }
+    }
+
+    *start = -merged_data_size;
+    *end = -merged_data_size;
+    tlsf_hole_insert(book, start);
+}
+#else
 static void ns_mem_free_and_merge_with_adjacent_blocks(ns_mem_book_t *book, ns_mem_word_size_t *cur_block, ns_mem_word_size_t data_size)
 {
     // Theory of operation: Block is always in form | Len | Data | Len |
@@ -402,6 +622,7 @@ static void ns_mem_free_and_merge_with_adjacent_blocks(ns_mem_book_t *book, ns_m
     *end = -merged_data_size;
 }
 #endif
+#endif
 
 void ns_mem_free(ns_mem_book_t *book, void *block)
 {
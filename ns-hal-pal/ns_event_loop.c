@@ -22,12 +22,17 @@
 #include "ns_trace.h"
 
 #include "eventOS_scheduler.h"
+#include "platform/eventloop_config.h"
 
 #include <assert.h>
 
 
 #define TRACE_GROUP "evlp"
 
+#if NS_EVENTLOOP_WORKERS > 1 && !defined(PAL_IGNORE_UNIQUE_THREAD_PRIORITY)
+#error "NS_EVENTLOOP_WORKERS > 1 runs the workers at the same priority, define PAL_IGNORE_UNIQUE_THREAD_PRIORITY"
+#endif
+
 static void event_loop_thread(const void *arg);
 
 static palThreadID_t event_thread_id = 0;
@@ -37,6 +42,17 @@ static palSemaphoreID_t event_signal_sema_id = 0;
 static palSemaphoreID_t event_stop_sema_id = 0;
 static volatile bool event_stop_loop;
 
+#if NS_EVENTLOOP_WORKERS > 1
+static void event_worker_thread(const void *arg);
+static void event_workers_init(void);
+static void event_workers_create(void);
+static void event_workers_stop(void);
+
+static palThreadID_t worker_thread_id[NS_EVENTLOOP_WORKERS];
+static palSemaphoreID_t worker_signal_sema_id[NS_EVENTLOOP_WORKERS];
+static palSemaphoreID_t worker_stop_sema_id = 0;
+#endif
+
 void eventOS_scheduler_mutex_wait(void)
 {
     palStatus_t status;
@@ -71,6 +87,87 @@ void eventOS_scheduler_idle(void)
     eventOS_scheduler_mutex_wait();
 }
 
+#if NS_EVENTLOOP_WORKERS > 1
+void eventOS_scheduler_worker_signal(uint8_t worker)
+{
+    palStatus_t status;
+    status = pal_osSemaphoreRelease(worker_signal_sema_id[worker]);
+    assert(PAL_SUCCESS == status);
+}
+
+void eventOS_scheduler_worker_idle(uint8_t worker)
+{
+    int32_t counters = 0;
+    palStatus_t status;
+
+    status = pal_osSemaphoreWait(worker_signal_sema_id[worker], UINT32_MAX, &counters);
+    assert(PAL_SUCCESS == status);
+}
+
+static void event_worker_thread(const void *arg)
+{
+    uint8_t worker = (uint8_t)(uintptr_t)arg;
+    palStatus_t status;
+
+    tr_debug("event_worker_thread %d loop start", worker);
+
+    // A stoppable version of eventOS_scheduler_run_worker(worker). The workers
+    // do not hold the scheduler mutex, that only excludes worker 0.
+    while (event_stop_loop == false) {
+        if (!eventOS_scheduler_dispatch_worker_event(worker)) {
+            eventOS_scheduler_worker_idle(worker);
+        }
+    }
+    tr_debug("event_worker_thread %d loop end", worker);
+
+    status = pal_osSemaphoreRelease(worker_stop_sema_id);
+    assert(PAL_SUCCESS == status);
+}
+
+// Events can be sent to any worker as soon as the tasklets exist, so the
+// semaphores are created before the event loop thread starts the workers
+static void event_workers_init(void)
+{
+    palStatus_t status;
+
+    status = pal_osSemaphoreCreate(0, &worker_stop_sema_id);
+    assert(PAL_SUCCESS == status);
+
+    for (uint8_t worker = 1; worker < NS_EVENTLOOP_WORKERS; worker++) {
+        status = pal_osSemaphoreCreate(0, &worker_signal_sema_id[worker]);
+        assert(PAL_SUCCESS == status);
+    }
+}
+
+static void event_workers_create(void)
+{
+    palStatus_t status;
+
+    for (uint8_t worker = 1; worker < NS_EVENTLOOP_WORKERS; worker++) {
+        status = pal_osThreadCreateWithAlloc(event_worker_thread, (void *)(uintptr_t)worker, PAL_osPriorityNormal, MBED_CONF_NS_HAL_PAL_EVENT_LOOP_THREAD_STACK_SIZE, NULL, &worker_thread_id[worker]);
+        assert(PAL_SUCCESS == status);
+    }
+}
+
+static void event_workers_stop(void)
+{
+    palStatus_t status;
+
+    // event_stop_loop is already set, wake every worker to notice it
+    for (uint8_t worker = 1; worker < NS_EVENTLOOP_WORKERS; worker++) {
+        eventOS_scheduler_worker_signal(worker);
+    }
+    for (uint8_t worker = 1; worker < NS_EVENTLOOP_WORKERS; worker++) {
+        status = pal_osSemaphoreWait(worker_stop_sema_id, UINT32_MAX, NULL);
+        assert(PAL_SUCCESS == status);
+    }
+    for (uint8_t worker = 1; worker < NS_EVENTLOOP_WORKERS; worker++) {
+        pal_osSemaphoreDelete(&worker_signal_sema_id[worker]);
+    }
+    pal_osSemaphoreDelete(&worker_stop_sema_id);
+}
+#endif
+
 static void event_loop_thread(const void *arg)
 {
     int32_t counters = 0;
@@ -87,6 +184,10 @@ static void event_loop_thread(const void *arg)
     eventOS_scheduler_mutex_wait();
     tr_debug("event_loop_thread loop start");
 
+#if NS_EVENTLOOP_WORKERS > 1
+    event_workers_create();
+#endif
+
     // A stoppable version of eventOS_scheduler_run(void)
     while (event_stop_loop == false) {
         if (!eventOS_scheduler_dispatch_event()) {
@@ -95,6 +196,10 @@ static void event_loop_thread(const void *arg)
     }
     tr_debug("event_loop_thread loop end");
 
+#if NS_EVENTLOOP_WORKERS > 1
+    event_workers_stop();
+#endif
+
     // cleanup the scheduler timer resources which are not needed anymore
     eventOS_scheduler_timer_stop();
 
@@ -123,6 +228,10 @@ void ns_event_loop_thread_create(void)
     status = pal_osMutexCreate(&event_mutex_id);
     assert(PAL_SUCCESS == status);
 
+#if NS_EVENTLOOP_WORKERS > 1
+    event_workers_init();
+#endif
+
     status = pal_osThreadCreateWithAlloc(event_loop_thread, NULL, PAL_osPriorityNormal, MBED_CONF_NS_HAL_PAL_EVENT_LOOP_THREAD_STACK_SIZE, NULL, &event_thread_id);
     assert(PAL_SUCCESS == status);
 }
@@ -143,6 +143,44 @@ extern void eventOS_event_send_user_allocated(arm_event_storage_t *event);
  * */
 extern int8_t eventOS_event_handler_create(void (*handler_func_ptr)(arm_event_t *), uint8_t init_event_type);
 
+/**
+ * \brief Pin an event handler to a scheduler worker
+ *
+ * With NS_EVENTLOOP_WORKERS greater than 1 the events of a tasklet are only
+ * run by the worker it is pinned to, so one tasklet never runs in parallel
+ * with itself and sees its events in order. New tasklets are pinned to
+ * worker 0, the thread running eventOS_scheduler_run().
+ *
+ * Events already queued for the tasklet are moved along. If an event of the
+ * tasklet is running, the move takes effect once it returns, so the tasklet
+ * never runs on both workers at once.
+ *
+ * Only worker 0 is excluded by eventOS_scheduler_mutex_wait(), a tasklet
+ * moved elsewhere must do its own locking against other threads.
+ *
+ * \param tasklet_id Tasklet ID from eventOS_event_handler_create()
+ * \param worker Worker index, below NS_EVENTLOOP_WORKERS
+ *
+ * \return 0 OK
+ * \return -1 Unknown tasklet or worker
+ */
+extern int8_t eventOS_event_handler_set_worker(int8_t tasklet_id, uint8_t worker);
+
+/**
+ * \brief Mark an event handler as reentrant
+ *
+ * Events of a reentrant tasklet may be stolen by any idle worker, so the
+ * tasklet can run in parallel with itself and its events may complete out of
+ * order. Has no effect with a single worker.
+ *
+ * \param tasklet_id Tasklet ID from eventOS_event_handler_create()
+ * \param reentrant true to allow stealing, false to run only on the pinned worker
+ *
+ * \return 0 OK
+ * \return -1 Unknown tasklet
+ */
+extern int8_t eventOS_event_handler_set_reentrant(int8_t tasklet_id, bool reentrant);
+
 /**
  * Cancel an event.
  *
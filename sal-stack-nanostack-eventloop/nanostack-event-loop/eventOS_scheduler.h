@@ -51,6 +51,28 @@ extern void eventOS_scheduler_run_until_idle(void);
  * Calls eventOS_scheduler_idle() whenever event queue is empty.
  */
 NS_NORETURN extern void eventOS_scheduler_run(void);
+
+/**
+ * Process one event from the queue of an additional worker.
+ *
+ * Only available with NS_EVENTLOOP_WORKERS greater than 1. Worker 0 is served by
+ * eventOS_scheduler_dispatch_event(), the others by one platform thread each.
+ * A worker with an empty queue steals events of reentrant tasklets from
+ * the others.
+ *
+ * \param worker Worker index, from 1 to NS_EVENTLOOP_WORKERS - 1
+ * \return true If there was event processed, false if the worker had nothing to do.
+ */
+bool eventOS_scheduler_dispatch_worker_event(uint8_t worker);
+
+/**
+ * \brief Start an additional worker.
+ * Loops forever processing events of the worker.
+ * Calls eventOS_scheduler_worker_idle() whenever the worker has nothing to do.
+ *
+ * \param worker Worker index, from 1 to NS_EVENTLOOP_WORKERS - 1
+ */
+NS_NORETURN extern void eventOS_scheduler_run_worker(uint8_t worker);
 /**
  * \brief Disable Event scheduler Timers
  *
@@ -111,6 +133,25 @@ extern void eventOS_scheduler_wait(void);
  */
 extern void eventOS_scheduler_signal(void);
 
+/**
+ * \brief Worker loop idle Callback.
+ *
+ * Counterpart of eventOS_scheduler_idle() for the additional workers, needs
+ * to be ported for the platform only with NS_EVENTLOOP_WORKERS greater than 1.
+ * Must return once eventOS_scheduler_worker_signal() has been called for the
+ * worker, also if that happened before entering.
+ *
+ * \param worker Worker index, from 1 to NS_EVENTLOOP_WORKERS - 1
+ */
+extern void eventOS_scheduler_worker_idle(uint8_t worker);
+
+/**
+ * \brief This function will be called when an additional worker receives an event.
+ *
+ * \param worker Worker index, from 1 to NS_EVENTLOOP_WORKERS - 1
+ */
+extern void eventOS_scheduler_worker_signal(uint8_t worker);
+
 /**
  * \brief This function will be called when stack can enter deep sleep state in detected time.
  *
@@ -27,6 +27,8 @@
 #undef NS_EVENTLOOP_USE_TICK_TIMER
 /* Exclude high resolution timer from build (removes need for "platform_timer" API) */
 #undef NS_EXCLUDE_HIGHRES_TIMER
+/* Number of scheduler workers; with more than 1 the platform runs eventOS_scheduler_run_worker() on its own threads */
+#undef NS_EVENTLOOP_WORKERS
 
 /*
  * mbedOS 5 specific configuration flag mapping to internal flags
@@ -39,6 +41,10 @@
 #define NS_EXCLUDE_HIGHRES_TIMER        1
 #endif
 
+#ifdef MBED_CONF_NANOSTACK_EVENTLOOP_WORKERS
+#define NS_EVENTLOOP_WORKERS            MBED_CONF_NANOSTACK_EVENTLOOP_WORKERS
+#endif
+
 /*
  * For mbedOS 3 and minar use platform tick timer by default, highres timers should come from eventloop adaptor
  */
@@ -53,4 +59,8 @@
 #include NS_EVENTLOOP_USER_CONFIG_FILE
 #endif
 
+#ifndef NS_EVENTLOOP_WORKERS
+#define NS_EVENTLOOP_WORKERS            1
+#endif
+
 #endif /* EVENTLOOP_CONFIG_H_ */
@@ -31,31 +31,82 @@ typedef struct arm_core_tasklet {
     ns_list_link_t link;
 } arm_core_tasklet_t;
 
+typedef NS_LIST_HEAD(arm_event_storage_t, link) event_queue_t;
+
 static NS_LIST_DEFINE(arm_core_tasklet_list, arm_core_tasklet_t, link);
-static NS_LIST_DEFINE(event_queue_active, arm_event_storage_t, link);
 static NS_LIST_DEFINE(free_event_entry, arm_event_storage_t, link);
 
 // Statically allocate initial pool of events.
 #define STARTUP_EVENT_POOL_SIZE 10
 static arm_event_storage_t startup_event_pool[STARTUP_EVENT_POOL_SIZE];
 
+#if NS_EVENTLOOP_WORKERS > 1
+NS_STATIC_ASSERT(NS_EVENTLOOP_WORKERS <= 32, "idle worker mask is 32 bits")
+
+/*
+ * Each worker owns a run queue, protected by the critical section like the
+ * single queue is, and an inbox. Senders push to the inbox with a CAS on the
+ * event link and never take the critical section; the worker moves the inbox
+ * into its run queue when it next looks for work. The run queue an event ends
+ * up in is decided by the receiver's affinity at that point, so an inbox
+ * may hold events for other workers after eventOS_event_handler_set_worker().
+ */
+typedef struct event_worker {
+    arm_event_storage_t *inbox;
+    event_queue_t queue;
+    int8_t running; /**< Tasklet whose event the worker is running, -1 if none */
+} event_worker_t;
+
+static event_worker_t event_workers[NS_EVENTLOOP_WORKERS];
+
+/* Worker of every tasklet ID, and bitmap of the reentrant tasklets */
+static uint8_t tasklet_worker[INT8_MAX + 1];
+static uint32_t tasklet_reentrant[(INT8_MAX + 1) / 32];
+
+/* Worker + 1 that a running tasklet moves to once its event is done, 0 if none */
+static uint8_t tasklet_move_to[INT8_MAX + 1];
+
+/* Workers which found no work on their last dispatch attempt */
+static uint32_t event_workers_idle;
+
+#define EVENT_THREAD_LOCAL __thread
+#else
+static event_queue_t NS_LIST_NAME_INIT(event_queue_active);
+
+#define EVENT_THREAD_LOCAL
+#endif
+
 /** Curr_tasklet tell to core and platform which task_let is active, Core Update this automatic when switch Tasklet. */
-int8_t curr_tasklet = 0;
+EVENT_THREAD_LOCAL int8_t curr_tasklet = 0;
 
 
 static arm_core_tasklet_t *tasklet_dynamically_allocate(void);
 static arm_event_storage_t *event_dynamically_allocate(void);
 static arm_event_storage_t *event_core_get(void);
 static void event_core_write(arm_event_storage_t *event);
+static void event_queue_insert(event_queue_t *queue, arm_event_storage_t *event);
+#if NS_EVENTLOOP_WORKERS > 1
+static void event_worker_collect(uint8_t worker);
+static void event_worker_collect_all(void);
+static void event_worker_signal(uint8_t worker);
+static bool event_tasklet_running(int8_t tasklet_id);
+static bool event_tasklet_move(int8_t tasklet_id, uint8_t worker);
+#endif
 
 static arm_core_tasklet_t *event_tasklet_handler_get(uint8_t tasklet_id)
 {
+    arm_core_tasklet_t *tasklet = NULL;
+
+    // Other workers and senders may walk the list while a tasklet is added
+    platform_enter_critical();
     ns_list_foreach(arm_core_tasklet_t, cur, &arm_core_tasklet_list) {
         if (cur->id == tasklet_id) {
-            return cur;
+            tasklet = cur;
+            break;
         }
     }
-    return NULL;
+    platform_exit_critical();
+    return tasklet;
 }
 
 bool event_tasklet_handler_id_valid(uint8_t tasklet_id)
@@ -101,9 +152,11 @@ int8_t eventOS_event_handler_create(void (*handler_func_ptr)(arm_event_s *), uin
     }
 
     //Fill in tasklet; add to list
+    platform_enter_critical();
     new->id = tasklet_get_free_id();
     new->func_ptr = handler_func_ptr;
     ns_list_add_to_end(&arm_core_tasklet_list, new);
+    platform_exit_critical();
 
     //Queue "init" event for the new task
     event_tmp->data.receiver = new->id;
@@ -115,6 +168,50 @@ int8_t eventOS_event_handler_create(void (*handler_func_ptr)(arm_event_s *), uin
     return new->id;
 }
 
+int8_t eventOS_event_handler_set_worker(int8_t tasklet_id, uint8_t worker)
+{
+    if (worker >= NS_EVENTLOOP_WORKERS || !event_tasklet_handler_get(tasklet_id)) {
+        return -1;
+    }
+#if NS_EVENTLOOP_WORKERS > 1
+    bool moved = false;
+
+    platform_enter_critical();
+    if (event_tasklet_running(tasklet_id)) {
+        // The next event must not start on the new worker while this one
+        // runs on the old, so the move waits for it to finish
+        tasklet_move_to[tasklet_id] = worker + 1;
+    } else {
+        tasklet_move_to[tasklet_id] = 0;
+        moved = event_tasklet_move(tasklet_id, worker);
+    }
+    platform_exit_critical();
+
+    if (moved) {
+        event_worker_signal(worker);
+    }
+#endif
+    return 0;
+}
+
+int8_t eventOS_event_handler_set_reentrant(int8_t tasklet_id, bool reentrant)
+{
+    if (!event_tasklet_handler_get(tasklet_id)) {
+        return -1;
+    }
+#if NS_EVENTLOOP_WORKERS > 1
+    uint32_t bit = 1u << (tasklet_id % 32);
+    if (reentrant) {
+        __atomic_fetch_or(&tasklet_reentrant[tasklet_id / 32], bit, __ATOMIC_RELAXED);
+    } else {
+        __atomic_fetch_and(&tasklet_reentrant[tasklet_id / 32], ~bit, __ATOMIC_RELAXED);
+    }
+#else
+    (void)reentrant;
+#endif
+    return 0;
+}
+
 int8_t eventOS_event_send(const arm_event_t *event)
 {
     if (event_tasklet_handler_get(event->receiver)) {
@@ -142,7 +239,12 @@ void eventOS_event_send_timer_allocated(arm_event_storage_t *event)
 
 void eventOS_event_cancel_critical(arm_event_storage_t *event)
 {
+#if NS_EVENTLOOP_WORKERS > 1
+    event_worker_collect_all();
+    ns_list_remove(&event_workers[tasklet_worker[(uint8_t)event->data.receiver & INT8_MAX]].queue, event);
+#else
     ns_list_remove(&event_queue_active, event);
+#endif
 }
 
 static arm_event_storage_t *event_dynamically_allocate(void)
@@ -202,44 +304,229 @@ void event_core_free_push(arm_event_storage_t *free)
 }
 
 
-static arm_event_storage_t *event_core_read(void)
+static void event_queue_insert(event_queue_t *queue, arm_event_storage_t *event)
+{
+    ns_list_foreach(arm_event_storage_t, event_tmp, queue) {
+        // note enum ordering means we're checking if event_tmp is LOWER priority than event
+        if (event_tmp->data.priority > event->data.priority) {
+            ns_list_add_before(queue, event_tmp, event);
+            return;
+        }
+    }
+    ns_list_add_to_end(queue, event);
+}
+
+#if NS_EVENTLOOP_WORKERS > 1
+// Requires lock to be held
+static bool event_tasklet_running(int8_t tasklet_id)
+{
+    for (uint8_t i = 0; i < NS_EVENTLOOP_WORKERS; i++) {
+        if (event_workers[i].running == tasklet_id) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Requires lock to be held, returns true if events were moved to the new worker
+static bool event_tasklet_move(int8_t tasklet_id, uint8_t worker)
+{
+    bool moved = false;
+
+    event_worker_collect_all();
+    uint8_t old_worker = tasklet_worker[tasklet_id];
+    if (old_worker != worker) {
+        __atomic_store_n(&tasklet_worker[tasklet_id], worker, __ATOMIC_RELAXED);
+        // Take the already queued events along, so they are not run in
+        // parallel with the ones sent from now on
+        ns_list_foreach_safe(arm_event_storage_t, cur, &event_workers[old_worker].queue) {
+            if (cur->data.receiver == tasklet_id) {
+                ns_list_remove(&event_workers[old_worker].queue, cur);
+                event_queue_insert(&event_workers[worker].queue, cur);
+                moved = true;
+            }
+        }
+    }
+    return moved;
+}
+
+static bool event_tasklet_reentrant(int8_t tasklet_id)
+{
+    uint8_t id = (uint8_t)tasklet_id & INT8_MAX;
+    return __atomic_load_n(&tasklet_reentrant[id / 32], __ATOMIC_RELAXED) & (1u << (id % 32));
+}
+
+static uint8_t event_tasklet_worker(int8_t tasklet_id)
+{
+    return __atomic_load_n(&tasklet_worker[(uint8_t)tasklet_id & INT8_MAX], __ATOMIC_RELAXED);
+}
+
+static void event_worker_signal(uint8_t worker)
+{
+    if (worker == 0) {
+        eventOS_scheduler_signal();
+    } else {
+        eventOS_scheduler_worker_signal(worker);
+    }
+}
+
+// Requires lock to be held
+static void event_worker_collect(uint8_t worker)
+{
+    arm_event_storage_t *event = __atomic_exchange_n(&event_workers[worker].inbox, NULL, __ATOMIC_ACQUIRE);
+    arm_event_storage_t *fifo = NULL;
+    uint32_t woken = 0;
+
+    // The inbox is last in, first out
+    while (event) {
+        arm_event_storage_t *next = event->link.next;
+        event->link.next = fifo;
+        fifo = event;
+        event = next;
+    }
+
+    while (fifo) {
+        arm_event_storage_t *next = fifo->link.next;
+        uint8_t target = event_tasklet_worker(fifo->data.receiver);
+        event_queue_insert(&event_workers[target].queue, fifo);
+        if (target != worker) {
+            woken |= 1u << target;
+        }
+        fifo = next;
+    }
+
+    for (uint8_t i = 0; woken; i++, woken >>= 1) {
+        if (woken & 1) {
+            event_worker_signal(i);
+        }
+    }
+}
+
+// Requires lock to be held
+static void event_worker_collect_all(void)
+{
+    for (uint8_t i = 0; i < NS_EVENTLOOP_WORKERS; i++) {
+        event_worker_collect(i);
+    }
+}
+
+// Requires lock to be held
+static arm_event_storage_t *event_worker_steal(uint8_t worker)
+{
+    for (uint8_t i = 1; i < NS_EVENTLOOP_WORKERS; i++) {
+        event_worker_t *victim = &event_workers[(worker + i) % NS_EVENTLOOP_WORKERS];
+        ns_list_foreach(arm_event_storage_t, cur, &victim->queue) {
+            if (event_tasklet_reentrant(cur->data.receiver)) {
+                ns_list_remove(&victim->queue, cur);
+                return cur;
+            }
+        }
+    }
+    return NULL;
+}
+
+static arm_event_storage_t *event_core_read(uint8_t worker)
 {
     platform_enter_critical();
-    arm_event_storage_t *event = ns_list_get_first(&event_queue_active);
+    event_worker_collect(worker);
+    arm_event_storage_t *event = ns_list_get_first(&event_workers[worker].queue);
+    if (event) {
+        ns_list_remove(&event_workers[worker].queue, event);
+    } else {
+        event = event_worker_steal(worker);
+    }
     if (event) {
         event->state = ARM_LIB_EVENT_RUNNING;
-        ns_list_remove(&event_queue_active, event);
+        event_workers[worker].running = event->data.receiver;
+        __atomic_fetch_and(&event_workers_idle, ~(1u << worker), __ATOMIC_RELAXED);
+    } else {
+        __atomic_fetch_or(&event_workers_idle, 1u << worker, __ATOMIC_RELAXED);
     }
     platform_exit_critical();
     return event;
 }
 
-void event_core_write(arm_event_storage_t *event)
+static void event_core_done(uint8_t worker)
 {
+    int8_t tasklet_id;
+    uint8_t move_to = 0;
+    bool moved = false;
+
     platform_enter_critical();
-    bool added = false;
-    ns_list_foreach(arm_event_storage_t, event_tmp, &event_queue_active) {
-        // note enum ordering means we're checking if event_tmp is LOWER priority than event
-        if (event_tmp->data.priority > event->data.priority) {
-            ns_list_add_before(&event_queue_active, event_tmp, event);
-            added = true;
-            break;
+    tasklet_id = event_workers[worker].running;
+    event_workers[worker].running = -1;
+    if (tasklet_move_to[tasklet_id] && !event_tasklet_running(tasklet_id)) {
+        move_to = tasklet_move_to[tasklet_id] - 1;
+        tasklet_move_to[tasklet_id] = 0;
+        moved = event_tasklet_move(tasklet_id, move_to);
+    }
+    platform_exit_critical();
+
+    if (moved) {
+        event_worker_signal(move_to);
+    }
+}
+
+void event_core_write(arm_event_storage_t *event)
+{
+    uint8_t worker = event_tasklet_worker(event->data.receiver);
+    event_worker_t *target = &event_workers[worker];
+    arm_event_storage_t *head = __atomic_load_n(&target->inbox, __ATOMIC_RELAXED);
+
+    event->state = ARM_LIB_EVENT_QUEUED;
+    do {
+        event->link.next = head;
+    } while (!__atomic_compare_exchange_n(&target->inbox, &head, event, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+
+    /* Wake From Idle */
+    event_worker_signal(worker);
+
+    /* Also wake an idle worker which may steal it, if the receiver allows */
+    if (event_tasklet_reentrant(event->data.receiver)) {
+        uint32_t idle = __atomic_load_n(&event_workers_idle, __ATOMIC_RELAXED) & ~(1u << worker);
+        if (idle) {
+            uint8_t thief = (uint8_t)__builtin_ctz(idle);
+            __atomic_fetch_and(&event_workers_idle, ~(1u << thief), __ATOMIC_RELAXED);
+            event_worker_signal(thief);
         }
     }
-    if (!added) {
-        ns_list_add_to_end(&event_queue_active, event);
+}
+#else
+static arm_event_storage_t *event_core_read(uint8_t worker)
+{
+    (void)worker;
+    platform_enter_critical();
+    arm_event_storage_t *event = ns_list_get_first(&event_queue_active);
+    if (event) {
+        event->state = ARM_LIB_EVENT_RUNNING;
+        ns_list_remove(&event_queue_active, event);
     }
+    platform_exit_critical();
+    return event;
+}
+
+void event_core_write(arm_event_storage_t *event)
+{
+    platform_enter_critical();
+    event_queue_insert(&event_queue_active, event);
     event->state = ARM_LIB_EVENT_QUEUED;
 
     /* Wake From Idle */
     platform_exit_critical();
     eventOS_scheduler_signal();
 }
+#endif
 
 // Requires lock to be held
 arm_event_storage_t *eventOS_event_find_by_id_critical(uint8_t tasklet_id, uint8_t event_id)
 {
-    ns_list_foreach(arm_event_storage_t, cur, &event_queue_active) {
+#if NS_EVENTLOOP_WORKERS > 1
+    event_worker_collect_all();
+    event_queue_t *queue = &event_workers[event_tasklet_worker(tasklet_id)].queue;
+#else
+    event_queue_t *queue = &event_queue_active;
+#endif
+    ns_list_foreach(arm_event_storage_t, cur, queue) {
         if (cur->data.receiver == tasklet_id && cur->data.event_id == event_id) {
             return cur;
         }
@@ -259,7 +546,19 @@ void eventOS_scheduler_init(void)
 {
     /* Reset Event List variables */
     ns_list_init(&free_event_entry);
+#if NS_EVENTLOOP_WORKERS > 1
+    for (unsigned i = 0; i < NS_EVENTLOOP_WORKERS; i++) {
+        event_workers[i].inbox = NULL;
+        ns_list_init(&event_workers[i].queue);
+        event_workers[i].running = -1;
+    }
+    memset(tasklet_worker, 0, sizeof(tasklet_worker));
+    memset(tasklet_reentrant, 0, sizeof(tasklet_reentrant));
+    memset(tasklet_move_to, 0, sizeof(tasklet_move_to));
+    event_workers_idle = 0;
+#else
     ns_list_init(&event_queue_active);
+#endif
     ns_list_init(&arm_core_tasklet_list);
 
     //Add first 10 entries to "free" list
@@ -306,18 +605,11 @@ int eventOS_scheduler_timer_synch_after_sleep(uint32_t sleep_ticks)
     return -1;
 }
 
-/**
- *
- * \brief Infinite Event Read Loop.
- *
- * Function Read and handle Cores Event and switch/enable tasklet which are event receiver. WhenEvent queue is empty it goes to sleep
- *
- */
-bool eventOS_scheduler_dispatch_event(void)
+static bool event_scheduler_dispatch(uint8_t worker)
 {
     curr_tasklet = 0;
 
-    arm_event_storage_t *cur_event = event_core_read();
+    arm_event_storage_t *cur_event = event_core_read(worker);
     if (!cur_event) {
         return false;
     }
@@ -338,6 +630,9 @@ bool eventOS_scheduler_dispatch_event(void)
     /* Tasklet Scheduler Call */
     tasklet->func_ptr(&cur_event->data);
     event_core_free_push(cur_event);
+#if NS_EVENTLOOP_WORKERS > 1
+    event_core_done(worker);
+#endif
 
     /* Set Current Tasklet to Idle state */
     curr_tasklet = 0;
@@ -345,6 +640,18 @@ bool eventOS_scheduler_dispatch_event(void)
     return true;
 }
 
+/**
+ *
+ * \brief Infinite Event Read Loop.
+ *
+ * Function Read and handle Cores Event and switch/enable tasklet which are event receiver. WhenEvent queue is empty it goes to sleep
+ *
+ */
+bool eventOS_scheduler_dispatch_event(void)
+{
+    return event_scheduler_dispatch(0);
+}
+
 void eventOS_scheduler_run_until_idle(void)
 {
     while (eventOS_scheduler_dispatch_event());
@@ -366,6 +673,25 @@ NS_NORETURN void eventOS_scheduler_run(void)
     }
 }
 
+#if NS_EVENTLOOP_WORKERS > 1
+bool eventOS_scheduler_dispatch_worker_event(uint8_t worker)
+{
+    if (worker == 0 || worker >= NS_EVENTLOOP_WORKERS) {
+        return false;
+    }
+    return event_scheduler_dispatch(worker);
+}
+
+NS_NORETURN void eventOS_scheduler_run_worker(uint8_t worker)
+{
+    while (1) {
+        if (!eventOS_scheduler_dispatch_worker_event(worker)) {
+            eventOS_scheduler_worker_idle(worker);
+        }
+    }
+}
+#endif
+
 void eventOS_cancel(arm_event_storage_t *event)
 {
     if (!event) {
@@ -198,11 +198,13 @@ void MbedCloudClient::error(int error, const char *reason)
 void MbedCloudClient::value_updated(M2MBase *base, M2MBase::BaseType type)
 {
     if (base) {
-        tr_info("MbedCloudClient::value_updated path %s", base->uri_path());
-        if (base->uri_path()) {
-            if (_update_values.count(base->uri_path()) != 0) {
-                tr_debug("MbedCloudClient::value_updated calling update() for %s", base->uri_path());
-                _update_values[base->uri_path()]->update();
+        char path_buffer[SN_NSDL_PATH_BUFFER_SIZE];
+        const char *path = base->uri_path(path_buffer);
+        tr_info("MbedCloudClient::value_updated path %s", path);
+        if (path) {
+            if (_update_values.count(path) != 0) {
+                tr_debug("MbedCloudClient::value_updated calling update() for %s", path);
+                _update_values[path]->update();
             } else {
                 // way to tell application that there is a value update
                 if (_value_callback) {
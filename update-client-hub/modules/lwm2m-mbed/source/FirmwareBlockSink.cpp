@@ -0,0 +1,194 @@
+// ----------------------------------------------------------------------------
+// Copyright 2016-2017 ARM Ltd.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ----------------------------------------------------------------------------
+
+// fixup the compilation on ARMCC for PRIu32
+#define __STDC_FORMAT_MACROS
+#include <inttypes.h>
+
+#include "update-client-lwm2m/FirmwareBlockSink.h"
+
+#include "update-client-common/arm_uc_common.h"
+
+#include <string.h>
+
+#define ARM_UCS_LWM2M_INTERNAL_ERROR (-1)
+#define ARM_UCS_LWM2M_INTERNAL_SUCCESS (0)
+
+namespace FirmwareBlockSink {
+
+    /* firmware PAL storage location and the handler of its events */
+    static uint32_t storageLocation = 0;
+    static ARM_UC_PAAL_UPDATE_SignalEvent_t externalEventHandler = NULL;
+
+    /* position of the next block in the image */
+    static uint16_t nextBlock = 0;
+    static uint32_t nextOffset = 0;
+
+    /* state of the write in progress */
+    static bool writeBusy = false;
+    static bool writeFailed = false;
+    static bool finalizePending = false;
+
+    /* the only copy of the block, kept until the firmware PAL has written it */
+    static uint8_t stagingMemory[ARM_UC_BLOCK_SINK_BUFFER_SIZE];
+    static arm_uc_buffer_t stagingBuffer = { sizeof(stagingMemory), 0, stagingMemory };
+}
+
+/**
+ * @brief Write the blocks received by a resource to the firmware PAL.
+ * @details The resource must allow PUT. Any previous block sink of the
+ *          resource is replaced.
+ *
+ * @param resource Resource receiving the image, such as /5/0/0, Package.
+ * @param location Prepared storage location of the firmware PAL.
+ * @param handler Event handler the firmware PAL events are forwarded to.
+ * @return ARM_UCS_LWM2M_INTERNAL_SUCCESS or ARM_UCS_LWM2M_INTERNAL_ERROR.
+ */
+int32_t FirmwareBlockSink::Attach(M2MResource* resource,
+                                  uint32_t location,
+                                  ARM_UC_PAAL_UPDATE_SignalEvent_t handler)
+{
+    UC_SRCE_TRACE("FirmwareBlockSink::Attach: %" PRIu32, location);
+
+    int32_t result = ARM_UCS_LWM2M_INTERNAL_ERROR;
+
+    if (resource)
+    {
+        storageLocation = location;
+        externalEventHandler = handler;
+        nextBlock = 0;
+        nextOffset = 0;
+        writeBusy = false;
+        writeFailed = false;
+        finalizePending = false;
+
+        if (resource->set_incoming_block_sink_callback(writeBlock))
+        {
+            result = ARM_UCS_LWM2M_INTERNAL_SUCCESS;
+        }
+    }
+
+    return result;
+}
+
+/**
+ * @brief Write one block of the image.
+ * @details The block data refers to the CoAP message, so it is copied to the
+ *          staging buffer before the write is started. A block is rejected
+ *          while the previous write is in progress, after a failed write and
+ *          when it does not follow the previous block.
+ *
+ * @param message Borrowed view of the block.
+ * @return True when the write of the block has been started.
+ */
+bool FirmwareBlockSink::writeBlock(const M2MBlockMessage* message)
+{
+    if ((message == NULL) || writeBusy || writeFailed || finalizePending)
+    {
+        return false;
+    }
+
+    /* a new push starts from the beginning of the image */
+    if (message->block_number() == 0)
+    {
+        nextBlock = 0;
+        nextOffset = 0;
+    }
+
+    uint32_t length = message->block_data_len();
+
+    if ((message->block_number() != nextBlock) ||
+        (length > stagingBuffer.size_max) ||
+        ((length > 0) && (message->block_data() == NULL)))
+    {
+        UC_SRCE_ERR_MSG("unexpected block %" PRIu16, message->block_number());
+        return false;
+    }
+
+    memcpy(stagingBuffer.ptr, message->block_data(), length);
+    stagingBuffer.size = length;
+
+    writeBusy = true;
+    finalizePending = message->is_last_block();
+
+    arm_uc_error_t result = ARM_UCP_Write(storageLocation, nextOffset, &stagingBuffer);
+
+    if (result.error != ERR_NONE)
+    {
+        UC_SRCE_ERR_MSG("ARM_UCP_Write failed: %" PRIx32, result.code);
+        writeBusy = false;
+        finalizePending = false;
+        return false;
+    }
+
+    nextBlock++;
+    nextOffset += length;
+
+    return true;
+}
+
+/**
+ * @brief Handle the events of the firmware PAL.
+ * @details The completion of the write of the last block finalizes the
+ *          storage location. Every event is forwarded to the handler given
+ *          to Attach.
+ *
+ * @param event Event from the firmware PAL.
+ */
+void FirmwareBlockSink::eventHandler(uint32_t event)
+{
+    switch (event)
+    {
+        case ARM_UC_PAAL_EVENT_WRITE_DONE:
+            writeBusy = false;
+
+            if (finalizePending)
+            {
+                arm_uc_error_t result = ARM_UCP_Finalize(storageLocation);
+
+                if (result.error != ERR_NONE)
+                {
+                    UC_SRCE_ERR_MSG("ARM_UCP_Finalize failed: %" PRIx32, result.code);
+                    finalizePending = false;
+                    writeFailed = true;
+                }
+            }
+            break;
+
+        case ARM_UC_PAAL_EVENT_WRITE_ERROR:
+            writeBusy = false;
+            finalizePending = false;
+            writeFailed = true;
+            break;
+
+        case ARM_UC_PAAL_EVENT_FINALIZE_DONE:
+        case ARM_UC_PAAL_EVENT_FINALIZE_ERROR:
+            finalizePending = false;
+            nextBlock = 0;
+            nextOffset = 0;
+            break;
+
+        default:
+            break;
+    }
+
+    if (externalEventHandler)
+    {
+        externalEventHandler(event);
+    }
+}
@@ -0,0 +1,58 @@
+// ----------------------------------------------------------------------------
+// Copyright 2016-2017 ARM Ltd.
+//
+// SPDX-License-Identifier: Apache-2.0
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+// ----------------------------------------------------------------------------
+
+#ifndef __ARM_UCS_FIRMWARE_BLOCK_SINK_H__
+#define __ARM_UCS_FIRMWARE_BLOCK_SINK_H__
+
+#include "mbed-client/m2mresource.h"
+#include "mbed-client/m2mblockmessage.h"
+
+#include "update-client-paal/arm_uc_paal_update.h"
+
+/* Largest block accepted by the sink, CoAP blocks are at most 1024 bytes */
+#ifndef ARM_UC_BLOCK_SINK_BUFFER_SIZE
+#define ARM_UC_BLOCK_SINK_BUFFER_SIZE 1024
+#endif
+
+/**
+ * Default consumer of a firmware image pushed block-wise to a resource.
+ *
+ * The sink is registered as the incoming block sink of the resource, so every
+ * block reaches it straight from the CoAP message. It copies the block once,
+ * to its staging buffer, and writes it through to the firmware PAL at the
+ * offset of the block. After the last block the storage location is finalized.
+ *
+ * The storage location must have been prepared with ARM_UCP_Prepare, and the
+ * events of the firmware PAL must be passed to eventHandler, which forwards
+ * them to the handler given to Attach.
+ */
+namespace FirmwareBlockSink {
+
+    /* Write the blocks of resource to firmware PAL storage location */
+    int32_t Attach(M2MResource* resource,
+                   uint32_t location,
+                   ARM_UC_PAAL_UPDATE_SignalEvent_t handler);
+
+    /* Write one block, the incoming_block_sink_callback set by Attach */
+    bool writeBlock(const M2MBlockMessage* message);
+
+    /* Event handler for the firmware PAL */
+    void eventHandler(uint32_t event);
+}
+
+#endif // __ARM_UCS_FIRMWARE_BLOCK_SINK_H__
@@ -19,6 +19,7 @@
 #include "arm_uc_mmDerManifestParser.h"
 
 #include <stdio.h>
+#include <string.h>
 
 #define DER_MANDATORY 0
 #define DER_OPTIONAL 1
@@ -516,6 +517,9 @@ const char* ARM_UC_mmDERDescID2Str(uint32_t id)
     }
 }
 
+// Index that ARM_UC_mmDERGetSignedResourceValues serves lookups from, NULL outside of ARM_UC_mmDERUseSignedResourceIndex
+static const struct ARM_UC_MM_DERIndex* arm_uc_mmSignedResourceIndex = NULL;
+
 /**
  * @brief Internal state of the parser
  */
@@ -523,7 +527,32 @@ struct ARM_UC_MM_DERParserState {
     uint32_t nValues;         //!< Number of values remaining to parse
     const uint32_t* valueIDs; //!< Current element of the value identifier array
     arm_uc_buffer_t* buffers; //!< Current buffer of the value output array
+    struct ARM_UC_MM_DERIndex* index; //!< Index to record every element in, or NULL
 };
+
+/**
+ * @brief Records the location of an element in an index
+ * @param[in,out] index The index to update
+ * @param[in]     id    The descriptor ID of the element
+ * @param[in]     ptr   The start of the element's value, or NULL if an optional element was not present
+ * @param[in]     size  The length of the element's value
+ */
+static void ARM_UC_mmDERIndexRecord(struct ARM_UC_MM_DERIndex* index, uint32_t id, const uint8_t* ptr, size_t size)
+{
+    if (id < ARM_UC_MM_DER_ID_MAX && index->state[id] == ARM_UC_MM_DER_INDEX_UNSEEN)
+    {
+        if (ptr)
+        {
+            index->offset[id] = (uint16_t)(ptr - index->ptr);
+            index->length[id] = (uint16_t)size;
+            index->state[id] = ARM_UC_MM_DER_INDEX_PRESENT;
+        }
+        else
+        {
+            index->state[id] = ARM_UC_MM_DER_INDEX_ABSENT;
+        }
+    }
+}
 /**
  * @brief Converts a buffer to an unsigned 32-bit integer
  * @details Assumes that the buffer is an unsigned, big-endian integer and returns it.
@@ -684,6 +713,10 @@ int32_t ARM_UC_mmDERGetValues(const struct arm_uc_mmDerElement* desc, uint8_t**
     // If an optional tag was expected, but not encountered, it is not an error unless it was requested by the user.
     if (rc == ARM_UC_DP_ERR_ASN1_UNEXPECTED_TAG && desc->optional && desc->id != state->valueIDs[0])
     {
+        if (state->index)
+        {
+            ARM_UC_mmDERIndexRecord(state->index, desc->id, NULL, 0);
+        }
         DER_PARSER_LOG(DER_PARSER_LOG_LEVEL_DESCRIPTORS, " (skipped)\n");
         return 0;
     } // TODO evaluate length handling in ARM_UC_MM_ASN1_get_tag
@@ -693,22 +726,24 @@ int32_t ARM_UC_mmDERGetValues(const struct arm_uc_mmDerElement* desc, uint8_t**
         DER_PARSER_LOG(DER_PARSER_LOG_LEVEL_DESCRIPTORS, " (error %d)\n", rc);
         return rc;
     }
+    // If the element is a sequence, its value is the whole element, not just the content.
+    uint8_t* valuePos = *pos;
+    size_t valueLen = len;
+    if (desc->tag == (ARM_UC_MM_ASN1_CONSTRUCTED | ARM_UC_MM_ASN1_SEQUENCE) && desc->nSubElements != 1)
+    {
+        valuePos = seqpos;
+        valueLen = len + (*pos - seqpos);
+    }
+    if (state->index)
+    {
+        ARM_UC_mmDERIndexRecord(state->index, desc->id, valuePos, valueLen);
+    }
     // If the encountered tag is one of the requested IDs, record its location and size, then move on to the next value
     if (desc->id == state->valueIDs[0])
     {
-        // If the element is a sequence, store the whole element, not just the content.
-        if (desc->tag == (ARM_UC_MM_ASN1_CONSTRUCTED | ARM_UC_MM_ASN1_SEQUENCE) && desc->nSubElements != 1)
-        {
-            state->buffers[0].ptr = seqpos;
-            state->buffers[0].size = len + (*pos - seqpos);
-            state->buffers[0].size_max = len + (*pos - seqpos);
-        }
-        else
-        {
-            state->buffers[0].ptr = *pos;
-            state->buffers[0].size = len;
-            state->buffers[0].size_max = len;
-        }
+        state->buffers[0].ptr = valuePos;
+        state->buffers[0].size = valueLen;
+        state->buffers[0].size_max = valueLen;
         state->nValues--;
         state->valueIDs++;
         state->buffers++;
@@ -854,7 +889,7 @@ int32_t ARM_UC_mmDERParseTree(const struct arm_uc_mmDerElement* desc, arm_uc_buf
     uint8_t *pos = buffer->ptr;
     uint8_t *end = pos + buffer->size;
     struct ARM_UC_MM_DERParserState state = {
-        nValues, valueIDs, buffers
+        nValues, (const uint32_t*)valueIDs, buffers, NULL
     };
     arm_uc_mm_derRecurseDepth = 0;
     int32_t rc = ARM_UC_mmDERGetValues(desc, &pos, end, &state);
@@ -865,10 +900,58 @@ int32_t ARM_UC_mmDERParseTree(const struct arm_uc_mmDerElement* desc, arm_uc_buf
     }
     return rc;
 }
+/**
+ * @brief Indexes every element of a SignedResource in a single walk of the DER tree
+ * @details The index belongs to the caller, which makes it the index of lookups with
+ * `ARM_UC_mmDERUseSignedResourceIndex` only while it holds the buffer unmodified.
+ *
+ * A malformed buffer is still indexed: lookups return the same errors that a tree walk would.
+ * @param[in]  buffer The SignedResource to index
+ * @param[out] index  The index to build
+ * @retval ARM_UC_DP_ERR_ASN1_INVALID_LENGTH  The buffer is too large to be indexed; no index is held
+ * @retval ARM_UC_DP_ERR_ASN1_OUT_OF_DATA     The parser has run out of data before running out of descriptors
+ * @retval ARM_UC_DP_ERR_ASN1_UNEXPECTED_TAG  The parser has encountered an encoding error, or unsupported DER document
+ * @retval ARM_UC_DP_ERR_ASN1_LENGTH_MISMATCH The elements of the DER tree do not have consistent lengths.
+ * @retval 0                                Success!
+ */
+int32_t ARM_UC_mmDERIndexSignedResource(arm_uc_buffer_t* buffer, struct ARM_UC_MM_DERIndex* index)
+{
+    memset(index, 0, sizeof(*index));
+    if (buffer->size > UINT16_MAX)
+    {
+        return ARM_UC_DP_ERR_ASN1_INVALID_LENGTH;
+    }
+    // The sentinel ID matches no descriptor, so nothing is extracted and the whole tree is walked.
+    const uint32_t sentinel = ARM_UC_MM_DER_ID_MAX;
+    uint8_t *pos = buffer->ptr;
+    uint8_t *end = pos + buffer->size;
+    struct ARM_UC_MM_DERParserState state = {
+        1, &sentinel, NULL, index
+    };
+    index->ptr = buffer->ptr;
+    index->size = buffer->size;
+    arm_uc_mm_derRecurseDepth = 0;
+    index->rc = ARM_UC_mmDERGetValues(&SignedResource, &pos, end, &state);
+    return index->rc;
+}
+
+/**
+ * @brief Selects the index that SignedResource lookups are served from
+ * @details Until it is called with NULL, `ARM_UC_mmDERGetSignedResourceValues` serves requests for the buffer described
+ * by the index from the index, and walks the DER tree for any other buffer. The caller must select NULL before it
+ * returns to the scheduler, so that no other FSM is ever served from an index it did not build.
+ * @param[in] index The index to serve lookups from, or NULL to walk the DER tree for every lookup
+ */
+void ARM_UC_mmDERUseSignedResourceIndex(const struct ARM_UC_MM_DERIndex* index)
+{
+    arm_uc_mmSignedResourceIndex = index;
+}
+
 /**
  * @brief Parses a tree of DER data by calling `ARM_UC_mmDERGetValues`
  * @details Populates a parser state with the IDs to be extracted, the number of values and the buffers to extract into
- * Calls `ARM_UC_mmDERParseTree` with `SignedResource`
+ * Calls `ARM_UC_mmDERParseTree` with `SignedResource`, unless the buffer is the one described by the index selected with
+ * `ARM_UC_mmDERUseSignedResourceIndex`, in which case the values are looked up in the index.
  * @param[in]  buffer   The data to parse
  * @param[in]  nValues  The number of values to search for
  * @param[in]  valueIDs Array of value identifiers
@@ -881,5 +964,32 @@ int32_t ARM_UC_mmDERParseTree(const struct arm_uc_mmDerElement* desc, arm_uc_buf
  */
 int32_t ARM_UC_mmDERGetSignedResourceValues(arm_uc_buffer_t* buffer, uint32_t nValues, const int32_t* valueIDs, arm_uc_buffer_t* buffers)
 {
-    return ARM_UC_mmDERParseTree(&SignedResource, buffer, nValues, valueIDs, buffers);
+    const struct ARM_UC_MM_DERIndex* index = arm_uc_mmSignedResourceIndex;
+    if (index == NULL || index->ptr == NULL || index->ptr != buffer->ptr || index->size != buffer->size)
+    {
+        return ARM_UC_mmDERParseTree(&SignedResource, buffer, nValues, valueIDs, buffers);
+    }
+    uint32_t i;
+    for (i = 0; i < nValues; i++)
+    {
+        uint32_t id = (uint32_t)valueIDs[i];
+        uint8_t state = (id < ARM_UC_MM_DER_ID_MAX) ? index->state[id] : ARM_UC_MM_DER_INDEX_UNSEEN;
+        if (state == ARM_UC_MM_DER_INDEX_PRESENT)
+        {
+            buffers[i].ptr = buffer->ptr + index->offset[id];
+            buffers[i].size = index->length[id];
+            buffers[i].size_max = index->length[id];
+        }
+        else if (state == ARM_UC_MM_DER_INDEX_ABSENT)
+        {
+            // A tree walk fails when a requested optional element is not present
+            return ARM_UC_DP_ERR_ASN1_UNEXPECTED_TAG;
+        }
+        else
+        {
+            // A tree walk searches until it fails or runs out of descriptors
+            return index->rc ? index->rc : (int32_t)(nValues - i);
+        }
+    }
+    return 0;
 }
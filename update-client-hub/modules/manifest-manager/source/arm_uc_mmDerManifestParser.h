@@ -146,10 +146,32 @@ enum derIDs {
 #define ENUM_AUTO(X) X,
     ARM_UC_MM_DER_ID_LIST
 #undef ENUM_AUTO
+    ARM_UC_MM_DER_ID_MAX
 };
 
 #define ARM_UC_DER_PARSER_ERROR_PREFIX TWO_CC('D', 'P')
 
+enum ARM_UC_MM_DERIndexState {
+    ARM_UC_MM_DER_INDEX_UNSEEN = 0, //!< The parser did not reach the element
+    ARM_UC_MM_DER_INDEX_PRESENT,    //!< The element was found at offset/length
+    ARM_UC_MM_DER_INDEX_ABSENT      //!< An optional element was expected, but a different tag was encountered
+};
+
+/**
+ * @brief Location of every element of a SignedResource, by element ID
+ * @details Built by a single walk of the whole SignedResource tree. Only the first occurrence of each ID is recorded,
+ * since that is the one a tree walk searching for that ID stops at. The result of the walk is kept as well, so that a
+ * lookup of an element that was not reached fails the same way a tree walk for it would.
+ */
+struct ARM_UC_MM_DERIndex {
+    const uint8_t* ptr;                          //!< Start of the indexed buffer, NULL if no index is held
+    uint32_t size;                               //!< Size of the indexed buffer
+    int32_t rc;                                  //!< Result of the indexing walk
+    uint16_t offset[ARM_UC_MM_DER_ID_MAX];       //!< Offset of each element's value from ptr
+    uint16_t length[ARM_UC_MM_DER_ID_MAX];       //!< Length of each element's value
+    uint8_t state[ARM_UC_MM_DER_ID_MAX];         //!< ARM_UC_MM_DERIndexState of each element
+};
+
 struct arm_uc_mmDerElement
 {
     uint32_t id;
@@ -171,6 +193,8 @@ uint32_t ARM_UC_mmDerBuf2Uint(arm_uc_buffer_t* buf);
 uint64_t ARM_UC_mmDerBuf2Uint64(arm_uc_buffer_t* buf);
 int32_t ARM_UC_mmDERGetSequenceElement(arm_uc_buffer_t* buffer, uint32_t index, arm_uc_buffer_t* element);
 int32_t ARM_UC_mmDERParseTree(const struct arm_uc_mmDerElement* desc, arm_uc_buffer_t* buffer, uint32_t nValues, const int32_t* valueIDs, arm_uc_buffer_t* buffers);
+int32_t ARM_UC_mmDERIndexSignedResource(arm_uc_buffer_t* buffer, struct ARM_UC_MM_DERIndex* index);
+void ARM_UC_mmDERUseSignedResourceIndex(const struct ARM_UC_MM_DERIndex* index);
 
 
 #ifdef __cplusplus
@@ -256,8 +256,9 @@ static arm_uc_error_t state_idle(struct arm_uc_mmInsertContext_t* ctx, uint32_t*
     return err;
 }
 /* @brief Begin state
- * @details This is an empty placeholder state that is used as a state transition target for Idle. This allows
- *          modifications to the FSM flow without modifying Idle.
+ * @details Indexes the manifest, so that the fields read by the verification states are looked up in the index rather
+ *          than found by walking the DER tree again for each field. The index is kept in the insert context and is only
+ *          used while ARM_UC_mmInsertFSM runs.
  * DOT States:
  * DOT:    Begin
  * DOT:    Begin -> VerifyBasicParameters
@@ -265,6 +266,8 @@ static arm_uc_error_t state_idle(struct arm_uc_mmInsertContext_t* ctx, uint32_t*
 static arm_uc_error_t state_begin(struct arm_uc_mmInsertContext_t* ctx, uint32_t* event)
 {
     arm_uc_error_t err = {MFST_ERR_NONE};
+    // A parse error is recorded in the index and reported by the first field lookup that reaches it.
+    ARM_UC_mmDERIndexSignedResource(&ctx->manifest, &ctx->manifestIndex);
     ctx->state = ARM_UC_MM_INS_STATE_VERIFY_BASIC_PARAMS;
     return err;
 }
@@ -595,6 +598,13 @@ arm_uc_error_t ARM_UC_mmInsertFSM(uint32_t event)
     uint32_t oldEvent;
 #endif
     ARM_UC_MM_DEBUG_LOG(ARM_UC_MM_DEBUG_LOG_LEVEL_STATES, "> %s (%u)\n", __PRETTY_FUNCTION__, (unsigned)event);
+    // The index is built in Begin, before that it may describe a manifest that an abandoned insert left behind
+    if (ctx->state == ARM_UC_MM_INS_STATE_IDLE || ctx->state == ARM_UC_MM_INS_STATE_BEGIN)
+    {
+        ctx->manifestIndex.ptr = NULL;
+    }
+    // Lookups are served from the index of this insert only until the FSM returns to the scheduler
+    ARM_UC_mmDERUseSignedResourceIndex(&ctx->manifestIndex);
     do {
         // Preserve the old state to check for state transitions
         oldState = ctx->state;
@@ -662,6 +672,11 @@ arm_uc_error_t ARM_UC_mmInsertFSM(uint32_t event)
         }
 #endif
     } while (err.code == MFST_ERR_NONE && oldState != ctx->state);
+    if (ctx->state == ARM_UC_MM_INS_STATE_ALERT || (err.code != MFST_ERR_NONE && err.code != MFST_ERR_PENDING))
+    {
+        ctx->manifestIndex.ptr = NULL;
+    }
+    ARM_UC_mmDERUseSignedResourceIndex(NULL);
     ARM_UC_MM_DEBUG_LOG(ARM_UC_MM_DEBUG_LOG_LEVEL_STATES, "< %s %c%c:%hu (%s)\n", __PRETTY_FUNCTION__, err.modulecc[0], err.modulecc[1], err.error, ARM_UC_err2Str(err));
     return err;
 }
@@ -21,6 +21,7 @@
 
 #include "update-client-manifest-manager/update-client-manifest-types.h"
 #include "update-client-manifest-manager/../source/arm_uc_mmConfig.h"
+#include "update-client-manifest-manager/../source/arm_uc_mmDerManifestParser.h"
 #include "update-client-common/arm_uc_error.h"
 #include "update-client-common/arm_uc_types.h"
 #include "update-client-common/arm_uc_scheduler.h"
@@ -176,6 +177,7 @@ struct arm_uc_mmInsertContext_t {
                   arm_uc_mm_crypto_flags_t cryptoMode;
                            arm_uc_buffer_t certificateStorage;
                                   uint32_t loopCounters[1];
+                 struct ARM_UC_MM_DERIndex manifestIndex;
 };
 
 struct arm_uc_mmContext_t {